@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdlib>
+#include <string>
+#include "FrameRecorder.h"
+#include "FrameReplayer.h"
+#include "Interrupter.h"
+#include "PreviewerEngineLog.h"
+#include "WebSocketServer.h"
+
+// Serves a recording of the -rec option on the previewer websocket, without an ACE runtime. The client connects
+// as it would to the previewer, the replay starts once it is writable.
+//   FrameReplay <recording> [-p <port>] [-speed <x>] [-loop <n>]
+
+namespace {
+    const int DEFAULT_PORT = 40000;
+    const int MIN_PORT = 1024;
+    const int MAX_PORT = 65535;
+    const double MAX_SPEED = 100.0;
+    const int MAX_LOOPS = 100000;
+
+    struct ReplayOptions {
+        std::string path;
+        int port = DEFAULT_PORT;
+        double speed = 1.0;
+        int loops = 1;
+    };
+
+    bool ParseOptions(int argc, char* argv[], ReplayOptions& options)
+    {
+        if (argc < 2) { // 2: the program and the recording
+            return false;
+        }
+        options.path = argv[1];
+        for (int i = 2; i + 1 < argc; i += 2) { // 2: every option takes one value
+            std::string name = argv[i];
+            char* end = nullptr;
+            if (name == "-p") {
+                options.port = static_cast<int>(std::strtol(argv[i + 1], &end, 10)); // 10: decimal
+            } else if (name == "-speed") {
+                options.speed = std::strtod(argv[i + 1], &end);
+            } else if (name == "-loop") {
+                options.loops = static_cast<int>(std::strtol(argv[i + 1], &end, 10)); // 10: decimal
+            } else {
+                return false;
+            }
+            if (end == argv[i + 1] || *end != '\0') {
+                return false;
+            }
+        }
+        return (argc % 2 == 0) && options.port >= MIN_PORT && options.port <= MAX_PORT && options.speed >= 0 &&
+            options.speed <= MAX_SPEED && options.loops >= 1 && options.loops <= MAX_LOOPS; // 2: name and value
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    ReplayOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        ELOG("Usage: FrameReplay <recording> [-p <port>] [-speed <0 as fast as possible, else 0-%.0f>] "
+             "[-loop <1-%d>]", MAX_SPEED, MAX_LOOPS);
+        return 1;
+    }
+    FrameRecordReader reader;
+    if (!reader.Open(options.path) || reader.GetCount() == 0) {
+        ELOG("FrameReplay no frames in %s", options.path.c_str());
+        return 1;
+    }
+    // The recording holds every simulcast variant, a client picks one with ?variant=<n> as on the previewer.
+    int32_t variantCount = 0;
+    FrameRecord record;
+    for (size_t position = 0; position < reader.GetCount(); position++) {
+        if (reader.Read(position, record)) {
+            variantCount = std::max(variantCount, record.variant);
+        }
+    }
+    WebSocketServer& server = WebSocketServer::GetInstance();
+    server.SetServerPort(options.port);
+    server.SetVariantCount(variantCount);
+    server.Run();
+    ILOG("FrameReplay %zu frames of %s on port %d", reader.GetCount(), options.path.c_str(), options.port);
+    // The schedule starts with the first frame, it must not include the wait for the client.
+    bool isConnected = false;
+    while (!isConnected && !Interrupter::IsInterrupt()) {
+        isConnected = server.WaitForClient(std::chrono::milliseconds(100)); // 100: wake up to see an interrupt
+    }
+    auto sink = [&server](const FrameRecord& frame) {
+        return server.WriteData(const_cast<uint8_t*>(frame.packet.data()), frame.packet.size(), frame.variant);
+    };
+    for (int loop = 0; loop < options.loops && !Interrupter::IsInterrupt(); loop++) {
+        FrameReplayer::Stats stats;
+        if (!FrameReplayer::Replay(reader, options.speed, sink, stats)) {
+            return 1;
+        }
+        ILOG("FrameReplay loop %d: %" PRIu64 " frames, %" PRIu64 " bytes in %" PRId64 " us, %" PRIu64
+             " late by up to %" PRId64 " us", loop + 1, stats.frames, stats.bytes, stats.durationUs,
+             stats.lateFrames, stats.maxLateUs);
+    }
+    return 0;
+}
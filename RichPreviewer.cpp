@@ -30,6 +30,7 @@
 #include "VirtualScreenImpl.h"
 
 static const int NOTIFY_INTERVAL_TIME = 1000; // Unit millisecond
+static const int SAVE_LAST_FRAME_INTERVAL_TIME = 10000; // Unit millisecond
 
 static void ApplyConfig()
 {
@@ -62,11 +63,22 @@ static void NotifyInspectorChanged()
     ILOG("Send inspector json tree.");
 }
 
+static void SaveLastFrame()
+{
+    VirtualScreenImpl::GetInstance().SaveLastFrame();
+}
+
 static void ProcessCommand()
 {
     static CppTimer inspectorNotifytimer(NotifyInspectorChanged);
     inspectorNotifytimer.Start(NOTIFY_INTERVAL_TIME); // Notify per second
     CppTimerManager::GetTimerManager().AddCppTimer(inspectorNotifytimer);
+    if (!CommandParser::GetInstance().GetLastFrameDir().empty()) {
+        // Also saved on exit, the timer keeps a frame when the previewer is killed.
+        static CppTimer lastFrameSaveTimer(SaveLastFrame);
+        lastFrameSaveTimer.Start(SAVE_LAST_FRAME_INTERVAL_TIME);
+        CppTimerManager::GetTimerManager().AddCppTimer(lastFrameSaveTimer);
+    }
 
     VirtualScreenImpl::GetInstance().InitFrameCountTimer();
     while (!Interrupter::IsInterrupt()) {
@@ -74,6 +86,7 @@ static void ProcessCommand()
         CppTimerManager::GetTimerManager().RunTimerTick();
         std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
+    SaveLastFrame();
     JsAppImpl::GetInstance().Stop();
 }
 
@@ -16,11 +16,14 @@
 #include "CommandLine.h"
 
 #include <algorithm>
+#include <cinttypes>
+#include <fstream>
 #include <regex>
 #include <sstream>
 
 #include "CommandLineInterface.h"
 #include "CommandParser.h"
+#include "FileSystem.h"
 #include "Interrupter.h"
 #include "JsApp.h"
 #include "JsAppImpl.h"
@@ -31,10 +34,29 @@
 #include "MouseInputImpl.h"
 #include "MouseWheelImpl.h"
 #include "KeyInputImpl.h"
+#include "PngEncoder.h"
 #include "PreviewerEngineLog.h"
+#include "PublicMethods.h"
 #include "SharedData.h"
 #include "VirtualMessageImpl.h"
 #include "VirtualScreenImpl.h"
+#include "WebSocketServer.h"
+
+namespace {
+    FrameConfig GetFrameConfig()
+    {
+        FrameConfig config;
+        VirtualScreenImpl& screen = VirtualScreenImpl::GetInstance();
+        config.route = screen.GetCurrentRouter();
+        config.width = screen.GetCurrentWidth();
+        config.height = screen.GetCurrentHeight();
+        config.orientation = JsAppImpl::GetInstance().GetOrientation();
+        config.colorMode = JsAppImpl::GetInstance().GetColorMode();
+        config.language = SharedData<std::string>::GetData(SharedDataType::LANGUAGE);
+        config.foldStatus = screen.GetFoldStatus();
+        return config;
+    }
+}
 
 CommandLine::CommandLine(CommandType commandType, const Json2::Value& arg, const LocalSocket& socket)
     : args(arg), cliSocket(socket), type(commandType), commandName("")
@@ -110,6 +132,35 @@ void CommandLine::SetCommandName(std::string command)
     this->commandName = command;
 }
 
+void CommandLine::SwitchConfiguration(const std::function<void()>& change) const
+{
+    VirtualScreenImpl::GetInstance().SaveLastFrame(); // the frames after the switch are not of the launch one
+    VirtualScreenImpl::GetInstance().StopSavingLastFrame();
+    VirtualScreenImpl::GetInstance().SaveConfigFrame(GetFrameConfig());
+    change();
+    if (VirtualScreenImpl::GetInstance().ShowConfigFrame(GetFrameConfig())) {
+        ILOG("%s shows the cached frame of the configuration", commandName.c_str());
+    }
+}
+
+bool CommandLine::IsOptionalIntValid(const std::string& key, int64_t minValue, int64_t maxValue) const
+{
+    if (!args.IsMember(key.c_str())) {
+        return true;
+    }
+    if (!args[key.c_str()].IsInt64()) {
+        ELOG("%s param %s must be an integer", commandName.c_str(), key.c_str());
+        return false;
+    }
+    int64_t value = args[key.c_str()].AsInt64();
+    if (value < minValue || value > maxValue) {
+        ELOG("%s param %s must be in [%" PRId64 ", %" PRId64 "]", commandName.c_str(), key.c_str(),
+             minValue, maxValue);
+        return false;
+    }
+    return true;
+}
+
 void CommandLine::SetCommandResult(const std::string& resultType, const Json2::Value& resultContent)
 {
     this->commandResult.Add("version", CommandLineInterface::COMMAND_VERSION.c_str());
@@ -141,6 +192,7 @@ void TouchAndMouseCommand::SetEventParams(EventParams& params)
     if (CommandParser::GetInstance().GetScreenMode() == CommandParser::ScreenMode::STATIC) {
         return;
     }
+    VirtualScreenImpl::GetInstance().MapInputPosition(params.x, params.y);
     MouseInputImpl::GetInstance().SetMousePosition(params.x, params.y);
     MouseInputImpl::GetInstance().SetMouseStatus(params.type);
     MouseInputImpl::GetInstance().SetMouseButton(params.button);
@@ -504,6 +556,8 @@ void ResolutionSwitchCommand::RunSet()
         reason = args["reason"].AsString();
     }
     ResolutionParam param(originWidth, originHeight, width, height);
+    VirtualScreenImpl::GetInstance().SaveLastFrame();
+    VirtualScreenImpl::GetInstance().StopSavingLastFrame();
     JsAppImpl::GetInstance().ResolutionChanged(param, screenDensity, reason);
     SetCommandResult("result", JsonReader::CreateBool(true));
     ILOG("ResolutionSwitch run finished.");
@@ -536,7 +590,9 @@ void OrientationCommand::RunSet()
     std::string commandOrientation = args["Orientation"].AsString();
     std::string currentOrientation = JsAppImpl::GetInstance().GetOrientation();
     if (commandOrientation != currentOrientation) {
-        JsAppImpl::GetInstance().OrientationChanged(commandOrientation);
+        SwitchConfiguration([&commandOrientation]() {
+            JsAppImpl::GetInstance().OrientationChanged(commandOrientation);
+        });
     }
     SetCommandResult("result", JsonReader::CreateBool(true));
     ILOG("Set Orientation run finished, Orientation is: %s", args["Orientation"].AsString().c_str());
@@ -570,8 +626,10 @@ void ColorModeCommand::RunSet()
     std::string commandColorMode = args["ColorMode"].AsString();
     std::string currentColorMode = JsAppImpl::GetInstance().GetColorMode();
     if (commandColorMode != currentColorMode) {
-        JsAppImpl::GetInstance().SetArgsColorMode(args["ColorMode"].AsString());
-        JsAppImpl::GetInstance().ColorModeChanged(commandColorMode);
+        SwitchConfiguration([&commandColorMode]() {
+            JsAppImpl::GetInstance().SetArgsColorMode(commandColorMode);
+            JsAppImpl::GetInstance().ColorModeChanged(commandColorMode);
+        });
     }
     SetCommandResult("result", JsonReader::CreateBool(true));
     ILOG("Set ColorMode run finished, ColorMode is: %s", args["ColorMode"].AsString().c_str());
@@ -618,6 +676,7 @@ bool MemoryRefreshCommand::IsSetArgValid() const
 void MemoryRefreshCommand::RunSet()
 {
     ILOG("MemoryRefreshCommand begin.");
+    VirtualScreenImpl::GetInstance().InvalidateConfigFrames(); // the frames were rendered from the old sources
     bool ret = JsAppImpl::GetInstance().MemoryRefresh(args.ToStyledString());
     SetCommandResult("result", JsonReader::CreateBool(ret));
     ILOG("MemoryRefresh finished.");
@@ -739,6 +798,7 @@ void ReloadRuntimePageCommand::RunSet()
         return;
     }
     std::string currentPage = args["ReloadRuntimePage"].AsString();
+    VirtualScreenImpl::GetInstance().InvalidateConfigFrames(); // the frames were rendered from the old sources
     JsAppImpl::GetInstance().ReloadRuntimePage(currentPage);
     SetCommandResult("result", JsonReader::CreateBool(true));
     ILOG("ReloadRuntimePage finished, currentPage is: %s", args["ReloadRuntimePage"].AsString().c_str());
@@ -819,7 +879,9 @@ void LanguageCommand::RunSet()
         return;
     }
     std::string language(args["Language"].AsString());
-    SharedData<std::string>::SetData(SharedDataType::LANGUAGE, language);
+    if (language != SharedData<std::string>::GetData(SharedDataType::LANGUAGE)) {
+        SwitchConfiguration([&language]() { SharedData<std::string>::SetData(SharedDataType::LANGUAGE, language); });
+    }
     SetCommandResult("result", JsonReader::CreateBool(true));
     ILOG("Set language run finished, language is: %s", language.c_str());
 }
@@ -1652,7 +1714,9 @@ void FoldStatusCommand::RunSet()
     int32_t height = args["height"].AsInt();
     std::string currentStatus = VirtualScreenImpl::GetInstance().GetFoldStatus();
     if (commandStatus != currentStatus) {
-        JsAppImpl::GetInstance().FoldStatusChanged(commandStatus, width, height);
+        SwitchConfiguration([&commandStatus, width, height]() {
+            JsAppImpl::GetInstance().FoldStatusChanged(commandStatus, width, height);
+        });
     }
     SetCommandResult("result", JsonReader::CreateBool(true));
     ILOG("Set FoldStatus run finished, FoldStatus is: %s", args["FoldStatus"].AsString().c_str());
@@ -1739,4 +1803,442 @@ void AvoidAreaChangedCommand::RunGet()
 {
     SetResultToManager("args", args, "AvoidAreaChanged");
     ILOG("Get AvoidAreaChangedCommand run finished.");
-}
\ No newline at end of file
+}
+
+AdaptiveQualityCommand::AdaptiveQualityCommand(CommandType commandType, const Json2::Value& arg,
+    const LocalSocket& socket) : CommandLine(commandType, arg, socket)
+{
+}
+
+bool AdaptiveQualityCommand::IsSetArgValid() const
+{
+    if (args.IsNull() || !args.IsMember("enable") || !args["enable"].IsBool()) {
+        ELOG("Invalid AdaptiveQuality of arguments!");
+        return false;
+    }
+    if (!IsOptionalIntValid("latency", 0, INT32_MAX) || !IsOptionalIntValid("bandwidth", 0, INT32_MAX) ||
+        !IsOptionalIntValid("maxQuality", AdaptiveQuality::MIN_QUALITY, AdaptiveQuality::MAX_QUALITY)) {
+        return false;
+    }
+    return true;
+}
+
+void AdaptiveQualityCommand::RunSet()
+{
+    AdaptiveQualityConfig config = VirtualScreenImpl::GetInstance().GetAdaptiveQuality();
+    config.enabled = args["enable"].AsBool();
+    if (args.IsMember("latency")) {
+        config.latencyBudgetMs = static_cast<int32_t>(args["latency"].AsInt64());
+    }
+    if (args.IsMember("bandwidth")) {
+        config.bandwidthBytesPerSecond = args["bandwidth"].AsInt64() * 1024; // 1024: the argument is in KB/s
+    }
+    if (args.IsMember("maxQuality")) {
+        config.maxQuality = static_cast<int32_t>(args["maxQuality"].AsInt64());
+    }
+    VirtualScreenImpl::GetInstance().SetAdaptiveQuality(config);
+    SetCommandResult("result", JsonReader::CreateBool(true));
+    ILOG("Set AdaptiveQuality enable: %d latency: %dms bandwidth: %" PRId64 "B/s maxQuality: %d",
+        config.enabled, config.latencyBudgetMs, config.bandwidthBytesPerSecond, config.maxQuality);
+}
+
+void AdaptiveQualityCommand::RunGet()
+{
+    AdaptiveQualityConfig config = VirtualScreenImpl::GetInstance().GetAdaptiveQuality();
+    Json2::Value resultContent = JsonReader::CreateObject();
+    resultContent.Add("enable", config.enabled);
+    resultContent.Add("latency", config.latencyBudgetMs);
+    resultContent.Add("bandwidth", config.bandwidthBytesPerSecond / 1024); // 1024: reported in KB/s
+    resultContent.Add("maxQuality", config.maxQuality);
+    SetCommandResult("result", resultContent);
+    ILOG("Get AdaptiveQuality run finished.");
+}
+
+FrameCodecCommand::FrameCodecCommand(CommandType commandType, const Json2::Value& arg,
+    const LocalSocket& socket) : CommandLine(commandType, arg, socket)
+{
+}
+
+bool FrameCodecCommand::IsSetArgValid() const
+{
+    if (args.IsNull() || !args.IsMember("codec") || !args["codec"].IsString()) {
+        ELOG("Invalid FrameCodec of arguments!");
+        return false;
+    }
+    return true;
+}
+
+void FrameCodecCommand::RunSet()
+{
+    std::string codec = args["codec"].AsString();
+    bool result = VirtualScreenImpl::GetInstance().SetFrameCodec(codec);
+    if (!result) {
+        ELOG("FrameCodec %s is not supported.", codec.c_str());
+    }
+    SetCommandResult("result", JsonReader::CreateBool(result));
+    ILOG("Set FrameCodec run finished, codec: %s", codec.c_str());
+}
+
+void FrameCodecCommand::RunGet()
+{
+    SetCommandResult("result", JsonReader::CreateString(VirtualScreenImpl::GetInstance().GetFrameCodec()));
+    ILOG("Get FrameCodec run finished.");
+}
+
+FrameDeltaCommand::FrameDeltaCommand(CommandType commandType, const Json2::Value& arg,
+    const LocalSocket& socket) : CommandLine(commandType, arg, socket)
+{
+}
+
+bool FrameDeltaCommand::IsSetArgValid() const
+{
+    if (args.IsNull() || !args.IsMember("enable") || !args["enable"].IsBool()) {
+        ELOG("Invalid FrameDelta of arguments!");
+        return false;
+    }
+    if (!args.IsMember("keyframeInterval")) {
+        return true;
+    }
+    if (!args["keyframeInterval"].IsInt64() || args["keyframeInterval"].AsInt64() < 1 ||
+        args["keyframeInterval"].AsInt64() > FrameDelta::MAX_KEYFRAME_INTERVAL) {
+        ELOG("FrameDelta param keyframeInterval must be in [1, %u]", FrameDelta::MAX_KEYFRAME_INTERVAL);
+        return false;
+    }
+    return true;
+}
+
+void FrameDeltaCommand::RunSet()
+{
+    uint32_t interval = VirtualScreenImpl::GetInstance().GetKeyframeInterval();
+    if (args.IsMember("keyframeInterval")) {
+        interval = static_cast<uint32_t>(args["keyframeInterval"].AsInt64());
+    }
+    bool enable = args["enable"].AsBool();
+    VirtualScreenImpl::GetInstance().SetFrameDelta(enable, interval);
+    SetCommandResult("result", JsonReader::CreateBool(true));
+    ILOG("Set FrameDelta enable: %d keyframeInterval: %u", enable, interval);
+}
+
+void FrameDeltaCommand::RunGet()
+{
+    Json2::Value resultContent = JsonReader::CreateObject();
+    resultContent.Add("enable", VirtualScreenImpl::GetInstance().IsFrameDeltaEnabled());
+    resultContent.Add("keyframeInterval", VirtualScreenImpl::GetInstance().GetKeyframeInterval());
+    SetCommandResult("result", resultContent);
+    ILOG("Get FrameDelta run finished.");
+}
+
+ProgressiveQualityCommand::ProgressiveQualityCommand(CommandType commandType, const Json2::Value& arg,
+    const LocalSocket& socket) : CommandLine(commandType, arg, socket)
+{
+}
+
+bool ProgressiveQualityCommand::IsSetArgValid() const
+{
+    if (args.IsNull() || !args.IsMember("enable") || !args["enable"].IsBool()) {
+        ELOG("Invalid ProgressiveQuality of arguments!");
+        return false;
+    }
+    if (!IsOptionalIntValid("motionQuality", AdaptiveQuality::MIN_QUALITY, AdaptiveQuality::MAX_QUALITY) ||
+        !IsOptionalIntValid("refineQuality", AdaptiveQuality::MIN_QUALITY, AdaptiveQuality::MAX_QUALITY) ||
+        !IsOptionalIntValid("idleMs", ProgressiveQuality::MIN_IDLE_MS, ProgressiveQuality::MAX_IDLE_MS)) {
+        return false;
+    }
+    return true;
+}
+
+void ProgressiveQualityCommand::RunSet()
+{
+    ProgressiveQualityConfig config = VirtualScreenImpl::GetInstance().GetProgressiveQuality();
+    config.enabled = args["enable"].AsBool();
+    if (args.IsMember("motionQuality")) {
+        config.motionQuality = static_cast<int32_t>(args["motionQuality"].AsInt64());
+    }
+    if (args.IsMember("refineQuality")) {
+        config.refineQuality = static_cast<int32_t>(args["refineQuality"].AsInt64());
+    }
+    if (args.IsMember("idleMs")) {
+        config.idleMs = static_cast<int32_t>(args["idleMs"].AsInt64());
+    }
+    VirtualScreenImpl::GetInstance().SetProgressiveQuality(config);
+    config = VirtualScreenImpl::GetInstance().GetProgressiveQuality();
+    SetCommandResult("result", JsonReader::CreateBool(true));
+    ILOG("Set ProgressiveQuality enable: %d motionQuality: %d refineQuality: %d idleMs: %d", config.enabled,
+        config.motionQuality, config.refineQuality, config.idleMs);
+}
+
+void ProgressiveQualityCommand::RunGet()
+{
+    ProgressiveQualityConfig config = VirtualScreenImpl::GetInstance().GetProgressiveQuality();
+    Json2::Value resultContent = JsonReader::CreateObject();
+    resultContent.Add("enable", config.enabled);
+    resultContent.Add("motionQuality", config.motionQuality);
+    resultContent.Add("refineQuality", config.refineQuality);
+    resultContent.Add("idleMs", config.idleMs);
+    SetCommandResult("result", resultContent);
+    ILOG("Get ProgressiveQuality run finished.");
+}
+
+FrameRateCommand::FrameRateCommand(CommandType commandType, const Json2::Value& arg,
+    const LocalSocket& socket) : CommandLine(commandType, arg, socket)
+{
+}
+
+bool FrameRateCommand::IsSetArgValid() const
+{
+    if (args.IsNull() || !args.IsMember("fps") || !args["fps"].IsInt64()) {
+        ELOG("Invalid FrameRate of arguments!");
+        return false;
+    }
+    if (args["fps"].AsInt64() < 0 || args["fps"].AsInt64() > FramePacer::MAX_FPS) {
+        ELOG("FrameRate param fps must be in [0, %d]", FramePacer::MAX_FPS);
+        return false;
+    }
+    return true;
+}
+
+void FrameRateCommand::RunSet()
+{
+    int32_t fps = static_cast<int32_t>(args["fps"].AsInt64());
+    VirtualScreenImpl::GetInstance().SetTargetFps(fps);
+    SetCommandResult("result", JsonReader::CreateBool(true));
+    ILOG("Set FrameRate fps: %d", fps);
+}
+
+void FrameRateCommand::RunGet()
+{
+    Json2::Value resultContent = JsonReader::CreateObject();
+    resultContent.Add("fps", VirtualScreenImpl::GetInstance().GetTargetFps());
+    SetCommandResult("result", resultContent);
+    ILOG("Get FrameRate run finished.");
+}
+
+ViewportCommand::ViewportCommand(CommandType commandType, const Json2::Value& arg,
+    const LocalSocket& socket) : CommandLine(commandType, arg, socket)
+{
+}
+
+bool ViewportCommand::IsSetArgValid() const
+{
+    if (args.IsNull()) {
+        ELOG("Invalid Viewport of arguments!");
+        return false;
+    }
+    for (const char* key : { "x", "y", "width", "height" }) {
+        if (!args.IsMember(key) || !args[key].IsInt64()) {
+            ELOG("Viewport param %s must be an integer", key);
+            return false;
+        }
+        if (args[key].AsInt64() < 0 || args[key].AsInt64() > maxViewportSize) {
+            ELOG("Viewport param %s must be in [0, %" PRId64 "]", key, maxViewportSize);
+            return false;
+        }
+    }
+    if (args.IsMember("scale") && (!args["scale"].IsDouble() || args["scale"].AsDouble() < FrameViewport::MIN_SCALE ||
+        args["scale"].AsDouble() > 1.0)) {
+        ELOG("Viewport param scale must be in [%.1f, 1]", FrameViewport::MIN_SCALE);
+        return false;
+    }
+    if (args.IsMember("client") && !args["client"].IsString()) {
+        ELOG("Viewport param client must be a string");
+        return false;
+    }
+    return true;
+}
+
+void ViewportCommand::RunSet()
+{
+    FrameViewport viewport;
+    viewport.x = static_cast<int32_t>(args["x"].AsInt64());
+    viewport.y = static_cast<int32_t>(args["y"].AsInt64());
+    viewport.width = static_cast<int32_t>(args["width"].AsInt64());
+    viewport.height = static_cast<int32_t>(args["height"].AsInt64());
+    if (args.IsMember("scale")) {
+        viewport.scale = args["scale"].AsDouble();
+    }
+    // Without a client name the viewport is every client's, input included. A named client only mirrors the
+    // screen, input positions keep mapping through the viewport of the others. Component frames are sent whole.
+    std::string client = args.IsMember("client") ? args["client"].AsString() : "";
+    if (client.empty()) {
+        VirtualScreenImpl::GetInstance().SetViewport(viewport);
+        viewport = VirtualScreenImpl::GetInstance().GetViewport();
+    }
+    if (!CommandParser::GetInstance().IsComponentMode()) {
+        WebSocketServer::GetInstance().SetViewport(client, viewport);
+    }
+    // The scene may stay still, the client gets the new viewport from the last frame.
+    VirtualScreenImpl::GetInstance().ResendLastFrame();
+    SetCommandResult("result", JsonReader::CreateBool(true));
+    ILOG("Set Viewport x: %d y: %d width: %d height: %d scale: %.2f client: %s", viewport.x, viewport.y,
+        viewport.width, viewport.height, viewport.scale, client.c_str());
+}
+
+void ViewportCommand::RunGet()
+{
+    FrameViewport viewport = VirtualScreenImpl::GetInstance().GetViewport();
+    Json2::Value resultContent = JsonReader::CreateObject();
+    resultContent.Add("x", viewport.x);
+    resultContent.Add("y", viewport.y);
+    resultContent.Add("width", viewport.width);
+    resultContent.Add("height", viewport.height);
+    resultContent.Add("scale", viewport.scale);
+    SetCommandResult("result", resultContent);
+    ILOG("Get Viewport run finished.");
+}
+
+ScreenshotCommand::ScreenshotCommand(CommandType commandType, const Json2::Value& arg,
+    const LocalSocket& socket) : CommandLine(commandType, arg, socket)
+{
+}
+
+bool ScreenshotCommand::IsActionArgValid() const
+{
+    if (args.IsNull() || !args.IsMember("format") || !args["format"].IsString() ||
+        std::find(formats.begin(), formats.end(), args["format"].AsString()) == formats.end()) {
+        ELOG("Screenshot param format must be png, jpeg or rgba");
+        return false;
+    }
+    if (args.IsMember("path")) {
+        std::string path = args["path"].IsString() ? args["path"].AsString() : "";
+        std::string::size_type separator = path.find_last_of("/\\");
+        if (path.empty() || separator == path.size() - 1) {
+            ELOG("Screenshot param path must be a file path");
+            return false;
+        }
+        if (separator != std::string::npos && separator > 0 &&
+            !FileSystem::IsDirectoryExists(path.substr(0, separator))) {
+            ELOG("Screenshot param path is in a directory that does not exist");
+            return false;
+        }
+    }
+    if (args.IsMember("next") && !args["next"].IsBool()) {
+        ELOG("Screenshot param next must be a bool");
+        return false;
+    }
+    const std::vector<std::pair<const char*, int64_t>> ranges = {
+        { "stableFrames", maxStableFrames }, { "timeout", maxTimeoutMs }, { "quality", maxQuality }
+    };
+    for (const auto& range : ranges) {
+        if (!IsOptionalIntValid(range.first, 1, range.second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ScreenshotCommand::RunAction()
+{
+    std::string format = args["format"].AsString();
+    bool isNext = args.IsMember("next") && args["next"].AsBool();
+    uint32_t stableFrames = args.IsMember("stableFrames") ? static_cast<uint32_t>(args["stableFrames"].AsInt64()) : 1;
+    int64_t timeout = args.IsMember("timeout") ? args["timeout"].AsInt64() : defaultTimeoutMs;
+    CapturedFrame frame;
+    if (!VirtualScreenImpl::GetInstance().CaptureFrame(isNext, stableFrames, std::chrono::milliseconds(timeout),
+        frame)) {
+        ELOG("Screenshot no frame settled in %" PRId64 " ms", timeout);
+        SetCommandResult("result", JsonReader::CreateBool(false));
+        return;
+    }
+    std::vector<uint8_t> image;
+    if (!EncodeFrame(format, frame.pixels, frame.width, frame.height, image)) {
+        ELOG("Screenshot encode %s failed", format.c_str());
+        SetCommandResult("result", JsonReader::CreateBool(false));
+        return;
+    }
+    Json2::Value resultContent = JsonReader::CreateObject();
+    resultContent.Add("format", format.c_str());
+    resultContent.Add("width", frame.width);
+    resultContent.Add("height", frame.height);
+    resultContent.Add("size", static_cast<int64_t>(image.size()));
+    if (args.IsMember("path")) {
+        std::string path = args["path"].AsString();
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(image.data()), image.size())) {
+            ELOG("Screenshot write %s failed", path.c_str());
+            SetCommandResult("result", JsonReader::CreateBool(false));
+            return;
+        }
+        resultContent.Add("path", path.c_str());
+    } else {
+        resultContent.Add("data", PublicMethods::Base64Encode(image.data(), image.size()).c_str());
+    }
+    SetCommandResult("result", resultContent);
+    ILOG("Screenshot %s %dx%d, %zu bytes", format.c_str(), frame.width, frame.height, image.size());
+}
+
+bool ScreenshotCommand::EncodeFrame(const std::string& format, std::vector<uint8_t>& frame, int32_t width,
+                                    int32_t height, std::vector<uint8_t>& image) const
+{
+    size_t stride = static_cast<size_t>(width) * 4; // 4 bytes per pixel
+    if (width <= 0 || height <= 0 || frame.size() < stride * static_cast<size_t>(height)) {
+        return false;
+    }
+    if (format == "rgba") {
+        image.swap(frame);
+        return true;
+    }
+    if (format == "png") {
+        return PngEncoder::EncodeRgbx(frame.data(), stride, width, height, image);
+    }
+    JpegRgbxSource source;
+    source.data = frame.data();
+    source.stride = stride;
+    source.width = width;
+    source.height = height;
+    source.scaledWidth = width;
+    source.scaledHeight = height;
+    JpegImageInfo info;
+    info.width = width;
+    info.height = height;
+    info.quality = args.IsMember("quality") ? static_cast<int32_t>(args["quality"].AsInt64()) :
+        static_cast<int32_t>(VirtualScreen::JpgQualityLevel::HIGHLEVEL);
+    // A jpeg of a 4 bytes per pixel frame stays well below the frame size even at quality 100.
+    image.resize(frame.size());
+    JpegEncoder encoder;
+    image.resize(encoder.EncodeRgbx(source, info, image.data(), image.size()));
+    return !image.empty();
+}
+
+TileCacheCommand::TileCacheCommand(CommandType commandType, const Json2::Value& arg,
+    const LocalSocket& socket) : CommandLine(commandType, arg, socket)
+{
+}
+
+bool TileCacheCommand::IsSetArgValid() const
+{
+    if (args.IsNull() || !args.IsMember("enable") || !args["enable"].IsBool()) {
+        ELOG("Invalid TileCache of arguments!");
+        return false;
+    }
+    if (!args.IsMember("capacity")) {
+        return true;
+    }
+    if (!args["capacity"].IsInt64() || args["capacity"].AsInt64() < TileCache::MIN_CAPACITY ||
+        args["capacity"].AsInt64() > TileCache::MAX_CAPACITY) {
+        ELOG("TileCache param capacity must be in [%u, %u]", TileCache::MIN_CAPACITY, TileCache::MAX_CAPACITY);
+        return false;
+    }
+    return true;
+}
+
+void TileCacheCommand::RunSet()
+{
+    uint32_t capacity = VirtualScreenImpl::GetInstance().GetTileCacheCapacity();
+    if (args.IsMember("capacity")) {
+        capacity = static_cast<uint32_t>(args["capacity"].AsInt64());
+    }
+    bool enable = args["enable"].AsBool();
+    VirtualScreenImpl::GetInstance().SetTileCache(enable, capacity);
+    SetCommandResult("result", JsonReader::CreateBool(true));
+    ILOG("Set TileCache enable: %d capacity: %u", enable, capacity);
+}
+
+void TileCacheCommand::RunGet()
+{
+    Json2::Value resultContent = JsonReader::CreateObject();
+    resultContent.Add("enable", VirtualScreenImpl::GetInstance().IsTileCacheEnabled());
+    resultContent.Add("capacity", VirtualScreenImpl::GetInstance().GetTileCacheCapacity());
+    resultContent.Add("tileSize", TileCache::TILE_SIZE);
+    SetCommandResult("result", resultContent);
+    ILOG("Get TileCache run finished.");
+}
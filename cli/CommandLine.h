@@ -16,6 +16,7 @@
 #ifndef COMMANDLINE_H
 #define COMMANDLINE_H
 
+#include <functional>
 #include <set>
 #include <vector>
 #include "JsonReader.h"
@@ -78,6 +79,11 @@ protected:
     }
     virtual void RunGet() {}
     virtual void RunAction() {}
+    // True when args has no key, or an integer key in [minValue, maxValue].
+    bool IsOptionalIntValid(const std::string& key, int64_t minValue, int64_t maxValue) const;
+    // Runs change and shows at once the frame last seen in the configuration it switches to, the runtime renders
+    // the real one meanwhile.
+    void SwitchConfiguration(const std::function<void()>& change) const;
 
 private:
     void Run();
@@ -518,4 +524,103 @@ public:
 protected:
     void RunGet() override;
 };
+
+class AdaptiveQualityCommand : public CommandLine {
+public:
+    AdaptiveQualityCommand(CommandType commandType, const Json2::Value& arg, const LocalSocket& socket);
+    ~AdaptiveQualityCommand() override {}
+
+protected:
+    void RunGet() override;
+    void RunSet() override;
+    bool IsSetArgValid() const override;
+};
+
+class FrameCodecCommand : public CommandLine {
+public:
+    FrameCodecCommand(CommandType commandType, const Json2::Value& arg, const LocalSocket& socket);
+    ~FrameCodecCommand() override {}
+
+protected:
+    void RunGet() override;
+    void RunSet() override;
+    bool IsSetArgValid() const override;
+};
+
+class FrameDeltaCommand : public CommandLine {
+public:
+    FrameDeltaCommand(CommandType commandType, const Json2::Value& arg, const LocalSocket& socket);
+    ~FrameDeltaCommand() override {}
+
+protected:
+    void RunGet() override;
+    void RunSet() override;
+    bool IsSetArgValid() const override;
+};
+
+class ProgressiveQualityCommand : public CommandLine {
+public:
+    ProgressiveQualityCommand(CommandType commandType, const Json2::Value& arg, const LocalSocket& socket);
+    ~ProgressiveQualityCommand() override {}
+
+protected:
+    void RunGet() override;
+    void RunSet() override;
+    bool IsSetArgValid() const override;
+};
+
+class FrameRateCommand : public CommandLine {
+public:
+    FrameRateCommand(CommandType commandType, const Json2::Value& arg, const LocalSocket& socket);
+    ~FrameRateCommand() override {}
+
+protected:
+    void RunGet() override;
+    void RunSet() override;
+    bool IsSetArgValid() const override;
+};
+
+class ViewportCommand : public CommandLine {
+public:
+    ViewportCommand(CommandType commandType, const Json2::Value& arg, const LocalSocket& socket);
+    ~ViewportCommand() override {}
+
+protected:
+    void RunGet() override;
+    void RunSet() override;
+    bool IsSetArgValid() const override;
+
+private:
+    const int64_t maxViewportSize = 3840; // the largest resolution -or takes
+};
+
+class ScreenshotCommand : public CommandLine {
+public:
+    ScreenshotCommand(CommandType commandType, const Json2::Value& arg, const LocalSocket& socket);
+    ~ScreenshotCommand() override {}
+
+protected:
+    void RunAction() override;
+    bool IsActionArgValid() const override;
+
+private:
+    bool EncodeFrame(const std::string& format, std::vector<uint8_t>& frame, int32_t width, int32_t height,
+                     std::vector<uint8_t>& image) const;
+    const std::vector<std::string> formats = { "png", "jpeg", "rgba" };
+    const int64_t maxStableFrames = 60;
+    const int64_t defaultTimeoutMs = 5000;
+    const int64_t maxTimeoutMs = 10000; // CaptureFrame ends the wait earlier, the command thread is blocked
+    const int64_t maxQuality = 100;
+};
+
+class TileCacheCommand : public CommandLine {
+public:
+    TileCacheCommand(CommandType commandType, const Json2::Value& arg, const LocalSocket& socket);
+    ~TileCacheCommand() override {}
+
+protected:
+    void RunGet() override;
+    void RunSet() override;
+    bool IsSetArgValid() const override;
+};
 #endif // COMMANDLINE_H
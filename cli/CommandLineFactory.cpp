@@ -48,6 +48,12 @@ void CommandLineFactory::InitCommandMap()
         typeMap["FoldStatus"] = &CommandLineFactory::CreateObject<FoldStatusCommand>;
         typeMap["AvoidArea"] = &CommandLineFactory::CreateObject<AvoidAreaCommand>;
         typeMap["AvoidAreaChanged"] = &CommandLineFactory::CreateObject<AvoidAreaChangedCommand>;
+        typeMap["FrameCodec"] = &CommandLineFactory::CreateObject<FrameCodecCommand>;
+        typeMap["FrameDelta"] = &CommandLineFactory::CreateObject<FrameDeltaCommand>;
+        typeMap["ProgressiveQuality"] = &CommandLineFactory::CreateObject<ProgressiveQualityCommand>;
+        typeMap["Viewport"] = &CommandLineFactory::CreateObject<ViewportCommand>;
+        typeMap["Screenshot"] = &CommandLineFactory::CreateObject<ScreenshotCommand>;
+        typeMap["TileCache"] = &CommandLineFactory::CreateObject<TileCacheCommand>;
     } else {
         typeMap["Power"] = &CommandLineFactory::CreateObject<PowerCommand>;
         typeMap["Volume"] = &CommandLineFactory::CreateObject<VolumeCommand>;
@@ -72,6 +78,8 @@ void CommandLineFactory::InitCommandMap()
     typeMap["Resolution"] = &CommandLineFactory::CreateObject<ResolutionCommand>;
     typeMap["DeviceType"] = &CommandLineFactory::CreateObject<DeviceTypeCommand>;
     typeMap["PointEvent"] = &CommandLineFactory::CreateObject<PointEventCommand>;
+    typeMap["AdaptiveQuality"] = &CommandLineFactory::CreateObject<AdaptiveQualityCommand>;
+    typeMap["FrameRate"] = &CommandLineFactory::CreateObject<FrameRateCommand>;
 }
 
 std::unique_ptr<CommandLine> CommandLineFactory::CreateCommandLine(std::string command,
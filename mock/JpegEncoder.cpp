@@ -0,0 +1,516 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JpegEncoder.h"
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <new>
+#include "FrameScaler.h"
+#include "PreviewerEngineLog.h"
+#include "YuvConvert.h"
+
+#define boolean jpegboolean
+#include "jpeglib.h"
+#undef boolean
+
+struct JpegEncoderContext {
+    jpeg_compress_struct cinfo;
+    jpeg_error_mgr errorManager;
+    jpeg_destination_mgr destination;
+    jmp_buf jump;
+    bool isOverflow;
+};
+
+namespace {
+    const int32_t MAX_ROWS_PER_WRITE = 16; // one MCU row for 4:2:0 sampling
+    const int32_t MCU_SIZE = 16; // jpeg_set_defaults samples chroma 2x2, one MCU covers 16x16 pixels
+    const int32_t CHROMA_ROWS = MCU_SIZE / 2; // chroma rows of one MCU row
+    const int32_t FULL_CHROMA_MCU_SIZE = 8; // without subsampling one MCU is a single 8x8 block
+    const int32_t RAW_COMPONENTS = 3;
+    const size_t RGBX_PIXEL_SIZE = 4;
+    const uint32_t MAX_RESTART_INTERVAL = 0xFFFF;
+    const uint32_t RST_MARKER_COUNT = 8;
+    const uint8_t MARKER_PREFIX = 0xFF;
+    const uint8_t MARKER_SOF0 = 0xC0;
+    const uint8_t MARKER_RST0 = 0xD0;
+    const uint8_t MARKER_EOI = 0xD9;
+    const uint8_t MARKER_SOS = 0xDA;
+    const uint8_t MARKER_DRI = 0xDD;
+    const size_t MARKER_SIZE = 2;
+    const size_t MARKER_LENGTH_SIZE = 2;
+    const size_t DRI_SIZE = 6;
+    const size_t SOF_HEIGHT_OFFSET = 5; // FF C0, length(2), precision(1), then the image height
+    const size_t STRIP_HEADER_RESERVE = 1024; // room for the tables in front of the entropy data
+    const uint32_t BITS_PER_BYTE = 8;
+    const uint32_t BYTE_MASK = 0xFF;
+
+    struct JpegLayout {
+        size_t sofPos = 0;
+        size_t sosPos = 0;
+        size_t dataPos = 0; // first byte of entropy coded data
+    };
+
+    bool ParseJpegLayout(const uint8_t* jpeg, size_t size, JpegLayout& layout)
+    {
+        bool hasSof = false;
+        size_t pos = MARKER_SIZE; // SOI
+        while (pos + MARKER_SIZE + MARKER_LENGTH_SIZE <= size) {
+            if (jpeg[pos] != MARKER_PREFIX) {
+                return false;
+            }
+            uint8_t marker = jpeg[pos + 1];
+            size_t length = (static_cast<size_t>(jpeg[pos + MARKER_SIZE]) << BITS_PER_BYTE) |
+                jpeg[pos + MARKER_SIZE + 1];
+            if (marker == MARKER_SOF0) {
+                layout.sofPos = pos;
+                hasSof = true;
+            } else if (marker == MARKER_SOS) {
+                layout.sosPos = pos;
+                layout.dataPos = pos + MARKER_SIZE + length;
+                return hasSof && layout.dataPos + MARKER_SIZE <= size && jpeg[size - MARKER_SIZE] == MARKER_PREFIX &&
+                    jpeg[size - 1] == MARKER_EOI;
+            }
+            pos += MARKER_SIZE + length;
+        }
+        return false;
+    }
+
+    void WriteMarker(uint8_t*& pos, uint8_t marker)
+    {
+        *pos++ = MARKER_PREFIX;
+        *pos++ = marker;
+    }
+
+    void WriteUint16(uint8_t*& pos, uint32_t value)
+    {
+        *pos++ = static_cast<uint8_t>((value >> BITS_PER_BYTE) & BYTE_MASK);
+        *pos++ = static_cast<uint8_t>(value & BYTE_MASK);
+    }
+
+    // libjpeg exits the process on errors by default, jump back to Encode instead.
+    void OnJpegError(j_common_ptr cinfo)
+    {
+        JpegEncoderContext* context = static_cast<JpegEncoderContext*>(cinfo->client_data);
+        if (!context->isOverflow) {
+            char message[JMSG_LENGTH_MAX] = {0};
+            (*cinfo->err->format_message)(cinfo, message);
+            ELOG("JpegEncoder encode failed: %s", message);
+        }
+        longjmp(context->jump, 1);
+    }
+
+    void InitDestination([[maybe_unused]] j_compress_ptr cinfo)
+    {
+        // next_output_byte and free_in_buffer are set by Encode before every frame
+    }
+
+    jpegboolean EmptyOutputBuffer(j_compress_ptr cinfo)
+    {
+        // The destination is a fixed transport buffer, running out of space aborts the frame.
+        JpegEncoderContext* context = static_cast<JpegEncoderContext*>(cinfo->client_data);
+        context->isOverflow = true;
+        (*cinfo->err->error_exit)(reinterpret_cast<j_common_ptr>(cinfo));
+        return FALSE;
+    }
+
+    void TermDestination([[maybe_unused]] j_compress_ptr cinfo)
+    {
+    }
+}
+
+JpegEncoder::JpegEncoder() : context(new(std::nothrow) JpegEncoderContext())
+{
+    if (!context) {
+        ELOG("Memory allocation failed: JpegEncoder context.");
+        return;
+    }
+    context->cinfo.err = jpeg_std_error(&context->errorManager);
+    context->errorManager.error_exit = OnJpegError;
+    context->cinfo.client_data = context.get();
+    if (setjmp(context->jump)) {
+        context.reset();
+        return;
+    }
+    jpeg_create_compress(&context->cinfo);
+    context->destination.init_destination = InitDestination;
+    context->destination.empty_output_buffer = EmptyOutputBuffer;
+    context->destination.term_destination = TermDestination;
+    context->cinfo.dest = &context->destination;
+}
+
+JpegEncoder::~JpegEncoder()
+{
+    if (context) {
+        jpeg_destroy_compress(&context->cinfo);
+    }
+}
+
+size_t JpegEncoder::Encode(const uint8_t* data, size_t stride, const JpegImageInfo& info, uint8_t* dst,
+                           size_t capacity)
+{
+    if (!context || data == nullptr || dst == nullptr || capacity == 0 || info.width < 1 || info.height < 1) {
+        return 0;
+    }
+    jpeg_compress_struct& cinfo = context->cinfo;
+    context->isOverflow = false;
+    if (setjmp(context->jump)) {
+        jpeg_abort_compress(&cinfo);
+        isConfigured = false;
+        if (context->isOverflow) {
+            ELOG("JpegEncoder output exceeds the destination size %zu.", capacity);
+        }
+        return 0;
+    }
+    if (!isConfigured || !(info == currentInfo)) {
+        Setup(info);
+    }
+    context->destination.next_output_byte = dst;
+    context->destination.free_in_buffer = capacity;
+    // The tables set up earlier are kept in cinfo and written again into every frame.
+    jpeg_start_compress(&cinfo, TRUE);
+    JSAMPROW rows[MAX_ROWS_PER_WRITE];
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JDIMENSION count = std::min<JDIMENSION>(MAX_ROWS_PER_WRITE, cinfo.image_height - cinfo.next_scanline);
+        for (JDIMENSION i = 0; i < count; ++i) {
+            // libjpeg only reads the input rows, the cast drops the const its row type lacks
+            rows[i] = const_cast<uint8_t*>(data + (cinfo.next_scanline + i) * stride);
+        }
+        jpeg_write_scanlines(&cinfo, rows, count);
+    }
+    jpeg_finish_compress(&cinfo);
+    return capacity - context->destination.free_in_buffer;
+}
+
+size_t JpegEncoder::EncodeRgbx(const JpegRgbxSource& source, const JpegImageInfo& info, uint8_t* dst,
+                               size_t capacity)
+{
+    if (!context || source.data == nullptr || dst == nullptr || capacity == 0 || info.width < 1 || info.height < 1 ||
+        info.width != source.scaledWidth || source.scaledWidth > source.width ||
+        source.scaledHeight > source.height || source.firstRow < 0 ||
+        info.height > source.scaledHeight - source.firstRow) {
+        return 0;
+    }
+    JpegImageInfo rawInfo = info;
+    rawInfo.components = RAW_COMPONENTS;
+    rawInfo.colorSpace = JCS_YCbCr;
+    rawInfo.isRawData = true;
+    rawInfo.isFullChroma = false;
+    // libjpeg reads whole blocks, the planes are as wide as the MCUs and the chroma planes half as wide.
+    lumaStride = static_cast<size_t>((info.width + MCU_SIZE - 1) / MCU_SIZE * MCU_SIZE);
+    chromaStride = lumaStride / 2; // 2: chroma is subsampled horizontally
+    planes.resize(lumaStride * MCU_SIZE + chromaStride * CHROMA_ROWS * 2); // 2: Cb and Cr
+    if (source.width != source.scaledWidth || source.height != source.scaledHeight) {
+        scaledRows.resize(static_cast<size_t>(info.width) * RGBX_PIXEL_SIZE * MCU_SIZE);
+    }
+    uint8_t* luma = planes.data();
+    uint8_t* cb = luma + lumaStride * MCU_SIZE;
+    uint8_t* cr = cb + chromaStride * CHROMA_ROWS;
+
+    jpeg_compress_struct& cinfo = context->cinfo;
+    context->isOverflow = false;
+    if (setjmp(context->jump)) {
+        jpeg_abort_compress(&cinfo);
+        isConfigured = false;
+        if (context->isOverflow) {
+            ELOG("JpegEncoder output exceeds the destination size %zu.", capacity);
+        }
+        return 0;
+    }
+    if (!isConfigured || !(rawInfo == currentInfo)) {
+        Setup(rawInfo);
+    }
+    context->destination.next_output_byte = dst;
+    context->destination.free_in_buffer = capacity;
+    jpeg_start_compress(&cinfo, TRUE);
+    JSAMPROW lumaRows[MCU_SIZE];
+    JSAMPROW cbRows[CHROMA_ROWS];
+    JSAMPROW crRows[CHROMA_ROWS];
+    JSAMPARRAY image[RAW_COMPONENTS] = { lumaRows, cbRows, crRows };
+    while (cinfo.next_scanline < cinfo.image_height) {
+        int32_t row = static_cast<int32_t>(cinfo.next_scanline);
+        int32_t count = std::min(MCU_SIZE, info.height - row);
+        if (!PrepareRawRows(source, row, count, luma, cb, cr)) {
+            ELOG("JpegEncoder rows %d to %d can not be scaled.", row, row + count);
+            jpeg_abort_compress(&cinfo);
+            return 0;
+        }
+        // The rows below the image repeat the last one, libjpeg wants whole MCU rows of raw data.
+        for (int32_t i = 0; i < MCU_SIZE; ++i) {
+            lumaRows[i] = luma + static_cast<size_t>(std::min(i, count - 1)) * lumaStride;
+        }
+        int32_t chromaCount = (count + 1) / 2; // 2: chroma is subsampled vertically
+        for (int32_t i = 0; i < CHROMA_ROWS; ++i) {
+            size_t offset = static_cast<size_t>(std::min(i, chromaCount - 1)) * chromaStride;
+            cbRows[i] = cb + offset;
+            crRows[i] = cr + offset;
+        }
+        jpeg_write_raw_data(&cinfo, image, MCU_SIZE);
+    }
+    jpeg_finish_compress(&cinfo);
+    return capacity - context->destination.free_in_buffer;
+}
+
+bool JpegEncoder::PrepareRawRows(const JpegRgbxSource& source, int32_t row, int32_t rowCount, uint8_t* luma,
+                                 uint8_t* cb, uint8_t* cr)
+{
+    int32_t width = source.scaledWidth;
+    int32_t frameRow = source.firstRow + row;
+    const uint8_t* pixels = source.data + static_cast<size_t>(frameRow) * source.stride;
+    size_t stride = source.stride;
+    if (source.width != source.scaledWidth || source.height != source.scaledHeight) {
+        stride = static_cast<size_t>(width) * RGBX_PIXEL_SIZE;
+        if (!FrameScaler::DownscaleRgbaRows(source.data, source.stride, source.width, source.height,
+            scaledRows.data(), stride, width, source.scaledHeight, frameRow, rowCount)) {
+            return false;
+        }
+        pixels = scaledRows.data();
+    }
+    YuvConvert::RgbxToYuv420(pixels, stride, width, rowCount, source.isBgr, luma, lumaStride, cb, cr, chromaStride);
+    // The blocks past the right edge repeat the last column, as libjpeg pads its own input.
+    for (int32_t y = 0; y < rowCount; ++y) {
+        uint8_t* line = luma + static_cast<size_t>(y) * lumaStride;
+        std::fill(line + width, line + lumaStride, line[width - 1]);
+    }
+    size_t chromaWidth = static_cast<size_t>(width + 1) / 2; // 2: chroma is subsampled horizontally
+    for (int32_t y = 0; y < (rowCount + 1) / 2; ++y) { // 2: chroma is subsampled vertically
+        uint8_t* cbLine = cb + static_cast<size_t>(y) * chromaStride;
+        uint8_t* crLine = cr + static_cast<size_t>(y) * chromaStride;
+        std::fill(cbLine + chromaWidth, cbLine + chromaStride, cbLine[chromaWidth - 1]);
+        std::fill(crLine + chromaWidth, crLine + chromaStride, crLine[chromaWidth - 1]);
+    }
+    return true;
+}
+
+uint32_t JpegEncoder::GetSetupCount() const
+{
+    return setupCount;
+}
+
+void JpegEncoder::Setup(const JpegImageInfo& info)
+{
+    jpeg_compress_struct& cinfo = context->cinfo;
+    cinfo.image_width = static_cast<JDIMENSION>(info.width);
+    cinfo.image_height = static_cast<JDIMENSION>(info.height);
+    cinfo.input_components = info.components;
+    cinfo.in_color_space = static_cast<J_COLOR_SPACE>(info.colorSpace);
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, info.quality, TRUE);
+    // YCbCr input keeps the 2x2 luma sampling of jpeg_set_defaults, the planes of EncodeRgbx are laid out for it.
+    cinfo.raw_data_in = info.isRawData ? TRUE : FALSE;
+    if (info.isFullChroma && !info.isRawData && cinfo.num_components > 1) {
+        cinfo.comp_info[0].h_samp_factor = 1;
+        cinfo.comp_info[0].v_samp_factor = 1;
+    }
+    currentInfo = info;
+    isConfigured = true;
+    setupCount++;
+}
+
+ParallelJpegEncoder::ParallelJpegEncoder(uint32_t threadCount)
+{
+    uint32_t count = std::max<uint32_t>(threadCount, 1);
+    for (uint32_t i = 0; i < count; ++i) {
+        strips.push_back(std::make_unique<Strip>());
+    }
+    // Strip 0 is encoded by the calling thread.
+    for (uint32_t i = 1; i < count; ++i) {
+        workers.emplace_back(&ParallelJpegEncoder::WorkerLoop, this, i);
+    }
+}
+
+ParallelJpegEncoder::~ParallelJpegEncoder()
+{
+    {
+        std::lock_guard<std::mutex> guard(frameMutex);
+        isStopping = true;
+    }
+    startCondition.notify_all();
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+size_t ParallelJpegEncoder::Encode(const uint8_t* data, size_t stride, const JpegImageInfo& info, uint8_t* dst,
+                                   size_t capacity)
+{
+    if (data == nullptr || dst == nullptr || capacity == 0 || info.width < 1 || info.height < 1) {
+        return 0;
+    }
+    uint32_t count = 0;
+    int32_t height = 0;
+    uint32_t restartInterval = 0;
+    if (!SplitFrame(info, count, height, restartInterval)) {
+        return strips[0]->encoder.Encode(data, stride, info, dst, capacity);
+    }
+    {
+        std::lock_guard<std::mutex> guard(frameMutex);
+        frameData = data;
+        frameStride = stride;
+        isRgbxFrame = false;
+        frameInfo = info;
+        stripCount = count;
+        stripHeight = height;
+    }
+    return EncodeStrips(restartInterval, dst, capacity);
+}
+
+size_t ParallelJpegEncoder::EncodeRgbx(const JpegRgbxSource& source, const JpegImageInfo& info, uint8_t* dst,
+                                       size_t capacity)
+{
+    if (source.data == nullptr || dst == nullptr || capacity == 0 || info.width < 1 || info.height < 1) {
+        return 0;
+    }
+    JpegImageInfo rawInfo = info;
+    rawInfo.isFullChroma = false; // the raw planes are always 4:2:0
+    uint32_t count = 0;
+    int32_t height = 0;
+    uint32_t restartInterval = 0;
+    if (!SplitFrame(rawInfo, count, height, restartInterval)) {
+        return strips[0]->encoder.EncodeRgbx(source, rawInfo, dst, capacity);
+    }
+    {
+        std::lock_guard<std::mutex> guard(frameMutex);
+        frameSource = source;
+        isRgbxFrame = true;
+        frameInfo = rawInfo;
+        frameInfo.components = RAW_COMPONENTS;
+        stripCount = count;
+        stripHeight = height;
+    }
+    return EncodeStrips(restartInterval, dst, capacity);
+}
+
+bool ParallelJpegEncoder::SplitFrame(const JpegImageInfo& info, uint32_t& count, int32_t& height,
+                                     uint32_t& restartInterval) const
+{
+    int32_t mcuSize = info.isFullChroma ? FULL_CHROMA_MCU_SIZE : MCU_SIZE;
+    uint32_t mcuRows = static_cast<uint32_t>((info.height + mcuSize - 1) / mcuSize);
+    uint32_t mcusPerRow = static_cast<uint32_t>((info.width + mcuSize - 1) / mcuSize);
+    count = std::min<uint32_t>(static_cast<uint32_t>(strips.size()), mcuRows);
+    uint32_t stripMcuRows = (mcuRows + count - 1) / count;
+    count = (mcuRows + stripMcuRows - 1) / stripMcuRows;
+    restartInterval = mcusPerRow * stripMcuRows;
+    height = static_cast<int32_t>(stripMcuRows) * mcuSize;
+    return count >= 2 && restartInterval <= MAX_RESTART_INTERVAL; // 2: one strip is encoded directly
+}
+
+size_t ParallelJpegEncoder::EncodeStrips(uint32_t restartInterval, uint8_t* dst, size_t capacity)
+{
+    {
+        std::lock_guard<std::mutex> guard(frameMutex);
+        pendingStrips = stripCount - 1;
+        frameGeneration++;
+    }
+    startCondition.notify_all();
+    EncodeStrip(0);
+    {
+        std::unique_lock<std::mutex> lock(frameMutex);
+        doneCondition.wait(lock, [this] { return pendingStrips == 0; });
+    }
+    return JoinStrips(restartInterval, dst, capacity);
+}
+
+uint32_t ParallelJpegEncoder::GetThreadCount() const
+{
+    return static_cast<uint32_t>(strips.size());
+}
+
+void ParallelJpegEncoder::WorkerLoop(uint32_t index)
+{
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(frameMutex);
+            startCondition.wait(lock, [this, seenGeneration] {
+                return isStopping || frameGeneration != seenGeneration;
+            });
+            if (isStopping) {
+                return;
+            }
+            seenGeneration = frameGeneration;
+            if (index >= stripCount) {
+                continue;
+            }
+        }
+        EncodeStrip(index);
+        {
+            std::lock_guard<std::mutex> guard(frameMutex);
+            pendingStrips--;
+        }
+        doneCondition.notify_one();
+    }
+}
+
+void ParallelJpegEncoder::EncodeStrip(uint32_t index)
+{
+    Strip& strip = *strips[index];
+    int32_t rowStart = static_cast<int32_t>(index) * stripHeight;
+    JpegImageInfo info = frameInfo;
+    info.height = std::min(stripHeight, frameInfo.height - rowStart);
+    size_t maxSize = static_cast<size_t>(info.width) * info.height * info.components + STRIP_HEADER_RESERVE;
+    if (strip.output.size() < maxSize) {
+        strip.output.resize(maxSize);
+    }
+    if (isRgbxFrame) {
+        JpegRgbxSource source = frameSource;
+        source.firstRow += rowStart;
+        strip.size = strip.encoder.EncodeRgbx(source, info, strip.output.data(), strip.output.size());
+        return;
+    }
+    strip.size = strip.encoder.Encode(frameData + rowStart * frameStride, frameStride, info, strip.output.data(),
+        strip.output.size());
+}
+
+size_t ParallelJpegEncoder::JoinStrips(uint32_t restartInterval, uint8_t* dst, size_t capacity) const
+{
+    std::vector<JpegLayout> layouts(stripCount);
+    size_t total = DRI_SIZE + MARKER_SIZE; // DRI segment and EOI
+    for (uint32_t i = 0; i < stripCount; ++i) {
+        const Strip& strip = *strips[i];
+        if (strip.size == 0 || !ParseJpegLayout(strip.output.data(), strip.size, layouts[i])) {
+            ELOG("ParallelJpegEncoder strip %u encode failed.", i);
+            return 0;
+        }
+        total += strip.size - layouts[i].dataPos - MARKER_SIZE + (i == 0 ? layouts[i].dataPos : MARKER_SIZE);
+    }
+    if (total > capacity) {
+        ELOG("ParallelJpegEncoder output exceeds the destination size %zu.", capacity);
+        return 0;
+    }
+    // Headers of strip 0 with the full image height and a DRI segment in front of SOS.
+    const uint8_t* header = strips[0]->output.data();
+    const JpegLayout& first = layouts[0];
+    uint8_t* pos = std::copy(header, header + first.sosPos, dst);
+    uint8_t* height = dst + first.sofPos + SOF_HEIGHT_OFFSET;
+    WriteUint16(height, static_cast<uint32_t>(frameInfo.height));
+    WriteMarker(pos, MARKER_DRI);
+    WriteUint16(pos, static_cast<uint32_t>(DRI_SIZE - MARKER_SIZE));
+    WriteUint16(pos, restartInterval);
+    pos = std::copy(header + first.sosPos, header + first.dataPos, pos);
+    // Each strip ends byte aligned with fresh DC predictors, which is what a restart interval expects.
+    for (uint32_t i = 0; i < stripCount; ++i) {
+        if (i > 0) {
+            WriteMarker(pos, static_cast<uint8_t>(MARKER_RST0 + (i - 1) % RST_MARKER_COUNT));
+        }
+        const uint8_t* output = strips[i]->output.data();
+        pos = std::copy(output + layouts[i].dataPos, output + strips[i]->size - MARKER_SIZE, pos);
+    }
+    WriteMarker(pos, MARKER_EOI);
+    return static_cast<size_t>(pos - dst);
+}
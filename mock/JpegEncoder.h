@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JPEGENCODER_H
+#define JPEGENCODER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct JpegEncoderContext;
+
+struct JpegImageInfo {
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t components = 0;
+    int32_t colorSpace = 0; // J_COLOR_SPACE of the input rows
+    int32_t quality = 0;
+    bool isRawData = false; // 4:2:0 YCbCr planes built by EncodeRgbx instead of rows in colorSpace
+    bool isFullChroma = false; // 4:4:4 sampling for rows in colorSpace, sharper colored edges for a larger jpeg
+
+    bool operator==(const JpegImageInfo& other) const
+    {
+        return width == other.width && height == other.height && components == other.components &&
+            colorSpace == other.colorSpace && quality == other.quality && isRawData == other.isRawData &&
+            isFullChroma == other.isFullChroma;
+    }
+};
+
+// A 4 bytes per pixel frame for EncodeRgbx. It is scaled down to scaledWidth x scaledHeight while it is encoded,
+// a JpegImageInfo of that width holds the rows [firstRow, firstRow + info.height) of the scaled frame.
+struct JpegRgbxSource {
+    const uint8_t* data = nullptr;
+    size_t stride = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t scaledWidth = 0;
+    int32_t scaledHeight = 0;
+    int32_t firstRow = 0;
+    bool isBgr = false;
+};
+
+// Long-lived libjpeg compressor. The quantization and huffman tables are built once and only rebuilt when the
+// image info changes, the compressed bytes go straight into a caller supplied buffer.
+class JpegEncoder {
+public:
+    JpegEncoder();
+    ~JpegEncoder();
+    JpegEncoder(const JpegEncoder&) = delete;
+    JpegEncoder& operator=(const JpegEncoder&) = delete;
+
+    // Returns the number of bytes written to dst, 0 when encoding failed or capacity is too small.
+    size_t Encode(const uint8_t* data, size_t stride, const JpegImageInfo& info, uint8_t* dst, size_t capacity);
+    // Same contract, one MCU row at a time the source is scaled, converted by YuvConvert and handed to libjpeg as
+    // raw data, so the frame is read once and libjpeg skips its own color conversion and downsampling.
+    size_t EncodeRgbx(const JpegRgbxSource& source, const JpegImageInfo& info, uint8_t* dst, size_t capacity);
+    uint32_t GetSetupCount() const;
+
+private:
+    void Setup(const JpegImageInfo& info);
+    bool PrepareRawRows(const JpegRgbxSource& source, int32_t row, int32_t rowCount, uint8_t* luma, uint8_t* cb,
+                        uint8_t* cr);
+    std::unique_ptr<JpegEncoderContext> context;
+    JpegImageInfo currentInfo;
+    bool isConfigured = false;
+    uint32_t setupCount = 0;
+    // Scratch of one MCU row for EncodeRgbx, small enough to stay in cache between the passes.
+    std::vector<uint8_t> scaledRows;
+    std::vector<uint8_t> planes;
+    size_t lumaStride = 0;
+    size_t chromaStride = 0;
+};
+
+// Splits a frame into horizontal strips of whole MCU rows, encodes them concurrently and joins them into one
+// baseline jpeg. Every strip starts a restart interval, so the joined scan is an ordinary restart-marked jpeg.
+class ParallelJpegEncoder {
+public:
+    explicit ParallelJpegEncoder(uint32_t threadCount);
+    ~ParallelJpegEncoder();
+    ParallelJpegEncoder(const ParallelJpegEncoder&) = delete;
+    ParallelJpegEncoder& operator=(const ParallelJpegEncoder&) = delete;
+
+    // Same contract as JpegEncoder::Encode and JpegEncoder::EncodeRgbx.
+    size_t Encode(const uint8_t* data, size_t stride, const JpegImageInfo& info, uint8_t* dst, size_t capacity);
+    size_t EncodeRgbx(const JpegRgbxSource& source, const JpegImageInfo& info, uint8_t* dst, size_t capacity);
+    uint32_t GetThreadCount() const;
+
+private:
+    struct Strip {
+        JpegEncoder encoder;
+        std::vector<uint8_t> output;
+        size_t size = 0;
+    };
+    bool SplitFrame(const JpegImageInfo& info, uint32_t& count, int32_t& height, uint32_t& restartInterval) const;
+    size_t EncodeStrips(uint32_t restartInterval, uint8_t* dst, size_t capacity);
+    void WorkerLoop(uint32_t index);
+    void EncodeStrip(uint32_t index);
+    size_t JoinStrips(uint32_t restartInterval, uint8_t* dst, size_t capacity) const;
+
+    std::vector<std::unique_ptr<Strip>> strips;
+    std::vector<std::thread> workers;
+    std::mutex frameMutex;
+    std::condition_variable startCondition;
+    std::condition_variable doneCondition;
+    uint64_t frameGeneration = 0;
+    uint32_t pendingStrips = 0;
+    bool isStopping = false;
+    // The frame being encoded, written by Encode before the workers are woken up.
+    const uint8_t* frameData = nullptr;
+    size_t frameStride = 0;
+    JpegRgbxSource frameSource; // used instead of frameData for EncodeRgbx
+    bool isRgbxFrame = false;
+    JpegImageInfo frameInfo;
+    uint32_t stripCount = 0;
+    int32_t stripHeight = 0;
+};
+
+#endif // JPEGENCODER_H
@@ -14,8 +14,12 @@
  */
 
 #include "VirtualScreen.h"
+
+#include <algorithm>
+#include <thread>
 #include "CommandParser.h"
 #include "CppTimerManager.h"
+#include "FrameBufferPool.h"
 #include "PreviewerEngineLog.h"
 #include "VirtualScreen.h"
 
@@ -26,6 +30,8 @@
 uint32_t VirtualScreen::validFrameCountPerMinute = 0;
 uint32_t VirtualScreen::invalidFrameCountPerMinute = 0;
 uint32_t VirtualScreen::sendFrameCountPerMinute = 0;
+uint32_t VirtualScreen::skipFrameCountPerMinute = 0;
+uint32_t VirtualScreen::coalescedFrameCountPerMinute = 0;
 uint32_t VirtualScreen::inputKeyCountPerMinute = 0;
 uint32_t VirtualScreen::inputMethodCountPerMinute = 0;
 bool VirtualScreen::isWebSocketListening = false;
@@ -46,7 +52,6 @@ VirtualScreen::VirtualScreen()
       frameCountTimer(nullptr),
       isWebSocketConfiged(false),
       currentRouter(""),
-      jpgScreenBuffer(nullptr),
       jpgBufferSize(0)
 {
 }
@@ -180,16 +185,25 @@ void VirtualScreen::InitFrameCountTimer()
 void VirtualScreen::PrintFrameCount()
 {
     if ((validFrameCountPerMinute | invalidFrameCountPerMinute | sendFrameCountPerMinute |
-        inputKeyCountPerMinute | inputMethodCountPerMinute) == 0) {
+        skipFrameCountPerMinute | coalescedFrameCountPerMinute | inputKeyCountPerMinute |
+        inputMethodCountPerMinute) == 0) {
         return;
     }
 
-    ELOG("ValidFrameCount: %d InvalidFrameCount: %d SendFrameCount: %d inputKeyCount: %d\
-         inputMethodCount: %d", validFrameCountPerMinute, invalidFrameCountPerMinute,
-         sendFrameCountPerMinute, inputKeyCountPerMinute, inputMethodCountPerMinute);
+    ELOG("ValidFrameCount: %d InvalidFrameCount: %d SendFrameCount: %d SkipFrameCount: %d CoalescedFrameCount: %d\
+         inputKeyCount: %d inputMethodCount: %d", validFrameCountPerMinute, invalidFrameCountPerMinute,
+         sendFrameCountPerMinute, skipFrameCountPerMinute, coalescedFrameCountPerMinute, inputKeyCountPerMinute,
+         inputMethodCountPerMinute);
+    FrameBufferPool& pool = FrameBufferPool::GetInstance();
+    ILOG("FrameBufferAllocCount: %llu FrameBufferPoolBytes: %zu FrameBufferPeakPoolBytes: %zu "
+         "FrameBufferFreeBytes: %zu/%zu FrameBufferEvictCount: %llu",
+         static_cast<unsigned long long>(pool.GetAllocationCount()), pool.GetPoolBytes(), pool.GetPeakPoolBytes(),
+         pool.GetFreeBytes(), pool.GetMaxFreeBytes(), static_cast<unsigned long long>(pool.GetEvictionCount()));
     validFrameCountPerMinute = 0;
     invalidFrameCountPerMinute = 0;
     sendFrameCountPerMinute = 0;
+    skipFrameCountPerMinute = 0;
+    coalescedFrameCountPerMinute = 0;
     inputKeyCountPerMinute = 0;
     inputMethodCountPerMinute = 0;
 }
@@ -290,8 +304,10 @@ bool VirtualScreen::StopSendStaticCardImage(const int duration)
     return false;
 }
 
-void VirtualScreen::RgbToJpg(unsigned char* data, const int32_t width, const int32_t height)
+void VirtualScreen::RgbToJpg(const unsigned char* data, const int32_t width, const int32_t height,
+                             uint8_t* dst, const size_t capacity)
 {
+    jpgBufferSize = 0;
     if (data == nullptr) {
         ELOG("VirtualScreen::RgbToJpg data is null.");
         return;
@@ -300,26 +316,272 @@ void VirtualScreen::RgbToJpg(unsigned char* data, const int32_t width, const int
         FLOG("VirtualScreenImpl::RgbToJpg the width or height is invalid value");
         return;
     }
-    jpeg_compress_struct jpeg = {0};
-    jpeg_error_mgr jerr;
-    jpeg.err = jpeg_std_error(&jerr);
-    jpeg_create_compress(&jpeg);
-    jpeg_mem_dest(&jpeg, &jpgScreenBuffer, &jpgBufferSize);
-    jpeg.image_width = width;
-    jpeg.image_height = height;
-    jpeg.input_components = jpgPix;
-    jpeg.in_color_space = JCS_RGB;
-    jpeg_set_defaults(&jpeg);
-    jpeg_set_quality(&jpeg, GetJpgQualityValue(width, height), TRUE);
-    jpeg_start_compress(&jpeg, TRUE);
-    JSAMPROW rowPointer[1];
-    int rowStride = width * jpgPix;
-    while (jpeg.next_scanline < jpeg.image_height) {
-        rowPointer[0] = &data[jpeg.next_scanline * rowStride];
-        jpeg_write_scanlines(&jpeg, rowPointer, 1);
+    CompressJpg(data, static_cast<size_t>(width) * jpgPix, width, height, jpgPix, JCS_RGB,
+                GetAdaptiveJpgQuality(width, height), dst, capacity);
+}
+
+bool VirtualScreen::IsRgbxJpgSupported()
+{
+#ifdef JCS_EXTENSIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void VirtualScreen::RgbxRegionToJpg(const unsigned char* data, const size_t stride, const int32_t width,
+                                    const int32_t height, const int32_t quality, uint8_t* dst, const size_t capacity,
+                                    const bool isFullChroma)
+{
+    jpgBufferSize = 0;
+    if (data == nullptr) {
+        ELOG("VirtualScreen::RgbxRegionToJpg data is null.");
+        return;
+    }
+    if (width < 1 || height < 1) {
+        FLOG("VirtualScreenImpl::RgbxRegionToJpg the width or height is invalid value");
+        return;
+    }
+#ifdef JCS_EXTENSIONS
+    CompressJpg(data, stride, width, height, pixelSize, JCS_EXT_RGBX, quality, dst, capacity, isFullChroma);
+#else
+    ELOG("VirtualScreen::RgbxRegionToJpg the linked libjpeg does not support extended color spaces.");
+#endif
+}
+
+void VirtualScreen::CompressJpg(const unsigned char* data, const size_t stride, const int32_t width,
+                                const int32_t height, const int32_t components, const int32_t colorSpace,
+                                const int32_t quality, uint8_t* dst, const size_t capacity, const bool isFullChroma)
+{
+    JpegImageInfo info;
+    info.width = width;
+    info.height = height;
+    info.components = components;
+    info.colorSpace = colorSpace;
+    info.quality = quality;
+    info.isFullChroma = isFullChroma;
+    AdaptiveQuality::Clock::time_point encodeStart = AdaptiveQuality::Clock::now();
+    ParallelJpegEncoder* encoder = GetParallelJpegEncoder(width, height);
+    if (encoder != nullptr) {
+        jpgBufferSize = encoder->Encode(data, stride, info, dst, capacity);
+    } else {
+        jpgBufferSize = jpegEncoder.Encode(data, stride, info, dst, capacity);
+    }
+    frameCost.encodeUs += std::chrono::duration_cast<std::chrono::microseconds>(
+        AdaptiveQuality::Clock::now() - encodeStart).count();
+}
+
+void VirtualScreen::RgbxRegionToRawJpg(const unsigned char* data, const size_t stride, const int32_t width,
+                                       const int32_t height, const int32_t scaledWidth, const int32_t scaledHeight,
+                                       const int32_t quality, uint8_t* dst, const size_t capacity)
+{
+    jpgBufferSize = 0;
+    if (data == nullptr) {
+        ELOG("VirtualScreen::RgbxRegionToRawJpg data is null.");
+        return;
+    }
+    if (scaledWidth < 1 || scaledHeight < 1 || scaledWidth > width || scaledHeight > height) {
+        FLOG("VirtualScreenImpl::RgbxRegionToRawJpg the width or height is invalid value");
+        return;
+    }
+    JpegRgbxSource source;
+    source.data = data;
+    source.stride = stride;
+    source.width = width;
+    source.height = height;
+    source.scaledWidth = scaledWidth;
+    source.scaledHeight = scaledHeight;
+    JpegImageInfo info;
+    info.width = scaledWidth;
+    info.height = scaledHeight;
+    info.quality = quality;
+    AdaptiveQuality::Clock::time_point encodeStart = AdaptiveQuality::Clock::now();
+    ParallelJpegEncoder* encoder = GetParallelJpegEncoder(scaledWidth, scaledHeight);
+    if (encoder != nullptr) {
+        jpgBufferSize = encoder->EncodeRgbx(source, info, dst, capacity);
+    } else {
+        jpgBufferSize = jpegEncoder.EncodeRgbx(source, info, dst, capacity);
+    }
+    frameCost.encodeUs += std::chrono::duration_cast<std::chrono::microseconds>(
+        AdaptiveQuality::Clock::now() - encodeStart).count();
+}
+
+ParallelJpegEncoder* VirtualScreen::GetParallelJpegEncoder(const int32_t width, const int32_t height)
+{
+    if (static_cast<int64_t>(width) * height < parallelJpegMinPixels) {
+        return nullptr;
     }
-    jpeg_finish_compress(&jpeg);
-    jpeg_destroy_compress(&jpeg);
+    if (!parallelJpegEncoder) {
+        uint32_t threadCount = std::min(std::thread::hardware_concurrency(), maxJpegThreads);
+        if (threadCount > 1) {
+            parallelJpegEncoder = std::make_unique<ParallelJpegEncoder>(threadCount);
+            ILOG("VirtualScreen parallel jpeg encoder threads: %u", threadCount);
+        }
+    }
+    return parallelJpegEncoder.get();
+}
+
+void VirtualScreen::SetAdaptiveQuality(const AdaptiveQualityConfig& config)
+{
+    adaptiveQuality.Configure(config);
+}
+
+AdaptiveQualityConfig VirtualScreen::GetAdaptiveQuality() const
+{
+    return adaptiveQuality.GetConfig();
+}
+
+bool VirtualScreen::SetFrameCodec(const std::string& name)
+{
+    return frameCodecSelector.SetCodec(name);
+}
+
+std::string VirtualScreen::GetFrameCodec() const
+{
+    return frameCodecSelector.GetCodecName();
+}
+
+void VirtualScreen::SetFrameDelta(bool enable, uint32_t keyframeInterval)
+{
+    frameDelta.Configure(enable, keyframeInterval);
+}
+
+bool VirtualScreen::IsFrameDeltaEnabled() const
+{
+    return frameDelta.IsEnabled();
+}
+
+uint32_t VirtualScreen::GetKeyframeInterval() const
+{
+    return frameDelta.GetKeyframeInterval();
+}
+
+void VirtualScreen::SetProgressiveQuality(const ProgressiveQualityConfig& config)
+{
+    progressiveQuality.Configure(config);
+}
+
+ProgressiveQualityConfig VirtualScreen::GetProgressiveQuality() const
+{
+    return progressiveQuality.GetConfig();
+}
+
+void VirtualScreen::InitFramePacer()
+{
+    int32_t fps = CommandParser::GetInstance().GetTargetFps();
+    if (fps < 0) {
+        fps = 1000 / sendPeriod; // 1000: ms per second
+    }
+    framePacer.SetTargetFps(fps);
+    ILOG("VirtualScreen::InitFramePacer target fps: %d", fps);
+}
+
+void VirtualScreen::InitFrameRecorder()
+{
+    std::string path = CommandParser::GetInstance().GetRecordPath();
+    if (path.empty() || frameRecorder.IsOpen()) {
+        return;
+    }
+    if (frameRecorder.Open(path)) {
+        ILOG("VirtualScreen::InitFrameRecorder record frames to %s", path.c_str());
+    }
+}
+
+void VirtualScreen::SetTargetFps(int32_t fps)
+{
+    framePacer.SetTargetFps(fps);
+}
+
+int32_t VirtualScreen::GetTargetFps() const
+{
+    return framePacer.GetTargetFps();
+}
+
+void VirtualScreen::SetViewport(const FrameViewport& value)
+{
+    std::lock_guard<std::mutex> guard(viewportMutex);
+    viewport = value;
+    viewport.x = std::max(viewport.x, 0);
+    viewport.y = std::max(viewport.y, 0);
+    viewport.width = std::max(viewport.width, 0);
+    viewport.height = std::max(viewport.height, 0);
+    viewport.scale = std::min(std::max(viewport.scale, FrameViewport::MIN_SCALE), 1.0);
+}
+
+FrameViewport VirtualScreen::GetViewport() const
+{
+    std::lock_guard<std::mutex> guard(viewportMutex);
+    return viewport;
+}
+
+void VirtualScreen::SetInputMapping(const FrameViewport& shown, const InputMapping& value)
+{
+    std::lock_guard<std::mutex> guard(viewportMutex);
+    bool isShown = shown.IsSet() ? shown == viewport : !viewport.IsSet();
+    if (isShown) {
+        inputMapping = value;
+    }
+}
+
+void VirtualScreen::MapInputPosition(double& x, double& y) const
+{
+    std::lock_guard<std::mutex> guard(viewportMutex);
+    x = x * inputMapping.scaleX + inputMapping.offsetX;
+    y = y * inputMapping.scaleY + inputMapping.offsetY;
+}
+
+int VirtualScreen::GetAdaptiveJpgQuality(int32_t width, int32_t height)
+{
+    return progressiveQuality.GetQuality(
+        adaptiveQuality.GetQuality(GetJpgQualityValue(width, height), AdaptiveQuality::Clock::now()));
+}
+
+AdaptiveQuality::Clock::time_point VirtualScreen::BeginFrameCost()
+{
+    frameCost = FrameCost();
+    return AdaptiveQuality::Clock::now();
+}
+
+void VirtualScreen::EndFrameCost(AdaptiveQuality::Clock::time_point frameStart)
+{
+    if (frameCost.bytes == 0) {
+        return; // nothing went out, the frame says nothing about the link
+    }
+    adaptiveQuality.OnFrameSent(frameCost, AdaptiveQuality::Clock::now());
+    // Waiting here rather than before the send lets the mailbox replace the frames rendered meanwhile, the next
+    // frame sent is the latest one.
+    AdaptiveQuality::Clock::time_point nextStart = std::max(
+        frameStart + std::chrono::microseconds(adaptiveQuality.GetFrameIntervalUs()),
+        framePacer.NextDeadline(frameStart));
+    std::this_thread::sleep_until(nextStart);
+}
+
+size_t VirtualScreen::WriteFrameData(uint8_t* data, size_t length, int32_t variant, const FrameViewport& viewport)
+{
+    return WriteFrameData(WebSocketServer::MakePacket(data, length), variant, viewport);
+}
+
+size_t VirtualScreen::WriteFrameData(const std::shared_ptr<SendPacket>& packet, int32_t variant,
+                                     const FrameViewport& viewport)
+{
+    if (packet == nullptr) {
+        return 0;
+    }
+    AdaptiveQuality::Clock::time_point writeStart = AdaptiveQuality::Clock::now();
+    size_t written = WebSocketServer::GetInstance().WriteData(packet, variant, viewport);
+    int64_t writeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        AdaptiveQuality::Clock::now() - writeStart).count();
+    // WriteData only queues the packet, the link time comes from the packets the server finished writing since.
+    frameCost.drainUs += writeUs + WebSocketServer::GetInstance().TakeDrainUs();
+    frameCost.bytes += written;
+    if (viewport.IsSet()) {
+        return written;
+    }
+    // The encode time so far of the frame the packet belongs to.
+    frameRecorder.Append(packet->GetData(), packet->GetSize(),
+                         static_cast<uint32_t>(std::min<int64_t>(frameCost.encodeUs, UINT32_MAX)),
+                         static_cast<uint32_t>(std::min<int64_t>(writeUs, UINT32_MAX)), variant);
+    return written;
 }
 
 void VirtualScreen::SetFoldable(const bool value)
@@ -360,6 +622,9 @@ int32_t VirtualScreen::GetFoldHeight() const
 
 void VirtualScreen::SetCurrentResolution(int32_t width, int32_t height)
 {
+    if (width != currentWidth || height != currentHeight) {
+        FrameBufferPool::GetInstance().Reset(); // frame buffers of the previous resolution are no longer reused
+    }
     currentWidth = width;
     currentHeight = height;
 }
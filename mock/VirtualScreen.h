@@ -19,12 +19,28 @@
 #include <atomic>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 
+#include "AdaptiveQuality.h"
 #include "CppTimer.h"
+#include "FrameCodec.h"
+#include "FrameDelta.h"
+#include "FramePacer.h"
+#include "FrameRecorder.h"
+#include "JpegEncoder.h"
 #include "LocalSocket.h"
+#include "ProgressiveQuality.h"
 #include "WebSocketServer.h"
 
+// Rendered size over sent size of a picture, and where it starts in the rendered frame.
+struct InputMapping {
+    double scaleX = 1.0;
+    double scaleY = 1.0;
+    double offsetX = 0.0;
+    double offsetY = 0.0;
+};
+
 class VirtualScreen {
 public:
     VirtualScreen();
@@ -68,12 +84,42 @@ public:
                                         const int32_t& compressionHeight);
 
     int GetJpgQualityValue(int32_t width, int32_t height) const;
+    // The quality of GetJpgQualityValue, lowered by the adaptive controller while a budget is exceeded and capped
+    // by the progressive refinement while the scene changes.
+    int GetAdaptiveJpgQuality(int32_t width, int32_t height);
+    void SetAdaptiveQuality(const AdaptiveQualityConfig& config);
+    AdaptiveQualityConfig GetAdaptiveQuality() const;
+    // Codec of the component mode frames, see FrameCodecSelector::SetCodec for the names.
+    bool SetFrameCodec(const std::string& name);
+    std::string GetFrameCodec() const;
+    // Component mode frames are sent as deltas to the previous one, with a keyframe every keyframeInterval frames.
+    void SetFrameDelta(bool enable, uint32_t keyframeInterval);
+    bool IsFrameDeltaEnabled() const;
+    uint32_t GetKeyframeInterval() const;
+    // Frames of a changing scene are capped at the motion quality, the last one is refined once the scene is idle.
+    void SetProgressiveQuality(const ProgressiveQualityConfig& config);
+    ProgressiveQualityConfig GetProgressiveQuality() const;
+    // The sender paces frames to -fps, or to sendPeriod without it. 0 sends every frame at once.
+    void InitFramePacer();
+    // Every packet sent goes to the -rec file as well, written off the render and sender threads.
+    void InitFrameRecorder();
+    void SetTargetFps(int32_t fps);
+    int32_t GetTargetFps() const;
+    // The viewport of the clients that send input, positions are mapped through it. The viewports of other
+    // clients, set by name, are kept by the WebSocketServer only.
+    void SetViewport(const FrameViewport& value);
+    FrameViewport GetViewport() const;
+    // Maps a position on the picture the client shows to the rendered frame, they differ when -sr downscales or
+    // a viewport is sent.
+    void MapInputPosition(double& x, double& y) const;
 
     enum class LoadDocType { INIT = 3, START = 1, FINISHED = 2, NORMAL = 0 };
     void SetLoadDocFlag(VirtualScreen::LoadDocType flag);
     VirtualScreen::LoadDocType GetLoadDocFlag() const;
 
-    enum class ProtocolVersion { LOADNORMAL = 2, LOADDOC = 3, LOADDOCRGBA = 4 };
+    enum class ProtocolVersion { LOADNORMAL = 2, LOADDOC = 3, LOADDOCRGBA = 4, TILECACHE = 5 };
+    // Bits of the flags byte of the header. STALE: a frame of an earlier session, live frames replace it.
+    enum class FrameFlag : uint8_t { STALE = 0x01 };
 
     enum class JpgPixCountLevel { LOWCOUNT = 100000, MIDDLECOUNT = 300000, HIGHCOUNT = 500000};
     enum class JpgQualityLevel { HIGHLEVEL = 100, MIDDLELEVEL = 90, LOWLEVEL = 85, DEFAULTLEVEL = 75};
@@ -87,7 +133,23 @@ public:
     void SetDropFrameFrequency(const int32_t& value);
     static bool JudgeStaticImage(const int duration);
     static bool StopSendStaticCardImage(const int duration);
-    void RgbToJpg(unsigned char* data, const int32_t width, const int32_t height);
+    // The encoders write the jpeg into [dst, dst + capacity) and leave its size in jpgBufferSize, 0 on failure.
+    void RgbToJpg(const unsigned char* data, const int32_t width, const int32_t height,
+                  uint8_t* dst, const size_t capacity);
+    // RgbxRegionToJpg encodes 4 bytes per pixel frames without repacking them to RGB, it needs the extended color
+    // spaces of libjpeg-turbo, callers check IsRgbxJpgSupported first.
+    static bool IsRgbxJpgSupported();
+    // Encode a window of a larger frame, its rows are stride bytes apart. The quality is the one of the whole
+    // frame so that the window matches the picture around it. isFullChroma samples the chroma of every pixel
+    // instead of every 2x2 block.
+    void RgbxRegionToJpg(const unsigned char* data, const size_t stride, const int32_t width, const int32_t height,
+                         const int32_t quality, uint8_t* dst, const size_t capacity, const bool isFullChroma = false);
+    // Encode a 4 bytes per pixel window scaled down to scaledWidth x scaledHeight. The scaling, the YCbCr
+    // conversion and the alpha drop run one MCU row ahead of the compression, see JpegEncoder::EncodeRgbx. Needs
+    // no libjpeg-turbo extension.
+    void RgbxRegionToRawJpg(const unsigned char* data, const size_t stride, const int32_t width,
+                            const int32_t height, const int32_t scaledWidth, const int32_t scaledHeight,
+                            const int32_t quality, uint8_t* dst, const size_t capacity);
     static uint32_t inputKeyCountPerMinute;
     static uint32_t inputMethodCountPerMinute;
 
@@ -120,33 +182,73 @@ protected:
     static uint32_t validFrameCountPerMinute;
     static uint32_t invalidFrameCountPerMinute;
     static uint32_t sendFrameCountPerMinute;
+    static uint32_t skipFrameCountPerMinute; // frames identical to the previous one, dropped before encoding
+    static uint32_t coalescedFrameCountPerMinute; // frames replaced by a newer one before the sender took them
 
     LocalSocket* screenSocket;
     std::unique_ptr<CppTimer> frameCountTimer;
 
-    const int32_t sendPeriod = 40;              // A frame is sent per 40 ms.
+    const int32_t sendPeriod = 40;              // A frame is sent per 40 ms unless -fps says otherwise.
     const uint16_t pixelSize = 4;               // 4 bytes per pixel
     const size_t headSize = 40;                 // The packet header length is 40 bytes.
     const size_t headReservedSize = 20;         // The reserved length of the packet header is 20 bytes.
+    const size_t protocolVersionPos = 20;       // The protocol version opens the region fields of the header.
+    const size_t codecIdPos = 30;               // The FrameCodecId byte follows the region fields of the header.
+    const size_t frameFlagsPos = 31;            // The FrameFlag bits follow the codec id.
     const uint32_t headStart = 0x12345678;      // Buffer header starts with magic value 0x12345678
     const int32_t frameCountPeriod = 60 * 1000; // Frame count per minute
+    const int64_t parallelJpegMinPixels = 1920 * 1080; // Frames from 1080p up are encoded in parallel strips
+    const uint32_t maxJpegThreads = 4;          // Leave the remaining cores to rendering
     uint16_t protocolVersion = static_cast<uint16_t>(VirtualScreen::ProtocolVersion::LOADNORMAL);
     bool isWebSocketConfiged;
     std::string currentRouter;
     std::string abilityCurrentRouter;
     std::string fastPreviewMsg;
-    uint8_t* jpgScreenBuffer;
+    JpegEncoder jpegEncoder;
+    std::unique_ptr<ParallelJpegEncoder> parallelJpegEncoder; // created on the first large frame
     unsigned long jpgBufferSize;
     int jpgPix = 3; // jpg color components
     int redPos = 0;
     int greenPos = 1;
     int bluePos = 2;
 
+    // The sender thread measures every frame between BeginFrameCost and EndFrameCost, the encoders and
+    // WriteFrameData add to frameCost. EndFrameCost also waits out the frame interval of the controller and the
+    // deadline of the frame pacer.
+    AdaptiveQuality::Clock::time_point BeginFrameCost();
+    void EndFrameCost(AdaptiveQuality::Clock::time_point frameStart);
+    // Only the bytes the client takes count, a simulcast variant it did not ask for is not written. The crop of a
+    // viewport goes to its clients only and is not recorded.
+    size_t WriteFrameData(uint8_t* data, size_t length, int32_t variant = 0,
+                          const FrameViewport& viewport = FrameViewport());
+    // The clients and the backups share the packet, it is not copied.
+    size_t WriteFrameData(const std::shared_ptr<SendPacket>& packet, int32_t variant = 0,
+                          const FrameViewport& viewport = FrameViewport());
+    // Taken only when shown is the viewport of the clients that send input, the whole frame when it is not set.
+    void SetInputMapping(const FrameViewport& shown, const InputMapping& value);
+    AdaptiveQuality adaptiveQuality;
+    ProgressiveQuality progressiveQuality;
+    FramePacer framePacer;
+    FrameCost frameCost;
+    FrameCodecSelector frameCodecSelector;
+    FrameDelta frameDelta;
+    FrameRecorder frameRecorder;
+    mutable std::mutex viewportMutex; // a touch never maps through half of one mapping and half of another
+    FrameViewport viewport;
+    InputMapping inputMapping;
+
     static std::chrono::system_clock::time_point startTime;
     static std::chrono::system_clock::time_point staticCardStartTime;
     VirtualScreen::LoadDocType startLoadDoc = VirtualScreen::LoadDocType::INIT;
     std::chrono::system_clock::time_point startDropFrameTime;   // record start drop frame time
     int dropFrameFrequency = 0; // save drop frame frequency
+
+private:
+    // The strip encoder for frames from parallelJpegMinPixels up, nullptr for smaller frames or a single core.
+    ParallelJpegEncoder* GetParallelJpegEncoder(const int32_t width, const int32_t height);
+    void CompressJpg(const unsigned char* data, const size_t stride, const int32_t width, const int32_t height,
+                     const int32_t components, const int32_t colorSpace, const int32_t quality,
+                     uint8_t* dst, const size_t capacity, const bool isFullChroma = false);
 };
 
 #endif // VIRTUALSCREEN_H
@@ -24,7 +24,9 @@
 #undef boolean
 #include "task_manager.h"
 #include "CommandParser.h"
+#include "FrameBufferPool.h"
 #include "ModelManager.h"
+#include "PixelConvert.h"
 #include "PreviewerEngineLog.h"
 #include "TraceTool.h"
 
@@ -36,6 +38,8 @@ void VirtualScreenImpl::InitAll(std::string pipeName, std::string pipePort)
         ability.SetImageDecodeAbility(OHOS::IMG_SUPPORT_BITMAP);
     }
 
+    InitFramePacer();
+    InitFrameRecorder();
     InitPipe(pipeName, pipePort);
     if ((!CommandParser::GetInstance().IsResolutionValid(orignalResolutionWidth)) ||
         (!CommandParser::GetInstance().IsResolutionValid(orignalResolutionHeight))) {
@@ -126,77 +130,81 @@ void VirtualScreenImpl::ScheduleBufferSend()
         return;
     }
     isFrameUpdated = true;
-    if (CommandParser::GetInstance().IsRegionRefresh()) {
-        SendFullBuffer();
-    } else {
-        SendFullBuffer();
+    WriteRefreshRegion();
+    size_t length = headSize + static_cast<size_t>(compressionResolutionWidth) * compressionResolutionHeight * jpgPix;
+    FrameMailbox::PostResult result = frameMailbox.Post(screenBuffer, length, compressionResolutionWidth,
+        compressionResolutionHeight);
+    if (result == FrameMailbox::PostResult::REPLACED) {
+        coalescedFrameCountPerMinute++;
     }
+    isChanged = false;
+}
+
+void VirtualScreenImpl::SendFrame(const MailboxFrame& frame)
+{
+    AdaptiveQuality::Clock::time_point frameStart = BeginFrameCost();
+    std::shared_ptr<SendPacket> packet = SendFullBuffer(frame.data, frame.width, frame.height);
     if (isFirstSend) {
         ILOG("Send first buffer finish");
         TraceTool::GetInstance().HandleTrace("Send first buffer finish");
         isFirstSend = false;
     }
     
-    {
+    if (packet != nullptr) {
+        // The clients and the backup share the packet.
         std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
-        if (!WebSocketServer::GetInstance().firstImageBuffer) {
-            WebSocketServer::GetInstance().firstImageBuffer = new(std::nothrow) uint8_t[LWS_PRE + bufferSize];
-            if (!WebSocketServer::GetInstance().firstImageBuffer) {
-                ELOG("Memory allocation failed: firstImageBuffer.");
-                return;
-            }
-            WebSocketServer::GetInstance().firstImagebufferSize = headSize + jpgBufferSize;
-        }
-        std::copy(regionBuffer,
-                  regionBuffer + headSize + jpgBufferSize,
-                  WebSocketServer::GetInstance().firstImageBuffer + LWS_PRE);
+        WebSocketServer::GetInstance().firstImage = packet;
     }
 
     sendFrameCountPerMinute++;
-    isChanged = false;
+    EndFrameCost(frameStart);
 }
 
-void VirtualScreenImpl::Send(unsigned char* data, int32_t width, int32_t height)
+std::shared_ptr<SendPacket> VirtualScreenImpl::Send(unsigned char* data, int32_t width, int32_t height)
 {
     if (CommandParser::GetInstance().GetScreenMode() == CommandParser::ScreenMode::STATIC
         && VirtualScreen::isOutOfSeconds) {
-        return;
+        return nullptr;
+    }
+    if (regionBuffer == nullptr || bufferSize <= headSize) {
+        ELOG("VirtualScreenImpl::Send region buffer is not ready.");
+        return nullptr;
+    }
+    // The jpeg is encoded in place right after the header of the websocket buffer.
+    VirtualScreen::RgbToJpg(data + headSize, width, height, regionBuffer + headSize, bufferSize - headSize);
+    if (jpgBufferSize == 0) {
+        return nullptr;
     }
     // if websocket is config, use websocet, else use localsocket
-    VirtualScreen::RgbToJpg(data + headSize, width, height);
-    std::copy(jpgScreenBuffer, jpgScreenBuffer + jpgBufferSize, regionBuffer + headSize);
-    WebSocketServer::GetInstance().WriteData(regionBuffer, headSize + jpgBufferSize);
-    FreeJpgMemory();
+    std::shared_ptr<SendPacket> packet = WebSocketServer::MakePacket(regionBuffer, headSize + jpgBufferSize);
+    WriteFrameData(packet);
+    return packet;
 }
 
-void VirtualScreenImpl::SendFullBuffer()
+std::shared_ptr<SendPacket> VirtualScreenImpl::SendFullBuffer(uint8_t* data, int32_t width, int32_t height)
 {
-    WriteRefreshRegion();
-    std::copy(screenBuffer, screenBuffer + headSize, regionBuffer);
-    Send(reinterpret_cast<unsigned char*>(screenBuffer),
-         compressionResolutionWidth,
-         compressionResolutionHeight);
+    std::copy(data, data + headSize, regionBuffer);
+    return Send(data, width, height);
 }
 
 void VirtualScreenImpl::SendRegionBuffer()
 {
     WriteRefreshRegion();
     std::copy(screenBuffer, screenBuffer + headSize, regionBuffer);
+    // The region is packed into a separate buffer because regionBuffer receives the encoded jpeg.
+    uint8_t* regionData = FrameBufferPool::GetInstance().Acquire(headSize + regionWidth * regionHeight * jpgPix);
+    if (!regionData) {
+        ELOG("Memory allocation failed: regionData.");
+        return;
+    }
     for (int i = regionY1; i <= regionY2; ++i) {
         uint8_t* startPos = screenBuffer + (i * compressionResolutionWidth + regionX1) * jpgPix + headSize;
         std::copy(startPos,
                   startPos + regionWidth * jpgPix,
-                  regionBuffer + ((i - regionY1) * regionWidth) * jpgPix + headSize);
-    }
-    Send(reinterpret_cast<unsigned char*>(regionBuffer), regionWidth, regionHeight);
-}
-
-void VirtualScreenImpl::FreeJpgMemory()
-{
-    if (jpgScreenBuffer != nullptr) {
-        free(jpgScreenBuffer);
-        jpgScreenBuffer = NULL;
+                  regionData + ((i - regionY1) * regionWidth) * jpgPix + headSize);
     }
+    Send(regionData, regionWidth, regionHeight);
+    FrameBufferPool::GetInstance().Release(regionData);
 }
 
 VirtualScreenImpl& VirtualScreenImpl::GetInstance()
@@ -228,22 +236,21 @@ VirtualScreenImpl::VirtualScreenImpl()
       regionY2(0),
       regionWidth(0),
       regionHeight(0),
-      bufferInfo(nullptr)
+      bufferInfo(nullptr),
+      frameMailbox([this](const MailboxFrame& frame) { SendFrame(frame); })
 {
 }
 
 VirtualScreenImpl::~VirtualScreenImpl()
 {
+    frameMailbox.Stop();
     if (wholeBuffer != nullptr) {
         delete [] wholeBuffer;
         wholeBuffer = nullptr;
         screenBuffer = nullptr;
     }
-    FreeJpgMemory();
-    if (WebSocketServer::GetInstance().firstImageBuffer) {
-        delete [] WebSocketServer::GetInstance().firstImageBuffer;
-        WebSocketServer::GetInstance().firstImageBuffer = nullptr;
-    }
+    std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+    WebSocketServer::GetInstance().firstImage = nullptr;
 }
 
 void VirtualScreenImpl::Flush(const OHOS::Rect& flushRect)
@@ -259,15 +266,9 @@ void VirtualScreenImpl::Flush(const OHOS::Rect& flushRect)
         return;
     }
 
-    for (int i = 0; i <= compressionResolutionHeight - 1; ++i) {
-        for (int j = 0; j <= compressionResolutionWidth - 1; ++j) {
-            uint8_t* curPixel = screenBuffer + (i * compressionResolutionWidth + j) * jpgPix + headSize;
-            uint8_t* osPixel = osBuffer + (i * compressionResolutionWidth + j) * pixelSize + headSize;
-            *(curPixel + redPos) = *(osPixel + bluePos);
-            *(curPixel + greenPos) = *(osPixel + greenPos);
-            *(curPixel + bluePos) = *(osPixel + redPos);
-        }
-    }
+    PixelConvert::BgraToRgb(osBuffer + headSize, compressionResolutionWidth * pixelSize, screenBuffer + headSize,
+                            compressionResolutionWidth * jpgPix, compressionResolutionWidth,
+                            compressionResolutionHeight);
 
     validFrameCountPerMinute++;
     isChanged = true;
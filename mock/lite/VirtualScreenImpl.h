@@ -21,6 +21,7 @@
 #include "input_device.h"
 
 #include "EndianUtil.h"
+#include "FrameMailbox.h"
 #include "LocalSocket.h"
 #include "VirtualScreen.h"
 
@@ -50,10 +51,11 @@ private:
     uint8_t* osBuffer;
     bool isChanged;
     void ScheduleBufferSend();
-    void Send(unsigned char* data, int32_t width, int32_t height);
-    void SendFullBuffer();
+    void SendFrame(const MailboxFrame& frame);
+    // Returns the packet written to the clients, nullptr when nothing was encoded.
+    std::shared_ptr<SendPacket> Send(unsigned char* data, int32_t width, int32_t height);
+    std::shared_ptr<SendPacket> SendFullBuffer(uint8_t* data, int32_t width, int32_t height);
     void SendRegionBuffer();
-    void FreeJpgMemory();
 
     template <class T, class = typename std::enable_if<std::is_integral<T>::value>::type>
     void WriteBuffer(const T data)
@@ -80,6 +82,8 @@ private:
     int16_t regionHeight;
     int32_t extendPix = 15;
     OHOS::BufferInfo* bufferInfo;
+    // Flush only posts the converted frame, the jpeg encoding and the websocket write run on its sender thread.
+    FrameMailbox frameMailbox;
     static constexpr int SEND_IMG_DURATION_MS = 300;
 };
 
@@ -15,13 +15,19 @@
 
 #include "VirtualScreenImpl.h"
 
+#include <algorithm>
 #include <cinttypes>
+#include <cmath>
 #define boolean jpegboolean
 #include "jpeglib.h"
 #undef boolean
 
 #include "CommandLineInterface.h"
 #include "CommandParser.h"
+#include "FrameBufferPool.h"
+#include "FrameHash.h"
+#include "FrameScaler.h"
+#include "FrameSnapshot.h"
 #include "PreviewerEngineLog.h"
 #include "TraceTool.h"
 #include <sstream>
@@ -35,37 +41,21 @@ VirtualScreenImpl& VirtualScreenImpl::GetInstance()
 void VirtualScreenImpl::SendBufferOnTimer()
 {
     GetInstance().SetLoadDocFlag(VirtualScreen::LoadDocType::NORMAL);
-    if (GetInstance().loadDocTempBuffer == nullptr) {
+    std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+    if (!GetInstance().hasLoadDocFrame) {
         PrintLoadDocFinishedLog("onRender timeout,no buffer to send");
         return;
     }
     VirtualScreen::isStartCount = true;
-    {
-        std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
-        if (GetInstance().loadDocCopyBuffer != nullptr) {
-            delete [] GetInstance().loadDocCopyBuffer;
-            GetInstance().loadDocCopyBuffer = nullptr;
-        }
-        GetInstance().loadDocCopyBuffer = new(std::nothrow) uint8_t[GetInstance().lengthTemp];
-        if (!GetInstance().loadDocCopyBuffer) {
-            ELOG("Memory allocation failed : loadDocCopyBuffer.");
-            return;
-        }
-        std::copy(GetInstance().loadDocTempBuffer,
-            GetInstance().loadDocTempBuffer + GetInstance().lengthTemp,
-            GetInstance().loadDocCopyBuffer);
-    }
     VirtualScreenImpl::GetInstance().protocolVersion =
         static_cast<uint16_t>(VirtualScreen::ProtocolVersion::LOADDOCRGBA);
-    GetInstance().bufferSize = GetInstance().lengthTemp + GetInstance().headSize;
-    GetInstance().wholeBuffer = new(std::nothrow) uint8_t[LWS_PRE + GetInstance().bufferSize];
-    if (!GetInstance().wholeBuffer) {
-        ELOG("Memory allocation failed : wholeBuffer.");
-        return;
+    GetInstance().hasLastFrameHash = false; // this frame does not come through Callback
+    // Swapped into the mailbox, not copied, loadDocFrame gets a buffer of the mailbox to fill next time.
+    if (GetInstance().frameMailbox.Post(GetInstance().loadDocFrame, GetInstance().widthTemp,
+        GetInstance().heightTemp, GetInstance().configGeneration) == FrameMailbox::PostResult::REPLACED) {
+        coalescedFrameCountPerMinute++;
     }
-    GetInstance().screenBuffer = GetInstance().wholeBuffer + LWS_PRE;
-    GetInstance().SendPixmap(GetInstance().loadDocCopyBuffer, GetInstance().lengthTemp,
-        GetInstance().widthTemp, GetInstance().heightTemp);
+    GetInstance().hasLoadDocFrame = false;
 }
 
 void VirtualScreenImpl::PrintLoadDocFinishedLog(const std::string& logStr)
@@ -119,22 +109,86 @@ bool VirtualScreenImpl::NoFlushEmptyFunc(int64_t timePassed)
     return false;
 }
 
-
-void VirtualScreenImpl::StartTimer()
+void VirtualScreenImpl::StartLoadDocRound()
 {
-    while (true) {
-        auto endTime = std::chrono::system_clock::now();
-        int64_t timePassed = std::chrono::duration_cast<std::chrono::milliseconds>(endTime -
-                                VirtualScreenImpl::GetInstance().startTime).count();
-        bool ret = false;
-        if (GetInstance().isFlushEmpty) {
-            ret = FlushEmptyFunc(endTime, timePassed);
-        } else {
-            ret = NoFlushEmptyFunc(timePassed);
+    {
+        std::lock_guard<std::mutex> guard(loadDocMutex);
+        if (isLoadDocStopping) {
+            return;
         }
-        if (ret) {
+        if (!loadDocThread.joinable()) {
+            loadDocThread = std::thread(&VirtualScreenImpl::LoadDocLoop, this);
+        }
+        loadDocRound++;
+        hasLoadDocEvent = true;
+    }
+    loadDocCondition.notify_one();
+}
+
+void VirtualScreenImpl::NotifyLoadDocEvent()
+{
+    {
+        std::lock_guard<std::mutex> guard(loadDocMutex);
+        if (loadDocRound == finishedLoadDocRound) {
             return;
         }
+        hasLoadDocEvent = true;
+    }
+    loadDocCondition.notify_one();
+}
+
+std::chrono::system_clock::time_point VirtualScreenImpl::GetLoadDocDeadline() const
+{
+    // The earliest time FlushEmptyFunc or NoFlushEmptyFunc may decide differently without a new event.
+    std::chrono::system_clock::time_point deadline = startTime + std::chrono::milliseconds(TIMEOUT_NINE_S);
+    if (isFlushEmpty) {
+        if (onRenderTime <= flushEmptyTime) {
+            // 1: the onRender timeout is exceeded, not reached
+            deadline = std::min(deadline,
+                flushEmptyTime + std::chrono::milliseconds(TIMEOUT_ONRENDER_DURATION_MS + 1));
+        }
+    } else {
+        deadline = std::min(deadline, startTime + std::chrono::milliseconds(SEND_IMG_DURATION_MS));
+    }
+    return deadline;
+}
+
+void VirtualScreenImpl::LoadDocLoop()
+{
+    std::unique_lock<std::mutex> lock(loadDocMutex);
+    while (!isLoadDocStopping) {
+        if (loadDocRound == finishedLoadDocRound) {
+            loadDocCondition.wait(lock, [this]() {
+                return isLoadDocStopping || loadDocRound != finishedLoadDocRound;
+            });
+            continue;
+        }
+        uint64_t round = loadDocRound;
+        hasLoadDocEvent = false;
+        lock.unlock(); // SendBufferOnTimer posts to the mailbox, the render thread may notify meanwhile
+        auto endTime = std::chrono::system_clock::now();
+        int64_t timePassed = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+        bool isFinished = isFlushEmpty ? FlushEmptyFunc(endTime, timePassed) : NoFlushEmptyFunc(timePassed);
+        std::chrono::system_clock::time_point deadline = GetLoadDocDeadline();
+        lock.lock();
+        if (isFinished) {
+            finishedLoadDocRound = round;
+            continue;
+        }
+        loadDocCondition.wait_until(lock, std::max(deadline, endTime + std::chrono::milliseconds(1)),
+            [this]() { return isLoadDocStopping || hasLoadDocEvent; });
+    }
+}
+
+void VirtualScreenImpl::StopLoadDocThread()
+{
+    {
+        std::lock_guard<std::mutex> guard(loadDocMutex);
+        isLoadDocStopping = true;
+    }
+    loadDocCondition.notify_all();
+    if (loadDocThread.joinable()) {
+        loadDocThread.join();
     }
 }
 
@@ -148,31 +202,25 @@ bool VirtualScreenImpl::LoadDocCallback(const void* data, const size_t length, c
     if (GetInstance().GetLoadDocFlag() == VirtualScreen::LoadDocType::FINISHED) {
         {
             std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
-            if (GetInstance().loadDocTempBuffer != nullptr) {
-                delete [] GetInstance().loadDocTempBuffer;
-                GetInstance().loadDocTempBuffer = nullptr;
-            }
-            GetInstance().lengthTemp = length;
+            GetInstance().hasLoadDocFrame = false;
             GetInstance().widthTemp = width;
             GetInstance().heightTemp = height;
             GetInstance().timeStampTemp = timeStamp;
             if (length <= 0) {
                 return false;
             }
-            GetInstance().loadDocTempBuffer = new(std::nothrow) uint8_t[length];
-            if (!GetInstance().loadDocTempBuffer) {
-                ELOG("Memory allocation failed : loadDocTempBuffer.");
-                return false;
-            }
-            uint8_t*  dataPtr = reinterpret_cast<uint8_t*>(const_cast<void*>(data));
-            std::copy(dataPtr, dataPtr + length, GetInstance().loadDocTempBuffer);
+            // The buffer keeps its capacity between frames, the frame is copied without an allocation.
+            const uint8_t* dataPtr = static_cast<const uint8_t*>(data);
+            GetInstance().loadDocFrame.assign(dataPtr, dataPtr + length);
+            GetInstance().hasLoadDocFrame = true;
             GetInstance().onRenderTime = std::chrono::system_clock::now();
         }
         if (VirtualScreen::isStartCount) {
             VirtualScreen::isStartCount = false;
             VirtualScreen::startTime = std::chrono::system_clock::now();
-            std::thread timerThread(std::ref(VirtualScreenImpl::StartTimer));
-            timerThread.detach();
+            GetInstance().StartLoadDocRound();
+        } else {
+            GetInstance().NotifyLoadDocEvent();
         }
         return false;
     }
@@ -198,16 +246,25 @@ bool VirtualScreenImpl::Callback(const void* data, const size_t length,
     if (!LoadDocCallback(data, length, width, height, timeStamp)) {
         return false; // 组件预览
     }
-
-    GetInstance().bufferSize = length + GetInstance().headSize;
-    GetInstance().wholeBuffer = new(std::nothrow) uint8_t[LWS_PRE + GetInstance().bufferSize];
-    if (!GetInstance().wholeBuffer) {
-        ELOG("Memory allocation failed : wholeBuffer.");
+    if (GetInstance().IsRepeatedFrame(data, length, width, height)) {
+        GetInstance().isFrameUpdated = true;
+        skipFrameCountPerMinute++;
+        return false; // 与上一帧相同
+    }
+    if (!GetInstance().JudgeBeforeSend(data)) {
+        GetInstance().hasLastFrameHash = false;
         return false;
     }
-    GetInstance().screenBuffer = GetInstance().wholeBuffer + LWS_PRE;
-
-    return GetInstance().SendPixmap(data, length, width, height);
+    FrameMailbox::PostResult result = GetInstance().frameMailbox.Post(static_cast<const uint8_t*>(data), length,
+        width, height, GetInstance().configGeneration);
+    if (result == FrameMailbox::PostResult::FAILED) {
+        GetInstance().hasLastFrameHash = false;
+        return false;
+    }
+    if (result == FrameMailbox::PostResult::REPLACED) {
+        coalescedFrameCountPerMinute++; // 发送线程未取走的旧帧被替换
+    }
+    return true;
 }
 
 bool VirtualScreenImpl::FlushEmptyCallback(const uint64_t timeStamp)
@@ -220,6 +277,7 @@ bool VirtualScreenImpl::FlushEmptyCallback(const uint64_t timeStamp)
     GetInstance().isFlushEmpty = true;
     GetInstance().flushEmptyTime = std::chrono::system_clock::now();
     GetInstance().flushEmptyTimeStamp = timeStamp;
+    GetInstance().NotifyLoadDocEvent();
     return true;
 }
 
@@ -263,6 +321,11 @@ void VirtualScreenImpl::FastPreviewCallback(const std::string& jsonStr)
 
 void VirtualScreenImpl::InitAll(std::string pipeName, std::string pipePort)
 {
+    InitFramePacer();
+    InitFrameRecorder();
+    framePyramid.SetSizes(CommandParser::GetInstance().GetSimulcastSizes());
+    WebSocketServer::GetInstance().SetVariantCount(static_cast<int32_t>(framePyramid.GetLevelCount()));
+    LoadLastFrame(); // before the server starts, the first client to connect gets it
     VirtualScreen::InitPipe(pipeName, pipePort);
 }
 
@@ -273,28 +336,285 @@ VirtualScreenImpl::VirtualScreenImpl()
       wholeBuffer(nullptr),
       screenBuffer(nullptr),
       bufferSize(0),
-      currentPos(0)
+      currentPos(0),
+      frameMailbox([this](const MailboxFrame& frame) { SendMailboxFrame(frame); })
 {
+    FrameBufferPool::GetInstance(); // the pool must outlive the screen, construct it first
+    frameMailbox.SetIdleHandler([this](const MailboxFrame& frame) { RefineMailboxFrame(frame); },
+        [this]() { return progressiveQuality.GetIdleDelay(); });
+    // Frames are not encoded while no client is connected, the one that connects gets the current frame at once.
+    WebSocketServer::GetInstance().SetConnectHandler([this]() { frameMailbox.Resend(); });
 }
 
 VirtualScreenImpl::~VirtualScreenImpl()
 {
+    WebSocketServer::GetInstance().SetConnectHandler(nullptr);
+    StopLoadDocThread(); // it posts to the mailbox
+    frameMailbox.Stop();
     FreeJpgMemory();
-    if (WebSocketServer::GetInstance().firstImageBuffer) {
-        delete [] WebSocketServer::GetInstance().firstImageBuffer;
-        WebSocketServer::GetInstance().firstImageBuffer = nullptr;
+    std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+    WebSocketServer::GetInstance().firstImage = nullptr;
+    ReleaseRegionBackups();
+    WebSocketServer::GetInstance().variantImages.clear();
+}
+
+void VirtualScreenImpl::ResendLastFrame()
+{
+    frameMailbox.Resend();
+}
+
+bool VirtualScreenImpl::CaptureFrame(bool isNext, uint32_t stableFrames, std::chrono::milliseconds timeout,
+                                     CapturedFrame& frame)
+{
+    int32_t fps = GetTargetFps();
+    std::chrono::milliseconds frameInterval((fps > 0) ? 1000 / fps : sendPeriod); // 1000: ms per second
+    std::function<void()> onWaiting = nullptr;
+    if (!isNext) {
+        onWaiting = [this]() { frameMailbox.Resend(); };
+    }
+    std::chrono::milliseconds quietPeriod = frameInterval * std::max(stableFrames, 1u);
+    return frameCapture.Capture(stableFrames, quietPeriod, std::min(timeout, quietPeriod + frameInterval), frame,
+                                onWaiting);
+}
+
+void VirtualScreenImpl::SetTileCache(bool enable, uint32_t capacity)
+{
+    tileCache.Configure(enable, capacity);
+}
+
+bool VirtualScreenImpl::IsTileCacheEnabled() const
+{
+    return tileCache.IsEnabled();
+}
+
+uint32_t VirtualScreenImpl::GetTileCacheCapacity() const
+{
+    return tileCache.GetCapacity();
+}
+
+void VirtualScreenImpl::SaveConfigFrame(const FrameConfig& config)
+{
+    std::vector<uint8_t> pixels;
+    int32_t width = 0;
+    int32_t height = 0;
+    uint64_t generation = 0;
+    // The last frame posted, it may not have been sent yet, tells by its tag whether the runtime rendered it in
+    // this configuration. A cached frame shown at the switch is posted with tag 0.
+    bool isRenderedSinceSwitch = frameMailbox.CopyLastPosted(pixels, width, height, generation) &&
+        generation == configGeneration;
+    configGeneration++;
+    if (isRenderedSinceSwitch) {
+        configFrameCache.Store(config, std::move(pixels), width, height);
+    }
+}
+
+bool VirtualScreenImpl::ShowConfigFrame(const FrameConfig& config)
+{
+    CachedFrame frame;
+    if (!configFrameCache.Find(config, frame)) {
+        return false;
+    }
+    hasLastFrameHash = false; // the real frame may look the same, it must not be dropped as a repeat
+    if (frameMailbox.Post(frame.pixels->data(), frame.pixels->size(), frame.width, frame.height) ==
+        FrameMailbox::PostResult::REPLACED) {
+        coalescedFrameCountPerMinute++;
+    }
+    return true;
+}
+
+void VirtualScreenImpl::InvalidateConfigFrames()
+{
+    configFrameCache.Invalidate();
+}
+
+std::string VirtualScreenImpl::GetLastFrameKey() const
+{
+    CommandParser& parser = CommandParser::GetInstance();
+    std::ostringstream key;
+    key << parser.Value("j") << '|' << parser.Value("url") << '|' << parser.GetDeviceType() << '|'
+        << parser.GetOrignalResolutionWidth() << 'x' << parser.GetOrignalResolutionHeight() << '|'
+        << parser.GetCompressionResolutionWidth() << 'x' << parser.GetCompressionResolutionHeight() << '|'
+        << parser.GetSendResolutionWidth() << 'x' << parser.GetSendResolutionHeight() << '|'
+        << parser.Value("cm") << '|' << parser.Value("o") << '|' << parser.Value("l") << '|'
+        << parser.GetFoldStatus() << '|' << parser.IsComponentMode();
+    return key.str();
+}
+
+void VirtualScreenImpl::LoadLastFrame()
+{
+    std::string dir = CommandParser::GetInstance().GetLastFrameDir();
+    if (dir.empty()) {
+        return;
+    }
+    std::string key = GetLastFrameKey();
+    {
+        // SaveLastFrame may already run on the command thread.
+        std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+        lastFrameKey = key;
+    }
+    std::vector<std::vector<uint8_t>> packets;
+    if (!FrameSnapshot::Load(dir, key, packets)) {
+        ILOG("No last frame of the project to send.");
+        return;
+    }
+    std::vector<std::shared_ptr<SendPacket>> loaded;
+    for (std::vector<uint8_t>& packet : packets) {
+        if (packet.size() < headSize) {
+            ELOG("The last frame of the project can not be sent.");
+            return;
+        }
+        packet[frameFlagsPos] |= static_cast<uint8_t>(VirtualScreen::FrameFlag::STALE);
+        loaded.push_back(WebSocketServer::MakePacket(packet.data(), packet.size()));
+        if (loaded.back() == nullptr) {
+            ELOG("The last frame of the project can not be sent.");
+            return;
+        }
+    }
+    std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+    if (WebSocketServer::GetInstance().firstImage != nullptr) {
+        return;
+    }
+    WebSocketServer::GetInstance().firstImage = loaded[0];
+    for (size_t i = 1; i < loaded.size(); ++i) {
+        WebSocketServer::GetInstance().regionImages.push_back(loaded[i]);
+        regionBackupBytes += loaded[i]->GetSize();
+    }
+    ILOG("The last frame of the project is sent until the first render, %zu packets.", loaded.size());
+}
+
+void VirtualScreenImpl::SaveLastFrame()
+{
+    if (!isSavingLastFrame) {
+        return;
+    }
+    std::string router = GetCurrentRouter();
+    if (!lastFrameRouter.empty() && router != lastFrameRouter) {
+        return; // the page is not the one of the launch arguments
+    }
+    std::vector<std::vector<uint8_t>> packets;
+    std::string key;
+    {
+        std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+        key = lastFrameKey;
+        const std::shared_ptr<SendPacket>& first = WebSocketServer::GetInstance().firstImage;
+        if (key.empty() || first == nullptr || first->GetSize() < headSize ||
+            (first->GetData()[frameFlagsPos] & static_cast<uint8_t>(VirtualScreen::FrameFlag::STALE)) != 0) {
+            return; // nothing rendered yet
+        }
+        packets.emplace_back(first->GetData(), first->GetData() + first->GetSize());
+        for (const std::shared_ptr<SendPacket>& region : WebSocketServer::GetInstance().regionImages) {
+            packets.emplace_back(region->GetData(), region->GetData() + region->GetSize());
+        }
+    }
+    uint64_t hash = packets.size();
+    for (const std::vector<uint8_t>& packet : packets) {
+        if (packet.size() < headSize) {
+            return;
+        }
+        // A client of the next session may not have chosen a codec or the tile cache, it reads jpeg only.
+        uint16_t version = static_cast<uint16_t>((packet[protocolVersionPos] << 8) | // 8: high byte
+            packet[protocolVersionPos + 1]);
+        if ((packet[codecIdPos] != static_cast<uint8_t>(FrameCodecId::DEFAULT) &&
+            packet[codecIdPos] != static_cast<uint8_t>(FrameCodecId::JPEG)) ||
+            version == static_cast<uint16_t>(VirtualScreen::ProtocolVersion::TILECACHE)) {
+            return;
+        }
+        hash = FrameHash::Hash64(packet.data(), packet.size(), hash);
+    }
+    if (hash == lastSavedFrameHash) {
+        return;
+    }
+    if (FrameSnapshot::Save(CommandParser::GetInstance().GetLastFrameDir(), key, packets)) {
+        lastSavedFrameHash = hash;
+        lastFrameRouter = router;
+    }
+}
+
+void VirtualScreenImpl::StopSavingLastFrame()
+{
+    isSavingLastFrame = false;
+}
+
+void VirtualScreenImpl::SendMailboxFrame(const MailboxFrame& frame)
+{
+    // Screenshots are taken whether a client is connected or not.
+    frameCapture.Offer(frame.data, frame.length, frame.width, frame.height);
+    if (!WebSocketServer::GetInstance().HasClients()) {
+        return;
+    }
+    AdaptiveQuality::Clock::time_point frameStart = BeginFrameCost();
+    if (!AcquireWholeBuffer(frame.length)) {
+        hasLastFrameHash = false;
+        return;
+    }
+    SendPixmap(frame.data, frame.length, frame.width, frame.height);
+    EndFrameCost(frameStart);
+}
+
+void VirtualScreenImpl::RefineMailboxFrame(const MailboxFrame& frame)
+{
+    // Component mode frames are lossless already.
+    if (!progressiveQuality.IsRefinementDue() || CommandParser::GetInstance().IsComponentMode() ||
+        !WebSocketServer::GetInstance().HasClients()) {
+        return;
+    }
+    if (CommandParser::GetInstance().GetScreenMode() == CommandParser::ScreenMode::STATIC
+        && VirtualScreen::isOutOfSeconds) {
+        return;
     }
-    if (VirtualScreenImpl::GetInstance().loadDocTempBuffer != nullptr) {
-        delete [] VirtualScreenImpl::GetInstance().loadDocTempBuffer;
-        VirtualScreenImpl::GetInstance().loadDocTempBuffer = nullptr;
+    // A one-off frame, its cost says nothing about the link and is kept out of the adaptive quality.
+    if (!JudgeBeforeSend(frame.data)) {
+        return;
     }
-    if (VirtualScreenImpl::GetInstance().loadDocCopyBuffer != nullptr) {
-        delete [] VirtualScreenImpl::GetInstance().loadDocCopyBuffer;
-        VirtualScreenImpl::GetInstance().loadDocCopyBuffer = nullptr;
+    originWidth = frame.width;
+    originHeight = frame.height;
+    if (WebSocketServer::GetInstance().HasClient(0)) {
+        RefineWholeFrame(frame);
     }
+    SendViewports(frame.data, frame.width, frame.height, true);
+    progressiveQuality.OnRefined();
+}
+
+void VirtualScreenImpl::RefineWholeFrame(const MailboxFrame& frame)
+{
+    if (!AcquireWholeBuffer(frame.length)) {
+        return;
+    }
+    int32_t sendWidth = frame.width;
+    int32_t sendHeight = frame.height;
+    uint8_t* scaled = DownscaleFrame(frame.data, frame.width, frame.height, sendWidth, sendHeight);
+    const uint8_t* pixels = (scaled != nullptr) ? scaled : frame.data;
+    // A complete frame, in region refresh mode the damage tracker already holds these pixels, the next regions
+    // are taken against it.
+    WriteHeader(sendWidth, sendHeight, { 0, 0, sendWidth, sendHeight });
+    size_t stride = static_cast<size_t>(sendWidth) * pixelSize;
+    int32_t quality = progressiveQuality.GetRefineQuality();
+    if (IsRgbxJpgSupported()) {
+        VirtualScreen::RgbxRegionToJpg(pixels, stride, sendWidth, sendHeight, quality, screenBuffer + headSize,
+                                       bufferSize - headSize, true);
+    } else {
+        VirtualScreen::RgbxRegionToRawJpg(pixels, stride, sendWidth, sendHeight, sendWidth, sendHeight, quality,
+                                          screenBuffer + headSize, bufferSize - headSize);
+    }
+    FrameBufferPool::GetInstance().Release(scaled);
+    if (jpgBufferSize == 0) {
+        ELOG("VirtualScreenImpl::RefineWholeFrame jpeg encode failed.");
+        FreeJpgMemory();
+        return;
+    }
+    std::shared_ptr<SendPacket> packet = TakeWholeBuffer(jpgBufferSize);
+    writed = WriteFrameData(packet);
+    BackupFrame(packet);
+    tileCache.RequestReset(); // a reconnecting client starts from this frame, it holds none of the tiles
 }
 
 void VirtualScreenImpl::Send(const void* data, int32_t retWidth, int32_t retHeight)
+{
+    Send(data, retWidth, retHeight, retWidth, retHeight);
+}
+
+void VirtualScreenImpl::Send(const void* data, int32_t retWidth, int32_t retHeight, int32_t sendWidth,
+                             int32_t sendHeight)
 {
     if (CommandParser::GetInstance().GetScreenMode() == CommandParser::ScreenMode::STATIC
         && VirtualScreen::isOutOfSeconds) {
@@ -305,60 +625,383 @@ void VirtualScreenImpl::Send(const void* data, int32_t retWidth, int32_t retHeig
         FLOG("VirtualScreenImpl::RgbToJpg the retWidth or height is invalid value");
         return;
     }
-    unsigned char* dataTemp = new(std::nothrow) unsigned char[retWidth * retHeight * jpgPix];
-    if (!dataTemp) {
-        ELOG("Memory allocation failed : dataTemp.");
+    if (!EncodeJpg(static_cast<const uint8_t*>(data), static_cast<size_t>(retWidth) * pixelSize, retWidth,
+                   retHeight, sendWidth, sendHeight, GetAdaptiveJpgQuality(sendWidth, sendHeight))) {
+        damageTracker.Reset(); // the client misses this frame, the next one has to be complete
+        hasLastFrameHash = false;
+        return;
+    }
+
+    std::shared_ptr<SendPacket> packet = TakeWholeBuffer(jpgBufferSize);
+    writed = WriteFrameData(packet);
+    BackupFrame(packet);
+}
+
+void VirtualScreenImpl::SendVariants(const void* data, int32_t retWidth, int32_t retHeight)
+{
+    if (framePyramid.GetLevelCount() == 0 || (CommandParser::GetInstance().GetScreenMode() ==
+        CommandParser::ScreenMode::STATIC && VirtualScreen::isOutOfSeconds)) {
+        return;
+    }
+    // Variants are encoded for the clients that take them only, one that connects gets the next frame at once.
+    std::vector<bool> isTaken(framePyramid.GetLevelCount());
+    for (size_t i = 0; i < isTaken.size(); i++) {
+        isTaken[i] = WebSocketServer::GetInstance().HasClient(static_cast<int32_t>(i) + 1); // 0 is the full stream
+    }
+    if (std::find(isTaken.begin(), isTaken.end(), true) == isTaken.end()) {
+        return;
+    }
+    if (!framePyramid.Build(static_cast<const uint8_t*>(data), static_cast<size_t>(retWidth) * pixelSize,
+                            retWidth, retHeight)) {
+        ELOG("VirtualScreenImpl::SendVariants scaling the frame failed.");
+        return;
+    }
+    const std::vector<FramePyramid::Level>& levels = framePyramid.GetLevels();
+    for (size_t i = 0; i < levels.size() && i < isTaken.size(); i++) {
+        if (!isTaken[i]) {
+            continue;
+        }
+        const FramePyramid::Level& level = levels[i];
+        if (!AcquireWholeBuffer(level.stride * level.height)) {
+            return;
+        }
+        WriteHeader(level.width, level.height, { 0, 0, level.width, level.height });
+        if (!EncodeJpg(level.data, level.stride, level.width, level.height, level.width, level.height,
+                       GetAdaptiveJpgQuality(level.width, level.height))) {
+            FreeJpgMemory();
+            continue;
+        }
+        int32_t variant = static_cast<int32_t>(i) + 1; // 0 is the full stream
+        std::shared_ptr<SendPacket> packet = TakeWholeBuffer(jpgBufferSize);
+        WriteFrameData(packet, variant);
+        BackupVariant(variant, packet);
+    }
+}
+
+void VirtualScreenImpl::SendViewports(const void* data, int32_t retWidth, int32_t retHeight, bool isRefine)
+{
+    for (const FrameViewport& view : WebSocketServer::GetInstance().GetViewports()) {
+        DamageRect region;
+        int32_t sendWidth = retWidth;
+        int32_t sendHeight = retHeight;
+        FitViewport(view, retWidth, retHeight, region, sendWidth, sendHeight);
+        if (!AcquireWholeBuffer(static_cast<size_t>(region.width) * region.height * pixelSize)) {
+            return;
+        }
+        int32_t quality = isRefine ? progressiveQuality.GetRefineQuality() :
+            GetAdaptiveJpgQuality(sendWidth, sendHeight);
+        SendViewport(data, retWidth, region, sendWidth, sendHeight, quality, view);
+    }
+}
+
+void VirtualScreenImpl::SendViewport(const void* data, int32_t retWidth, const DamageRect& region,
+                                     int32_t sendWidth, int32_t sendHeight, int32_t quality,
+                                     const FrameViewport& view)
+{
+    if (CommandParser::GetInstance().GetScreenMode() == CommandParser::ScreenMode::STATIC
+        && VirtualScreen::isOutOfSeconds) {
+        return;
+    }
+    WriteHeader(sendWidth, sendHeight, region, true);
+    size_t stride = static_cast<size_t>(retWidth) * pixelSize;
+    const uint8_t* origin = static_cast<const uint8_t*>(data) + region.y * stride +
+        static_cast<size_t>(region.x) * pixelSize;
+    if (!EncodeJpg(origin, stride, region.width, region.height, sendWidth, sendHeight, quality)) {
+        return;
+    }
+    WriteFrameData(TakeWholeBuffer(jpgBufferSize), 0, view);
+    FreeJpgMemory();
+}
+
+void VirtualScreenImpl::SendTiles(const void* data, int32_t retWidth, int32_t retHeight)
+{
+    if (CommandParser::GetInstance().GetScreenMode() == CommandParser::ScreenMode::STATIC
+        && VirtualScreen::isOutOfSeconds) {
         return;
     }
-    for (int i = 0; i < retHeight; i++) {
-        for (int j = 0; j < retWidth; j++) {
-            int inputBasePos = i * retWidth * pixelSize + j * pixelSize;
-            int nowBasePos = i * retWidth * jpgPix + j * jpgPix;
-            dataTemp[nowBasePos + redPos] = *((char*)data + inputBasePos + redPos);
-            dataTemp[nowBasePos + greenPos] = *((char*)data + inputBasePos + greenPos);
-            dataTemp[nowBasePos + bluePos] = *((char*)data + inputBasePos + bluePos);
+    {
+        // Tile frames are replayed after the last reset on reconnection, like the regions, a long chain is cut off.
+        std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+        if (IsRegionChainLong()) {
+            tileCache.RequestReset();
         }
     }
-    VirtualScreen::RgbToJpg(dataTemp, retWidth, retHeight);
-    delete [] dataTemp;
-    if (jpgBufferSize > bufferSize - headSize) {
-        FLOG("VirtualScreenImpl::Send length must < %d", bufferSize - headSize);
+    size_t tableSize = TileCache::GetTableSize(retWidth, retHeight);
+    size_t length = tableSize + TileCache::GetAtlasSize(retWidth, retHeight);
+    if (tableSize == 0 || (bufferSize < headSize + length && !AcquireWholeBuffer(length))) {
+        hasLastFrameHash = false;
+        return;
+    }
+    WriteHeader(retWidth, retHeight, { 0, 0, retWidth, retHeight }, true);
+    currentPos = protocolVersionPos;
+    WriteBuffer(static_cast<uint16_t>(VirtualScreen::ProtocolVersion::TILECACHE));
+    uint32_t connection = WebSocketServer::connectionCount;
+    int32_t quality = GetAdaptiveJpgQuality(retWidth, retHeight);
+    bool isReset = false;
+    AdaptiveQuality::Clock::time_point encodeStart = AdaptiveQuality::Clock::now();
+    if (tileCache.Encode(static_cast<const uint8_t*>(data), retWidth, retHeight, static_cast<uint32_t>(quality),
+        connection, screenBuffer + headSize, bufferSize - headSize, tileAtlas, isReset) == 0) {
+        hasLastFrameHash = false;
+        return;
+    }
+    frameCost.encodeUs += std::chrono::duration_cast<std::chrono::microseconds>(
+        AdaptiveQuality::Clock::now() - encodeStart).count();
+    jpgBufferSize = 0;
+    if (tileAtlas.tileCount > 0) {
+        // RgbxRegionToRawJpg measures its own encode time.
+        VirtualScreen::RgbxRegionToRawJpg(tileAtlas.pixels.data(), static_cast<size_t>(tileAtlas.width) * pixelSize,
+            tileAtlas.width, tileAtlas.height, tileAtlas.width, tileAtlas.height, quality,
+            screenBuffer + headSize + tableSize, bufferSize - headSize - tableSize);
+        if (jpgBufferSize == 0) {
+            ELOG("VirtualScreenImpl::SendTiles jpeg encode failed.");
+            tileCache.RequestReset(); // the tiles of this frame were taken as sent
+            hasLastFrameHash = false;
+            return;
+        }
+    }
+    size_t size = tableSize + jpgBufferSize;
+    std::shared_ptr<SendPacket> packet = isReset ? TakeWholeBuffer(size) : CopyRegion(size);
+    writed = WriteFrameData(packet);
+    if (writed == 0) {
+        tileCache.RequestReset(); // nobody took the tiles of this frame, the next frame must not refer to them
+    }
+    if (isReset) {
+        BackupFrame(packet);
+    } else {
+        BackupRegion(packet);
+        FreeJpgMemory();
+    }
+}
+
+void VirtualScreenImpl::SendDamage(const void* data, int32_t retWidth, int32_t retHeight)
+{
+    std::vector<DamageRect> regions = damageTracker.Update(static_cast<const uint8_t*>(data),
+        static_cast<size_t>(retWidth) * pixelSize, retWidth, retHeight);
+    if (regions.empty()) {
+        FreeJpgMemory(); // nothing changed since the last frame
+        return;
+    }
+    if (damageTracker.IsFullFrame(regions)) {
+        WriteHeader(retWidth, retHeight, regions[0]);
+        Send(data, retWidth, retHeight);
+        return;
+    }
+    // Every region goes out as its own message through the same buffer, it is large enough for a whole frame.
+    for (const DamageRect& region : regions) {
+        SendRegion(data, retWidth, retHeight, region);
+    }
+    FreeJpgMemory();
+}
+
+void VirtualScreenImpl::SendRegion(const void* data, int32_t retWidth, int32_t retHeight, const DamageRect& region)
+{
+    if (CommandParser::GetInstance().GetScreenMode() == CommandParser::ScreenMode::STATIC
+        && VirtualScreen::isOutOfSeconds) {
         return;
     }
+    WriteHeader(retWidth, retHeight, region);
+    size_t stride = static_cast<size_t>(retWidth) * pixelSize;
+    const uint8_t* origin = static_cast<const uint8_t*>(data) + region.y * stride +
+        static_cast<size_t>(region.x) * pixelSize;
+    if (!EncodeJpg(origin, stride, region.width, region.height, region.width, region.height,
+                   GetAdaptiveJpgQuality(retWidth, retHeight))) {
+        damageTracker.Reset();
+        hasLastFrameHash = false;
+        return;
+    }
+    std::shared_ptr<SendPacket> packet = CopyRegion(jpgBufferSize);
+    writed = WriteFrameData(packet);
+    BackupRegion(packet);
+}
 
-    std::copy(jpgScreenBuffer, jpgScreenBuffer + jpgBufferSize, screenBuffer + headSize);
-    writed = WebSocketServer::GetInstance().WriteData(screenBuffer, headSize + jpgBufferSize);
-    BackupAndDeleteBuffer(jpgBufferSize);
+bool VirtualScreenImpl::EncodeJpg(const uint8_t* data, size_t stride, int32_t width, int32_t height,
+                                  int32_t sendWidth, int32_t sendHeight, int32_t quality)
+{
+    if (screenBuffer == nullptr || bufferSize <= headSize) {
+        ELOG("VirtualScreenImpl::Send screen buffer is not ready.");
+        return false;
+    }
+    // The jpeg is encoded in place right after the header of the websocket buffer.
+    VirtualScreen::RgbxRegionToRawJpg(data, stride, width, height, sendWidth, sendHeight, quality,
+                                      screenBuffer + headSize, bufferSize - headSize);
+    if (jpgBufferSize == 0) {
+        FLOG("VirtualScreenImpl::Send jpeg encode failed, length must < %" PRIu64, bufferSize - headSize);
+        return false;
+    }
+    return true;
 }
 
 void VirtualScreenImpl::SendRgba(const void* data, size_t length)
 {
     const char* charData = reinterpret_cast<const char*>(data);
     std::copy(charData, charData + length, screenBuffer + headSize);
-    writed = WebSocketServer::GetInstance().WriteData(screenBuffer, headSize + length);
-    BackupAndDeleteBuffer(length);
+    std::shared_ptr<SendPacket> packet = TakeWholeBuffer(length);
+    writed = WriteFrameData(packet);
+    BackupFrame(packet);
 }
 
-void VirtualScreenImpl::BackupAndDeleteBuffer(const unsigned long imageBufferSize)
+void VirtualScreenImpl::SendComponent(const void* data, size_t length, int32_t retWidth, int32_t retHeight)
 {
-    std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
-    if (WebSocketServer::GetInstance().firstImageBuffer) {
-        delete [] WebSocketServer::GetInstance().firstImageBuffer;
-        WebSocketServer::GetInstance().firstImageBuffer = nullptr;
+    if (frameDelta.IsEnabled() && SendDeltaFrame(data, retWidth, retHeight)) {
+        return;
     }
-    WebSocketServer::GetInstance().firstImageBuffer = new(std::nothrow) uint8_t[LWS_PRE + bufferSize];
-    if (!WebSocketServer::GetInstance().firstImageBuffer) {
-        ELOG("Memory allocation failed : firstImageBuffer.");
+    // Read before the send, a client connecting meanwhile gets this frame from the backup.
+    uint32_t connection = WebSocketServer::connectionCount;
+    FrameCodec* codec = frameCodecSelector.Pick();
+    if (codec == nullptr) {
+        SendRgba(data, length);
+        frameDelta.SetReference(static_cast<const uint8_t*>(data), retWidth, retHeight, connection);
+        return;
+    }
+    if (screenBuffer == nullptr || bufferSize <= headSize) {
+        ELOG("VirtualScreenImpl::SendComponent screen buffer is not ready.");
         return;
     }
-    WebSocketServer::GetInstance().firstImagebufferSize = headSize + jpgBufferSize;
-    std::copy(screenBuffer,
-              screenBuffer + headSize + imageBufferSize,
-              WebSocketServer::GetInstance().firstImageBuffer + LWS_PRE);
+    const uint8_t* pixels = static_cast<const uint8_t*>(data);
+    AdaptiveQuality::Clock::time_point encodeStart = AdaptiveQuality::Clock::now();
+    size_t encodedSize = codec->Encode(pixels, retWidth, retHeight, screenBuffer + headSize, bufferSize - headSize);
+    if (encodedSize == 0) {
+        // The frame does not compress, raw RGBA always fits the buffer.
+        codec = frameCodecSelector.GetRawCodec();
+        encodedSize = codec->Encode(pixels, retWidth, retHeight, screenBuffer + headSize, bufferSize - headSize);
+    }
+    int64_t encodeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        AdaptiveQuality::Clock::now() - encodeStart).count();
+    if (encodedSize == 0) {
+        ELOG("VirtualScreenImpl::SendComponent frame size does not match %dx%d.", retWidth, retHeight);
+        FreeJpgMemory();
+        hasLastFrameHash = false;
+        return;
+    }
+    frameCost.encodeUs += encodeUs;
+    screenBuffer[codecIdPos] = static_cast<uint8_t>(codec->GetId());
+    int64_t drainUs = frameCost.drainUs;
+    std::shared_ptr<SendPacket> packet = TakeWholeBuffer(encodedSize);
+    writed = WriteFrameData(packet);
+    frameCodecSelector.OnFrameSent(codec->GetId(), length, encodedSize, encodeUs, frameCost.drainUs - drainUs);
+    BackupFrame(packet);
+    frameDelta.SetReference(pixels, retWidth, retHeight, connection);
+}
+
+bool VirtualScreenImpl::SendDeltaFrame(const void* data, int32_t retWidth, int32_t retHeight)
+{
+    if (screenBuffer == nullptr || bufferSize <= headSize) {
+        return false;
+    }
+    {
+        // Deltas are replayed after the last keyframe on reconnection, like the regions, a long chain is cut off.
+        std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+        if (IsRegionChainLong()) {
+            return false;
+        }
+    }
+    uint32_t connection = WebSocketServer::connectionCount;
+    AdaptiveQuality::Clock::time_point encodeStart = AdaptiveQuality::Clock::now();
+    size_t encodedSize = frameDelta.Encode(static_cast<const uint8_t*>(data), retWidth, retHeight, connection,
+        screenBuffer + headSize, bufferSize - headSize);
+    if (encodedSize == 0) {
+        return false; // a keyframe is due
+    }
+    frameCost.encodeUs += std::chrono::duration_cast<std::chrono::microseconds>(
+        AdaptiveQuality::Clock::now() - encodeStart).count();
+    screenBuffer[codecIdPos] = static_cast<uint8_t>(FrameCodecId::DELTA);
+    std::shared_ptr<SendPacket> packet = CopyRegion(encodedSize);
+    writed = WriteFrameData(packet);
+    BackupRegion(packet);
+    FreeJpgMemory();
+    return true;
+}
+
+std::shared_ptr<SendPacket> VirtualScreenImpl::TakeWholeBuffer(size_t imageBufferSize)
+{
+    // The clients and the backup share the encoded frame, the buffer goes back to the pool after the last of them.
+    std::shared_ptr<SendPacket> packet = SendPacket::Create(FrameBufferPool::GetInstance().Share(wholeBuffer),
+                                                            LWS_PRE, headSize + imageBufferSize);
+    wholeBuffer = nullptr;
+    screenBuffer = nullptr;
+    return packet;
+}
+
+std::shared_ptr<SendPacket> VirtualScreenImpl::CopyRegion(size_t imageBufferSize)
+{
+    // Region messages are small, they are copied out so the whole frame buffer can carry the next region.
+    size_t size = headSize + imageBufferSize;
+    uint8_t* buffer = FrameBufferPool::GetInstance().Acquire(LWS_PRE + size);
+    if (!buffer) {
+        ELOG("Memory allocation failed : region packet.");
+        return nullptr;
+    }
+    std::copy(screenBuffer, screenBuffer + size, buffer + LWS_PRE);
+    return SendPacket::Create(FrameBufferPool::GetInstance().Share(buffer), LWS_PRE, size);
+}
+
+void VirtualScreenImpl::BackupFrame(const std::shared_ptr<SendPacket>& packet)
+{
+    {
+        // The frame just sent becomes the backup for reconnection.
+        std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+        WebSocketServer::GetInstance().firstImage = packet;
+        ReleaseRegionBackups();
+    }
+    FreeJpgMemory();
+}
 
+void VirtualScreenImpl::BackupVariant(int32_t variant, const std::shared_ptr<SendPacket>& packet)
+{
+    {
+        std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+        std::vector<std::shared_ptr<SendPacket>>& backups = WebSocketServer::GetInstance().variantImages;
+        if (backups.size() < static_cast<size_t>(variant)) {
+            backups.resize(variant);
+        }
+        backups[variant - 1] = packet;
+    }
     FreeJpgMemory();
 }
 
+void VirtualScreenImpl::BackupRegion(const std::shared_ptr<SendPacket>& packet)
+{
+    if (!packet) {
+        damageTracker.Reset();
+        frameDelta.RequestKeyframe(); // a reconnecting client would miss this delta
+        tileCache.RequestReset();
+        return;
+    }
+    std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+    WebSocketServer::GetInstance().regionImages.push_back(packet);
+    regionBackupBytes += packet->GetSize();
+    if (IsRegionChainLong()) {
+        damageTracker.Reset(); // replaying the regions would cost more than a new full frame
+    }
+}
+
+bool VirtualScreenImpl::IsRegionChainLong() const
+{
+    const std::shared_ptr<SendPacket>& first = WebSocketServer::GetInstance().firstImage;
+    return regionBackupBytes > (first ? first->GetSize() : 0) ||
+        WebSocketServer::GetInstance().regionImages.size() >= MAX_REGION_BACKUPS;
+}
+
+void VirtualScreenImpl::ReleaseRegionBackups()
+{
+    WebSocketServer::GetInstance().regionImages.clear();
+    regionBackupBytes = 0;
+}
+
+bool VirtualScreenImpl::AcquireWholeBuffer(size_t length)
+{
+    FrameBufferPool::GetInstance().Release(wholeBuffer);
+    bufferSize = length + headSize;
+    wholeBuffer = FrameBufferPool::GetInstance().Acquire(LWS_PRE + bufferSize);
+    if (!wholeBuffer) {
+        ELOG("Memory allocation failed : wholeBuffer.");
+        screenBuffer = nullptr;
+        return false;
+    }
+    screenBuffer = wholeBuffer + LWS_PRE;
+    return true;
+}
+
 bool VirtualScreenImpl::JudgeBeforeSend(const void* data)
 {
     if (data == nullptr) {
@@ -373,9 +1016,25 @@ bool VirtualScreenImpl::JudgeBeforeSend(const void* data)
     return true;
 }
 
+bool VirtualScreenImpl::IsRepeatedFrame(const void* data, size_t length, int32_t width, int32_t height)
+{
+    if (data == nullptr || length == 0) {
+        return false;
+    }
+    uint64_t hash = FrameHash::Hash64(static_cast<const uint8_t*>(data), length);
+    bool isRepeated = hasLastFrameHash && hash == lastFrameHash && width == lastFrameWidth &&
+        height == lastFrameHeight;
+    hasLastFrameHash = true;
+    lastFrameHash = hash;
+    lastFrameWidth = width;
+    lastFrameHeight = height;
+    return isRepeated;
+}
+
 bool VirtualScreenImpl::SendPixmap(const void* data, size_t length, int32_t retWidth, int32_t retHeight)
 {
     if (!JudgeBeforeSend(data)) {
+        hasLastFrameHash = false;
         return false;
     }
     if (isFirstRender) {
@@ -384,65 +1043,142 @@ bool VirtualScreenImpl::SendPixmap(const void* data, size_t length, int32_t retW
         isFirstRender = false;
     }
     isFrameUpdated = true;
+    originWidth = retWidth;
+    originHeight = retHeight;
+    int32_t sendWidth = retWidth;
+    int32_t sendHeight = retHeight;
+    if (CommandParser::GetInstance().IsComponentMode()) {
+        WriteHeader(retWidth, retHeight, { 0, 0, retWidth, retHeight });
+        SendComponent(data, length, retWidth, retHeight);
+    } else if (!WebSocketServer::GetInstance().HasClient(0)) {
+        // The clients show a viewport or a variant, the full stream goes on from its backups once one takes it.
+    } else if (tileCache.IsEnabled()) {
+        // Unchanged tiles replace the damage regions, region refresh starts over from a full frame once it is off.
+        damageTracker.Reset();
+        uint8_t* scaled = DownscaleFrame(static_cast<const uint8_t*>(data), retWidth, retHeight, sendWidth,
+            sendHeight);
+        SendTiles((scaled != nullptr) ? scaled : data, sendWidth, sendHeight);
+        FrameBufferPool::GetInstance().Release(scaled);
+    } else if (CommandParser::GetInstance().IsRegionRefresh()) {
+        // The damage tracker compares the frames as they are sent, they are scaled first.
+        uint8_t* scaled = DownscaleFrame(static_cast<const uint8_t*>(data), retWidth, retHeight, sendWidth,
+            sendHeight);
+        SendDamage((scaled != nullptr) ? scaled : data, sendWidth, sendHeight);
+        FrameBufferPool::GetInstance().Release(scaled);
+    } else {
+        FitSendSize(retWidth, retHeight, sendWidth, sendHeight);
+        WriteHeader(sendWidth, sendHeight, { 0, 0, sendWidth, sendHeight });
+        Send(data, retWidth, retHeight, sendWidth, sendHeight);
+    }
+    if (!CommandParser::GetInstance().IsComponentMode()) {
+        SendViewports(data, retWidth, retHeight, false);
+        SendVariants(data, retWidth, retHeight);
+    }
+    if (isFirstSend) {
+        ILOG("Send first buffer finish");
+        TraceTool::GetInstance().HandleTrace("Send first buffer finish");
+        isFirstSend = false;
+    }
+    validFrameCountPerMinute++;
+    sendFrameCountPerMinute++;
+    return writed == length;
+}
+
+void VirtualScreenImpl::FitSendSize(int32_t width, int32_t height, int32_t& sendWidth, int32_t& sendHeight)
+{
+    FrameScaler::FitSize(width, height, CommandParser::GetInstance().GetSendResolutionWidth(),
+        CommandParser::GetInstance().GetSendResolutionHeight(), sendWidth, sendHeight);
+    InputMapping mapping;
+    mapping.scaleX = static_cast<double>(width) / sendWidth;
+    mapping.scaleY = static_cast<double>(height) / sendHeight;
+    SetInputMapping(FrameViewport(), mapping);
+}
+
+void VirtualScreenImpl::FitViewport(const FrameViewport& view, int32_t width, int32_t height, DamageRect& region,
+                                    int32_t& sendWidth, int32_t& sendHeight)
+{
+    // The viewport is kept across rotations and resizes, it is cut to the frame every time.
+    region.x = std::min(view.x, width);
+    region.y = std::min(view.y, height);
+    region.width = std::min(view.width, width - region.x);
+    region.height = std::min(view.height, height - region.y);
+    if (region.width < 1 || region.height < 1) {
+        region = { 0, 0, width, height };
+        sendWidth = width;
+        sendHeight = height;
+    } else {
+        sendWidth = std::max(static_cast<int32_t>(std::lround(region.width * view.scale)), 1);
+        sendHeight = std::max(static_cast<int32_t>(std::lround(region.height * view.scale)), 1);
+    }
+    InputMapping mapping;
+    mapping.scaleX = static_cast<double>(region.width) / sendWidth;
+    mapping.scaleY = static_cast<double>(region.height) / sendHeight;
+    mapping.offsetX = region.x;
+    mapping.offsetY = region.y;
+    SetInputMapping(view, mapping);
+}
+
+uint8_t* VirtualScreenImpl::DownscaleFrame(const uint8_t* data, int32_t width, int32_t height, int32_t& sendWidth,
+                                           int32_t& sendHeight)
+{
+    FitSendSize(width, height, sendWidth, sendHeight);
+    if (sendWidth == width && sendHeight == height) {
+        return nullptr;
+    }
+    uint8_t* scaled = FrameBufferPool::GetInstance().Acquire(static_cast<size_t>(sendWidth) * sendHeight * pixelSize);
+    if (!scaled || !FrameScaler::DownscaleRgba(data, static_cast<size_t>(width) * pixelSize, width, height,
+        scaled, static_cast<size_t>(sendWidth) * pixelSize, sendWidth, sendHeight)) {
+        ELOG("VirtualScreenImpl::DownscaleFrame failed, the frame is sent at %dx%d.", width, height);
+        FrameBufferPool::GetInstance().Release(scaled);
+        sendWidth = width;
+        sendHeight = height;
+        SetInputMapping(FrameViewport(), InputMapping());
+        return nullptr;
+    }
+    return scaled;
+}
+
+void VirtualScreenImpl::WriteHeader(int32_t retWidth, int32_t retHeight, const DamageRect& region)
+{
+    WriteHeader(retWidth, retHeight, region, CommandParser::GetInstance().IsRegionRefresh());
+}
+
+void VirtualScreenImpl::WriteHeader(int32_t retWidth, int32_t retHeight, const DamageRect& region, bool hasRegion)
+{
     currentPos = 0;
     WriteBuffer(headStart);
+    WriteBuffer(originWidth);
+    WriteBuffer(originHeight);
     WriteBuffer(retWidth);
     WriteBuffer(retHeight);
-    WriteBuffer(retWidth);
-    WriteBuffer(retHeight);
-    if (!CommandParser::GetInstance().IsRegionRefresh()) {
+    if (!hasRegion) {
         for (size_t i = 0; i < headReservedSize / sizeof(int32_t); i++) {
             WriteBuffer(static_cast<uint32_t>(0));
         }
     } else {
-        uint16_t x1 = 0;
-        uint16_t y1 = 0;
-        uint16_t width = static_cast<uint16_t>(retWidth);
-        uint16_t height = static_cast<uint16_t>(retHeight);
         WriteBuffer(protocolVersion);
-        WriteBuffer(x1);
-        WriteBuffer(y1);
-        WriteBuffer(width);
-        WriteBuffer(height);
+        WriteBuffer(static_cast<uint16_t>(region.x));
+        WriteBuffer(static_cast<uint16_t>(region.y));
+        WriteBuffer(static_cast<uint16_t>(region.width));
+        WriteBuffer(static_cast<uint16_t>(region.height));
         for (size_t i = 0; i < 10 / sizeof(uint16_t); i++) { // fill 10bytes for header
             WriteBuffer(static_cast<uint16_t>(0));
         }
     }
-    if (CommandParser::GetInstance().IsComponentMode()) {
-        SendRgba(data, length);
-    } else {
-        Send(data, retWidth, retHeight);
+    if (!frameCodecSelector.IsDefault()) {
+        // A client that chose a codec reads the id of every frame, SendComponent overwrites it.
+        screenBuffer[codecIdPos] = static_cast<uint8_t>(FrameCodecId::JPEG);
     }
-    if (isFirstSend) {
-        ILOG("Send first buffer finish");
-        TraceTool::GetInstance().HandleTrace("Send first buffer finish");
-        isFirstSend = false;
-    }
-    validFrameCountPerMinute++;
-    sendFrameCountPerMinute++;
-    return writed == length;
 }
 
 void VirtualScreenImpl::FreeJpgMemory()
 {
     if (wholeBuffer != nullptr) {
-        delete [] wholeBuffer;
+        FrameBufferPool::GetInstance().Release(wholeBuffer);
         wholeBuffer = nullptr;
         screenBuffer = nullptr;
     }
-    if (jpgScreenBuffer != nullptr) {
-        free(jpgScreenBuffer);
-        jpgScreenBuffer = NULL;
-        jpgBufferSize = 0;
-    }
-    if (loadDocCopyBuffer != nullptr) {
-        delete [] loadDocCopyBuffer;
-        loadDocCopyBuffer = nullptr;
-    }
-    if (loadDocTempBuffer != nullptr) {
-        delete [] loadDocTempBuffer;
-        loadDocTempBuffer = nullptr;
-    }
+    jpgBufferSize = 0;
 }
 
 ScreenInfo VirtualScreenImpl::GetScreenInfo()
@@ -16,6 +16,16 @@
 #ifndef VIRTUALSREENIMPL_H
 #define VIRTUALSREENIMPL_H
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "ConfigFrameCache.h"
+#include "DamageTracker.h"
+#include "FrameCapture.h"
+#include "FrameMailbox.h"
+#include "FramePyramid.h"
+#include "TileCache.h"
 #include "VirtualScreen.h"
 
 class ScreenInfo {
@@ -35,7 +45,6 @@ public:
     VirtualScreenImpl(const VirtualScreenImpl&) = delete;
     VirtualScreenImpl& operator=(const VirtualScreenImpl&) = delete;
     static VirtualScreenImpl& GetInstance();
-    static void StartTimer();
     static bool FlushEmptyFunc(std::chrono::system_clock::time_point endTime, int64_t timePassed);
     static bool NoFlushEmptyFunc(int64_t timePassed);
     static void PrintLoadDocFinishedLog(const std::string& logStr);
@@ -52,15 +61,93 @@ public:
     void InitAll(std::string pipeName, std::string pipePort);
     ScreenInfo GetScreenInfo();
     void InitFoldParams();
+    // Sends the last frame once more, after a setting changed what the client is sent.
+    void ResendLastFrame();
+    // A copy of a frame the sender takes, the next one, or the last one again unless isNext. Waits for
+    // stableFrames identical frames, a still scene counts as stable after as many frame intervals. The command
+    // thread waits here, so the wait ends one frame interval after a settled frame could have come at the latest.
+    bool CaptureFrame(bool isNext, uint32_t stableFrames, std::chrono::milliseconds timeout, CapturedFrame& frame);
+    // Full frames go out as tile tables, the client keeps capacity tiles, see TileCache.
+    void SetTileCache(bool enable, uint32_t capacity);
+    bool IsTileCacheEnabled() const;
+    uint32_t GetTileCacheCapacity() const;
+    // The last frame sent is kept as the one of config, before a command switches away from it. Frames sent
+    // before the previous switch are not, they may show the configuration before it.
+    void SaveConfigFrame(const FrameConfig& config);
+    // Sends the frame kept for config, false when there is none.
+    bool ShowConfigFrame(const FrameConfig& config);
+    // The kept frames no longer match the sources.
+    void InvalidateConfigFrames();
+    // With -lfd the frame last sent by a session of the same project, page and launch configuration is sent to the
+    // first client, flagged STALE, until a live frame replaces it.
+    void SaveLastFrame();
+    // The frames stop matching the launch configuration, they are no longer kept for the next session.
+    void StopSavingLastFrame();
 private:
     VirtualScreenImpl();
     ~VirtualScreenImpl();
+    void SendMailboxFrame(const MailboxFrame& frame);
+    // Sends the last frame once more at the refine quality after the scene stayed idle, see ProgressiveQuality.
+    void RefineMailboxFrame(const MailboxFrame& frame);
+    void RefineWholeFrame(const MailboxFrame& frame);
     void Send(const void* data, int32_t retWidth, int32_t retHeight);
+    // The frame is scaled down to sendWidth x sendHeight while it is encoded.
+    void Send(const void* data, int32_t retWidth, int32_t retHeight, int32_t sendWidth, int32_t sendHeight);
+    // Every simulcast variant of the frame, as a full frame, after the frame went out in the full stream.
+    void SendVariants(const void* data, int32_t retWidth, int32_t retHeight);
     void SendRgba(const void* data, size_t length);
-    void BackupAndDeleteBuffer(const unsigned long imageBufferSize);
+    void SendComponent(const void* data, size_t length, int32_t retWidth, int32_t retHeight);
+    bool SendDeltaFrame(const void* data, int32_t retWidth, int32_t retHeight);
+    void SendDamage(const void* data, int32_t retWidth, int32_t retHeight);
+    void SendRegion(const void* data, int32_t retWidth, int32_t retHeight, const DamageRect& region);
+    // A TILECACHE frame: the tile table, then the jpeg of the tiles the client does not hold.
+    void SendTiles(const void* data, int32_t retWidth, int32_t retHeight);
+    // The crop of every viewport a client shows, to the clients of that viewport. Refined crops take the refine
+    // quality instead of the adaptive one.
+    void SendViewports(const void* data, int32_t retWidth, int32_t retHeight, bool isRefine);
+    // Only region of the frame, encoded at sendWidth x sendHeight, the header tells the client where it lies.
+    // Crops are not backed up, a client of a viewport gets a new one when it connects.
+    void SendViewport(const void* data, int32_t retWidth, const DamageRect& region, int32_t sendWidth,
+                      int32_t sendHeight, int32_t quality, const FrameViewport& view);
+    bool EncodeJpg(const uint8_t* data, size_t stride, int32_t width, int32_t height, int32_t sendWidth,
+                   int32_t sendHeight, int32_t quality);
+    // The size a rendered frame is sent at to fit -sr, input positions are mapped back by the same ratio.
+    void FitSendSize(int32_t width, int32_t height, int32_t& sendWidth, int32_t& sendHeight);
+    // The viewport cut to the frame and its size as sent, the whole frame when they do not meet. Input positions
+    // are mapped through it when it is the viewport of the clients that send input.
+    void FitViewport(const FrameViewport& view, int32_t width, int32_t height, DamageRect& region,
+                     int32_t& sendWidth, int32_t& sendHeight);
+    // Returns the frame downscaled to fit -sr from the pool, nullptr when it is sent as rendered.
+    uint8_t* DownscaleFrame(const uint8_t* data, int32_t width, int32_t height, int32_t& sendWidth,
+                            int32_t& sendHeight);
+    // The header carries the rendered size first, then the size of the picture that follows.
+    void WriteHeader(int32_t retWidth, int32_t retHeight, const DamageRect& region);
+    // The region fields are written when hasRegion, otherwise they are zero like the rest of the reserved bytes.
+    void WriteHeader(int32_t retWidth, int32_t retHeight, const DamageRect& region, bool hasRegion);
+    // The encoded frame in the whole buffer as a packet, the buffer is handed over to it.
+    std::shared_ptr<SendPacket> TakeWholeBuffer(size_t imageBufferSize);
+    // A copy of the encoded region in a buffer of its size, nullptr when it can not be allocated.
+    std::shared_ptr<SendPacket> CopyRegion(size_t imageBufferSize);
+    void BackupFrame(const std::shared_ptr<SendPacket>& packet);
+    void BackupRegion(const std::shared_ptr<SendPacket>& packet);
+    void BackupVariant(int32_t variant, const std::shared_ptr<SendPacket>& packet);
+    // Called with the backup mutex held. Past this, replaying the regions costs more than a full frame.
+    bool IsRegionChainLong() const;
+    void ReleaseRegionBackups();
+    bool AcquireWholeBuffer(size_t length);
     bool JudgeBeforeSend(const void* data);
+    bool IsRepeatedFrame(const void* data, size_t length, int32_t width, int32_t height);
     bool SendPixmap(const void* data, size_t length, int32_t retWidth, int32_t retHeight);
     void FreeJpgMemory();
+    std::string GetLastFrameKey() const;
+    void LoadLastFrame();
+    // A LoadDocument frame is chosen on a thread that sleeps until a frame or the end mark arrives or a time limit
+    // passes, the round started by the first frame ends once SendBufferOnTimer ran or nothing came in 9 s.
+    void StartLoadDocRound();
+    void NotifyLoadDocEvent();
+    void LoadDocLoop();
+    std::chrono::system_clock::time_point GetLoadDocDeadline() const;
+    void StopLoadDocThread();
     template<class T, class = typename std::enable_if<std::is_integral<T>::value>::type>
     void WriteBuffer(const T data)
     {
@@ -76,13 +163,37 @@ private:
     uint8_t* wholeBuffer;
     uint8_t* screenBuffer;
     uint64_t bufferSize;
+    int32_t originWidth = 0; // rendered size of the frame being sent
+    int32_t originHeight = 0;
     unsigned long long currentPos;
     static constexpr int SEND_IMG_DURATION_MS = 300;
     static constexpr int STOP_SEND_CARD_DURATION_MS = 10000;
+    static constexpr size_t MAX_REGION_BACKUPS = 64; // a full frame is sent once this many regions are kept
 
-    uint8_t* loadDocTempBuffer;
-    uint8_t* loadDocCopyBuffer;
-    size_t lengthTemp;
+    DamageTracker damageTracker;
+    uint64_t regionBackupBytes = 0;
+    // Render callbacks only post frames here, encoding and the blocking websocket write run on its sender thread.
+    FrameMailbox frameMailbox;
+    FramePyramid framePyramid; // the simulcast variants, -sv
+    FrameCapture frameCapture; // screenshots, fed by the sender thread
+    TileCache tileCache;
+    TileAtlas tileAtlas; // kept between the frames for its capacity
+    ConfigFrameCache configFrameCache;
+    // Counts the configuration switches, rendered frames are posted with it as their tag.
+    std::atomic<uint64_t> configGeneration { 1 };
+    std::string lastFrameKey; // empty without -lfd
+    std::string lastFrameRouter; // the page of the first frame saved, frames of other pages are not
+    uint64_t lastSavedFrameHash = 0;
+    std::atomic<bool> isSavingLastFrame { true };
+    // Hash of the last frame posted by Callback, cleared when the client may not show that frame.
+    std::atomic<bool> hasLastFrameHash { false };
+    uint64_t lastFrameHash = 0;
+    int32_t lastFrameWidth = 0;
+    int32_t lastFrameHeight = 0;
+
+    // The last LoadDocument frame, swapped into the mailbox when it is sent so both buffers are reused.
+    std::vector<uint8_t> loadDocFrame;
+    bool hasLoadDocFrame = false;
     int32_t widthTemp;
     int32_t heightTemp;
     uint64_t timeStampTemp;
@@ -95,6 +206,13 @@ private:
     uint64_t flushEmptyTimeStamp = 0;
     std::chrono::system_clock::time_point flushEmptyTime = std::chrono::system_clock::time_point::min();
     std::chrono::system_clock::time_point onRenderTime = std::chrono::system_clock::time_point::min();
+    std::thread loadDocThread; // started by the first LoadDocument frame
+    std::mutex loadDocMutex;
+    std::condition_variable loadDocCondition;
+    uint64_t loadDocRound = 0; // rounds started, a new one may start before the thread saw the last one end
+    uint64_t finishedLoadDocRound = 0;
+    bool hasLoadDocEvent = false;
+    bool isLoadDocStopping = false;
 };
 
 #endif // VIRTUALSREENIMPL_H
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "JpegEncoder.h"
+#define boolean jpegboolean
+#include "jpeglib.h"
+#undef boolean
+
+namespace {
+    struct Resolution {
+        const char* name;
+        int32_t width;
+        int32_t height;
+    };
+
+    const std::vector<Resolution> RESOLUTIONS = {
+        { "1080p", 1920, 1080 },
+        { "1440p", 2560, 1440 },
+        { "4K", 3840, 2160 },
+    };
+
+    const int32_t RGBX_COMPONENTS = 4;
+    const int32_t QUALITY = 75; // quality VirtualScreen picks for frames above 1080p
+    const double DEFAULT_MIN_SECONDS = 1.0;
+    const double MS_PER_SECOND = 1000.0;
+
+    // How the frame reaches libjpeg: its own color conversion, the YCbCr planes of EncodeRgbx, or those planes
+    // built from the frame scaled to half size on the way.
+    enum class EncodePath { RGBX, RAW, RAW_HALF };
+
+    struct PathInfo {
+        const char* name;
+        EncodePath path;
+    };
+
+    const std::vector<PathInfo> PATHS = {
+        { "rgbx", EncodePath::RGBX },
+        { "raw", EncodePath::RAW },
+        { "raw/2", EncodePath::RAW_HALF },
+    };
+
+    // A UI-like frame: flat panels with gradients and some sharp edged detail.
+    std::vector<uint8_t> MakeFrame(const Resolution& resolution)
+    {
+        const int32_t panelSize = 120;
+        const int32_t detailPeriod = 7;
+        std::vector<uint8_t> frame(static_cast<size_t>(resolution.width) * resolution.height * RGBX_COMPONENTS);
+        for (int32_t y = 0; y < resolution.height; ++y) {
+            for (int32_t x = 0; x < resolution.width; ++x) {
+                uint8_t* pixel = frame.data() + (static_cast<size_t>(y) * resolution.width + x) * RGBX_COMPONENTS;
+                bool isPanel = ((x / panelSize) + (y / panelSize)) % 2 == 0; // 2: checker panels
+                bool isDetail = (x % detailPeriod == 0) && (y % detailPeriod < 3); // 3: short strokes
+                pixel[0] = isDetail ? 0 : static_cast<uint8_t>(isPanel ? 240 : x * 255 / resolution.width);
+                pixel[1] = isDetail ? 0 : static_cast<uint8_t>(isPanel ? 240 : y * 255 / resolution.height);
+                pixel[2] = isDetail ? 0 : static_cast<uint8_t>(isPanel ? 245 : 200); // 2: blue channel
+                pixel[3] = 255; // 3: alpha channel, 255: opaque
+            }
+        }
+        return frame;
+    }
+
+    size_t EncodeFrame(ParallelJpegEncoder& encoder, const std::vector<uint8_t>& frame, const Resolution& resolution,
+                       EncodePath path, std::vector<uint8_t>& output)
+    {
+        JpegImageInfo info;
+        info.width = resolution.width;
+        info.height = resolution.height;
+        info.quality = QUALITY;
+        size_t stride = static_cast<size_t>(resolution.width) * RGBX_COMPONENTS;
+        if (path == EncodePath::RGBX) {
+            info.components = RGBX_COMPONENTS;
+            info.colorSpace = JCS_EXT_RGBX;
+            return encoder.Encode(frame.data(), stride, info, output.data(), output.size());
+        }
+        JpegRgbxSource source;
+        source.data = frame.data();
+        source.stride = stride;
+        source.width = resolution.width;
+        source.height = resolution.height;
+        if (path == EncodePath::RAW_HALF) {
+            info.width /= 2; // 2: half size
+            info.height /= 2; // 2: half size
+        }
+        source.scaledWidth = info.width;
+        source.scaledHeight = info.height;
+        return encoder.EncodeRgbx(source, info, output.data(), output.size());
+    }
+
+    double MeasureMs(ParallelJpegEncoder& encoder, const std::vector<uint8_t>& frame, const Resolution& resolution,
+                     EncodePath path, std::vector<uint8_t>& output, double minSeconds, size_t& size)
+    {
+        size = EncodeFrame(encoder, frame, resolution, path, output);
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0;
+        uint64_t frames = 0;
+        while (elapsed < minSeconds) {
+            EncodeFrame(encoder, frame, resolution, path, output);
+            frames++;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return elapsed * MS_PER_SECOND / frames;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    if (argc > 1 && std::atoi(argv[1]) > 0) {
+        maxThreads = static_cast<uint32_t>(std::atoi(argv[1]));
+    }
+    double minSeconds = argc > 2 ? std::atof(argv[2]) : DEFAULT_MIN_SECONDS;
+    if (minSeconds <= 0) {
+        minSeconds = DEFAULT_MIN_SECONDS;
+    }
+    std::printf("%-6s %-10s %-6s %-8s %10s %8s %8s %10s\n", "name", "resolution", "path", "threads", "ms/frame",
+        "fps", "speedup", "bytes");
+    for (const Resolution& resolution : RESOLUTIONS) {
+        std::vector<uint8_t> frame = MakeFrame(resolution);
+        std::vector<uint8_t> output(frame.size());
+        double baseMs = 0;
+        for (const PathInfo& path : PATHS) {
+            for (uint32_t threads = 1; threads <= maxThreads; ++threads) {
+                ParallelJpegEncoder encoder(threads);
+                size_t size = 0;
+                double ms = MeasureMs(encoder, frame, resolution, path.path, output, minSeconds, size);
+                if (baseMs == 0) {
+                    baseMs = ms; // speedups are against the single threaded rgbx path
+                }
+                std::printf("%-6s %4dx%-5d %-6s %-8u %10.2f %8.1f %7.2fx %10zu\n", resolution.name,
+                    resolution.width, resolution.height, path.name, threads, ms, MS_PER_SECOND / ms, baseMs / ms,
+                    size);
+            }
+        }
+    }
+    return 0;
+}
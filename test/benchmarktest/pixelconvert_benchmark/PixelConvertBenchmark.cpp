@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "PixelConvert.h"
+
+namespace {
+    struct DeviceResolution {
+        const char* device;
+        int32_t width;
+        int32_t height;
+    };
+
+    // Default screen of every device type accepted by CommandParser's -device argument.
+    const std::vector<DeviceResolution> DEVICES = {
+        { "liteWearable", 454, 454 },
+        { "smartVision", 960, 480 },
+        { "wearable", 466, 466 },
+        { "tv", 1920, 1080 },
+        { "phone", 1080, 2340 },
+        { "tablet", 2560, 1600 },
+        { "car", 1920, 1080 },
+        { "2in1", 2560, 1600 },
+        { "default", 1080, 2340 },
+    };
+
+    const std::vector<PixelConvert::Kernel> KERNELS = {
+        PixelConvert::Kernel::SCALAR,
+        PixelConvert::Kernel::SSSE3,
+        PixelConvert::Kernel::AVX2,
+        PixelConvert::Kernel::NEON,
+    };
+
+    using ConvertFunc = void (*)(const uint8_t*, size_t, uint8_t*, size_t, int32_t, int32_t);
+
+    struct Conversion {
+        const char* name;
+        ConvertFunc func;
+        size_t dstPixelSize;
+        bool usesKernel;
+    };
+
+    const std::vector<Conversion> CONVERSIONS = {
+        { "RgbaToRgb", PixelConvert::RgbaToRgb, 3, true },
+        { "BgraToRgb", PixelConvert::BgraToRgb, 3, true },
+        { "CopyRgba", PixelConvert::CopyRgba, 4, false },
+    };
+
+    const size_t SRC_PIXEL_SIZE = 4;
+    const double DEFAULT_MIN_SECONDS = 0.2;
+    const double BYTES_PER_GB = 1e9;
+
+    // Throughput is counted in source bytes, the number the send path has to read every frame.
+    double Measure(const Conversion& conversion, const DeviceResolution& resolution, double minSeconds)
+    {
+        size_t pixels = static_cast<size_t>(resolution.width) * resolution.height;
+        std::vector<uint8_t> src(pixels * SRC_PIXEL_SIZE);
+        std::vector<uint8_t> dst(pixels * conversion.dstPixelSize);
+        for (size_t i = 0; i < src.size(); ++i) {
+            src[i] = static_cast<uint8_t>(i);
+        }
+        size_t srcStride = resolution.width * SRC_PIXEL_SIZE;
+        size_t dstStride = resolution.width * conversion.dstPixelSize;
+        conversion.func(src.data(), srcStride, dst.data(), dstStride, resolution.width, resolution.height);
+
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0;
+        uint64_t frames = 0;
+        while (elapsed < minSeconds) {
+            conversion.func(src.data(), srcStride, dst.data(), dstStride, resolution.width, resolution.height);
+            frames++;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return static_cast<double>(src.size()) * frames / elapsed / BYTES_PER_GB;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    double minSeconds = argc > 1 ? std::atof(argv[1]) : DEFAULT_MIN_SECONDS;
+    if (minSeconds <= 0) {
+        minSeconds = DEFAULT_MIN_SECONDS;
+    }
+    std::printf("%-14s %-11s %-10s %-8s %10s\n", "device", "resolution", "conversion", "kernel", "GB/s");
+    for (const DeviceResolution& resolution : DEVICES) {
+        std::string size = std::to_string(resolution.width) + "x" + std::to_string(resolution.height);
+        for (const Conversion& conversion : CONVERSIONS) {
+            for (PixelConvert::Kernel kernel : KERNELS) {
+                if (!PixelConvert::IsKernelSupported(kernel)) {
+                    continue;
+                }
+                PixelConvert::SetKernel(kernel);
+                double rate = Measure(conversion, resolution, minSeconds);
+                std::printf("%-14s %-11s %-10s %-8s %10.2f\n", resolution.device, size.c_str(), conversion.name,
+                    conversion.usesKernel ? PixelConvert::GetKernelName(kernel) : "copy", rate);
+                if (!conversion.usesKernel) {
+                    break;
+                }
+            }
+        }
+    }
+    return 0;
+}
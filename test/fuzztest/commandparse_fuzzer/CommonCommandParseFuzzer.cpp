@@ -37,6 +37,8 @@ std::map<std::string, std::string> commonDataMap = {
     {"LoadContent", ""},
     {"UnsupportedCommond", ""},
     {"KeyPress", R"({"isInputMethod":true,"codePoint":33})"},
+    {"AdaptiveQuality", R"({"enable":true,"latency":50,"bandwidth":2048,"maxQuality":90})"},
+    {"FrameRate", R"({"fps":30})"},
 };
 
 TEST(CommonCommandParseFuzzTest, test_command)
@@ -52,7 +52,13 @@ std::map<std::string, std::string> richDataMap = {
     {"AvoidArea", R"({"topRect":{"posX":0,"posY":0,"width":2340,"height":117},"bottomRect":{"posX":
         0,"posY":0,"width":0,"height":0},"leftRect":{"posX":0,"posY":0,"width":0,"height":0},
         "rightRect":{"posX":0,"posY":0,"width":2340,"height":84}})"},
-    {"AvoidAreaChanged", ""}
+    {"AvoidAreaChanged", ""},
+    {"FrameCodec", R"({"codec":"auto"})"},
+    {"FrameDelta", R"({"enable":true,"keyframeInterval":120})"},
+    {"ProgressiveQuality", R"({"enable":true,"motionQuality":60,"refineQuality":100,"idleMs":300})"},
+    {"Viewport", R"({"x":0,"y":0,"width":540,"height":1170,"scale":0.5})"},
+    {"Screenshot", R"({"format":"png","next":false,"stableFrames":1,"timeout":1})"},
+    {"TileCache", R"({"enable":true,"capacity":2048})"}
 };
 
 TEST(RichCommandParseFuzzTest, test_command)
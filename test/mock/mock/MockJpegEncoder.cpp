@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JpegEncoder.h"
+
+struct JpegEncoderContext {};
+
+JpegEncoder::JpegEncoder() {}
+JpegEncoder::~JpegEncoder() {}
+
+size_t JpegEncoder::Encode(const uint8_t* data, size_t stride, const JpegImageInfo& info, uint8_t* dst,
+                           size_t capacity)
+{
+    return 0;
+}
+
+size_t JpegEncoder::EncodeRgbx(const JpegRgbxSource& source, const JpegImageInfo& info, uint8_t* dst,
+                               size_t capacity)
+{
+    return 0;
+}
+
+uint32_t JpegEncoder::GetSetupCount() const
+{
+    return setupCount;
+}
+
+ParallelJpegEncoder::ParallelJpegEncoder(uint32_t threadCount) {}
+ParallelJpegEncoder::~ParallelJpegEncoder() {}
+
+size_t ParallelJpegEncoder::Encode(const uint8_t* data, size_t stride, const JpegImageInfo& info, uint8_t* dst,
+                                   size_t capacity)
+{
+    return 0;
+}
+
+size_t ParallelJpegEncoder::EncodeRgbx(const JpegRgbxSource& source, const JpegImageInfo& info, uint8_t* dst,
+                                       size_t capacity)
+{
+    return 0;
+}
+
+uint32_t ParallelJpegEncoder::GetThreadCount() const
+{
+    return static_cast<uint32_t>(strips.size());
+}
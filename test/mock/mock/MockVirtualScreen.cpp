@@ -64,6 +64,89 @@ void VirtualScreen::SetDropFrameFrequency(const int32_t& value)
     dropFrameFrequency = value;
 }
 
+void VirtualScreen::SetAdaptiveQuality(const AdaptiveQualityConfig& config)
+{
+    adaptiveQuality.Configure(config);
+}
+
+AdaptiveQualityConfig VirtualScreen::GetAdaptiveQuality() const
+{
+    return adaptiveQuality.GetConfig();
+}
+
+bool VirtualScreen::SetFrameCodec(const std::string& name)
+{
+    return frameCodecSelector.SetCodec(name);
+}
+
+std::string VirtualScreen::GetFrameCodec() const
+{
+    return frameCodecSelector.GetCodecName();
+}
+
+void VirtualScreen::SetFrameDelta(bool enable, uint32_t keyframeInterval)
+{
+    frameDelta.Configure(enable, keyframeInterval);
+}
+
+bool VirtualScreen::IsFrameDeltaEnabled() const
+{
+    return frameDelta.IsEnabled();
+}
+
+uint32_t VirtualScreen::GetKeyframeInterval() const
+{
+    return frameDelta.GetKeyframeInterval();
+}
+
+void VirtualScreen::SetProgressiveQuality(const ProgressiveQualityConfig& config)
+{
+    progressiveQuality.Configure(config);
+}
+
+ProgressiveQualityConfig VirtualScreen::GetProgressiveQuality() const
+{
+    return progressiveQuality.GetConfig();
+}
+
+void VirtualScreen::SetTargetFps(int32_t fps)
+{
+    framePacer.SetTargetFps(fps);
+}
+
+int32_t VirtualScreen::GetTargetFps() const
+{
+    return framePacer.GetTargetFps();
+}
+
+void VirtualScreen::SetViewport(const FrameViewport& value)
+{
+    std::lock_guard<std::mutex> guard(viewportMutex);
+    viewport = value;
+}
+
+FrameViewport VirtualScreen::GetViewport() const
+{
+    std::lock_guard<std::mutex> guard(viewportMutex);
+    return viewport;
+}
+
+void VirtualScreen::SetInputMapping(const FrameViewport& shown, const InputMapping& value)
+{
+    std::lock_guard<std::mutex> guard(viewportMutex);
+    bool isShown = shown.IsSet() ? shown == viewport : !viewport.IsSet();
+    if (isShown) {
+        inputMapping = value;
+    }
+}
+
+void VirtualScreen::MapInputPosition(double& x, double& y) const
+{
+    std::lock_guard<std::mutex> guard(viewportMutex);
+    x = x * inputMapping.scaleX + inputMapping.offsetX;
+    y = y * inputMapping.scaleY + inputMapping.offsetY;
+}
+
 std::string VirtualScreen::GetFoldStatus() const
 {
     g_getFoldStatus = true;
@@ -57,3 +57,42 @@ ScreenInfo VirtualScreenImpl::GetScreenInfo()
 }
 
 void VirtualScreenImpl::InitFoldParams() {}
+
+void VirtualScreenImpl::ResendLastFrame() {}
+
+bool VirtualScreenImpl::CaptureFrame(bool isNext, uint32_t stableFrames, std::chrono::milliseconds timeout,
+                                     CapturedFrame& frame)
+{
+    frame.width = 2; // 2: a 2 x 2 frame
+    frame.height = 2; // 2: a 2 x 2 frame
+    frame.pixels.assign(frame.width * frame.height * 4, 0xFF); // 4 bytes per pixel
+    return true;
+}
+
+void VirtualScreenImpl::SetTileCache(bool enable, uint32_t capacity)
+{
+    tileCache.Configure(enable, capacity);
+}
+
+bool VirtualScreenImpl::IsTileCacheEnabled() const
+{
+    return tileCache.IsEnabled();
+}
+
+uint32_t VirtualScreenImpl::GetTileCacheCapacity() const
+{
+    return tileCache.GetCapacity();
+}
+
+void VirtualScreenImpl::SaveConfigFrame(const FrameConfig& config) {}
+
+bool VirtualScreenImpl::ShowConfigFrame(const FrameConfig& config)
+{
+    return false;
+}
+
+void VirtualScreenImpl::InvalidateConfigFrames() {}
+
+void VirtualScreenImpl::SaveLastFrame() {}
+
+void VirtualScreenImpl::StopSavingLastFrame() {}
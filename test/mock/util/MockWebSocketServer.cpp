@@ -13,17 +13,22 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <atomic>
 #include "WebSocketServer.h"
 #include "MockGlobalResult.h"
 
-lws* WebSocketServer::webSocket = nullptr;
 std::atomic<bool> WebSocketServer::interrupted = false;
-WebSocketServer::WebSocketState WebSocketServer::webSocketWritable = WebSocketState::INIT;
-uint8_t* WebSocketServer::firstImageBuffer = nullptr;
-uint64_t WebSocketServer::firstImagebufferSize = 0;
+std::shared_ptr<SendPacket> WebSocketServer::firstImage;
+std::vector<std::shared_ptr<SendPacket>> WebSocketServer::regionImages;
+std::vector<std::shared_ptr<SendPacket>> WebSocketServer::variantImages;
+std::atomic<uint32_t> WebSocketServer::connectionCount = 0;
 
-WebSocketServer::WebSocketServer() : serverThread(nullptr), serverPort(0) {}
+WebSocketServer::WebSocketServer()
+    : serverThread(nullptr), serverPort(0),
+      router([this](int32_t variant) { return GetLastImagePackets(variant); })
+{
+}
 
 WebSocketServer::~WebSocketServer() {}
 
@@ -43,6 +48,11 @@ void WebSocketServer::SetSid(const std::string curSid)
     sid = curSid;
 }
 
+void WebSocketServer::SetVariantCount(int32_t count)
+{
+    variantCount = count;
+}
+
 int WebSocketServer::ProtocolCallback(struct lws* wsi,
                                       enum lws_callback_reasons reason,
                                       void* user,
@@ -64,8 +74,86 @@ void WebSocketServer::Run()
     g_run = true;
 }
 
-size_t WebSocketServer::WriteData(unsigned char* data, size_t length)
+std::vector<std::shared_ptr<SendPacket>> WebSocketServer::GetLastImagePackets(int32_t variant)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    return ClientRouter::SelectBackups(variant, firstImage, regionImages, variantImages);
+}
+
+bool WebSocketServer::AddClient(struct lws* wsi, int32_t variant, const std::string& name)
+{
+    if (!router.Add(wsi, variant, name)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(clientsMutex);
+    connectionCount++;
+    if (connectHandler) {
+        connectHandler();
+    }
+    return true;
+}
+
+void WebSocketServer::RemoveClient(struct lws* wsi)
 {
+    router.Remove(wsi);
+}
+
+std::shared_ptr<SendPacket> WebSocketServer::MakePacket(const uint8_t* data, size_t length)
+{
+    return SendPacket::Copy(data, length, 0);
+}
+
+size_t WebSocketServer::WriteData(unsigned char* data, size_t length, int32_t variant,
+                                  const FrameViewport& viewport)
+{
+    return WriteData(MakePacket(data, length), variant, viewport);
+}
+
+size_t WebSocketServer::WriteData(const std::shared_ptr<SendPacket>& packet, int32_t variant,
+                                  const FrameViewport& viewport)
+{
+    // The tests read what a client got from its queue.
+    if (router.Route(packet, variant, viewport) == 0) {
+        return 0;
+    }
     g_writeData = true;
-    return length;
+    return packet->GetSize();
+}
+
+bool WebSocketServer::HasClients()
+{
+    return router.GetCount() > 0;
+}
+
+bool WebSocketServer::HasClient(int32_t variant)
+{
+    return router.HasClient(variant);
+}
+
+void WebSocketServer::SetViewport(const std::string& name, const FrameViewport& viewport)
+{
+    if (router.SetViewport(name, viewport)) {
+        connectionCount++;
+    }
+}
+
+std::vector<FrameViewport> WebSocketServer::GetViewports()
+{
+    return router.GetViewports();
+}
+
+void WebSocketServer::SetConnectHandler(std::function<void()> handler)
+{
+    std::lock_guard<std::mutex> guard(clientsMutex);
+    connectHandler = std::move(handler);
+}
+
+bool WebSocketServer::WaitForClient(std::chrono::milliseconds timeout)
+{
+    return router.GetCount() > 0;
+}
+
+int64_t WebSocketServer::TakeDrainUs()
+{
+    return 0;
 }
\ No newline at end of file
@@ -13,6 +13,8 @@
  * limitations under the License.
  */
 #include <string>
+#include <cstdio>
+#include <fstream>
 #include <map>
 #include "gtest/gtest.h"
 #define private public
@@ -468,6 +470,272 @@ namespace {
         EXPECT_EQ(VirtualScreenImpl::GetInstance().dropFrameFrequency, 0);
     }
 
+    TEST_F(CommandLineTest, AdaptiveQualityCommandTest)
+    {
+        VirtualScreenImpl::GetInstance().SetAdaptiveQuality(AdaptiveQualityConfig());
+        CommandLine::CommandType type = CommandLine::CommandType::SET;
+        std::string msg = R"({"enable" : true, "latency" : 50, "bandwidth" : 2048, "maxQuality" : 90})";
+        Json2::Value args1 = JsonReader::ParseJsonData2(msg);
+        AdaptiveQualityCommand command1(type, args1, *socket);
+        command1.CheckAndRun();
+        AdaptiveQualityConfig config = VirtualScreenImpl::GetInstance().GetAdaptiveQuality();
+        EXPECT_TRUE(config.enabled);
+        EXPECT_EQ(config.latencyBudgetMs, 50); // set value is 50
+        EXPECT_EQ(config.bandwidthBytesPerSecond, 2048 * 1024); // 2048KB/s
+        EXPECT_EQ(config.maxQuality, 90); // set value is 90
+        // 只关闭时保留其他预算
+        std::string msg2 = R"({"enable" : false})";
+        Json2::Value args2 = JsonReader::ParseJsonData2(msg2);
+        AdaptiveQualityCommand command2(type, args2, *socket);
+        command2.CheckAndRun();
+        config = VirtualScreenImpl::GetInstance().GetAdaptiveQuality();
+        EXPECT_FALSE(config.enabled);
+        EXPECT_EQ(config.latencyBudgetMs, 50); // set value is 50
+        // 质量上限超出范围
+        std::string msg3 = R"({"enable" : true, "maxQuality" : 101})";
+        Json2::Value args3 = JsonReader::ParseJsonData2(msg3);
+        AdaptiveQualityCommand command3(type, args3, *socket);
+        command3.CheckAndRun();
+        EXPECT_FALSE(VirtualScreenImpl::GetInstance().GetAdaptiveQuality().enabled);
+        // 参数类型错误
+        std::string msg4 = R"({"enable" : "aaa"})";
+        Json2::Value args4 = JsonReader::ParseJsonData2(msg4);
+        AdaptiveQualityCommand command4(type, args4, *socket);
+        command4.CheckAndRun();
+        EXPECT_FALSE(VirtualScreenImpl::GetInstance().GetAdaptiveQuality().enabled);
+    }
+
+    TEST_F(CommandLineTest, FrameRateCommandTest)
+    {
+        VirtualScreenImpl::GetInstance().SetTargetFps(0);
+        CommandLine::CommandType type = CommandLine::CommandType::SET;
+        std::string msg = R"({"fps" : 30})";
+        Json2::Value args1 = JsonReader::ParseJsonData2(msg);
+        FrameRateCommand command1(type, args1, *socket);
+        command1.CheckAndRun();
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().GetTargetFps(), 30); // set value is 30
+        // 帧率超出范围
+        std::string msg2 = R"({"fps" : 1000})";
+        Json2::Value args2 = JsonReader::ParseJsonData2(msg2);
+        FrameRateCommand command2(type, args2, *socket);
+        command2.CheckAndRun();
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().GetTargetFps(), 30); // set value is 30
+        // 参数类型错误
+        std::string msg3 = R"({"fps" : "aaa"})";
+        Json2::Value args3 = JsonReader::ParseJsonData2(msg3);
+        FrameRateCommand command3(type, args3, *socket);
+        command3.CheckAndRun();
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().GetTargetFps(), 30); // set value is 30
+        VirtualScreenImpl::GetInstance().SetTargetFps(0);
+    }
+
+    TEST_F(CommandLineTest, FrameCodecCommandTest)
+    {
+        CommandLine::CommandType type = CommandLine::CommandType::SET;
+        std::string msg = R"({"codec" : "lz4"})";
+        Json2::Value args1 = JsonReader::ParseJsonData2(msg);
+        FrameCodecCommand command1(type, args1, *socket);
+        command1.CheckAndRun();
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().GetFrameCodec(), "lz4");
+        // 不支持的编解码器保持原设置
+        std::string msg2 = R"({"codec" : "zstd"})";
+        Json2::Value args2 = JsonReader::ParseJsonData2(msg2);
+        FrameCodecCommand command2(type, args2, *socket);
+        command2.CheckAndRun();
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().GetFrameCodec(), "lz4");
+        // 参数类型错误
+        std::string msg3 = R"({"codec" : 1})";
+        Json2::Value args3 = JsonReader::ParseJsonData2(msg3);
+        FrameCodecCommand command3(type, args3, *socket);
+        command3.CheckAndRun();
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().GetFrameCodec(), "lz4");
+        VirtualScreenImpl::GetInstance().SetFrameCodec("default");
+    }
+
+    TEST_F(CommandLineTest, FrameDeltaCommandTest)
+    {
+        CommandLine::CommandType type = CommandLine::CommandType::SET;
+        std::string msg = R"({"enable" : true, "keyframeInterval" : 30})";
+        Json2::Value args1 = JsonReader::ParseJsonData2(msg);
+        FrameDeltaCommand command1(type, args1, *socket);
+        command1.CheckAndRun();
+        EXPECT_TRUE(VirtualScreenImpl::GetInstance().IsFrameDeltaEnabled());
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().GetKeyframeInterval(), 30); // set value is 30
+        // 关键帧间隔超出范围
+        std::string msg2 = R"({"enable" : false, "keyframeInterval" : 0})";
+        Json2::Value args2 = JsonReader::ParseJsonData2(msg2);
+        FrameDeltaCommand command2(type, args2, *socket);
+        command2.CheckAndRun();
+        EXPECT_TRUE(VirtualScreenImpl::GetInstance().IsFrameDeltaEnabled());
+        // 只关闭时保留关键帧间隔
+        std::string msg3 = R"({"enable" : false})";
+        Json2::Value args3 = JsonReader::ParseJsonData2(msg3);
+        FrameDeltaCommand command3(type, args3, *socket);
+        command3.CheckAndRun();
+        EXPECT_FALSE(VirtualScreenImpl::GetInstance().IsFrameDeltaEnabled());
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().GetKeyframeInterval(), 30); // set value is 30
+    }
+
+    TEST_F(CommandLineTest, ProgressiveQualityCommandTest)
+    {
+        VirtualScreenImpl::GetInstance().SetProgressiveQuality(ProgressiveQualityConfig());
+        CommandLine::CommandType type = CommandLine::CommandType::SET;
+        std::string msg = R"({"enable" : true, "motionQuality" : 50, "refineQuality" : 95, "idleMs" : 500})";
+        Json2::Value args1 = JsonReader::ParseJsonData2(msg);
+        ProgressiveQualityCommand command1(type, args1, *socket);
+        command1.CheckAndRun();
+        ProgressiveQualityConfig config = VirtualScreenImpl::GetInstance().GetProgressiveQuality();
+        EXPECT_TRUE(config.enabled);
+        EXPECT_EQ(config.motionQuality, 50); // set value is 50
+        EXPECT_EQ(config.refineQuality, 95); // set value is 95
+        EXPECT_EQ(config.idleMs, 500); // set value is 500
+        // 只关闭时保留其他参数
+        std::string msg2 = R"({"enable" : false})";
+        Json2::Value args2 = JsonReader::ParseJsonData2(msg2);
+        ProgressiveQualityCommand command2(type, args2, *socket);
+        command2.CheckAndRun();
+        config = VirtualScreenImpl::GetInstance().GetProgressiveQuality();
+        EXPECT_FALSE(config.enabled);
+        EXPECT_EQ(config.idleMs, 500); // set value is 500
+        // 空闲时间超出范围
+        std::string msg3 = R"({"enable" : true, "idleMs" : 0})";
+        Json2::Value args3 = JsonReader::ParseJsonData2(msg3);
+        ProgressiveQualityCommand command3(type, args3, *socket);
+        command3.CheckAndRun();
+        EXPECT_FALSE(VirtualScreenImpl::GetInstance().GetProgressiveQuality().enabled);
+        // 参数类型错误
+        std::string msg4 = R"({"enable" : true, "motionQuality" : "aaa"})";
+        Json2::Value args4 = JsonReader::ParseJsonData2(msg4);
+        ProgressiveQualityCommand command4(type, args4, *socket);
+        command4.CheckAndRun();
+        EXPECT_FALSE(VirtualScreenImpl::GetInstance().GetProgressiveQuality().enabled);
+    }
+
+    TEST_F(CommandLineTest, ViewportCommandTest)
+    {
+        VirtualScreenImpl::GetInstance().SetViewport(FrameViewport());
+        CommandLine::CommandType type = CommandLine::CommandType::SET;
+        std::string msg = R"({"x" : 100, "y" : 200, "width" : 540, "height" : 1170, "scale" : 0.5})";
+        Json2::Value args1 = JsonReader::ParseJsonData2(msg);
+        ViewportCommand command1(type, args1, *socket);
+        command1.CheckAndRun();
+        FrameViewport viewport = VirtualScreenImpl::GetInstance().GetViewport();
+        EXPECT_EQ(viewport.x, 100); // set value is 100
+        EXPECT_EQ(viewport.y, 200); // set value is 200
+        EXPECT_EQ(viewport.width, 540); // set value is 540
+        EXPECT_EQ(viewport.height, 1170); // set value is 1170
+        EXPECT_DOUBLE_EQ(viewport.scale, 0.5); // set value is 0.5
+        // 缩放比例超出范围
+        std::string msg2 = R"({"x" : 0, "y" : 0, "width" : 100, "height" : 100, "scale" : 2})";
+        Json2::Value args2 = JsonReader::ParseJsonData2(msg2);
+        ViewportCommand command2(type, args2, *socket);
+        command2.CheckAndRun();
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().GetViewport().width, 540); // set value is 540
+        // 缺少参数
+        std::string msg3 = R"({"x" : 0, "y" : 0, "width" : 100})";
+        Json2::Value args3 = JsonReader::ParseJsonData2(msg3);
+        ViewportCommand command3(type, args3, *socket);
+        command3.CheckAndRun();
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().GetViewport().width, 540); // set value is 540
+        // 宽高为 0 时恢复发送整帧
+        std::string msg4 = R"({"x" : 0, "y" : 0, "width" : 0, "height" : 0})";
+        Json2::Value args4 = JsonReader::ParseJsonData2(msg4);
+        ViewportCommand command4(type, args4, *socket);
+        command4.CheckAndRun();
+        viewport = VirtualScreenImpl::GetInstance().GetViewport();
+        EXPECT_EQ(viewport.width, 0);
+        EXPECT_DOUBLE_EQ(viewport.scale, 1.0); // 1.0: 默认不缩放
+        // 只设置指定客户端的视口
+        std::string msg5 = R"({"x" : 0, "y" : 0, "width" : 100, "height" : 100, "client" : "zoom"})";
+        Json2::Value args5 = JsonReader::ParseJsonData2(msg5);
+        ViewportCommand command5(type, args5, *socket);
+        command5.CheckAndRun();
+        EXPECT_EQ(WebSocketServer::GetInstance().router.namedViewports["zoom"].width, 100); // set value is 100
+        EXPECT_EQ(WebSocketServer::GetInstance().router.defaultViewport.width, 0);
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().GetViewport().width, 0); // 输入坐标不经过指定客户端的视口
+        // 客户端名称类型错误
+        std::string msg6 = R"({"x" : 0, "y" : 0, "width" : 200, "height" : 200, "client" : 1})";
+        Json2::Value args6 = JsonReader::ParseJsonData2(msg6);
+        ViewportCommand command6(type, args6, *socket);
+        command6.CheckAndRun();
+        EXPECT_EQ(WebSocketServer::GetInstance().router.namedViewports["zoom"].width, 100); // set value is 100
+        WebSocketServer::GetInstance().SetViewport("", FrameViewport());
+        VirtualScreenImpl::GetInstance().SetViewport(FrameViewport());
+    }
+
+    TEST_F(CommandLineTest, ScreenshotCommandTest)
+    {
+        CommandLine::CommandType type = CommandLine::CommandType::ACTION;
+        // 写入 png 文件
+        std::string path = "screenshot_test.png";
+        std::string msg = R"({"format" : "png", "path" : "screenshot_test.png", "stableFrames" : 2})";
+        Json2::Value args1 = JsonReader::ParseJsonData2(msg);
+        ScreenshotCommand command1(type, args1, *socket);
+        EXPECT_TRUE(command1.IsActionArgValid());
+        command1.RunAction();
+        EXPECT_EQ(command1.commandResult["result"]["width"].AsInt(), 2); // 2: 模拟帧的宽度
+        EXPECT_EQ(command1.commandResult["result"]["path"].AsString(), path);
+        std::ifstream file(path, std::ios::binary);
+        char signature[4] = { 0 }; // 4: 签名的前四个字节
+        file.read(signature, sizeof(signature));
+        EXPECT_EQ(std::string(signature + 1, 3), "PNG"); // 3: PNG 三个字母
+        file.close();
+        std::remove(path.c_str());
+        // 不给路径时以 base64 返回原始 RGBA
+        std::string msg2 = R"({"format" : "rgba", "next" : true})";
+        Json2::Value args2 = JsonReader::ParseJsonData2(msg2);
+        ScreenshotCommand command2(type, args2, *socket);
+        command2.RunAction();
+        EXPECT_EQ(command2.commandResult["result"]["size"].AsInt(), 16); // 16: 2 x 2 x 4 字节
+        EXPECT_EQ(command2.commandResult["result"]["data"].AsString(), "/////////////////////w==");
+        // 格式和帧数不合法
+        std::string msg3 = R"({"format" : "bmp"})";
+        Json2::Value args3 = JsonReader::ParseJsonData2(msg3);
+        ScreenshotCommand command3(type, args3, *socket);
+        EXPECT_FALSE(command3.IsActionArgValid());
+        std::string msg4 = R"({"format" : "png", "stableFrames" : 0})";
+        Json2::Value args4 = JsonReader::ParseJsonData2(msg4);
+        ScreenshotCommand command4(type, args4, *socket);
+        EXPECT_FALSE(command4.IsActionArgValid());
+        std::string msg5 = R"({"format" : "png", "timeout" : 20000})";
+        Json2::Value args5 = JsonReader::ParseJsonData2(msg5);
+        ScreenshotCommand command5(type, args5, *socket);
+        EXPECT_FALSE(command5.IsActionArgValid());
+        // 路径所在目录不存在
+        std::string msg6 = R"({"format" : "png", "path" : "screenshot_no_such_dir/screenshot_test.png"})";
+        Json2::Value args6 = JsonReader::ParseJsonData2(msg6);
+        ScreenshotCommand command6(type, args6, *socket);
+        EXPECT_FALSE(command6.IsActionArgValid());
+        std::string msg7 = R"({"format" : "png", "path" : "./"})";
+        Json2::Value args7 = JsonReader::ParseJsonData2(msg7);
+        ScreenshotCommand command7(type, args7, *socket);
+        EXPECT_FALSE(command7.IsActionArgValid());
+    }
+
+    TEST_F(CommandLineTest, TileCacheCommandTest)
+    {
+        CommandLine::CommandType type = CommandLine::CommandType::SET;
+        std::string msg = R"({"enable" : true, "capacity" : 1024})";
+        Json2::Value args1 = JsonReader::ParseJsonData2(msg);
+        TileCacheCommand command1(type, args1, *socket);
+        command1.CheckAndRun();
+        EXPECT_TRUE(VirtualScreenImpl::GetInstance().IsTileCacheEnabled());
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().GetTileCacheCapacity(), 1024); // set value is 1024
+        // 容量超出范围
+        std::string msg2 = R"({"enable" : false, "capacity" : 1})";
+        Json2::Value args2 = JsonReader::ParseJsonData2(msg2);
+        TileCacheCommand command2(type, args2, *socket);
+        command2.CheckAndRun();
+        EXPECT_TRUE(VirtualScreenImpl::GetInstance().IsTileCacheEnabled());
+        // 只关闭时保留容量
+        std::string msg3 = R"({"enable" : false})";
+        Json2::Value args3 = JsonReader::ParseJsonData2(msg3);
+        TileCacheCommand command3(type, args3, *socket);
+        command3.CheckAndRun();
+        EXPECT_FALSE(VirtualScreenImpl::GetInstance().IsTileCacheEnabled());
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().GetTileCacheCapacity(), 1024); // set value is 1024
+    }
+
     TEST_F(CommandLineTest, KeyPressCommandImeTest)
     {
         CommandLine::CommandType type = CommandLine::CommandType::ACTION;
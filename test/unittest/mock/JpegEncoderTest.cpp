@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "gtest/gtest.h"
+#include "JpegEncoder.h"
+#define boolean jpegboolean
+#include "jpeglib.h"
+#undef boolean
+
+namespace {
+    const int32_t WIDTH = 64;
+    const int32_t HEIGHT = 48;
+    const int32_t RGB_COMPONENTS = 3;
+    const int32_t RGBX_COMPONENTS = 4;
+    const int32_t QUALITY = 90;
+    const uint8_t SOI_FIRST = 0xFF;
+    const uint8_t SOI_SECOND = 0xD8;
+
+    JpegImageInfo MakeInfo()
+    {
+        JpegImageInfo info;
+        info.width = WIDTH;
+        info.height = HEIGHT;
+        info.components = RGB_COMPONENTS;
+        info.colorSpace = JCS_RGB;
+        info.quality = QUALITY;
+        return info;
+    }
+
+    std::vector<uint8_t> MakeImage()
+    {
+        std::vector<uint8_t> image(WIDTH * HEIGHT * RGB_COMPONENTS);
+        for (size_t i = 0; i < image.size(); ++i) {
+            image[i] = static_cast<uint8_t>(i % 251); // 251: arbitrary pattern
+        }
+        return image;
+    }
+
+    std::vector<uint8_t> Decode(std::vector<uint8_t>& jpeg, size_t size, int32_t& width, int32_t& height)
+    {
+        jpeg_decompress_struct cinfo;
+        jpeg_error_mgr jerr;
+        cinfo.err = jpeg_std_error(&jerr);
+        jpeg_create_decompress(&cinfo);
+        jpeg_mem_src(&cinfo, jpeg.data(), size);
+        jpeg_read_header(&cinfo, TRUE);
+        jpeg_start_decompress(&cinfo);
+        width = static_cast<int32_t>(cinfo.output_width);
+        height = static_cast<int32_t>(cinfo.output_height);
+        size_t rowSize = cinfo.output_width * cinfo.output_components;
+        std::vector<uint8_t> pixels(rowSize * cinfo.output_height);
+        while (cinfo.output_scanline < cinfo.output_height) {
+            JSAMPROW row = pixels.data() + cinfo.output_scanline * rowSize;
+            jpeg_read_scanlines(&cinfo, &row, 1);
+        }
+        jpeg_finish_decompress(&cinfo);
+        jpeg_destroy_decompress(&cinfo);
+        return pixels;
+    }
+
+    TEST(JpegEncoderTest, EncodeReuseTablesTest)
+    {
+        // 测试连续编码相同尺寸时只初始化一次编码参数，且输出一致
+        JpegEncoder encoder;
+        std::vector<uint8_t> image = MakeImage();
+        std::vector<uint8_t> first(image.size() * 2);
+        std::vector<uint8_t> second(image.size() * 2);
+        size_t firstSize = encoder.Encode(image.data(), WIDTH * RGB_COMPONENTS, MakeInfo(), first.data(),
+            first.size());
+        size_t secondSize = encoder.Encode(image.data(), WIDTH * RGB_COMPONENTS, MakeInfo(), second.data(),
+            second.size());
+        EXPECT_GT(firstSize, 0);
+        EXPECT_EQ(firstSize, secondSize);
+        EXPECT_EQ(first, second);
+        EXPECT_EQ(first[0], SOI_FIRST);
+        EXPECT_EQ(first[1], SOI_SECOND);
+        EXPECT_EQ(encoder.GetSetupCount(), 1);
+        // 质量变化时重新初始化
+        JpegImageInfo info = MakeInfo();
+        info.quality = QUALITY - 1;
+        EXPECT_GT(encoder.Encode(image.data(), WIDTH * RGB_COMPONENTS, info, first.data(), first.size()), 0);
+        EXPECT_EQ(encoder.GetSetupCount(), 2);
+    }
+
+    TEST(JpegEncoderTest, EncodeOverflowTest)
+    {
+        // 测试目标缓冲区不足时返回 0，且之后仍可正常编码
+        JpegEncoder encoder;
+        std::vector<uint8_t> image = MakeImage();
+        std::vector<uint8_t> small(16);
+        EXPECT_EQ(encoder.Encode(image.data(), WIDTH * RGB_COMPONENTS, MakeInfo(), small.data(), small.size()), 0);
+        std::vector<uint8_t> dst(image.size() * 2);
+        EXPECT_GT(encoder.Encode(image.data(), WIDTH * RGB_COMPONENTS, MakeInfo(), dst.data(), dst.size()), 0);
+    }
+
+    TEST(JpegEncoderTest, EncodeInvalidArgsTest)
+    {
+        // 测试非法参数
+        JpegEncoder encoder;
+        std::vector<uint8_t> image = MakeImage();
+        std::vector<uint8_t> dst(image.size());
+        EXPECT_EQ(encoder.Encode(nullptr, WIDTH * RGB_COMPONENTS, MakeInfo(), dst.data(), dst.size()), 0);
+        EXPECT_EQ(encoder.Encode(image.data(), WIDTH * RGB_COMPONENTS, MakeInfo(), nullptr, dst.size()), 0);
+        JpegImageInfo info = MakeInfo();
+        info.width = 0;
+        EXPECT_EQ(encoder.Encode(image.data(), WIDTH * RGB_COMPONENTS, info, dst.data(), dst.size()), 0);
+    }
+
+    std::vector<uint8_t> MakeRgbxImage(int32_t width, int32_t height)
+    {
+        std::vector<uint8_t> image(static_cast<size_t>(width) * height * RGBX_COMPONENTS);
+        for (int32_t y = 0; y < height; ++y) {
+            for (int32_t x = 0; x < width; ++x) {
+                uint8_t* pixel = image.data() + (y * width + x) * RGBX_COMPONENTS;
+                pixel[0] = static_cast<uint8_t>(x * 4); // 4: 水平渐变
+                pixel[1] = static_cast<uint8_t>(y * 3); // 3: 垂直渐变
+                pixel[2] = static_cast<uint8_t>((x / 8 + y / 8) % 2 ? 200 : 40); // 2: 蓝色, 8: 棋盘格
+                pixel[3] = static_cast<uint8_t>(x); // 3: 透明度，编码时丢弃
+            }
+        }
+        return image;
+    }
+
+    JpegRgbxSource MakeSource(const std::vector<uint8_t>& image, int32_t width, int32_t height)
+    {
+        JpegRgbxSource source;
+        source.data = image.data();
+        source.stride = static_cast<size_t>(width) * RGBX_COMPONENTS;
+        source.width = width;
+        source.height = height;
+        source.scaledWidth = width;
+        source.scaledHeight = height;
+        return source;
+    }
+
+    TEST(JpegEncoderTest, EncodeRgbxTest)
+    {
+        // 测试自行转换 YCbCr 平面的编码结果与 libjpeg 转换的结果解码后基本一致，且奇数宽高正常
+        const int32_t width = 61;
+        const int32_t height = 35;
+        std::vector<uint8_t> image = MakeRgbxImage(width, height);
+        JpegImageInfo info = MakeInfo();
+        info.width = width;
+        info.height = height;
+        JpegEncoder encoder;
+        std::vector<uint8_t> raw(image.size() * 2);
+        size_t rawSize = encoder.EncodeRgbx(MakeSource(image, width, height), info, raw.data(), raw.size());
+        ASSERT_GT(rawSize, 0);
+        EXPECT_EQ(encoder.EncodeRgbx(MakeSource(image, width, height), info, raw.data(), raw.size()), rawSize);
+        EXPECT_EQ(encoder.GetSetupCount(), 1);
+        info.components = RGBX_COMPONENTS;
+        info.colorSpace = JCS_EXT_RGBX;
+        std::vector<uint8_t> converted(image.size() * 2);
+        size_t convertedSize = encoder.Encode(image.data(), width * RGBX_COMPONENTS, info, converted.data(),
+            converted.size());
+        ASSERT_GT(convertedSize, 0);
+        int32_t rawWidth = 0;
+        int32_t rawHeight = 0;
+        int32_t convertedWidth = 0;
+        int32_t convertedHeight = 0;
+        std::vector<uint8_t> rawPixels = Decode(raw, rawSize, rawWidth, rawHeight);
+        std::vector<uint8_t> convertedPixels = Decode(converted, convertedSize, convertedWidth, convertedHeight);
+        EXPECT_EQ(rawWidth, width);
+        EXPECT_EQ(rawHeight, height);
+        ASSERT_EQ(rawPixels.size(), convertedPixels.size());
+        double difference = 0;
+        for (size_t i = 0; i < rawPixels.size(); ++i) {
+            difference += std::abs(rawPixels[i] - convertedPixels[i]);
+        }
+        EXPECT_LT(difference / rawPixels.size(), 2.0); // 2.0: 平均误差上限
+        // 输出尺寸大于输入时失败
+        JpegRgbxSource source = MakeSource(image, width, height);
+        source.scaledWidth = width + 1;
+        info.width = width + 1;
+        EXPECT_EQ(encoder.EncodeRgbx(source, info, raw.data(), raw.size()), 0);
+        EXPECT_EQ(encoder.EncodeRgbx(MakeSource(image, width, height), MakeInfo(), raw.data(), 16), 0);
+    }
+
+    TEST(ParallelJpegEncoderTest, EncodeRgbxStripsTest)
+    {
+        // 测试编码时缩小，且分条并行编码与单线程编码解码后的像素一致
+        const int32_t width = 200;
+        const int32_t height = 300;
+        const int32_t scaledWidth = 100;
+        const int32_t scaledHeight = 150;
+        const uint32_t threadCount = 3;
+        std::vector<uint8_t> image = MakeRgbxImage(width, height);
+        JpegRgbxSource source = MakeSource(image, width, height);
+        source.scaledWidth = scaledWidth;
+        source.scaledHeight = scaledHeight;
+        JpegImageInfo info = MakeInfo();
+        info.width = scaledWidth;
+        info.height = scaledHeight;
+        JpegEncoder serialEncoder;
+        ParallelJpegEncoder parallelEncoder(threadCount);
+        std::vector<uint8_t> serial(image.size());
+        std::vector<uint8_t> parallel(image.size());
+        size_t serialSize = serialEncoder.EncodeRgbx(source, info, serial.data(), serial.size());
+        size_t parallelSize = parallelEncoder.EncodeRgbx(source, info, parallel.data(), parallel.size());
+        ASSERT_GT(serialSize, 0);
+        ASSERT_GT(parallelSize, 0);
+        int32_t serialWidth = 0;
+        int32_t serialHeight = 0;
+        int32_t parallelWidth = 0;
+        int32_t parallelHeight = 0;
+        std::vector<uint8_t> serialPixels = Decode(serial, serialSize, serialWidth, serialHeight);
+        std::vector<uint8_t> parallelPixels = Decode(parallel, parallelSize, parallelWidth, parallelHeight);
+        EXPECT_EQ(parallelWidth, scaledWidth);
+        EXPECT_EQ(parallelHeight, scaledHeight);
+        EXPECT_EQ(serialPixels, parallelPixels);
+    }
+
+    TEST(ParallelJpegEncoderTest, EncodeStripsTest)
+    {
+        // 测试分条并行编码的结果可以正常解码，且与单线程编码解码后的像素一致
+        const int32_t width = 100;
+        const int32_t height = 150; // 150: 最后一个条带不满一个完整条带高度
+        const uint32_t threadCount = 3;
+        std::vector<uint8_t> image(width * height * RGB_COMPONENTS);
+        for (size_t i = 0; i < image.size(); ++i) {
+            image[i] = static_cast<uint8_t>((i * 13) % 256); // 13: arbitrary pattern
+        }
+        JpegImageInfo info = MakeInfo();
+        info.width = width;
+        info.height = height;
+        JpegEncoder serialEncoder;
+        ParallelJpegEncoder parallelEncoder(threadCount);
+        EXPECT_EQ(parallelEncoder.GetThreadCount(), threadCount);
+        std::vector<uint8_t> serial(image.size() * 2);
+        std::vector<uint8_t> parallel(image.size() * 2);
+        size_t serialSize = serialEncoder.Encode(image.data(), width * RGB_COMPONENTS, info, serial.data(),
+            serial.size());
+        for (int i = 0; i < 2; ++i) { // 2: 连续编码两帧，验证工作线程可重复使用
+            size_t parallelSize = parallelEncoder.Encode(image.data(), width * RGB_COMPONENTS, info,
+                parallel.data(), parallel.size());
+            ASSERT_GT(parallelSize, 0);
+            int32_t serialWidth = 0;
+            int32_t serialHeight = 0;
+            int32_t parallelWidth = 0;
+            int32_t parallelHeight = 0;
+            std::vector<uint8_t> serialPixels = Decode(serial, serialSize, serialWidth, serialHeight);
+            std::vector<uint8_t> parallelPixels = Decode(parallel, parallelSize, parallelWidth, parallelHeight);
+            EXPECT_EQ(parallelWidth, width);
+            EXPECT_EQ(parallelHeight, height);
+            EXPECT_EQ(serialPixels, parallelPixels);
+        }
+        // 目标缓冲区不足时返回 0
+        EXPECT_EQ(parallelEncoder.Encode(image.data(), width * RGB_COMPONENTS, info, parallel.data(), 64), 0);
+    }
+
+    TEST(ParallelJpegEncoderTest, EncodeFullChromaTest)
+    {
+        // 测试 4:4:4 采样编码，分条并行编码按 8x8 的 MCU 切分，结果与单线程编码一致
+        const int32_t width = 100;
+        const int32_t height = 150; // 150: 不是 8 的倍数
+        const uint32_t threadCount = 3;
+        std::vector<uint8_t> image(width * height * RGB_COMPONENTS);
+        for (size_t i = 0; i < image.size(); ++i) {
+            image[i] = static_cast<uint8_t>((i * 7) % 256); // 7: arbitrary pattern
+        }
+        JpegImageInfo info = MakeInfo();
+        info.width = width;
+        info.height = height;
+        info.isFullChroma = true;
+        JpegEncoder serialEncoder;
+        ParallelJpegEncoder parallelEncoder(threadCount);
+        std::vector<uint8_t> serial(image.size() * 2);
+        std::vector<uint8_t> parallel(image.size() * 2);
+        size_t serialSize = serialEncoder.Encode(image.data(), width * RGB_COMPONENTS, info, serial.data(),
+            serial.size());
+        size_t parallelSize = parallelEncoder.Encode(image.data(), width * RGB_COMPONENTS, info, parallel.data(),
+            parallel.size());
+        ASSERT_GT(serialSize, 0);
+        ASSERT_GT(parallelSize, 0);
+        jpeg_decompress_struct cinfo;
+        jpeg_error_mgr jerr;
+        cinfo.err = jpeg_std_error(&jerr);
+        jpeg_create_decompress(&cinfo);
+        jpeg_mem_src(&cinfo, parallel.data(), parallelSize);
+        jpeg_read_header(&cinfo, TRUE);
+        EXPECT_EQ(cinfo.comp_info[0].h_samp_factor, 1);
+        EXPECT_EQ(cinfo.comp_info[0].v_samp_factor, 1);
+        jpeg_destroy_decompress(&cinfo);
+        int32_t serialWidth = 0;
+        int32_t serialHeight = 0;
+        int32_t parallelWidth = 0;
+        int32_t parallelHeight = 0;
+        std::vector<uint8_t> serialPixels = Decode(serial, serialSize, serialWidth, serialHeight);
+        std::vector<uint8_t> parallelPixels = Decode(parallel, parallelSize, parallelWidth, parallelHeight);
+        EXPECT_EQ(parallelHeight, height);
+        EXPECT_EQ(serialPixels, parallelPixels);
+    }
+}
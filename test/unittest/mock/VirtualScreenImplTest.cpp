@@ -13,7 +13,11 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <string>
+#include <thread>
 #include <vector>
 #include "gtest/gtest.h"
 #define private public
@@ -23,6 +27,8 @@
 #include "CommandParser.h"
 #include "VirtualScreen.h"
 #include "CommandLineInterface.h"
+#include "FrameBufferPool.h"
+#include "FrameSnapshot.h"
 
 namespace {
     class VirtualScreenImplTest : public ::testing::Test {
@@ -50,6 +56,12 @@ namespace {
         {
             CommandLineInterface::GetInstance().InitPipe("phone");
             socket = std::make_unique<LocalSocket>();
+            WebSocketServer::GetInstance().AddClient(mainClient, 0); // 0: 接收整帧的客户端
+        }
+
+        static void TearDownTestCase()
+        {
+            WebSocketServer::GetInstance().RemoveClient(mainClient);
         }
 
         static std::unique_ptr<LocalSocket> socket;
@@ -57,6 +69,7 @@ namespace {
         static unsigned long jpgBuffSize;
         static int32_t jpgWidth;
         static int32_t jpgHeight;
+        static lws* mainClient;
     };
 
     std::unique_ptr<LocalSocket> VirtualScreenImplTest::socket = nullptr;
@@ -64,6 +77,7 @@ namespace {
     unsigned long VirtualScreenImplTest::jpgBuffSize = 0;
     int32_t VirtualScreenImplTest::jpgWidth = 0;
     int32_t VirtualScreenImplTest::jpgHeight = 0;
+    lws* VirtualScreenImplTest::mainClient = reinterpret_cast<lws*>(1); // 1: 模拟的连接
 
     // 测试拷贝构造函数是否被删除
     TEST_F(VirtualScreenImplTest, CopyConstructorDeletedTest)
@@ -284,16 +298,29 @@ namespace {
     TEST_F(VirtualScreenImplTest, RgbToJpgTest)
     {
         InitBuffer();
+        std::vector<uint8_t> dst(jpgBuffSize);
         VirtualScreenImpl::GetInstance().jpgBufferSize = 0;
-        VirtualScreenImpl::GetInstance().RgbToJpg(jpgBuff, 3, 3);
+        VirtualScreenImpl::GetInstance().RgbToJpg(jpgBuff, 3, 3, dst.data(), dst.size());
         EXPECT_TRUE(VirtualScreenImpl::GetInstance().jpgBufferSize > 0);
+        // 目标缓冲区不足时编码失败
+        VirtualScreenImpl::GetInstance().RgbToJpg(jpgBuff, 3, 3, dst.data(), 1);
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().jpgBufferSize, 0);
         delete[] jpgBuff;
         jpgBuff = nullptr;
-        if (VirtualScreenImpl::GetInstance().jpgScreenBuffer) {
-            free(VirtualScreenImpl::GetInstance().jpgScreenBuffer);
-            VirtualScreenImpl::GetInstance().jpgScreenBuffer = NULL;
-            VirtualScreenImpl::GetInstance().jpgBufferSize = 0;
-        }
+    }
+
+    TEST_F(VirtualScreenImplTest, JpegEncoderReuseTest)
+    {
+        // 测试相同尺寸的连续帧复用编码器参数
+        InitBuffer();
+        std::vector<uint8_t> dst(jpgBuffSize);
+        VirtualScreenImpl::GetInstance().RgbToJpg(jpgBuff, jpgWidth, jpgHeight, dst.data(), dst.size());
+        uint32_t setupCount = VirtualScreenImpl::GetInstance().jpegEncoder.GetSetupCount();
+        VirtualScreenImpl::GetInstance().RgbToJpg(jpgBuff, jpgWidth, jpgHeight, dst.data(), dst.size());
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().jpegEncoder.GetSetupCount(), setupCount);
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
+        VirtualScreenImpl::GetInstance().jpgBufferSize = 0;
     }
 
     TEST_F(VirtualScreenImplTest, SetFoldableTest)
@@ -343,17 +370,20 @@ namespace {
     TEST_F(VirtualScreenImplTest, SendBufferOnTimerTest)
     {
         g_writeData = false;
-        VirtualScreenImpl::GetInstance().loadDocTempBuffer = nullptr;
+        VirtualScreenImpl::GetInstance().hasLoadDocFrame = false;
         VirtualScreenImpl::GetInstance().SendBufferOnTimer();
 
-        InitBuffer(); // jpgBuffer在loadDocTempBuffer释放时释放
-        VirtualScreenImpl::GetInstance().lengthTemp = jpgBuffSize;
-        VirtualScreenImpl::GetInstance().loadDocTempBuffer = jpgBuff;
+        InitBuffer();
+        VirtualScreenImpl::GetInstance().loadDocFrame.assign(jpgBuff, jpgBuff + jpgBuffSize);
+        VirtualScreenImpl::GetInstance().hasLoadDocFrame = true;
         VirtualScreenImpl::GetInstance().widthTemp = jpgWidth;
         VirtualScreenImpl::GetInstance().heightTemp = jpgHeight;
-        VirtualScreenImpl::GetInstance().loadDocCopyBuffer = new unsigned char[0];
         VirtualScreenImpl::GetInstance().SendBufferOnTimer();
+        VirtualScreenImpl::GetInstance().frameMailbox.WaitIdle();
         EXPECT_TRUE(g_writeData);
+        EXPECT_FALSE(VirtualScreenImpl::GetInstance().hasLoadDocFrame);
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
     }
 
     TEST_F(VirtualScreenImplTest, CallbackTest)
@@ -362,15 +392,100 @@ namespace {
         VirtualScreenImpl::GetInstance().loadDocTimeStamp = 0;
         CommandParser::GetInstance().screenMode = CommandParser::ScreenMode::DYNAMIC;
         VirtualScreenImpl::GetInstance().SetLoadDocFlag(VirtualScreen::LoadDocType::INIT);
+        VirtualScreenImpl::GetInstance().hasLastFrameHash = false;
         g_writeData = false;
         InitBuffer();
         int tm = 100;
         VirtualScreenImpl::Callback(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight, tm);
+        VirtualScreenImpl::GetInstance().frameMailbox.WaitIdle();
+        EXPECT_TRUE(g_writeData);
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
+    }
+
+    TEST_F(VirtualScreenImplTest, CaptureWithoutClientTest)
+    {
+        // 测试没有 websocket 客户端时不编码发送，截图仍能取到帧，客户端连接后重发当前帧
+        VirtualScreenImpl& screen = VirtualScreenImpl::GetInstance();
+        CommandParser::GetInstance().staticCard = false;
+        screen.loadDocTimeStamp = 0;
+        CommandParser::GetInstance().screenMode = CommandParser::ScreenMode::DYNAMIC;
+        screen.SetLoadDocFlag(VirtualScreen::LoadDocType::INIT);
+        screen.hasLastFrameHash = false;
+        WebSocketServer::GetInstance().RemoveClient(mainClient);
+        g_writeData = false;
+        InitBuffer();
+        int tm = 100;
+        VirtualScreenImpl::Callback(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight, tm);
+        screen.frameMailbox.WaitIdle();
+        EXPECT_FALSE(g_writeData);
+        CapturedFrame captured;
+        EXPECT_TRUE(screen.CaptureFrame(false, 1, std::chrono::milliseconds(1000), captured)); // 1000: 超时
+        EXPECT_EQ(captured.width, jpgWidth);
+        WebSocketServer::GetInstance().AddClient(mainClient, 0);
+        screen.frameMailbox.WaitIdle();
+        EXPECT_TRUE(g_writeData);
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
+    }
+
+    TEST_F(VirtualScreenImplTest, CallbackSkipRepeatedFrameTest)
+    {
+        // 测试与上一帧相同的帧在编码前被跳过并计数
+        CommandParser::GetInstance().staticCard = false;
+        VirtualScreenImpl::GetInstance().loadDocTimeStamp = 0;
+        CommandParser::GetInstance().screenMode = CommandParser::ScreenMode::DYNAMIC;
+        VirtualScreenImpl::GetInstance().SetLoadDocFlag(VirtualScreen::LoadDocType::INIT);
+        VirtualScreenImpl::GetInstance().hasLastFrameHash = false;
+        InitBuffer();
+        int tm = 100;
+        g_writeData = false;
+        VirtualScreenImpl::Callback(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight, tm);
+        VirtualScreenImpl::GetInstance().frameMailbox.WaitIdle();
+        EXPECT_TRUE(g_writeData);
+        uint32_t skipCount = VirtualScreen::skipFrameCountPerMinute;
+        g_writeData = false;
+        EXPECT_FALSE(VirtualScreenImpl::Callback(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight, tm));
+        VirtualScreenImpl::GetInstance().frameMailbox.WaitIdle();
+        EXPECT_FALSE(g_writeData);
+        EXPECT_EQ(VirtualScreen::skipFrameCountPerMinute, skipCount + 1);
+        // 内容变化后正常发送
+        jpgBuff[0] = 0;
+        VirtualScreenImpl::Callback(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight, tm);
+        VirtualScreenImpl::GetInstance().frameMailbox.WaitIdle();
         EXPECT_TRUE(g_writeData);
         delete[] jpgBuff;
         jpgBuff = nullptr;
     }
 
+    TEST_F(VirtualScreenImplTest, CallbackReuseFrameBufferTest)
+    {
+        CommandParser::GetInstance().staticCard = false;
+        VirtualScreenImpl::GetInstance().loadDocTimeStamp = 0;
+        CommandParser::GetInstance().screenMode = CommandParser::ScreenMode::DYNAMIC;
+        VirtualScreenImpl::GetInstance().SetLoadDocFlag(VirtualScreen::LoadDocType::INIT);
+        InitBuffer();
+        int tm = 100;
+        // 客户端队列与备份共享帧缓冲，服务端写完后缓冲回到池中
+        ClientSendQueue& queue = WebSocketServer::GetInstance().router.Find(mainClient)->queue;
+        VirtualScreenImpl::Callback(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight, tm);
+        VirtualScreenImpl::Callback(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight, tm);
+        VirtualScreenImpl::GetInstance().frameMailbox.WaitIdle();
+        queue.Replace({});
+        uint64_t count = FrameBufferPool::GetInstance().GetAllocationCount();
+        VirtualScreenImpl::Callback(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight, tm);
+        VirtualScreenImpl::GetInstance().frameMailbox.WaitIdle();
+        queue.Replace({});
+        VirtualScreenImpl::Callback(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight, tm);
+        VirtualScreenImpl::GetInstance().frameMailbox.WaitIdle();
+        queue.Replace({});
+        EXPECT_EQ(FrameBufferPool::GetInstance().GetAllocationCount(), count);
+        ASSERT_NE(WebSocketServer::GetInstance().firstImage, nullptr);
+        EXPECT_GT(WebSocketServer::GetInstance().firstImage->GetSize(), VirtualScreenImpl::GetInstance().headSize);
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
+    }
+
     TEST_F(VirtualScreenImplTest, FlushEmptyCallbackTest)
     {
         int tm = 100;
@@ -426,10 +541,7 @@ namespace {
         int width = 100;
         int pixSize = 4;
         int length = height * width * pixSize;
-        VirtualScreenImpl::GetInstance().bufferSize = length + VirtualScreenImpl::GetInstance().headSize;
-        VirtualScreenImpl::GetInstance().wholeBuffer =
-            new uint8_t[LWS_PRE + VirtualScreenImpl::GetInstance().bufferSize];
-        VirtualScreenImpl::GetInstance().screenBuffer = VirtualScreenImpl::GetInstance().wholeBuffer + LWS_PRE;
+        EXPECT_TRUE(VirtualScreenImpl::GetInstance().AcquireWholeBuffer(length));
         // data is nullptr
         bool ret = VirtualScreenImpl::GetInstance().SendPixmap(nullptr, length, width, height);
         EXPECT_FALSE(ret);
@@ -449,6 +561,413 @@ namespace {
         jpgBuff = nullptr;
     }
 
+    TEST_F(VirtualScreenImplTest, SendDamageTest)
+    {
+        // 测试区域刷新模式下只发送变化的区域
+        VirtualScreenImpl& screen = VirtualScreenImpl::GetInstance();
+        bool temp = CommandParser::GetInstance().isRegionRefresh;
+        CommandParser::GetInstance().isRegionRefresh = true;
+        CommandParser::GetInstance().screenMode = CommandParser::ScreenMode::DYNAMIC;
+        screen.isWebSocketConfiged = true;
+        screen.damageTracker.Reset();
+        InitBuffer();
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        EXPECT_TRUE(WebSocketServer::GetInstance().regionImages.empty()); // 首帧发送整帧
+        // 画面无变化时不发送
+        g_writeData = false;
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        EXPECT_FALSE(g_writeData);
+        // 只发送变化像素所在的分块，并在包头中写入区域
+        jpgBuff[(50 * jpgWidth + 60) * 4] = 0; // 50, 60: 第二行第二列分块, 4: 每像素字节数
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        EXPECT_TRUE(g_writeData);
+        ASSERT_EQ(WebSocketServer::GetInstance().regionImages.size(), 1);
+        const uint8_t* header = WebSocketServer::GetInstance().regionImages[0]->GetData();
+        const int32_t tile = DamageTracker::DEFAULT_TILE_SIZE;
+        EXPECT_EQ((header[22] << 8) | header[23], tile); // 22: x1, 8: 高字节
+        EXPECT_EQ((header[24] << 8) | header[25], tile); // 24: y1, 8: 高字节
+        EXPECT_EQ((header[26] << 8) | header[27], tile); // 26: width, 8: 高字节
+        EXPECT_EQ((header[28] << 8) | header[29], tile); // 28: height, 8: 高字节
+        CommandParser::GetInstance().isRegionRefresh = temp;
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
+    }
+
+    TEST_F(VirtualScreenImplTest, SendComponentTest)
+    {
+        // 测试组件模式按会话指定的编解码器发送，并在包头写入编解码器标识
+        VirtualScreenImpl& screen = VirtualScreenImpl::GetInstance();
+        bool temp = CommandParser::GetInstance().isComponentMode;
+        CommandParser::GetInstance().isComponentMode = true;
+        screen.isWebSocketConfiged = true;
+        InitBuffer();
+        EXPECT_TRUE(screen.SetFrameCodec("qoi"));
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        {
+            std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+            const uint8_t* header = WebSocketServer::GetInstance().firstImage->GetData();
+            EXPECT_EQ(header[screen.codecIdPos], static_cast<uint8_t>(FrameCodecId::QOI));
+            // 纯色画面压缩后远小于原始数据
+            EXPECT_LT(WebSocketServer::GetInstance().firstImage->GetSize(), jpgBuffSize / 10); // 10: 压缩率
+        }
+        // 默认模式保持原始 RGBA
+        EXPECT_TRUE(screen.SetFrameCodec("default"));
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        {
+            std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+            const uint8_t* header = WebSocketServer::GetInstance().firstImage->GetData();
+            EXPECT_EQ(header[screen.codecIdPos], static_cast<uint8_t>(FrameCodecId::DEFAULT));
+            EXPECT_EQ(WebSocketServer::GetInstance().firstImage->GetSize(), screen.headSize + jpgBuffSize);
+        }
+        CommandParser::GetInstance().isComponentMode = temp;
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
+    }
+
+    TEST_F(VirtualScreenImplTest, SendDeltaFrameTest)
+    {
+        // 测试组件模式差分发送：首帧为关键帧，之后的帧与上一帧异或后发送，并随关键帧一起备份用于重连
+        VirtualScreenImpl& screen = VirtualScreenImpl::GetInstance();
+        bool temp = CommandParser::GetInstance().isComponentMode;
+        CommandParser::GetInstance().isComponentMode = true;
+        screen.isWebSocketConfiged = true;
+        screen.SetFrameDelta(true, FrameDelta::DEFAULT_KEYFRAME_INTERVAL);
+        InitBuffer();
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        EXPECT_TRUE(WebSocketServer::GetInstance().regionImages.empty());
+        jpgBuff[0] = 0;
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        ASSERT_EQ(WebSocketServer::GetInstance().regionImages.size(), 1);
+        const uint8_t* header = WebSocketServer::GetInstance().regionImages[0]->GetData();
+        EXPECT_EQ(header[screen.codecIdPos], static_cast<uint8_t>(FrameCodecId::DELTA));
+        EXPECT_LT(WebSocketServer::GetInstance().regionImages[0]->GetSize(), jpgBuffSize / 10); // 10: 压缩率
+        // 新的连接需要关键帧
+        WebSocketServer::connectionCount++;
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        EXPECT_TRUE(WebSocketServer::GetInstance().regionImages.empty());
+        screen.SetFrameDelta(false, FrameDelta::DEFAULT_KEYFRAME_INTERVAL);
+        CommandParser::GetInstance().isComponentMode = temp;
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
+    }
+
+    TEST_F(VirtualScreenImplTest, SendTilesTest)
+    {
+        // 测试图块缓存发送：首帧发送全部图块并作为重连备份，之后只发送变化的图块，新连接重新开始
+        VirtualScreenImpl& screen = VirtualScreenImpl::GetInstance();
+        CommandParser& parser = CommandParser::GetInstance();
+        bool regionTemp = parser.isRegionRefresh;
+        bool componentTemp = parser.isComponentMode;
+        parser.isRegionRefresh = false;
+        parser.isComponentMode = false;
+        screen.isWebSocketConfiged = true;
+        screen.SetTileCache(true, TileCache::DEFAULT_CAPACITY);
+        InitBuffer();
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        EXPECT_TRUE(WebSocketServer::GetInstance().regionImages.empty());
+        ASSERT_NE(WebSocketServer::GetInstance().firstImage, nullptr);
+        const uint8_t* first = WebSocketServer::GetInstance().firstImage->GetData();
+        uint8_t version = static_cast<uint8_t>(VirtualScreen::ProtocolVersion::TILECACHE);
+        EXPECT_EQ(first[screen.protocolVersionPos + 1], version); // 1: 网络字节序的低位字节
+        EXPECT_EQ(first[screen.headSize + 12] & TileCache::FLAG_RESET, TileCache::FLAG_RESET); // 12: 标志位偏移
+        size_t firstSize = WebSocketServer::GetInstance().firstImage->GetSize();
+        jpgBuff[0] = 0;
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        ASSERT_EQ(WebSocketServer::GetInstance().regionImages.size(), 1);
+        EXPECT_LT(WebSocketServer::GetInstance().regionImages[0]->GetSize(), firstSize);
+        // 没有客户端收到的图块不能被下一帧引用
+        WebSocketServer::GetInstance().router.Find(mainClient)->variant = 1; // 1: 连接数不变而整帧流无人订阅
+        jpgBuff[0] = 1;
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        WebSocketServer::GetInstance().router.Find(mainClient)->variant = 0;
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        EXPECT_TRUE(WebSocketServer::GetInstance().regionImages.empty());
+        // 新的连接从空缓存开始
+        WebSocketServer::connectionCount++;
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        EXPECT_TRUE(WebSocketServer::GetInstance().regionImages.empty());
+        screen.SetTileCache(false, TileCache::DEFAULT_CAPACITY);
+        parser.isRegionRefresh = regionTemp;
+        parser.isComponentMode = componentTemp;
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
+    }
+
+    TEST_F(VirtualScreenImplTest, ConfigFrameTest)
+    {
+        // 测试切换配置前保存当前帧，切换回来时立即发送保存的帧，源码刷新后失效
+        VirtualScreenImpl& screen = VirtualScreenImpl::GetInstance();
+        CommandParser::GetInstance().staticCard = false;
+        CommandParser::GetInstance().screenMode = CommandParser::ScreenMode::DYNAMIC;
+        screen.loadDocTimeStamp = 0;
+        screen.SetLoadDocFlag(VirtualScreen::LoadDocType::INIT);
+        screen.hasLastFrameHash = false;
+        InitBuffer();
+        FrameConfig light;
+        light.colorMode = "light";
+        FrameConfig dark;
+        dark.colorMode = "dark";
+        int tm = 100;
+        VirtualScreenImpl::Callback(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight, tm);
+        screen.frameMailbox.WaitIdle();
+        screen.SaveConfigFrame(light);
+        EXPECT_FALSE(screen.ShowConfigFrame(dark));
+        // 切换后还没有新帧时，当前帧仍是切换前的画面，不保存
+        screen.SaveConfigFrame(dark);
+        EXPECT_FALSE(screen.ShowConfigFrame(dark));
+        g_writeData = false;
+        EXPECT_TRUE(screen.ShowConfigFrame(light));
+        screen.frameMailbox.WaitIdle();
+        EXPECT_TRUE(g_writeData);
+        screen.InvalidateConfigFrames();
+        EXPECT_FALSE(screen.ShowConfigFrame(light));
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
+    }
+
+    TEST_F(VirtualScreenImplTest, LastFrameTest)
+    {
+        // 测试保存最后发送的帧，下次启动时作为过期帧在首次渲染前发送
+        VirtualScreenImpl& screen = VirtualScreenImpl::GetInstance();
+        CommandParser::GetInstance().lastFrameDir = ".";
+        std::string key = screen.GetLastFrameKey();
+        const size_t packetSize = screen.headSize + 100; // 100: 图像数据长度
+        uint8_t* buffer = FrameBufferPool::GetInstance().Acquire(LWS_PRE + packetSize);
+        ASSERT_NE(buffer, nullptr);
+        std::fill(buffer + LWS_PRE, buffer + LWS_PRE + packetSize, 0);
+        buffer[LWS_PRE + screen.headSize] = 0x5A; // 0x5A: 图像数据
+        {
+            std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+            WebSocketServer::GetInstance().firstImage =
+                SendPacket::Create(FrameBufferPool::GetInstance().Share(buffer), LWS_PRE, packetSize);
+            screen.ReleaseRegionBackups();
+            screen.lastFrameKey = key;
+        }
+        screen.SaveLastFrame();
+        std::vector<std::vector<uint8_t>> packets;
+        ASSERT_TRUE(FrameSnapshot::Load(".", key, packets));
+        ASSERT_EQ(packets.size(), 1);
+        EXPECT_EQ(packets[0], std::vector<uint8_t>(buffer + LWS_PRE, buffer + LWS_PRE + packetSize));
+        // 新会话：没有帧时读入保存的帧并标记为过期
+        {
+            std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+            WebSocketServer::GetInstance().firstImage = nullptr;
+        }
+        screen.LoadLastFrame();
+        std::shared_ptr<SendPacket> loaded = WebSocketServer::GetInstance().firstImage;
+        ASSERT_NE(loaded, nullptr);
+        EXPECT_EQ(loaded->GetSize(), packetSize);
+        EXPECT_EQ(loaded->GetData()[screen.frameFlagsPos], static_cast<uint8_t>(VirtualScreen::FrameFlag::STALE));
+        EXPECT_EQ(loaded->GetData()[screen.headSize], 0x5A); // 0x5A: 图像数据
+        screen.StopSavingLastFrame();
+        EXPECT_FALSE(screen.isSavingLastFrame);
+        std::remove(FrameSnapshot::GetPath(".", key).c_str());
+        CommandParser::GetInstance().lastFrameDir = "";
+        screen.lastFrameKey = "";
+        screen.isSavingLastFrame = true;
+    }
+
+    TEST_F(VirtualScreenImplTest, SendDownscaledTest)
+    {
+        // 测试按 -sr 缩小后发送，包头保留渲染尺寸，输入坐标映射回渲染尺寸
+        VirtualScreenImpl& screen = VirtualScreenImpl::GetInstance();
+        CommandParser& parser = CommandParser::GetInstance();
+        bool regionTemp = parser.isRegionRefresh;
+        bool componentTemp = parser.isComponentMode;
+        parser.isRegionRefresh = false;
+        parser.isComponentMode = false;
+        parser.sendResolutionWidth = 50; // 50: 缩小一半
+        parser.sendResolutionHeight = 50; // 50: 缩小一半
+        screen.isWebSocketConfiged = true;
+        InitBuffer();
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        {
+            std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+            const uint8_t* header = WebSocketServer::GetInstance().firstImage->GetData();
+            EXPECT_EQ((header[6] << 8) | header[7], jpgWidth); // 6: 渲染宽度低16位, 8: 高字节
+            EXPECT_EQ((header[14] << 8) | header[15], 50); // 14: 发送宽度低16位, 8: 高字节, 50: 缩小一半
+        }
+        double x = 10;
+        double y = 20;
+        screen.MapInputPosition(x, y);
+        EXPECT_DOUBLE_EQ(x, 20); // 20: 放大一倍
+        EXPECT_DOUBLE_EQ(y, 40); // 40: 放大一倍
+        parser.sendResolutionWidth = 0;
+        parser.sendResolutionHeight = 0;
+        parser.isRegionRefresh = regionTemp;
+        parser.isComponentMode = componentTemp;
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
+    }
+
+    TEST_F(VirtualScreenImplTest, SendVariantsTest)
+    {
+        // 测试每帧只编码有客户端订阅的联播尺寸，并保留该尺寸的最后一帧供重连时发送
+        VirtualScreenImpl& screen = VirtualScreenImpl::GetInstance();
+        CommandParser& parser = CommandParser::GetInstance();
+        bool regionTemp = parser.isRegionRefresh;
+        bool componentTemp = parser.isComponentMode;
+        parser.isRegionRefresh = false;
+        parser.isComponentMode = false;
+        parser.screenMode = CommandParser::ScreenMode::DYNAMIC;
+        screen.isWebSocketConfiged = true;
+        screen.framePyramid.SetSizes({ { 50, 50 }, { 25, 25 } }); // 50, 25: 缩小一半和四分之一
+        WebSocketServer::GetInstance().variantImages.clear();
+        InitBuffer();
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        EXPECT_TRUE(WebSocketServer::GetInstance().variantImages.empty());
+        lws* variantClient = reinterpret_cast<lws*>(2); // 2: 模拟的第二个连接
+        WebSocketServer::GetInstance().AddClient(variantClient, 2); // 2: 客户端选择最小尺寸
+        g_writeData = false;
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        EXPECT_TRUE(g_writeData);
+        {
+            std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+            const std::vector<std::shared_ptr<SendPacket>>& variants = WebSocketServer::GetInstance().variantImages;
+            ASSERT_EQ(variants.size(), 2); // 2: 两个联播尺寸
+            EXPECT_EQ(variants[0], nullptr);
+            ASSERT_NE(variants[1], nullptr);
+            const uint8_t* header = variants[1]->GetData();
+            EXPECT_EQ((header[6] << 8) | header[7], jpgWidth); // 6: 渲染宽度低16位, 8: 高字节
+            EXPECT_EQ((header[14] << 8) | header[15], 25); // 14: 发送宽度低16位, 8: 高字节, 25: 缩小到四分之一
+        }
+        WebSocketServer::GetInstance().RemoveClient(variantClient);
+        screen.framePyramid.SetSizes({});
+        parser.isRegionRefresh = regionTemp;
+        parser.isComponentMode = componentTemp;
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
+    }
+
+    TEST_F(VirtualScreenImplTest, SendViewportTest)
+    {
+        // 测试设置视口的客户端只收到视口区域，包头写入区域位置，其他客户端仍收到整帧，输入坐标映射回渲染帧
+        VirtualScreenImpl& screen = VirtualScreenImpl::GetInstance();
+        CommandParser& parser = CommandParser::GetInstance();
+        bool regionTemp = parser.isRegionRefresh;
+        bool componentTemp = parser.isComponentMode;
+        parser.isRegionRefresh = false;
+        parser.isComponentMode = false;
+        parser.screenMode = CommandParser::ScreenMode::DYNAMIC;
+        screen.isWebSocketConfiged = true;
+        FrameViewport viewport;
+        viewport.x = 50; // 50: 右半部分
+        viewport.width = 80; // 80: 超出帧宽的部分被裁掉
+        viewport.height = 100; // 100: 整个高度
+        viewport.scale = 0.5; // 0.5: 缩小一半
+        lws* zoomClient = reinterpret_cast<lws*>(3); // 3: 模拟的第三个连接
+        WebSocketServer::GetInstance().AddClient(zoomClient, 0, "zoom");
+        WebSocketServer::GetInstance().SetViewport("zoom", viewport);
+        InitBuffer();
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        {
+            size_t offset = 0;
+            std::shared_ptr<SendPacket> packet =
+                WebSocketServer::GetInstance().router.Find(zoomClient)->queue.GetFront(offset);
+            ASSERT_NE(packet, nullptr);
+            const uint8_t* header = packet->GetData();
+            EXPECT_EQ((header[6] << 8) | header[7], jpgWidth); // 6: 渲染宽度低16位, 8: 高字节
+            EXPECT_EQ((header[14] << 8) | header[15], 25); // 14: 发送宽度低16位, 8: 高字节, 25: 裁剪后缩小一半
+            EXPECT_EQ((header[22] << 8) | header[23], 50); // 22: x1, 8: 高字节, 50: 视口起点
+            EXPECT_EQ((header[26] << 8) | header[27], 50); // 26: width, 8: 高字节, 50: 裁剪后的宽度
+            // 没有视口的客户端收到整帧，视口区域不作为重连备份
+            std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+            header = WebSocketServer::GetInstance().firstImage->GetData();
+            EXPECT_EQ((header[14] << 8) | header[15], jpgWidth); // 14: 发送宽度低16位, 8: 高字节
+        }
+        // 指定客户端的视口不影响其他客户端的输入坐标
+        double x = 10;
+        double y = 20;
+        screen.MapInputPosition(x, y);
+        EXPECT_DOUBLE_EQ(x, 10); // 10: 不偏移
+        // 所有客户端的视口决定输入坐标的映射
+        screen.SetViewport(viewport);
+        WebSocketServer::GetInstance().SetViewport("", screen.GetViewport());
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        screen.MapInputPosition(x, y);
+        EXPECT_DOUBLE_EQ(x, 70); // 70: 50 + 10 * 2
+        EXPECT_DOUBLE_EQ(y, 40); // 40: 20 * 2
+        // 清除视口后恢复整帧发送
+        screen.SetViewport(FrameViewport());
+        WebSocketServer::GetInstance().SetViewport("", screen.GetViewport());
+        EXPECT_TRUE(WebSocketServer::GetInstance().GetViewports().empty());
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        x = 10;
+        screen.MapInputPosition(x, y);
+        EXPECT_DOUBLE_EQ(x, 10); // 10: 不再偏移
+        WebSocketServer::GetInstance().RemoveClient(zoomClient);
+        parser.isRegionRefresh = regionTemp;
+        parser.isComponentMode = componentTemp;
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
+    }
+
+    TEST_F(VirtualScreenImplTest, RefineMailboxFrameTest)
+    {
+        // 测试运动时按低质量发送，空闲后以精细质量重发最后一帧整帧，且只发送一次
+        VirtualScreenImpl& screen = VirtualScreenImpl::GetInstance();
+        CommandParser& parser = CommandParser::GetInstance();
+        bool regionTemp = parser.isRegionRefresh;
+        bool componentTemp = parser.isComponentMode;
+        parser.isRegionRefresh = false;
+        parser.isComponentMode = false;
+        parser.screenMode = CommandParser::ScreenMode::DYNAMIC;
+        screen.isWebSocketConfiged = true;
+        ProgressiveQualityConfig config;
+        config.enabled = true;
+        config.motionQuality = 50; // 50: 运动时质量
+        screen.SetProgressiveQuality(config);
+        InitBuffer();
+        EXPECT_EQ(screen.GetAdaptiveJpgQuality(jpgWidth, jpgHeight), 50); // 50: 运动时质量
+        ASSERT_TRUE(screen.AcquireWholeBuffer(jpgBuffSize));
+        screen.SendPixmap(jpgBuff, jpgBuffSize, jpgWidth, jpgHeight);
+        EXPECT_TRUE(screen.progressiveQuality.IsRefinementDue());
+        uint64_t motionSize = WebSocketServer::GetInstance().firstImage->GetSize();
+        MailboxFrame frame;
+        frame.data = jpgBuff;
+        frame.length = jpgBuffSize;
+        frame.width = jpgWidth;
+        frame.height = jpgHeight;
+        g_writeData = false;
+        screen.RefineMailboxFrame(frame);
+        EXPECT_TRUE(g_writeData);
+        EXPECT_FALSE(screen.progressiveQuality.IsRefinementDue());
+        {
+            std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
+            const uint8_t* header = WebSocketServer::GetInstance().firstImage->GetData();
+            EXPECT_EQ((header[14] << 8) | header[15], jpgWidth); // 14: 发送宽度低16位, 8: 高字节
+            EXPECT_GT(WebSocketServer::GetInstance().firstImage->GetSize(), motionSize);
+        }
+        // 已精细发送后不再重复发送
+        g_writeData = false;
+        screen.RefineMailboxFrame(frame);
+        EXPECT_FALSE(g_writeData);
+        screen.SetProgressiveQuality(ProgressiveQualityConfig());
+        parser.isRegionRefresh = regionTemp;
+        parser.isComponentMode = componentTemp;
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
+    }
+
     TEST_F(VirtualScreenImplTest, PageCallbackTest)
     {
         EXPECT_TRUE(VirtualScreenImpl::GetInstance().PageCallback("pages/Index"));
@@ -473,10 +992,7 @@ namespace {
         int pixSize = 4;
         int height = 100;
         int length = height * width * pixSize;
-        VirtualScreenImpl::GetInstance().bufferSize = length + VirtualScreenImpl::GetInstance().headSize;
-        VirtualScreenImpl::GetInstance().wholeBuffer =
-            new uint8_t[LWS_PRE + VirtualScreenImpl::GetInstance().bufferSize];
-        VirtualScreenImpl::GetInstance().screenBuffer = VirtualScreenImpl::GetInstance().wholeBuffer + LWS_PRE;
+        EXPECT_TRUE(VirtualScreenImpl::GetInstance().AcquireWholeBuffer(length));
         // static mode
         CommandParser::ScreenMode tempMode = CommandParser::GetInstance().screenMode;
         CommandParser::GetInstance().screenMode = CommandParser::ScreenMode::STATIC;
@@ -532,23 +1048,47 @@ namespace {
         // GetLoadDocFlag is VirtualScreen::LoadDocType::FINISHED && length = 0
         VirtualScreen::LoadDocType temp = VirtualScreenImpl::GetInstance().startLoadDoc;
         VirtualScreenImpl::GetInstance().startLoadDoc = VirtualScreen::LoadDocType::FINISHED;
-        VirtualScreenImpl::GetInstance().loadDocTempBuffer = new uint8_t[1];
+        VirtualScreenImpl::GetInstance().hasLoadDocFrame = true;
         ret = VirtualScreenImpl::LoadDocCallback(jpgBuff, 0, jpgWidth, jpgHeight, tm);
         EXPECT_FALSE(ret);
+        EXPECT_FALSE(VirtualScreenImpl::GetInstance().hasLoadDocFrame);
         VirtualScreenImpl::GetInstance().startLoadDoc = temp;
         delete[] jpgBuff;
         jpgBuff = nullptr;
     }
 
-    TEST_F(VirtualScreenImplTest, StartTimerTest)
+    TEST_F(VirtualScreenImplTest, LoadDocRoundTest)
     {
+        // 测试计时线程在超时后发送最后一帧并结束本轮，不占用CPU空转
+        VirtualScreenImpl& screen = VirtualScreenImpl::GetInstance();
+        InitBuffer();
+        screen.loadDocFrame.assign(jpgBuff, jpgBuff + jpgBuffSize);
+        screen.hasLoadDocFrame = true;
+        screen.widthTemp = jpgWidth;
+        screen.heightTemp = jpgHeight;
+        screen.isFlushEmpty = false;
+        screen.onRenderTime = std::chrono::system_clock::now();
+        VirtualScreen::startTime = std::chrono::system_clock::now();
         g_writeData = false;
-        VirtualScreenImpl::GetInstance().isFlushEmpty = false;
-        VirtualScreenImpl::GetInstance().StartTimer();
-        EXPECT_FALSE(g_writeData);
-        VirtualScreenImpl::GetInstance().isFlushEmpty = true;
-        VirtualScreenImpl::GetInstance().StartTimer();
-        EXPECT_FALSE(g_writeData);
+        screen.StartLoadDocRound();
+        // 300ms 后没有结束标记，发送最后一帧
+        auto isFinished = [&screen]() {
+            std::lock_guard<std::mutex> guard(screen.loadDocMutex);
+            return screen.loadDocRound == screen.finishedLoadDocRound;
+        };
+        auto waitEnd = std::chrono::steady_clock::now() + std::chrono::seconds(2); // 2: 最多等待2秒
+        while (!isFinished() && std::chrono::steady_clock::now() < waitEnd) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10)); // 10: 轮询间隔
+        }
+        EXPECT_TRUE(isFinished());
+        EXPECT_FALSE(screen.hasLoadDocFrame);
+        screen.frameMailbox.WaitIdle();
+        EXPECT_TRUE(g_writeData);
+        screen.NotifyLoadDocEvent(); // 本轮结束后的事件被忽略
+        EXPECT_FALSE(screen.hasLoadDocEvent);
+        screen.onRenderTime = std::chrono::system_clock::time_point::min();
+        delete[] jpgBuff;
+        jpgBuff = nullptr;
     }
 
     TEST_F(VirtualScreenImplTest, NoFlushEmptyFuncTest)
@@ -148,13 +148,15 @@ namespace {
 
         CommandParser::GetInstance().screenMode = CommandParser::ScreenMode::STATIC;
         VirtualScreen::isOutOfSeconds = true;
+        VirtualScreenImpl::GetInstance().jpgBufferSize = 0;
         VirtualScreenImpl::GetInstance().SendRegionBuffer();
-        EXPECT_TRUE(VirtualScreenImpl::GetInstance().jpgScreenBuffer == nullptr);
-        VirtualScreenImpl::GetInstance().FreeJpgMemory();
+        EXPECT_EQ(VirtualScreenImpl::GetInstance().jpgBufferSize, 0);
         CommandParser::GetInstance().screenMode = CommandParser::ScreenMode::DYNAMIC;
         VirtualScreen::isOutOfSeconds = false;
         VirtualScreenImpl::GetInstance().SendRegionBuffer();
-        EXPECT_TRUE(VirtualScreenImpl::GetInstance().jpgScreenBuffer == nullptr);
+        // jpeg 直接编码到发送缓冲区，不会超出缓冲区大小
+        EXPECT_TRUE(VirtualScreenImpl::GetInstance().jpgBufferSize + VirtualScreenImpl::GetInstance().headSize <=
+            VirtualScreenImpl::GetInstance().bufferSize);
     }
 
     TEST_F(VirtualScreenImplTest, FlushTest)
@@ -177,6 +179,7 @@ namespace {
         VirtualScreenImpl::GetInstance().isFirstSend = false;
         VirtualScreenImpl::GetInstance().Flush(flushRect);
         EXPECT_FALSE(VirtualScreenImpl::GetInstance().isChanged);
+        VirtualScreenImpl::GetInstance().frameMailbox.WaitIdle();
     }
 
     TEST_F(VirtualScreenImplTest, CheckBufferSendTest)
@@ -203,5 +206,7 @@ namespace {
         VirtualScreenImpl::GetInstance().isFirstSend = false;
         VirtualScreenImpl::GetInstance().CheckBufferSend();
         EXPECT_FALSE(VirtualScreenImpl::GetInstance().isChanged);
+        VirtualScreenImpl::GetInstance().frameMailbox.WaitIdle();
+        EXPECT_TRUE(WebSocketServer::GetInstance().firstImage != nullptr); // 发送线程备份最后一帧
     }
 }
\ No newline at end of file
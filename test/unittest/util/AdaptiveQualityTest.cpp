@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "gtest/gtest.h"
+#include "AdaptiveQuality.h"
+
+namespace {
+    const int32_t BASE_QUALITY = 90;
+
+    FrameCost MakeCost(int64_t encodeUs, int64_t drainUs, size_t bytes)
+    {
+        FrameCost cost;
+        cost.encodeUs = encodeUs;
+        cost.drainUs = drainUs;
+        cost.bytes = bytes;
+        return cost;
+    }
+
+    TEST(AdaptiveQualityTest, DisabledTest)
+    {
+        // 测试未开启时质量与帧间隔保持不变
+        AdaptiveQuality controller;
+        AdaptiveQuality::Clock::time_point now = AdaptiveQuality::Clock::now();
+        controller.OnFrameSent(MakeCost(1000000, 1000000, 1000000), now); // 1000000: 远超预算
+        EXPECT_EQ(controller.GetQuality(BASE_QUALITY, now), BASE_QUALITY);
+        EXPECT_EQ(controller.GetFrameIntervalUs(), 0);
+    }
+
+    TEST(AdaptiveQualityTest, LatencyBudgetTest)
+    {
+        // 测试超出时延预算时降低质量，质量降到下限后降低帧率，空闲后恢复最高质量
+        AdaptiveQuality controller;
+        AdaptiveQualityConfig config;
+        config.enabled = true;
+        config.latencyBudgetMs = 20; // 20: 每帧 20ms
+        config.maxQuality = 80; // 80: 质量上限
+        controller.Configure(config);
+        AdaptiveQuality::Clock::time_point now = AdaptiveQuality::Clock::now();
+        EXPECT_EQ(controller.GetQuality(BASE_QUALITY, now), 80); // 80: 不超过质量上限
+        controller.OnFrameSent(MakeCost(10000, 30000, 1000), now); // 10000, 30000: 共 40ms
+        EXPECT_LT(controller.GetQuality(BASE_QUALITY, now), 80); // 80: 质量上限
+        EXPECT_EQ(controller.GetFrameIntervalUs(), 0);
+        for (int i = 0; i < 20; ++i) { // 20: 足够降到下限
+            controller.OnFrameSent(MakeCost(10000, 30000, 1000), now); // 10000, 30000: 共 40ms
+        }
+        EXPECT_EQ(controller.GetCurrentQuality(), AdaptiveQuality::MIN_QUALITY);
+        EXPECT_GT(controller.GetFrameIntervalUs(), 40000); // 40000: 留出链路空闲时间
+        // 有余量时缓慢恢复
+        for (int i = 0; i < 40; ++i) { // 40: 足够让平均耗时回落
+            controller.OnFrameSent(MakeCost(1000, 1000, 1000), now); // 1000: 共 2ms
+        }
+        EXPECT_GT(controller.GetCurrentQuality(), AdaptiveQuality::MIN_QUALITY);
+        EXPECT_EQ(controller.GetFrameIntervalUs(), 0);
+        // 空闲超过 1 秒后恢复最高质量
+        now += std::chrono::seconds(2); // 2: 空闲 2 秒
+        EXPECT_EQ(controller.GetQuality(BASE_QUALITY, now), 80); // 80: 质量上限
+    }
+
+    TEST(AdaptiveQualityTest, BandwidthBudgetTest)
+    {
+        // 测试带宽预算限制帧间隔并降低质量
+        AdaptiveQuality controller;
+        AdaptiveQualityConfig config;
+        config.enabled = true;
+        config.bandwidthBytesPerSecond = 1000000; // 1000000: 1MB/s
+        controller.Configure(config);
+        AdaptiveQuality::Clock::time_point now = AdaptiveQuality::Clock::now();
+        controller.OnFrameSent(MakeCost(1000, 1000, 20000), now); // 20000: 20KB 每帧可达 50 帧每秒
+        EXPECT_EQ(controller.GetFrameIntervalUs(), 20000); // 20000: 20ms
+        EXPECT_EQ(controller.GetCurrentQuality(), AdaptiveQuality::MAX_QUALITY);
+        controller.Configure(config);
+        controller.OnFrameSent(MakeCost(1000, 1000, 100000), now); // 100000: 100KB 每帧只有 10 帧每秒
+        EXPECT_EQ(controller.GetFrameIntervalUs(), 100000); // 100000: 100ms
+        EXPECT_LT(controller.GetCurrentQuality(), AdaptiveQuality::MAX_QUALITY);
+        controller.OnFrameSent(MakeCost(1000, 1000, 10000000), now); // 10000000: 单帧超过帧间隔上限
+        EXPECT_EQ(controller.GetFrameIntervalUs(), AdaptiveQuality::MAX_FRAME_INTERVAL_US);
+    }
+}
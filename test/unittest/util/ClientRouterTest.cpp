@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ClientRouter.h"
+
+namespace {
+    std::shared_ptr<SendPacket> MakePacket(uint8_t value, size_t size)
+    {
+        std::vector<uint8_t> data(size, value);
+        return SendPacket::Copy(data.data(), data.size(), 16); // 16: 帧头预留
+    }
+
+    std::shared_ptr<SendPacket> GetFront(ClientRouter& router, void* handle)
+    {
+        size_t offset = 0;
+        return router.Find(handle)->queue.GetFront(offset);
+    }
+
+    void* const MAIN_CLIENT = reinterpret_cast<void*>(1); // 1: 整帧流客户端
+    void* const VARIANT_CLIENT = reinterpret_cast<void*>(2); // 2: 联播尺寸客户端
+    void* const ZOOM_CLIENT = reinterpret_cast<void*>(3); // 3: 指定视口的客户端
+
+    TEST(ClientRouterTest, RouteTest)
+    {
+        // 测试数据包只发给所选尺寸和视口相同的客户端
+        ClientRouter router(nullptr);
+        FrameViewport view;
+        view.width = 50; // 50: 视口宽度
+        view.height = 50; // 50: 视口高度
+        EXPECT_FALSE(router.SetViewport("zoom", view));
+        ASSERT_NE(router.Add(MAIN_CLIENT, 0, ""), nullptr);
+        ASSERT_NE(router.Add(VARIANT_CLIENT, 1, ""), nullptr);
+        ASSERT_NE(router.Add(ZOOM_CLIENT, 0, "zoom"), nullptr);
+        EXPECT_EQ(router.GetCount(), 3); // 3: 三个客户端
+        EXPECT_TRUE(router.HasClient(0));
+        EXPECT_TRUE(router.HasClient(1));
+        EXPECT_FALSE(router.HasClient(2)); // 2: 没有客户端选择的尺寸
+        ASSERT_EQ(router.GetViewports().size(), 1);
+        EXPECT_EQ(router.GetViewports()[0], view);
+        EXPECT_TRUE(router.GetPendingHandles().empty());
+        std::shared_ptr<SendPacket> frame = MakePacket(1, 100); // 100: 包长度
+        EXPECT_EQ(router.Route(frame, 0, FrameViewport()), 1);
+        EXPECT_EQ(GetFront(router, MAIN_CLIENT), frame);
+        EXPECT_EQ(GetFront(router, VARIANT_CLIENT), nullptr);
+        EXPECT_EQ(GetFront(router, ZOOM_CLIENT), nullptr);
+        std::shared_ptr<SendPacket> crop = MakePacket(2, 50); // 50: 包长度
+        EXPECT_EQ(router.Route(crop, 0, view), 1);
+        EXPECT_EQ(GetFront(router, ZOOM_CLIENT), crop);
+        EXPECT_EQ(router.Route(MakePacket(3, 10), 2, FrameViewport()), 0); // 2, 10: 无人订阅的尺寸
+        EXPECT_EQ(router.GetPendingHandles().size(), 2); // 2: 有待写数据的客户端
+        router.Remove(MAIN_CLIENT);
+        EXPECT_EQ(router.Find(MAIN_CLIENT), nullptr);
+        EXPECT_FALSE(router.HasClient(0));
+    }
+
+    TEST(ClientRouterTest, ResyncTest)
+    {
+        // 测试新连接和落后的客户端从备份恢复，视口区域本身就是完整画面
+        std::shared_ptr<SendPacket> first = MakePacket(1, 100); // 100: 包长度
+        std::shared_ptr<SendPacket> region = MakePacket(2, 10); // 10: 包长度
+        ClientRouter router([&first, &region](int32_t variant) {
+            return ClientRouter::SelectBackups(variant, first, { region }, {});
+        });
+        ASSERT_NE(router.Add(MAIN_CLIENT, 0, ""), nullptr);
+        EXPECT_EQ(GetFront(router, MAIN_CLIENT), first);
+        EXPECT_EQ(router.Find(MAIN_CLIENT)->queue.GetBytes(), 110); // 110: 整帧和区域
+        // 队列满后丢弃未开始的包，从备份和当前包恢复
+        size_t pushed = 2; // 2: 备份的包数
+        for (; pushed < ClientSendQueue::DEFAULT_MAX_PACKETS; pushed++) {
+            EXPECT_EQ(router.Route(MakePacket(3, 10), 0, FrameViewport()), 1); // 10: 包长度
+        }
+        std::shared_ptr<SendPacket> latest = MakePacket(4, 10); // 10: 包长度
+        EXPECT_EQ(router.Route(latest, 0, FrameViewport()), 1);
+        EXPECT_EQ(router.Find(MAIN_CLIENT)->queue.GetDroppedCount(), ClientSendQueue::DEFAULT_MAX_PACKETS);
+        EXPECT_EQ(router.Find(MAIN_CLIENT)->queue.GetBytes(), 120); // 120: 备份和当前包
+        EXPECT_EQ(GetFront(router, MAIN_CLIENT), first);
+        // 指定视口的客户端连接时不发送整帧备份，回到整帧流时从备份开始
+        FrameViewport view;
+        view.width = 50; // 50: 视口宽度
+        view.height = 50; // 50: 视口高度
+        router.SetViewport("zoom", view);
+        ASSERT_NE(router.Add(ZOOM_CLIENT, 0, "zoom"), nullptr);
+        EXPECT_TRUE(router.Find(ZOOM_CLIENT)->queue.IsEmpty());
+        EXPECT_EQ(router.Route(MakePacket(5, 10), 0, view), 1); // 10: 包长度
+        EXPECT_TRUE(router.SetViewport("zoom", FrameViewport()));
+        EXPECT_EQ(GetFront(router, ZOOM_CLIENT), first);
+        EXPECT_FALSE(router.SetViewport("zoom", FrameViewport()));
+        EXPECT_FALSE(ClientRouter::IsReplayed(1, FrameViewport()));
+        EXPECT_FALSE(ClientRouter::IsReplayed(0, view));
+    }
+
+    TEST(ClientRouterTest, SelectBackupsTest)
+    {
+        // 测试按尺寸选择备份，缺少包的链不发送
+        std::shared_ptr<SendPacket> first = MakePacket(1, 100); // 100: 包长度
+        std::shared_ptr<SendPacket> region = MakePacket(2, 10); // 10: 包长度
+        std::shared_ptr<SendPacket> variant = MakePacket(3, 20); // 20: 包长度
+        std::vector<std::shared_ptr<SendPacket>> packets =
+            ClientRouter::SelectBackups(0, first, { region }, { nullptr, variant });
+        ASSERT_EQ(packets.size(), 2); // 2: 整帧和区域
+        EXPECT_EQ(packets[0], first);
+        EXPECT_EQ(packets[1], region);
+        packets = ClientRouter::SelectBackups(2, first, { region }, { nullptr, variant }); // 2: 第二个联播尺寸
+        ASSERT_EQ(packets.size(), 1);
+        EXPECT_EQ(packets[0], variant);
+        EXPECT_TRUE(ClientRouter::SelectBackups(1, first, { region }, { nullptr, variant }).empty());
+        EXPECT_TRUE(ClientRouter::SelectBackups(3, first, {}, { nullptr, variant }).empty()); // 3: 未配置的尺寸
+        EXPECT_TRUE(ClientRouter::SelectBackups(0, nullptr, { region }, {}).empty());
+        EXPECT_TRUE(ClientRouter::SelectBackups(0, first, { nullptr }, {}).empty());
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ClientSendQueue.h"
+
+namespace {
+    std::shared_ptr<SendPacket> MakePacket(uint8_t value, size_t size)
+    {
+        std::vector<uint8_t> data(size, value);
+        return SendPacket::Copy(data.data(), data.size(), 16); // 16: 帧头预留
+    }
+
+    TEST(ClientSendQueueTest, PushAndAdvanceTest)
+    {
+        // 测试数据包按顺序写出，部分写出的包留在队首，写完后标记为已发送
+        ClientSendQueue queue(4, 1000); // 4: 最多4个包, 1000: 最多1000字节
+        std::shared_ptr<SendPacket> first = MakePacket(1, 100); // 100: 包长度
+        std::shared_ptr<SendPacket> second = MakePacket(2, 200); // 200: 包长度
+        EXPECT_TRUE(queue.Push(first));
+        EXPECT_TRUE(queue.Push(second));
+        EXPECT_EQ(queue.GetBytes(), 300); // 300: 两个包的长度
+        size_t offset = 1;
+        EXPECT_EQ(queue.GetFront(offset), first);
+        EXPECT_EQ(offset, 0);
+        EXPECT_FALSE(queue.Advance(40)); // 40: 写出一部分
+        EXPECT_EQ(queue.GetFront(offset), first);
+        EXPECT_EQ(offset, 40); // 40: 已写出的部分
+        EXPECT_FALSE(first->isWritten);
+        EXPECT_TRUE(queue.Advance(60)); // 60: 剩余部分
+        EXPECT_TRUE(first->isWritten);
+        EXPECT_EQ(queue.GetFront(offset), second);
+        EXPECT_TRUE(queue.Advance(200)); // 200: 整个包
+        EXPECT_TRUE(queue.IsEmpty());
+        EXPECT_EQ(queue.GetFront(offset), nullptr);
+        EXPECT_FALSE(queue.Advance(1));
+    }
+
+    TEST(ClientSendQueueTest, BoundAndReplaceTest)
+    {
+        // 测试超出上限时不入队，替换时保留正在写的包并丢弃其余的包
+        ClientSendQueue queue(2, 1000); // 2: 最多2个包, 1000: 最多1000字节
+        EXPECT_TRUE(queue.Push(MakePacket(1, 2000))); // 2000: 空队列接受超长的包
+        EXPECT_FALSE(queue.Push(MakePacket(2, 10))); // 10: 超出字节上限
+        EXPECT_TRUE(queue.Advance(2000)); // 2000: 整个包
+        std::shared_ptr<SendPacket> first = MakePacket(3, 100); // 100: 包长度
+        EXPECT_TRUE(queue.Push(first));
+        EXPECT_TRUE(queue.Push(MakePacket(4, 100))); // 100: 包长度
+        EXPECT_FALSE(queue.Push(MakePacket(5, 100))); // 100: 超出包数上限
+        EXPECT_FALSE(queue.Advance(10)); // 10: 第一个包开始写出
+        std::shared_ptr<SendPacket> resync = MakePacket(6, 50); // 50: 包长度
+        queue.Replace({ resync });
+        EXPECT_EQ(queue.GetDroppedCount(), 1);
+        EXPECT_EQ(queue.GetBytes(), 150); // 150: 正在写的包和替换的包
+        size_t offset = 0;
+        EXPECT_EQ(queue.GetFront(offset), first);
+        EXPECT_EQ(offset, 10); // 10: 已写出的部分
+        EXPECT_TRUE(queue.Advance(90)); // 90: 剩余部分
+        EXPECT_EQ(queue.GetFront(offset), resync);
+        queue.Replace({});
+        EXPECT_TRUE(queue.IsEmpty());
+        EXPECT_EQ(queue.GetDroppedCount(), 2); // 2: 共丢弃两个包
+    }
+
+    TEST(ClientSendQueueTest, SharedBufferTest)
+    {
+        // 测试多个队列共享同一个包时不复制缓冲，最后一个持有者释放时才归还缓冲
+        bool isReleased = false;
+        uint8_t* data = new uint8_t[116]; // 116: 16 字节帧头预留加 100 字节数据
+        std::shared_ptr<uint8_t> buffer(data, [&isReleased](uint8_t* released) {
+            isReleased = true;
+            delete[] released;
+        });
+        std::shared_ptr<SendPacket> packet = SendPacket::Create(std::move(buffer), 16, 100); // 16: 帧头预留
+        ASSERT_NE(packet, nullptr);
+        EXPECT_EQ(packet->GetData(), data + 16); // 16: 帧头预留
+        EXPECT_EQ(SendPacket::Create(nullptr, 16, 100), nullptr); // 16: 帧头预留
+        ClientSendQueue first;
+        ClientSendQueue second;
+        EXPECT_TRUE(first.Push(packet));
+        EXPECT_TRUE(second.Push(packet));
+        packet = nullptr;
+        size_t offset = 0;
+        EXPECT_EQ(first.GetFront(offset)->GetData(), second.GetFront(offset)->GetData());
+        EXPECT_TRUE(first.Advance(100)); // 100: 整个包
+        EXPECT_FALSE(isReleased);
+        EXPECT_TRUE(second.Advance(100)); // 100: 整个包
+        EXPECT_TRUE(isReleased);
+    }
+}
@@ -94,6 +94,11 @@ namespace {
         "-or 1080 2340 "
         "-cr 1080 2340 "
         "-fr 1080 2504 "
+        "-sr 540 1170 "
+        "-fps 30 "
+        "-sv 360x780,180x390 "
+        "-rec =file= "
+        "-lfd =dir= "
         "-f =file= "
         "-n entry "
         "-av ACE_2_0 "
@@ -776,6 +781,107 @@ namespace {
         }
     }
 
+    TEST_F(CommandParserTest, IsCommandValidTest_SrErr)
+    {
+        CommandParser::GetInstance().argsMap.clear();
+        // no param -sr
+        auto it = std::find(validParamVec.begin(), validParamVec.end(), "-sr");
+        if (it != validParamVec.end()) {
+            *it = "aaasr";
+        }
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_TRUE(CommandParser::GetInstance().IsCommandValid());
+        if (it != validParamVec.end()) {
+            *it = "-sr";
+        }
+        // param -sr value is invalid
+        CommandParser::GetInstance().argsMap.clear();
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = "0";
+        }
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_FALSE(CommandParser::GetInstance().IsCommandValid());
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = "540";
+        }
+    }
+
+    TEST_F(CommandParserTest, IsCommandValidTest_FpsErr)
+    {
+        CommandParser::GetInstance().argsMap.clear();
+        auto it = std::find(validParamVec.begin(), validParamVec.end(), "-fps");
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = "~!@#$%^&";
+        }
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_FALSE(CommandParser::GetInstance().IsCommandValid());
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = "121";
+        }
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_FALSE(CommandParser::GetInstance().IsCommandValid());
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = "30";
+        }
+    }
+
+    TEST_F(CommandParserTest, IsCommandValidTest_SvErr)
+    {
+        CommandParser::GetInstance().argsMap.clear();
+        auto it = std::find(validParamVec.begin(), validParamVec.end(), "-sv");
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = "360*780";
+        }
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_FALSE(CommandParser::GetInstance().IsCommandValid());
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = "360x780,180x0";
+        }
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_FALSE(CommandParser::GetInstance().IsCommandValid());
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = "360x780,180x390,90x195,45x98";
+        }
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_FALSE(CommandParser::GetInstance().IsCommandValid());
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = "360x780,180x390";
+        }
+    }
+
+    TEST_F(CommandParserTest, IsCommandValidTest_RecErr)
+    {
+        CommandParser::GetInstance().argsMap.clear();
+        auto it = std::find(validParamVec.begin(), validParamVec.end(), "-rec");
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = currDir + "/notexistdir/frames.rec";
+        }
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_FALSE(CommandParser::GetInstance().IsCommandValid());
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = currDir + "/";
+        }
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_FALSE(CommandParser::GetInstance().IsCommandValid());
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = currFile;
+        }
+    }
+
+    TEST_F(CommandParserTest, IsCommandValidTest_LfdErr)
+    {
+        CommandParser::GetInstance().argsMap.clear();
+        auto it = std::find(validParamVec.begin(), validParamVec.end(), "-lfd");
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = currDir + "/notexistdir";
+        }
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_FALSE(CommandParser::GetInstance().IsCommandValid());
+        if (it != validParamVec.end() && std::next(it) != validParamVec.end()) {
+            *std::next(it) = currDir;
+        }
+    }
+
     TEST_F(CommandParserTest, IsCommandValidTest_LjPathErr)
     {
         CommandParser::GetInstance().argsMap.clear();
@@ -1144,6 +1250,50 @@ namespace {
         EXPECT_EQ(CommandParser::GetInstance().GetFoldResolutionHeight(), value);
     }
 
+    TEST_F(CommandParserTest, GetSendResolutionTest)
+    {
+        CommandParser::GetInstance().argsMap.clear();
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_TRUE(CommandParser::GetInstance().IsCommandValid());
+        EXPECT_EQ(CommandParser::GetInstance().GetSendResolutionWidth(), 540); // 540: -sr width
+        EXPECT_EQ(CommandParser::GetInstance().GetSendResolutionHeight(), 1170); // 1170: -sr height
+    }
+
+    TEST_F(CommandParserTest, GetTargetFpsTest)
+    {
+        CommandParser::GetInstance().argsMap.clear();
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_TRUE(CommandParser::GetInstance().IsCommandValid());
+        EXPECT_EQ(CommandParser::GetInstance().GetTargetFps(), 30); // 30: -fps
+    }
+
+    TEST_F(CommandParserTest, GetSimulcastSizesTest)
+    {
+        CommandParser::GetInstance().argsMap.clear();
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_TRUE(CommandParser::GetInstance().IsCommandValid());
+        std::vector<std::pair<int32_t, int32_t>> sizes = CommandParser::GetInstance().GetSimulcastSizes();
+        ASSERT_EQ(sizes.size(), 2); // 2: -sv 中的两个尺寸
+        EXPECT_EQ(sizes[0], std::make_pair(360, 780)); // 360, 780: 第一个尺寸
+        EXPECT_EQ(sizes[1], std::make_pair(180, 390)); // 180, 390: 第二个尺寸
+    }
+
+    TEST_F(CommandParserTest, GetRecordPathTest)
+    {
+        CommandParser::GetInstance().argsMap.clear();
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_TRUE(CommandParser::GetInstance().IsCommandValid());
+        EXPECT_EQ(CommandParser::GetInstance().GetRecordPath(), currFile);
+    }
+
+    TEST_F(CommandParserTest, GetLastFrameDirTest)
+    {
+        CommandParser::GetInstance().argsMap.clear();
+        EXPECT_TRUE(CommandParser::GetInstance().ProcessCommand(validParamVec));
+        EXPECT_TRUE(CommandParser::GetInstance().IsCommandValid());
+        EXPECT_EQ(CommandParser::GetInstance().GetLastFrameDir(), currDir);
+    }
+
     TEST_F(CommandParserTest, GetLoaderJsonPathTest)
     {
         EXPECT_EQ(CommandParser::GetInstance().GetLoaderJsonPath(), currFile);
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "ConfigFrameCache.h"
+
+namespace {
+    FrameConfig MakeConfig(const std::string& colorMode)
+    {
+        FrameConfig config;
+        config.route = "pages/Index";
+        config.width = 2; // 2: 帧宽度
+        config.height = 2; // 2: 帧高度
+        config.orientation = "portrait";
+        config.colorMode = colorMode;
+        config.language = "zh_CN";
+        config.foldStatus = "unfold";
+        return config;
+    }
+
+    TEST(ConfigFrameCacheTest, StoreFindTest)
+    {
+        // 测试按配置保存和查找帧，同一配置的帧被替换
+        ConfigFrameCache cache;
+        CachedFrame frame;
+        EXPECT_FALSE(cache.Find(MakeConfig("light"), frame));
+        cache.Store(MakeConfig("light"), std::vector<uint8_t>(16, 1), 2, 2); // 16: 2 x 2 帧, 2: 宽高
+        cache.Store(MakeConfig("dark"), std::vector<uint8_t>(16, 2), 2, 2); // 16: 2 x 2 帧, 2: 宽高
+        ASSERT_TRUE(cache.Find(MakeConfig("light"), frame));
+        EXPECT_EQ((*frame.pixels)[0], 1);
+        EXPECT_EQ(frame.width, 2); // 2: 宽度
+        ASSERT_TRUE(cache.Find(MakeConfig("dark"), frame));
+        EXPECT_EQ((*frame.pixels)[0], 2); // 2: 深色模式的帧
+        cache.Store(MakeConfig("dark"), std::vector<uint8_t>(16, 3), 2, 2); // 16: 2 x 2 帧, 2: 宽高
+        EXPECT_EQ(cache.GetCount(), 2); // 2: 两种配置
+        EXPECT_EQ(cache.GetBytes(), 32); // 32: 两帧
+        ASSERT_TRUE(cache.Find(MakeConfig("dark"), frame));
+        EXPECT_EQ((*frame.pixels)[0], 3); // 3: 替换后的帧
+        // 其他字段不同也不匹配
+        FrameConfig other = MakeConfig("dark");
+        other.language = "en_US";
+        EXPECT_FALSE(cache.Find(other, frame));
+        // 空帧不保存
+        cache.Store(other, std::vector<uint8_t>(), 2, 2); // 2: 宽高
+        EXPECT_EQ(cache.GetCount(), 2); // 2: 两种配置
+    }
+
+    TEST(ConfigFrameCacheTest, EvictInvalidateTest)
+    {
+        // 测试超出条目数时淘汰最久未使用的帧，源码刷新后全部失效
+        ConfigFrameCache cache;
+        for (size_t i = 0; i <= ConfigFrameCache::MAX_ENTRIES; ++i) {
+            cache.Store(MakeConfig(std::to_string(i)), std::vector<uint8_t>(16, 1), 2, 2); // 16: 2 x 2 帧, 2: 宽高
+            if (i == 0) {
+                continue;
+            }
+            CachedFrame frame;
+            EXPECT_TRUE(cache.Find(MakeConfig("0"), frame)); // 一直使用的帧不被淘汰
+        }
+        EXPECT_EQ(cache.GetCount(), ConfigFrameCache::MAX_ENTRIES);
+        CachedFrame frame;
+        EXPECT_TRUE(cache.Find(MakeConfig("0"), frame));
+        EXPECT_FALSE(cache.Find(MakeConfig("1"), frame));
+        // 失效前取出的帧仍可使用
+        cache.Invalidate();
+        EXPECT_EQ(cache.GetRevision(), 1);
+        EXPECT_EQ(cache.GetCount(), 0);
+        EXPECT_EQ(cache.GetBytes(), 0);
+        EXPECT_FALSE(cache.Find(MakeConfig("0"), frame));
+        EXPECT_EQ(frame.pixels->size(), 16); // 16: 2 x 2 帧
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "DamageTracker.h"
+
+namespace {
+    const int32_t WIDTH = 100;
+    const int32_t HEIGHT = 70;
+    const int32_t PIXEL_SIZE = 4;
+    const int32_t TILE = 32;
+
+    std::vector<uint8_t> MakeFrame()
+    {
+        std::vector<uint8_t> frame(WIDTH * HEIGHT * PIXEL_SIZE);
+        for (size_t i = 0; i < frame.size(); ++i) {
+            frame[i] = static_cast<uint8_t>(i % 253); // 253: arbitrary pattern
+        }
+        return frame;
+    }
+
+    void TouchPixel(std::vector<uint8_t>& frame, int32_t x, int32_t y)
+    {
+        frame[(y * WIDTH + x) * PIXEL_SIZE] ^= 0xFF;
+    }
+
+    DamageRect MakeRect(int32_t x, int32_t y, int32_t width, int32_t height)
+    {
+        DamageRect rect;
+        rect.x = x;
+        rect.y = y;
+        rect.width = width;
+        rect.height = height;
+        return rect;
+    }
+
+    TEST(DamageTrackerTest, FirstFrameTest)
+    {
+        // 测试首帧、尺寸变化和 Reset 之后返回整帧区域
+        DamageTracker tracker(TILE);
+        std::vector<uint8_t> frame = MakeFrame();
+        std::vector<DamageRect> rects = tracker.Update(frame.data(), WIDTH * PIXEL_SIZE, WIDTH, HEIGHT);
+        ASSERT_EQ(rects.size(), 1);
+        EXPECT_EQ(rects[0], MakeRect(0, 0, WIDTH, HEIGHT));
+        EXPECT_TRUE(tracker.IsFullFrame(rects));
+        // 相同帧无变化
+        EXPECT_TRUE(tracker.Update(frame.data(), WIDTH * PIXEL_SIZE, WIDTH, HEIGHT).empty());
+        tracker.Reset();
+        EXPECT_TRUE(tracker.IsFullFrame(tracker.Update(frame.data(), WIDTH * PIXEL_SIZE, WIDTH, HEIGHT)));
+        rects = tracker.Update(frame.data(), WIDTH * PIXEL_SIZE, WIDTH / 2, HEIGHT); // 2: 宽度变化
+        ASSERT_EQ(rects.size(), 1);
+        EXPECT_EQ(rects[0], MakeRect(0, 0, WIDTH / 2, HEIGHT)); // 2: 宽度变化
+        // 非法参数
+        EXPECT_TRUE(tracker.Update(nullptr, WIDTH * PIXEL_SIZE, WIDTH, HEIGHT).empty());
+        EXPECT_TRUE(tracker.Update(frame.data(), PIXEL_SIZE, WIDTH, HEIGHT).empty());
+    }
+
+    TEST(DamageTrackerTest, SingleTileTest)
+    {
+        // 测试单个像素变化只返回所在的分块，边缘分块按帧尺寸裁剪
+        DamageTracker tracker(TILE);
+        std::vector<uint8_t> frame = MakeFrame();
+        tracker.Update(frame.data(), WIDTH * PIXEL_SIZE, WIDTH, HEIGHT);
+        TouchPixel(frame, 40, 10); // 40, 10: 第二列第一行分块
+        std::vector<DamageRect> rects = tracker.Update(frame.data(), WIDTH * PIXEL_SIZE, WIDTH, HEIGHT);
+        ASSERT_EQ(rects.size(), 1);
+        EXPECT_EQ(rects[0], MakeRect(TILE, 0, TILE, TILE));
+        EXPECT_FALSE(tracker.IsFullFrame(rects));
+        TouchPixel(frame, WIDTH - 1, HEIGHT - 1);
+        rects = tracker.Update(frame.data(), WIDTH * PIXEL_SIZE, WIDTH, HEIGHT);
+        ASSERT_EQ(rects.size(), 1);
+        EXPECT_EQ(rects[0], MakeRect(96, 64, 4, 6)); // 96, 64, 4, 6: 右下角不完整分块
+        // 变化已记录，再次比较无变化
+        EXPECT_TRUE(tracker.Update(frame.data(), WIDTH * PIXEL_SIZE, WIDTH, HEIGHT).empty());
+    }
+
+    TEST(DamageTrackerTest, MergeTest)
+    {
+        // 测试上下相邻且列范围相同的分块合并为一个矩形，不相邻的分块各自成为矩形
+        DamageTracker tracker(TILE);
+        std::vector<uint8_t> frame = MakeFrame();
+        tracker.Update(frame.data(), WIDTH * PIXEL_SIZE, WIDTH, HEIGHT);
+        TouchPixel(frame, 0, 0);
+        TouchPixel(frame, 0, 40); // 40: 第二行分块
+        TouchPixel(frame, 70, 0); // 70: 第三列分块
+        std::vector<DamageRect> rects = tracker.Update(frame.data(), WIDTH * PIXEL_SIZE, WIDTH, HEIGHT);
+        ASSERT_EQ(rects.size(), 2);
+        EXPECT_EQ(rects[0], MakeRect(0, 0, TILE, 64)); // 64: 两行分块
+        EXPECT_EQ(rects[1], MakeRect(64, 0, TILE, TILE));
+    }
+
+    TEST(DamageTrackerTest, BoundingRectTest)
+    {
+        // 测试矩形数量超过上限时合并为外接矩形
+        DamageTracker tracker(TILE, 1);
+        std::vector<uint8_t> frame = MakeFrame();
+        tracker.Update(frame.data(), WIDTH * PIXEL_SIZE, WIDTH, HEIGHT);
+        TouchPixel(frame, 0, 0);
+        TouchPixel(frame, 70, 40); // 70, 40: 第三列第二行分块
+        std::vector<DamageRect> rects = tracker.Update(frame.data(), WIDTH * PIXEL_SIZE, WIDTH, HEIGHT);
+        ASSERT_EQ(rects.size(), 1);
+        EXPECT_EQ(rects[0], MakeRect(0, 0, 96, 64)); // 96, 64: 三列两行分块
+    }
+
+    TEST(DamageTrackerTest, StrideTest)
+    {
+        // 测试带行间距的输入
+        const int32_t padding = 16;
+        size_t stride = WIDTH * PIXEL_SIZE + padding;
+        std::vector<uint8_t> frame(stride * HEIGHT, 0);
+        DamageTracker tracker(TILE);
+        tracker.Update(frame.data(), stride, WIDTH, HEIGHT);
+        frame[stride - 1] = 1; // 行尾填充不属于图像
+        EXPECT_TRUE(tracker.Update(frame.data(), stride, WIDTH, HEIGHT).empty());
+        frame[stride * 50 + 8] = 1; // 50, 8: 第二行第一列分块
+        std::vector<DamageRect> rects = tracker.Update(frame.data(), stride, WIDTH, HEIGHT);
+        ASSERT_EQ(rects.size(), 1);
+        EXPECT_EQ(rects[0], MakeRect(0, TILE, TILE, TILE));
+    }
+}
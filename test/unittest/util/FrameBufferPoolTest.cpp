@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#include "FrameBufferPool.h"
+
+namespace {
+    TEST(FrameBufferPoolTest, AcquireAndReleaseTest)
+    {
+        FrameBufferPool& pool = FrameBufferPool::GetInstance();
+        pool.Reset();
+        EXPECT_EQ(pool.Acquire(0), nullptr);
+        size_t size = 1000;
+        uint8_t* buffer = pool.Acquire(size);
+        ASSERT_NE(buffer, nullptr);
+        EXPECT_GE(pool.GetCapacity(buffer), size);
+        uint64_t count = pool.GetAllocationCount();
+        pool.Release(buffer);
+        // 同一档位的缓冲区被复用，不再重新分配
+        uint8_t* reused = pool.Acquire(size + 1);
+        EXPECT_EQ(reused, buffer);
+        EXPECT_EQ(pool.GetAllocationCount(), count);
+        pool.Release(reused);
+    }
+
+    TEST(FrameBufferPoolTest, PeakPoolBytesTest)
+    {
+        FrameBufferPool& pool = FrameBufferPool::GetInstance();
+        pool.Reset();
+        size_t size = 200 * 1024;
+        uint8_t* first = pool.Acquire(size);
+        uint8_t* second = pool.Acquire(size);
+        ASSERT_NE(first, nullptr);
+        ASSERT_NE(second, nullptr);
+        EXPECT_NE(first, second);
+        size_t bytes = pool.GetPoolBytes();
+        EXPECT_GE(bytes, size * 2);
+        EXPECT_GE(pool.GetPeakPoolBytes(), bytes);
+        pool.Release(first);
+        pool.Release(second);
+    }
+
+    TEST(FrameBufferPoolTest, ResetTest)
+    {
+        FrameBufferPool& pool = FrameBufferPool::GetInstance();
+        pool.Reset();
+        size_t base = pool.GetPoolBytes();
+        uint8_t* cached = pool.Acquire(4096);
+        uint8_t* inFlight = pool.Acquire(4096);
+        pool.Release(cached);
+        pool.Reset();
+        // 缓存的缓冲区立即释放，在途的缓冲区归还时释放
+        EXPECT_EQ(pool.GetPoolBytes(), base + pool.GetCapacity(inFlight));
+        pool.Release(inFlight);
+        EXPECT_EQ(pool.GetPoolBytes(), base);
+    }
+
+    TEST(FrameBufferPoolTest, ReleaseUnknownBufferTest)
+    {
+        FrameBufferPool& pool = FrameBufferPool::GetInstance();
+        uint8_t buffer[16] = {0};
+        size_t bytes = pool.GetPoolBytes();
+        pool.Release(nullptr);
+        pool.Release(buffer);
+        EXPECT_EQ(pool.GetPoolBytes(), bytes);
+        EXPECT_EQ(pool.GetCapacity(buffer), 0);
+    }
+
+    TEST(FrameBufferPoolTest, MaxFreeBytesTest)
+    {
+        // 测试缓存的缓冲区总量超过上限时先释放最早归还的缓冲区
+        FrameBufferPool& pool = FrameBufferPool::GetInstance();
+        pool.Reset();
+        size_t limit = pool.GetMaxFreeBytes();
+        size_t size = 128 * 1024; // 128 KiB: 档位的整数倍
+        uint8_t* oldest = pool.Acquire(size);
+        uint8_t* middle = pool.Acquire(size * 2); // 2: 另一个档位
+        uint8_t* newest = pool.Acquire(size);
+        ASSERT_NE(oldest, nullptr);
+        ASSERT_NE(middle, nullptr);
+        ASSERT_NE(newest, nullptr);
+        pool.SetMaxFreeBytes(size * 3); // 3: 容纳两个缓冲区
+        pool.Release(oldest);
+        pool.Release(middle);
+        EXPECT_EQ(pool.GetFreeBytes(), size * 3); // 3: 两个缓冲区
+        uint64_t evicted = pool.GetEvictionCount();
+        pool.Release(newest);
+        EXPECT_EQ(pool.GetEvictionCount(), evicted + 1);
+        EXPECT_EQ(pool.GetFreeBytes(), size * 3); // 3: 最早归还的被释放
+        EXPECT_EQ(pool.GetCapacity(oldest), 0);
+        EXPECT_EQ(pool.GetCapacity(middle), size * 2); // 2: 仍在缓存中
+        // 复用缓存的缓冲区后不再计入上限
+        uint64_t count = pool.GetAllocationCount();
+        EXPECT_EQ(pool.Acquire(size), newest);
+        EXPECT_EQ(pool.GetAllocationCount(), count);
+        EXPECT_EQ(pool.GetFreeBytes(), size * 2); // 2: 剩余一个缓冲区
+        pool.SetMaxFreeBytes(0);
+        EXPECT_EQ(pool.GetFreeBytes(), 0);
+        pool.SetMaxFreeBytes(limit);
+        pool.Release(newest);
+    }
+}
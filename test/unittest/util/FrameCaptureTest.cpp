@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "FrameCapture.h"
+
+namespace {
+    const std::chrono::milliseconds LONG_QUIET(10000); // 10000: 不会因静止而结束
+    const std::chrono::milliseconds TIMEOUT(5000); // 5000: 测试的超时
+
+    TEST(FrameCaptureTest, NextFrameTest)
+    {
+        // 测试未等待时不拷贝帧，等待时取到之后发送的第一帧
+        FrameCapture capture;
+        std::vector<uint8_t> first = { 1, 2, 3, 4 };
+        capture.Offer(first.data(), first.size(), 1, 1);
+        std::vector<uint8_t> second = { 5, 6, 7, 8 };
+        std::thread sender([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20)); // 20: 等待截图开始
+            capture.Offer(second.data(), second.size(), 1, 1);
+        });
+        CapturedFrame frame;
+        EXPECT_TRUE(capture.Capture(1, LONG_QUIET, TIMEOUT, frame));
+        sender.join();
+        EXPECT_EQ(frame.pixels, second);
+        EXPECT_EQ(frame.width, 1);
+        EXPECT_EQ(frame.height, 1);
+    }
+
+    TEST(FrameCaptureTest, StableFramesTest)
+    {
+        // 测试连续 N 帧相同才返回，中间变化会重新计数
+        FrameCapture capture;
+        std::vector<std::vector<uint8_t>> frames = {
+            { 1, 1, 1, 1 }, { 2, 2, 2, 2 }, { 2, 2, 2, 2 }, { 3, 3, 3, 3 }, { 3, 3, 3, 3 }, { 3, 3, 3, 3 }
+        };
+        size_t offered = 0;
+        CapturedFrame frame;
+        bool isCaptured = capture.Capture(3, LONG_QUIET, TIMEOUT, frame, [&]() { // 3: 连续三帧相同
+            std::thread([&]() {
+                for (const std::vector<uint8_t>& pixels : frames) {
+                    capture.Offer(pixels.data(), pixels.size(), 1, 1);
+                    offered++;
+                }
+            }).join();
+        });
+        EXPECT_TRUE(isCaptured);
+        EXPECT_EQ(offered, frames.size());
+        EXPECT_EQ(frame.pixels, frames.back());
+    }
+
+    TEST(FrameCaptureTest, QuietAndTimeoutTest)
+    {
+        // 测试静止画面在静默期后返回，没有帧时超时失败
+        FrameCapture capture;
+        std::vector<uint8_t> still = { 9, 9, 9, 9 };
+        CapturedFrame frame;
+        auto start = FrameCapture::Clock::now();
+        EXPECT_TRUE(capture.Capture(5, std::chrono::milliseconds(50), TIMEOUT, frame, [&]() { // 5: 帧数, 50: 静默期
+            capture.Offer(still.data(), still.size(), 1, 1);
+        }));
+        EXPECT_GE(FrameCapture::Clock::now() - start, std::chrono::milliseconds(50)); // 50: 静默期
+        EXPECT_EQ(frame.pixels, still);
+
+        CapturedFrame missing;
+        EXPECT_FALSE(capture.Capture(1, LONG_QUIET, std::chrono::milliseconds(30), missing)); // 30: 超时
+        EXPECT_TRUE(missing.pixels.empty());
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "FrameCodec.h"
+#include "Lz4Codec.h"
+#include "QoiCodec.h"
+
+namespace {
+    const int32_t WIDTH = 97;
+    const int32_t HEIGHT = 61;
+    const size_t PIXEL_SIZE = 4;
+
+    // 上半部分为纯色，下半部分为渐变和噪声，覆盖各种编码分支
+    std::vector<uint8_t> MakeFrame()
+    {
+        std::vector<uint8_t> frame(WIDTH * HEIGHT * PIXEL_SIZE);
+        uint32_t seed = 12345; // 12345: 随机种子
+        for (int32_t y = 0; y < HEIGHT; ++y) {
+            for (int32_t x = 0; x < WIDTH; ++x) {
+                uint8_t* px = frame.data() + (y * WIDTH + x) * PIXEL_SIZE;
+                seed = seed * 1103515245 + 12345; // 1103515245, 12345: 线性同余
+                if (y < HEIGHT / 2) { // 2: 上半部分
+                    px[0] = 250; // 250: 纯色
+                    px[1] = 250; // 250: 纯色
+                    px[2] = 250; // 2: 蓝色, 250: 纯色
+                    px[3] = 255; // 3: 透明度, 255: 不透明
+                } else if (x < WIDTH / 2) { // 2: 左半部分
+                    px[0] = static_cast<uint8_t>(x * 2); // 2: 渐变
+                    px[1] = static_cast<uint8_t>(y * 3); // 3: 渐变
+                    px[2] = static_cast<uint8_t>(x + y); // 2: 蓝色
+                    px[3] = (x % 7 == 0) ? 128 : 255; // 3: 透明度, 7: 间隔, 128: 半透明, 255: 不透明
+                } else {
+                    px[0] = static_cast<uint8_t>(seed >> 24); // 24: 噪声
+                    px[1] = static_cast<uint8_t>(seed >> 16); // 16: 噪声
+                    px[2] = static_cast<uint8_t>(seed >> 8); // 2: 蓝色, 8: 噪声
+                    px[3] = 255; // 3: 透明度, 255: 不透明
+                }
+            }
+        }
+        return frame;
+    }
+
+    void CheckRoundTrip(FrameCodec& codec, const std::vector<uint8_t>& frame)
+    {
+        std::vector<uint8_t> encoded(frame.size() * 2); // 2: 足够容纳最坏情况
+        size_t size = codec.Encode(frame.data(), WIDTH, HEIGHT, encoded.data(), encoded.size());
+        ASSERT_GT(size, 0);
+        std::vector<uint8_t> decoded(frame.size());
+        EXPECT_TRUE(codec.Decode(encoded.data(), size, WIDTH, HEIGHT, decoded.data()));
+        EXPECT_EQ(decoded, frame);
+        // 缓冲区不足时编码失败且不越界
+        std::vector<uint8_t> small(size / 2); // 2: 一半大小
+        EXPECT_EQ(codec.Encode(frame.data(), WIDTH, HEIGHT, small.data(), small.size()), 0);
+        // 截断的数据解码失败
+        EXPECT_FALSE(codec.Decode(encoded.data(), size / 2, WIDTH, HEIGHT, decoded.data())); // 2: 截断一半
+    }
+
+    TEST(FrameCodecTest, QoiRoundTripTest)
+    {
+        // 测试 QOI 编解码无损
+        QoiCodec codec;
+        std::vector<uint8_t> frame = MakeFrame();
+        CheckRoundTrip(codec, frame);
+        std::vector<uint8_t> encoded(frame.size() * 2); // 2: 足够容纳最坏情况
+        EXPECT_LT(codec.Encode(frame.data(), WIDTH, HEIGHT, encoded.data(), encoded.size()), frame.size());
+    }
+
+    TEST(FrameCodecTest, Lz4RoundTripTest)
+    {
+        // 测试 LZ4 编解码无损，且多帧复用同一个编码器
+        Lz4Codec codec;
+        std::vector<uint8_t> frame = MakeFrame();
+        CheckRoundTrip(codec, frame);
+        frame[0] = 0;
+        CheckRoundTrip(codec, frame);
+        // 短数据只有字面量
+        uint8_t shortData[] = { 1, 2, 3, 4, 5, 6, 7 };
+        uint8_t encoded[16] = { 0 }; // 16: 足够容纳短数据
+        size_t size = codec.Compress(shortData, sizeof(shortData), encoded, sizeof(encoded));
+        EXPECT_EQ(size, sizeof(shortData) + 1);
+        uint8_t decoded[sizeof(shortData)] = { 0 };
+        EXPECT_TRUE(codec.Decompress(encoded, size, decoded, sizeof(decoded)));
+        EXPECT_EQ(std::vector<uint8_t>(decoded, decoded + sizeof(decoded)),
+            std::vector<uint8_t>(shortData, shortData + sizeof(shortData)));
+    }
+
+    TEST(FrameCodecTest, RawRoundTripTest)
+    {
+        // 测试原始 RGBA 拷贝
+        RawFrameCodec codec;
+        std::vector<uint8_t> frame = MakeFrame();
+        CheckRoundTrip(codec, frame);
+    }
+
+    TEST(FrameCodecTest, SelectorTest)
+    {
+        // 测试会话指定编解码器和自动选择
+        FrameCodecSelector selector;
+        EXPECT_TRUE(selector.IsDefault());
+        EXPECT_EQ(selector.Pick(), nullptr);
+        EXPECT_FALSE(selector.SetCodec("zstd"));
+        EXPECT_TRUE(selector.SetCodec("qoi"));
+        ASSERT_NE(selector.Pick(), nullptr);
+        EXPECT_EQ(selector.Pick()->GetId(), FrameCodecId::QOI);
+        EXPECT_EQ(selector.GetCodecName(), "qoi");
+        // 自动模式先逐个测量，再选总耗时最少的
+        EXPECT_TRUE(selector.SetCodec("auto"));
+        const size_t rawBytes = 1000000;
+        for (int i = 0; i < 3; ++i) { // 3: 三个候选
+            FrameCodec* codec = selector.Pick();
+            ASSERT_NE(codec, nullptr);
+            if (codec->GetId() == FrameCodecId::LZ4) {
+                selector.OnFrameSent(codec->GetId(), rawBytes, rawBytes / 10, 2000, 1000); // 10: 压缩率
+            } else if (codec->GetId() == FrameCodecId::QOI) {
+                selector.OnFrameSent(codec->GetId(), rawBytes, rawBytes / 5, 5000, 2000); // 5: 压缩率
+            } else {
+                selector.OnFrameSent(codec->GetId(), rawBytes, rawBytes, 100, 10000); // 10000: 链路耗时
+            }
+        }
+        EXPECT_EQ(selector.Pick()->GetId(), FrameCodecId::LZ4);
+    }
+}
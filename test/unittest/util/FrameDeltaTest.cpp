@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "FrameDelta.h"
+
+namespace {
+    const int32_t WIDTH = 64;
+    const int32_t HEIGHT = 48;
+    const size_t FRAME_SIZE = WIDTH * HEIGHT * 4; // 4: 每像素字节数
+
+    std::vector<uint8_t> MakeFrame(uint8_t seed)
+    {
+        std::vector<uint8_t> frame(FRAME_SIZE);
+        for (size_t i = 0; i < frame.size(); ++i) {
+            frame[i] = static_cast<uint8_t>(i * 7 + seed); // 7: 生成不易压缩的图案
+        }
+        return frame;
+    }
+
+    TEST(FrameDeltaTest, EncodeApplyTest)
+    {
+        // 测试差分帧可以在客户端还原出新画面
+        FrameDelta delta;
+        delta.Configure(true, FrameDelta::DEFAULT_KEYFRAME_INTERVAL);
+        std::vector<uint8_t> frame = MakeFrame(0);
+        std::vector<uint8_t> encoded(FRAME_SIZE);
+        // 没有参考帧时需要关键帧
+        EXPECT_EQ(delta.Encode(frame.data(), WIDTH, HEIGHT, 1, encoded.data(), encoded.size()), 0);
+        delta.SetReference(frame.data(), WIDTH, HEIGHT, 1);
+        std::vector<uint8_t> next = frame;
+        next[100] ^= 0xFF; // 100: 改变一个字节
+        next[2000] = 0; // 2000: 改变另一个字节
+        size_t size = delta.Encode(next.data(), WIDTH, HEIGHT, 1, encoded.data(), encoded.size());
+        ASSERT_GT(size, 0);
+        EXPECT_LT(size, FRAME_SIZE / 50); // 50: 少量变化时差分远小于整帧
+        FrameDelta client;
+        std::vector<uint8_t> picture = frame;
+        EXPECT_TRUE(client.Apply(encoded.data(), size, WIDTH, HEIGHT, picture.data()));
+        EXPECT_EQ(picture, next);
+        // 截断的差分被拒绝
+        EXPECT_FALSE(client.Apply(encoded.data(), size - 1, WIDTH, HEIGHT, picture.data()));
+    }
+
+    TEST(FrameDeltaTest, KeyframeTest)
+    {
+        // 测试周期关键帧、连接变化、尺寸变化和变化过大时回退到关键帧
+        FrameDelta delta;
+        delta.Configure(true, 2); // 2: 每两帧差分后发送关键帧
+        std::vector<uint8_t> frame = MakeFrame(0);
+        std::vector<uint8_t> encoded(FRAME_SIZE);
+        delta.SetReference(frame.data(), WIDTH, HEIGHT, 1);
+        EXPECT_GT(delta.Encode(frame.data(), WIDTH, HEIGHT, 1, encoded.data(), encoded.size()), 0);
+        EXPECT_GT(delta.Encode(frame.data(), WIDTH, HEIGHT, 1, encoded.data(), encoded.size()), 0);
+        EXPECT_EQ(delta.Encode(frame.data(), WIDTH, HEIGHT, 1, encoded.data(), encoded.size()), 0);
+        delta.SetReference(frame.data(), WIDTH, HEIGHT, 1);
+        // 客户端重连
+        EXPECT_EQ(delta.Encode(frame.data(), WIDTH, HEIGHT, 2, encoded.data(), encoded.size()), 0); // 2: 新连接
+        // 尺寸变化
+        EXPECT_EQ(delta.Encode(frame.data(), HEIGHT, WIDTH, 1, encoded.data(), encoded.size()), 0);
+        // 整帧都变化
+        std::vector<uint8_t> other(FRAME_SIZE);
+        uint32_t seed = 1;
+        for (uint8_t& value : other) {
+            seed = seed * 1103515245 + 12345; // 1103515245, 12345: 线性同余
+            value = static_cast<uint8_t>(seed >> 24); // 24: 取高位
+        }
+        EXPECT_EQ(delta.Encode(other.data(), WIDTH, HEIGHT, 1, encoded.data(), encoded.size()), 0);
+        // 请求关键帧
+        delta.RequestKeyframe();
+        EXPECT_EQ(delta.Encode(frame.data(), WIDTH, HEIGHT, 1, encoded.data(), encoded.size()), 0);
+        // 关闭后不再保留参考帧
+        delta.SetReference(frame.data(), WIDTH, HEIGHT, 1);
+        delta.Configure(false, 2); // 2: 关键帧间隔
+        EXPECT_FALSE(delta.IsEnabled());
+        EXPECT_EQ(delta.Encode(frame.data(), WIDTH, HEIGHT, 1, encoded.data(), encoded.size()), 0);
+    }
+}
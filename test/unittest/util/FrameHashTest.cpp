@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <set>
+#include <vector>
+#include "gtest/gtest.h"
+#include "FrameHash.h"
+
+namespace {
+    std::vector<uint8_t> MakeData(size_t size)
+    {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<uint8_t>((i * 31) % 256); // 31: arbitrary pattern
+        }
+        return data;
+    }
+
+    TEST(FrameHashTest, SameDataTest)
+    {
+        // 测试相同数据得到相同哈希值，种子不同则哈希值不同
+        std::vector<uint8_t> first = MakeData(100 * 100 * 4); // 100 * 100 * 4: 100x100 RGBA 帧
+        std::vector<uint8_t> second = first;
+        EXPECT_EQ(FrameHash::Hash64(first.data(), first.size()), FrameHash::Hash64(second.data(), second.size()));
+        EXPECT_NE(FrameHash::Hash64(first.data(), first.size(), 1), FrameHash::Hash64(first.data(), first.size()));
+        EXPECT_EQ(FrameHash::Hash64(nullptr, first.size()), FrameHash::Hash64(first.data(), 0));
+    }
+
+    TEST(FrameHashTest, SingleByteChangeTest)
+    {
+        // 测试任意位置改变一个字节哈希值都会变化，覆盖整块、块内条带、末尾重叠条带和短数据
+        const std::vector<size_t> sizes = { 7, 63, 64, 65, 1024, 1025, 3000 };
+        for (size_t size : sizes) {
+            std::vector<uint8_t> data = MakeData(size);
+            uint64_t base = FrameHash::Hash64(data.data(), data.size());
+            std::set<uint64_t> hashes = { base };
+            for (size_t i = 0; i < size; ++i) {
+                data[i] ^= 1;
+                hashes.insert(FrameHash::Hash64(data.data(), data.size()));
+                data[i] ^= 1;
+            }
+            EXPECT_EQ(hashes.size(), size + 1) << "size: " << size;
+            EXPECT_EQ(FrameHash::Hash64(data.data(), data.size()), base);
+        }
+    }
+
+    TEST(FrameHashTest, LengthTest)
+    {
+        // 测试内容相同长度不同时哈希值不同
+        std::vector<uint8_t> data(4096, 0);
+        std::set<uint64_t> hashes;
+        for (size_t size = 0; size <= data.size(); size += 64) { // 64: 条带长度
+            hashes.insert(FrameHash::Hash64(data.data(), size));
+        }
+        EXPECT_EQ(hashes.size(), data.size() / 64 + 1); // 64: 条带长度
+    }
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "FrameMailbox.h"
+
+namespace {
+    TEST(FrameMailboxTest, PostTest)
+    {
+        // 测试投递的帧被发送线程处理，且处理的是数据的拷贝
+        std::vector<uint8_t> received;
+        int32_t width = 0;
+        int32_t height = 0;
+        FrameMailbox mailbox([&](const MailboxFrame& frame) {
+            received.assign(frame.data, frame.data + frame.length);
+            width = frame.width;
+            height = frame.height;
+        });
+        std::vector<uint8_t> data = { 1, 2, 3, 4 };
+        EXPECT_EQ(mailbox.Post(data.data(), data.size(), 1, 1), FrameMailbox::PostResult::QUEUED);
+        data[0] = 0;
+        mailbox.WaitIdle();
+        EXPECT_EQ(received, std::vector<uint8_t>({ 1, 2, 3, 4 }));
+        EXPECT_EQ(width, 1);
+        EXPECT_EQ(height, 1);
+        EXPECT_EQ(mailbox.Post(nullptr, data.size(), 1, 1), FrameMailbox::PostResult::FAILED);
+        mailbox.Stop();
+        EXPECT_EQ(mailbox.Post(data.data(), data.size(), 1, 1), FrameMailbox::PostResult::FAILED);
+    }
+
+    TEST(FrameMailboxTest, PostSwapTest)
+    {
+        // 测试交换缓冲区投递的帧不拷贝，调用方拿回可复用的缓冲区
+        std::vector<uint8_t> received;
+        FrameMailbox mailbox([&](const MailboxFrame& frame) {
+            received.assign(frame.data, frame.data + frame.length);
+        });
+        std::vector<uint8_t> data = { 1, 2, 3, 4 };
+        const uint8_t* posted = data.data();
+        EXPECT_EQ(mailbox.Post(data, 1, 1), FrameMailbox::PostResult::QUEUED);
+        EXPECT_NE(data.data(), posted);
+        mailbox.WaitIdle();
+        EXPECT_EQ(received, std::vector<uint8_t>({ 1, 2, 3, 4 }));
+        data.assign({ 5, 6 }); // 5, 6: 第二帧
+        EXPECT_EQ(mailbox.Post(data, 1, 1), FrameMailbox::PostResult::QUEUED);
+        mailbox.WaitIdle();
+        EXPECT_EQ(received, std::vector<uint8_t>({ 5, 6 }));
+        data.clear();
+        EXPECT_EQ(mailbox.Post(data, 1, 1), FrameMailbox::PostResult::FAILED);
+    }
+
+    TEST(FrameMailboxTest, LatestFrameWinsTest)
+    {
+        // 测试发送线程忙时新帧替换未处理的帧，只处理最新的一帧
+        std::mutex gateMutex;
+        std::condition_variable gateCondition;
+        bool isGateOpen = false;
+        bool isFirstStarted = false;
+        std::vector<uint8_t> handled;
+        FrameMailbox mailbox([&](const MailboxFrame& frame) {
+            std::unique_lock<std::mutex> lock(gateMutex);
+            handled.push_back(frame.data[0]);
+            isFirstStarted = true;
+            gateCondition.notify_all();
+            gateCondition.wait(lock, [&]() { return isGateOpen; });
+        });
+        uint8_t frames[] = { 1, 2, 3, 4 };
+        EXPECT_EQ(mailbox.Post(&frames[0], 1, 1, 1), FrameMailbox::PostResult::QUEUED);
+        {
+            std::unique_lock<std::mutex> lock(gateMutex);
+            gateCondition.wait(lock, [&]() { return isFirstStarted; });
+        }
+        EXPECT_EQ(mailbox.Post(&frames[1], 1, 1, 1), FrameMailbox::PostResult::QUEUED);
+        EXPECT_EQ(mailbox.Post(&frames[2], 1, 1, 1), FrameMailbox::PostResult::REPLACED); // 2: 替换第二帧
+        EXPECT_EQ(mailbox.Post(&frames[3], 1, 1, 1), FrameMailbox::PostResult::REPLACED); // 3: 替换第三帧
+        {
+            std::lock_guard<std::mutex> guard(gateMutex);
+            isGateOpen = true;
+        }
+        gateCondition.notify_all();
+        mailbox.WaitIdle();
+        EXPECT_EQ(handled, std::vector<uint8_t>({ 1, 4 })); // 4: 最新一帧
+        EXPECT_EQ(mailbox.GetReplacedCount(), 2); // 2: 两帧被丢弃
+    }
+
+    TEST(FrameMailboxTest, NoHandlerTest)
+    {
+        // 测试未设置处理函数时投递失败
+        FrameMailbox mailbox;
+        uint8_t data = 1;
+        EXPECT_EQ(mailbox.Post(&data, 1, 1, 1), FrameMailbox::PostResult::FAILED);
+        mailbox.WaitIdle();
+    }
+
+    TEST(FrameMailboxTest, IdleHandlerTest)
+    {
+        // 测试空闲超过设定时间后最后一帧再交给空闲处理函数一次，新帧到来后重新计时
+        std::mutex idleMutex;
+        std::condition_variable idleCondition;
+        std::vector<uint8_t> refined;
+        FrameMailbox mailbox([](const MailboxFrame&) {});
+        mailbox.SetIdleHandler([&](const MailboxFrame& frame) {
+            std::lock_guard<std::mutex> guard(idleMutex);
+            refined.push_back(frame.data[0]);
+            idleCondition.notify_all();
+        }, []() { return std::chrono::milliseconds(10); }); // 10: 空闲 10ms
+        uint8_t frames[] = { 1, 2 };
+        auto waitRefined = [&](size_t count) {
+            std::unique_lock<std::mutex> lock(idleMutex);
+            return idleCondition.wait_for(lock, std::chrono::seconds(5), [&]() { return refined.size() >= count; });
+        };
+        EXPECT_EQ(mailbox.Post(&frames[0], 1, 1, 1), FrameMailbox::PostResult::QUEUED);
+        EXPECT_TRUE(waitRefined(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50)); // 50: 超过空闲时间，不应再次处理
+        EXPECT_EQ(mailbox.Post(&frames[1], 1, 1, 1), FrameMailbox::PostResult::QUEUED);
+        EXPECT_TRUE(waitRefined(2)); // 2: 第二帧
+        mailbox.Stop();
+        EXPECT_EQ(refined, std::vector<uint8_t>({ 1, 2 }));
+    }
+
+    TEST(FrameMailboxTest, IdleDisabledTest)
+    {
+        // 测试空闲时间为 0 时不调用空闲处理函数
+        bool isRefined = false;
+        FrameMailbox mailbox([](const MailboxFrame&) {});
+        mailbox.SetIdleHandler([&](const MailboxFrame&) { isRefined = true; },
+            []() { return std::chrono::milliseconds(0); });
+        uint8_t data = 1;
+        EXPECT_EQ(mailbox.Post(&data, 1, 1, 1), FrameMailbox::PostResult::QUEUED);
+        mailbox.WaitIdle();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20)); // 20: 等待可能的空闲处理
+        mailbox.Stop();
+        EXPECT_FALSE(isRefined);
+    }
+
+    TEST(FrameMailboxTest, ResendTest)
+    {
+        // 测试重发时最后处理的帧再次交给处理函数，未处理过任何帧时不重发
+        std::vector<uint8_t> handled;
+        FrameMailbox mailbox([&](const MailboxFrame& frame) { handled.push_back(frame.data[0]); });
+        mailbox.Resend();
+        mailbox.WaitIdle();
+        EXPECT_TRUE(handled.empty());
+        uint8_t data = 7; // 7: 帧内容
+        EXPECT_EQ(mailbox.Post(&data, 1, 1, 1), FrameMailbox::PostResult::QUEUED);
+        mailbox.WaitIdle();
+        mailbox.Resend();
+        mailbox.WaitIdle();
+        mailbox.Stop();
+        ASSERT_EQ(handled.size(), 2); // 2: 首次发送和重发
+        EXPECT_EQ(handled[1], 7); // 7: 重发的仍是最后一帧
+    }
+
+    TEST(FrameMailboxTest, CopyLastPostedTest)
+    {
+        // 测试复制最后投递的帧及其标签，发送线程尚未处理的帧也能取到
+        std::mutex gateMutex;
+        std::condition_variable gateCondition;
+        bool isGateOpen = true;
+        int startedCount = 0;
+        FrameMailbox mailbox([&](const MailboxFrame& frame) {
+            std::unique_lock<std::mutex> lock(gateMutex);
+            startedCount++;
+            gateCondition.notify_all();
+            gateCondition.wait(lock, [&]() { return isGateOpen; });
+        });
+        std::vector<uint8_t> copy;
+        int32_t width = 0;
+        int32_t height = 0;
+        uint64_t tag = 0;
+        EXPECT_FALSE(mailbox.CopyLastPosted(copy, width, height, tag));
+        std::vector<uint8_t> data = { 1, 2, 3, 4, 5, 6, 7, 8 }; // 8: 2 x 1 帧
+        mailbox.Post(data.data(), data.size(), 2, 1, 3); // 2: 宽度, 3: 标签
+        mailbox.WaitIdle();
+        ASSERT_TRUE(mailbox.CopyLastPosted(copy, width, height, tag));
+        EXPECT_EQ(copy, data);
+        EXPECT_EQ(width, 2); // 2: 宽度
+        EXPECT_EQ(height, 1);
+        EXPECT_EQ(tag, 3); // 3: 标签
+        {
+            std::lock_guard<std::mutex> guard(gateMutex);
+            isGateOpen = false;
+        }
+        mailbox.Resend(); // 发送线程阻塞在重发上，之后投递的帧保持未处理
+        {
+            std::unique_lock<std::mutex> lock(gateMutex);
+            gateCondition.wait(lock, [&]() { return startedCount == 2; }); // 2: 第一帧和重发
+        }
+        std::vector<uint8_t> pending = { 9, 9 }; // 9: 未处理的帧
+        mailbox.Post(pending.data(), pending.size(), 1, 2, 4); // 2: 高度, 4: 标签
+        ASSERT_TRUE(mailbox.CopyLastPosted(copy, width, height, tag));
+        EXPECT_EQ(copy, pending);
+        EXPECT_EQ(height, 2); // 2: 高度
+        EXPECT_EQ(tag, 4); // 4: 标签
+        {
+            std::lock_guard<std::mutex> guard(gateMutex);
+            isGateOpen = true;
+        }
+        gateCondition.notify_all();
+        mailbox.WaitIdle();
+        mailbox.Stop();
+    }
+}
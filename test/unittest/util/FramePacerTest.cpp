@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "FramePacer.h"
+
+namespace {
+    using Us = std::chrono::microseconds;
+
+    TEST(FramePacerTest, UnpacedTest)
+    {
+        // 测试未设置帧率时下一帧可立即开始
+        FramePacer pacer;
+        FramePacer::Clock::time_point now = FramePacer::Clock::now();
+        EXPECT_EQ(pacer.NextDeadline(now), now);
+        pacer.SetTargetFps(-1); // -1: 无效帧率按 0 处理
+        EXPECT_EQ(pacer.GetTargetFps(), 0);
+        pacer.SetTargetFps(1000); // 1000: 超过上限
+        EXPECT_EQ(pacer.GetTargetFps(), FramePacer::MAX_FPS);
+    }
+
+    TEST(FramePacerTest, DeadlineGridTest)
+    {
+        // 测试截止时间按固定间隔推进，单帧耗时抖动不影响平均帧率
+        FramePacer pacer;
+        pacer.SetTargetFps(25); // 25: 每帧 40ms
+        FramePacer::Clock::time_point start = FramePacer::Clock::now();
+        EXPECT_EQ(pacer.NextDeadline(start), start + Us(40000)); // 40000: 一帧间隔
+        // 在截止时间之后 10ms 才开始的帧，下一截止时间仍在网格上
+        EXPECT_EQ(pacer.NextDeadline(start + Us(50000)), start + Us(80000)); // 50000, 80000: 第二个网格点
+        EXPECT_EQ(pacer.NextDeadline(start + Us(80000)), start + Us(120000)); // 120000: 第三个网格点
+    }
+
+    TEST(FramePacerTest, IdleRestartTest)
+    {
+        // 测试空闲超过一帧间隔后从新帧开始重新计时，不会连续补发
+        FramePacer pacer;
+        pacer.SetTargetFps(50); // 50: 每帧 20ms
+        FramePacer::Clock::time_point start = FramePacer::Clock::now();
+        EXPECT_EQ(pacer.NextDeadline(start), start + Us(20000)); // 20000: 一帧间隔
+        FramePacer::Clock::time_point later = start + Us(1000000); // 1000000: 空闲 1s
+        EXPECT_EQ(pacer.NextDeadline(later), later + Us(20000)); // 20000: 一帧间隔
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "FramePyramid.h"
+
+namespace {
+    constexpr size_t PIXEL_SIZE = 4;
+
+    std::vector<uint8_t> MakeFrame(int32_t width, int32_t height)
+    {
+        std::vector<uint8_t> frame(static_cast<size_t>(width) * height * PIXEL_SIZE);
+        for (size_t i = 0; i < frame.size(); i++) {
+            frame[i] = static_cast<uint8_t>(i % 251); // 251: 非 2 的幂，避免规律图案
+        }
+        return frame;
+    }
+
+    TEST(FramePyramidTest, LevelSizeTest)
+    {
+        // 测试各层按配置顺序输出，尺寸与 -sr 的缩放规则一致
+        FramePyramid pyramid;
+        pyramid.SetSizes({ { 180, 390 }, { 360, 780 }, { 2000, 4000 }, { 90, 195 } }); // 超出上限的配置被丢弃
+        ASSERT_EQ(pyramid.GetLevelCount(), FramePyramid::MAX_LEVELS);
+        std::vector<uint8_t> frame = MakeFrame(720, 1560); // 720, 1560: 渲染尺寸
+        ASSERT_TRUE(pyramid.Build(frame.data(), 720 * PIXEL_SIZE, 720, 1560));
+        const std::vector<FramePyramid::Level>& levels = pyramid.GetLevels();
+        EXPECT_EQ(levels[0].width, 180); // 180: 第一层宽
+        EXPECT_EQ(levels[0].height, 390); // 390: 第一层高
+        EXPECT_EQ(levels[1].width, 360); // 360: 第二层宽
+        EXPECT_EQ(levels[1].height, 780); // 780: 第二层高
+        // 不放大，与原帧同尺寸的层直接引用原帧
+        EXPECT_EQ(levels[2].width, 720); // 720: 原宽
+        EXPECT_EQ(levels[2].data, frame.data());
+    }
+
+    TEST(FramePyramidTest, ChainedLevelTest)
+    {
+        // 测试小层由大层缩放得到，结果与由原帧直接缩放一致
+        std::vector<uint8_t> frame(64 * 64 * PIXEL_SIZE, 0); // 64: 帧边长
+        for (int32_t y = 0; y < 64; y++) { // 64: 帧边长
+            for (int32_t x = 0; x < 64; x++) { // 64: 帧边长
+                frame[(y * 64 + x) * PIXEL_SIZE] = static_cast<uint8_t>((x + y) * 2); // 2: 渐变步长
+            }
+        }
+        FramePyramid chained;
+        chained.SetSizes({ { 32, 32 }, { 16, 16 } }); // 32, 16: 逐级减半
+        ASSERT_TRUE(chained.Build(frame.data(), 64 * PIXEL_SIZE, 64, 64));
+        FramePyramid direct;
+        direct.SetSizes({ { 16, 16 } }); // 16: 直接缩放到最小层
+        ASSERT_TRUE(direct.Build(frame.data(), 64 * PIXEL_SIZE, 64, 64));
+        const FramePyramid::Level& small = chained.GetLevels()[1];
+        const FramePyramid::Level& reference = direct.GetLevels()[0];
+        ASSERT_EQ(small.width, reference.width);
+        for (size_t i = 0; i < small.stride * small.height; i++) {
+            EXPECT_NEAR(small.data[i], reference.data[i], 1); // 1: 两次取整的误差
+        }
+    }
+
+    TEST(FramePyramidTest, InvalidFrameTest)
+    {
+        // 测试空帧或尺寸非法时构建失败
+        FramePyramid pyramid;
+        pyramid.SetSizes({ { 180, 390 } }); // 180, 390: 缩略图尺寸
+        EXPECT_FALSE(pyramid.Build(nullptr, 0, 720, 1560)); // 720, 1560: 渲染尺寸
+        std::vector<uint8_t> frame = MakeFrame(4, 4); // 4: 帧边长
+        EXPECT_FALSE(pyramid.Build(frame.data(), 4 * PIXEL_SIZE, 0, 4)); // 0: 非法宽度
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "FrameRecorder.h"
+#include "FrameReplayer.h"
+
+namespace {
+    const std::string RECORDING_PATH = "frame_recorder_test.rec";
+
+    std::vector<uint8_t> MakePacket(uint8_t value, size_t length)
+    {
+        return std::vector<uint8_t>(length, value);
+    }
+
+    void RecordPackets(size_t count)
+    {
+        FrameRecorder recorder;
+        ASSERT_TRUE(recorder.Open(RECORDING_PATH));
+        EXPECT_TRUE(recorder.IsOpen());
+        for (size_t i = 0; i < count; i++) {
+            std::vector<uint8_t> packet = MakePacket(static_cast<uint8_t>(i), 40 + i); // 40: 帧头长度
+            EXPECT_TRUE(recorder.Append(packet.data(), packet.size(), 100 + i, 200 + i, i % 2)); // 2: 两个变体
+        }
+        EXPECT_FALSE(recorder.Append(nullptr, 1, 0, 0, 0));
+        recorder.Close();
+        EXPECT_FALSE(recorder.IsOpen());
+        EXPECT_EQ(recorder.GetDroppedCount(), 0);
+    }
+
+    TEST(FrameRecorderTest, RecordAndReadTest)
+    {
+        // 测试录制的数据包按顺序完整读出，带有耗时和变体
+        const size_t count = 5;
+        RecordPackets(count);
+        FrameRecordReader reader;
+        ASSERT_TRUE(reader.Open(RECORDING_PATH));
+        ASSERT_EQ(reader.GetCount(), count);
+        FrameRecord record;
+        uint64_t lastTimestamp = 0;
+        for (size_t i = 0; i < count; i++) {
+            ASSERT_TRUE(reader.Read(i, record));
+            EXPECT_EQ(record.packet, MakePacket(static_cast<uint8_t>(i), 40 + i)); // 40: 帧头长度
+            EXPECT_EQ(record.encodeUs, 100 + i); // 100: 编码耗时
+            EXPECT_EQ(record.writeUs, 200 + i); // 200: 发送耗时
+            EXPECT_EQ(record.variant, static_cast<int32_t>(i % 2)); // 2: 两个变体
+            EXPECT_GE(record.timestampUs, lastTimestamp);
+            lastTimestamp = record.timestampUs;
+        }
+        EXPECT_FALSE(reader.Read(count, record));
+        std::remove(RECORDING_PATH.c_str());
+    }
+
+    TEST(FrameRecorderTest, TruncatedRecordingTest)
+    {
+        // 测试没有索引且最后一条被截断的录制文件，能读出完整的记录
+        const size_t count = 3;
+        RecordPackets(count);
+        std::ifstream in(RECORDING_PATH, std::ios::binary);
+        std::vector<char> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        // 去掉索引和最后一条记录的最后一个字节
+        const size_t indexSize = 4 + 4 + count * 16 + 8 + 4; // 4: 标记, 4: 数量, 16: 每项, 8: 偏移, 4: 结尾标记
+        content.resize(content.size() - indexSize - 1);
+        std::ofstream out(RECORDING_PATH, std::ios::binary | std::ios::trunc);
+        out.write(content.data(), content.size());
+        out.close();
+        FrameRecordReader reader;
+        ASSERT_TRUE(reader.Open(RECORDING_PATH));
+        EXPECT_EQ(reader.GetCount(), count - 1);
+        FrameRecord record;
+        EXPECT_TRUE(reader.Read(1, record));
+        EXPECT_EQ(record.packet, MakePacket(1, 41)); // 41: 第二个数据包的长度
+        std::remove(RECORDING_PATH.c_str());
+
+        FrameRecordReader invalidReader;
+        EXPECT_FALSE(invalidReader.Open(RECORDING_PATH));
+    }
+
+    TEST(FrameRecorderTest, ReplayTest)
+    {
+        // 测试按原速重放时按录制的时间间隔发送，速度为 0 时不等待
+        RecordPackets(3); // 3: 三个数据包
+        FrameRecordReader reader;
+        ASSERT_TRUE(reader.Open(RECORDING_PATH));
+        std::vector<size_t> sizes;
+        auto sink = [&sizes](const FrameRecord& record) {
+            sizes.push_back(record.packet.size());
+            return record.packet.size();
+        };
+        FrameReplayer::Stats stats;
+        EXPECT_TRUE(FrameReplayer::Replay(reader, 0, sink, stats));
+        EXPECT_EQ(stats.frames, 3); // 3: 三个数据包
+        EXPECT_EQ(stats.bytes, 40 + 41 + 42); // 40, 41, 42: 各数据包长度
+        EXPECT_EQ(sizes, std::vector<size_t>({ 40, 41, 42 })); // 40, 41, 42: 按录制顺序
+        FrameRecord first;
+        FrameRecord last;
+        ASSERT_TRUE(reader.Read(0, first));
+        ASSERT_TRUE(reader.Read(2, last)); // 2: 最后一个
+        EXPECT_TRUE(FrameReplayer::Replay(reader, 1.0, sink, stats));
+        EXPECT_GE(stats.durationUs, static_cast<int64_t>(last.timestampUs - first.timestampUs));
+        EXPECT_FALSE(FrameReplayer::Replay(reader, -1.0, sink, stats));
+        std::remove(RECORDING_PATH.c_str());
+    }
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "FrameScaler.h"
+
+namespace {
+    const size_t PIXEL_SIZE = 4;
+
+    std::vector<uint8_t> MakeFrame(int32_t width, int32_t height)
+    {
+        std::vector<uint8_t> frame(static_cast<size_t>(width) * height * PIXEL_SIZE);
+        uint32_t seed = 7; // 7: 随机种子
+        for (uint8_t& value : frame) {
+            seed = seed * 1103515245 + 12345; // 1103515245, 12345: 线性同余
+            value = static_cast<uint8_t>(seed >> 24); // 24: 取高位
+        }
+        return frame;
+    }
+
+    TEST(FrameScalerTest, FitSizeTest)
+    {
+        // 测试按宽高比缩放到显示区域内，且不放大
+        int32_t width = 0;
+        int32_t height = 0;
+        FrameScaler::FitSize(1080, 2340, 540, 1170, width, height); // 1080, 2340: 原尺寸, 540, 1170: 显示区域
+        EXPECT_EQ(width, 540); // 540: 缩小一半
+        EXPECT_EQ(height, 1170); // 1170: 缩小一半
+        FrameScaler::FitSize(1080, 2340, 1000, 1000, width, height); // 1000: 正方形显示区域
+        EXPECT_EQ(width, 462); // 462: 1080 * 1000 / 2340
+        EXPECT_EQ(height, 1000); // 1000: 受高度限制
+        // 横屏画面使用旋转后的显示区域
+        FrameScaler::FitSize(2340, 1080, 540, 1170, width, height); // 2340, 1080: 横屏
+        EXPECT_EQ(width, 1170); // 1170: 缩小一半
+        EXPECT_EQ(height, 540); // 540: 缩小一半
+        FrameScaler::FitSize(100, 200, 540, 1170, width, height); // 100, 200: 小于显示区域
+        EXPECT_EQ(width, 100); // 100: 保持原尺寸
+        EXPECT_EQ(height, 200); // 200: 保持原尺寸
+    }
+
+    TEST(FrameScalerTest, HalveTest)
+    {
+        // 测试缩小一半时每个像素是2x2像素的均值
+        const int32_t width = 38;
+        const int32_t height = 10;
+        std::vector<uint8_t> frame = MakeFrame(width, height);
+        std::vector<uint8_t> scaled(static_cast<size_t>(width / 2) * (height / 2) * PIXEL_SIZE); // 2: 一半
+        ASSERT_TRUE(FrameScaler::DownscaleRgba(frame.data(), width * PIXEL_SIZE, width, height, scaled.data(),
+            width / 2 * PIXEL_SIZE, width / 2, height / 2)); // 2: 一半
+        size_t stride = width * PIXEL_SIZE;
+        for (int32_t y = 0; y < height / 2; ++y) { // 2: 一半
+            for (int32_t x = 0; x < width / 2; ++x) { // 2: 一半
+                for (size_t c = 0; c < PIXEL_SIZE; ++c) {
+                    size_t pos = y * 2 * stride + x * 2 * PIXEL_SIZE + c; // 2: 源像素位置
+                    uint32_t sum = frame[pos] + frame[pos + PIXEL_SIZE] + frame[pos + stride] +
+                        frame[pos + stride + PIXEL_SIZE];
+                    EXPECT_EQ(scaled[(y * width / 2 + x) * PIXEL_SIZE + c], (sum + 2) / 4); // 2: 四舍五入, 4: 均值
+                }
+            }
+        }
+    }
+
+    TEST(FrameScalerTest, AreaScaleTest)
+    {
+        // 测试任意比例缩放：纯色保持不变，渐变保持单调
+        const int32_t width = 90;
+        const int32_t height = 30;
+        std::vector<uint8_t> frame(static_cast<size_t>(width) * height * PIXEL_SIZE);
+        for (int32_t y = 0; y < height; ++y) {
+            for (int32_t x = 0; x < width; ++x) {
+                uint8_t* pixel = frame.data() + (y * width + x) * PIXEL_SIZE;
+                pixel[0] = static_cast<uint8_t>(x * 2); // 2: 水平渐变
+                pixel[1] = 77; // 77: 纯色通道
+                pixel[2] = static_cast<uint8_t>(y * 8); // 2: 蓝色, 8: 垂直渐变
+                pixel[3] = 255; // 3: 透明度, 255: 不透明
+            }
+        }
+        const int32_t dstWidth = 37;
+        const int32_t dstHeight = 13;
+        std::vector<uint8_t> scaled(static_cast<size_t>(dstWidth) * dstHeight * PIXEL_SIZE);
+        ASSERT_TRUE(FrameScaler::DownscaleRgba(frame.data(), width * PIXEL_SIZE, width, height, scaled.data(),
+            dstWidth * PIXEL_SIZE, dstWidth, dstHeight));
+        for (int32_t y = 0; y < dstHeight; ++y) {
+            for (int32_t x = 0; x < dstWidth; ++x) {
+                const uint8_t* pixel = scaled.data() + (y * dstWidth + x) * PIXEL_SIZE;
+                EXPECT_EQ(pixel[1], 77); // 77: 纯色通道
+                EXPECT_EQ(pixel[3], 255); // 3: 透明度, 255: 不透明
+                if (x > 0) {
+                    EXPECT_GT(pixel[0], pixel[-PIXEL_SIZE]);
+                }
+                if (y > 0) {
+                    EXPECT_GT(pixel[2], pixel[2 - dstWidth * PIXEL_SIZE]); // 2: 蓝色
+                }
+            }
+        }
+        // 不支持放大
+        EXPECT_FALSE(FrameScaler::DownscaleRgba(frame.data(), width * PIXEL_SIZE, width, height, scaled.data(),
+            (width + 1) * PIXEL_SIZE, width + 1, height));
+    }
+
+    TEST(FrameScalerTest, DownscaleRowsTest)
+    {
+        // 测试按行带缩放的结果与整帧缩放一致
+        const int32_t width = 64;
+        const int32_t height = 50;
+        std::vector<uint8_t> frame = MakeFrame(width, height);
+        const std::vector<std::pair<int32_t, int32_t>> sizes = { { 32, 25 }, { 45, 31 } }; // 2:1 与任意比例
+        for (const std::pair<int32_t, int32_t>& size : sizes) {
+            size_t dstStride = size.first * PIXEL_SIZE;
+            std::vector<uint8_t> whole(dstStride * size.second);
+            ASSERT_TRUE(FrameScaler::DownscaleRgba(frame.data(), width * PIXEL_SIZE, width, height, whole.data(),
+                dstStride, size.first, size.second));
+            const int32_t band = 7; // 7: 行带高度，最后一个行带不满
+            std::vector<uint8_t> rows(dstStride * band);
+            for (int32_t row = 0; row < size.second; row += band) {
+                int32_t count = std::min(band, size.second - row);
+                ASSERT_TRUE(FrameScaler::DownscaleRgbaRows(frame.data(), width * PIXEL_SIZE, width, height,
+                    rows.data(), dstStride, size.first, size.second, row, count));
+                EXPECT_TRUE(std::equal(rows.begin(), rows.begin() + dstStride * count,
+                    whole.begin() + dstStride * row));
+            }
+            // 行范围越界
+            EXPECT_FALSE(FrameScaler::DownscaleRgbaRows(frame.data(), width * PIXEL_SIZE, width, height,
+                rows.data(), dstStride, size.first, size.second, size.second - 1, 2)); // 2: 超出一行
+        }
+    }
+}
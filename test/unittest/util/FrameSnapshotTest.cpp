@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "FrameSnapshot.h"
+
+namespace {
+    const std::string SNAPSHOT_DIR = ".";
+    const std::string SNAPSHOT_KEY = "entry|pages/Index|1080x2340|phone|light|portrait|zh_CN";
+
+    std::vector<std::vector<uint8_t>> MakePackets()
+    {
+        // 一个整帧和两个区域帧
+        return { std::vector<uint8_t>(100, 0x5A), std::vector<uint8_t>(50, 1), std::vector<uint8_t>(60, 2) };
+    }
+
+    TEST(FrameSnapshotTest, SaveAndLoadTest)
+    {
+        // 测试保存的数据包按同一个键按顺序读回，其他键读不到
+        std::vector<std::vector<uint8_t>> packets = MakePackets();
+        ASSERT_TRUE(FrameSnapshot::Save(SNAPSHOT_DIR, SNAPSHOT_KEY, packets));
+        std::vector<std::vector<uint8_t>> loaded;
+        ASSERT_TRUE(FrameSnapshot::Load(SNAPSHOT_DIR, SNAPSHOT_KEY, loaded));
+        EXPECT_EQ(loaded, packets);
+        EXPECT_FALSE(FrameSnapshot::Load(SNAPSHOT_DIR, SNAPSHOT_KEY + "|dark", loaded));
+        // 覆盖保存后读到新的数据包
+        packets.resize(1);
+        packets[0][0] = 2; // 2: 新的内容
+        ASSERT_TRUE(FrameSnapshot::Save(SNAPSHOT_DIR, SNAPSHOT_KEY, packets));
+        ASSERT_TRUE(FrameSnapshot::Load(SNAPSHOT_DIR, SNAPSHOT_KEY, loaded));
+        EXPECT_EQ(loaded, packets);
+        EXPECT_FALSE(FrameSnapshot::Save(SNAPSHOT_DIR, SNAPSHOT_KEY, {}));
+        EXPECT_FALSE(FrameSnapshot::Save(SNAPSHOT_DIR, SNAPSHOT_KEY, { packets[0], {} }));
+        std::remove(FrameSnapshot::GetPath(SNAPSHOT_DIR, SNAPSHOT_KEY).c_str());
+    }
+
+    TEST(FrameSnapshotTest, DamagedSnapshotTest)
+    {
+        // 测试被截断或被改动的快照文件不会被读出
+        ASSERT_TRUE(FrameSnapshot::Save(SNAPSHOT_DIR, SNAPSHOT_KEY, MakePackets()));
+        std::string path = FrameSnapshot::GetPath(SNAPSHOT_DIR, SNAPSHOT_KEY);
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        std::vector<char> changed = content;
+        changed.back() ^= 1;
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(changed.data(), changed.size());
+        std::vector<std::vector<uint8_t>> loaded;
+        EXPECT_FALSE(FrameSnapshot::Load(SNAPSHOT_DIR, SNAPSHOT_KEY, loaded));
+        EXPECT_TRUE(loaded.empty());
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(content.data(), content.size() - 1);
+        EXPECT_FALSE(FrameSnapshot::Load(SNAPSHOT_DIR, SNAPSHOT_KEY, loaded));
+        std::remove(path.c_str());
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "PixelConvert.h"
+
+namespace {
+    const std::vector<PixelConvert::Kernel> ALL_KERNELS = {
+        PixelConvert::Kernel::SCALAR,
+        PixelConvert::Kernel::SSSE3,
+        PixelConvert::Kernel::AVX2,
+        PixelConvert::Kernel::NEON,
+    };
+
+    std::vector<uint8_t> MakeImage(size_t size)
+    {
+        std::vector<uint8_t> image(size);
+        for (size_t i = 0; i < size; ++i) {
+            image[i] = static_cast<uint8_t>(i * 7 + 3); // 7, 3: arbitrary pattern
+        }
+        return image;
+    }
+
+    TEST(PixelConvertTest, RgbaToRgbTest)
+    {
+        // 测试所有支持的内核在奇数宽度下丢弃 alpha 通道的结果一致
+        PixelConvert::Kernel origin = PixelConvert::GetKernel();
+        const int32_t width = 37;
+        const int32_t height = 5;
+        std::vector<uint8_t> src = MakeImage(width * height * 4);
+        for (PixelConvert::Kernel kernel : ALL_KERNELS) {
+            if (!PixelConvert::SetKernel(kernel)) {
+                continue;
+            }
+            std::vector<uint8_t> dst(width * height * 3, 0);
+            PixelConvert::RgbaToRgb(src.data(), width * 4, dst.data(), width * 3, width, height);
+            for (int32_t i = 0; i < width * height; ++i) {
+                EXPECT_EQ(dst[i * 3], src[i * 4]);
+                EXPECT_EQ(dst[i * 3 + 1], src[i * 4 + 1]);
+                EXPECT_EQ(dst[i * 3 + 2], src[i * 4 + 2]);
+            }
+        }
+        PixelConvert::SetKernel(origin);
+    }
+
+    TEST(PixelConvertTest, BgraToRgbStrideTest)
+    {
+        // 测试带行跨距的 BGRA 转 RGB，行尾填充字节不能被写入
+        PixelConvert::Kernel origin = PixelConvert::GetKernel();
+        const int32_t width = 70;
+        const int32_t height = 3;
+        const size_t srcStride = width * 4 + 12;
+        const size_t dstStride = width * 3 + 5;
+        std::vector<uint8_t> src = MakeImage(srcStride * height);
+        for (PixelConvert::Kernel kernel : ALL_KERNELS) {
+            if (!PixelConvert::SetKernel(kernel)) {
+                continue;
+            }
+            std::vector<uint8_t> dst(dstStride * height, 0xEE);
+            PixelConvert::BgraToRgb(src.data(), srcStride, dst.data(), dstStride, width, height);
+            for (int32_t i = 0; i < height; ++i) {
+                for (int32_t j = 0; j < width; ++j) {
+                    const uint8_t* s = src.data() + i * srcStride + j * 4;
+                    const uint8_t* d = dst.data() + i * dstStride + j * 3;
+                    EXPECT_EQ(d[0], s[2]);
+                    EXPECT_EQ(d[1], s[1]);
+                    EXPECT_EQ(d[2], s[0]);
+                }
+                for (size_t k = width * 3; k < dstStride; ++k) {
+                    EXPECT_EQ(dst[i * dstStride + k], 0xEE);
+                }
+            }
+        }
+        PixelConvert::SetKernel(origin);
+    }
+
+    TEST(PixelConvertTest, CopyRgbaTest)
+    {
+        // 测试带行跨距的四通道直接拷贝
+        const int32_t width = 9;
+        const int32_t height = 4;
+        const size_t srcStride = width * 4 + 8;
+        std::vector<uint8_t> src = MakeImage(srcStride * height);
+        std::vector<uint8_t> dst(width * height * 4, 0);
+        PixelConvert::CopyRgba(src.data(), srcStride, dst.data(), width * 4, width, height);
+        for (int32_t i = 0; i < height; ++i) {
+            for (int32_t j = 0; j < width * 4; ++j) {
+                EXPECT_EQ(dst[i * width * 4 + j], src[i * srcStride + j]);
+            }
+        }
+    }
+
+    TEST(PixelConvertTest, InvalidArgsTest)
+    {
+        // 测试非法参数时不访问缓冲区
+        uint8_t dst[4] = {1, 2, 3, 4};
+        PixelConvert::RgbaToRgb(nullptr, 0, dst, 0, 1, 1);
+        PixelConvert::BgraToRgb(dst, 4, dst, 3, 0, 1);
+        PixelConvert::CopyRgba(dst, 4, nullptr, 4, 1, 1);
+        EXPECT_EQ(dst[0], 1);
+        EXPECT_TRUE(PixelConvert::IsKernelSupported(PixelConvert::Kernel::SCALAR));
+        EXPECT_STREQ(PixelConvert::GetKernelName(PixelConvert::Kernel::SCALAR), "SCALAR");
+    }
+}
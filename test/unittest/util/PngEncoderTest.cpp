@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+#include "PngEncoder.h"
+
+namespace {
+    uint32_t ReadBigEndian32(const uint8_t* data)
+    {
+        return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) | // 24, 16: 高位字节
+            (static_cast<uint32_t>(data[2]) << 8) | data[3]; // 2, 3: 低位字节, 8: 移位
+    }
+
+    // 解析 png 的块并解开存储型 deflate 块，返回每行去掉过滤字节的像素
+    bool DecodeStoredPng(const std::vector<uint8_t>& png, int32_t& width, int32_t& height,
+                         std::vector<uint8_t>& pixels)
+    {
+        const size_t signatureSize = 8;
+        size_t pos = signatureSize;
+        std::vector<uint8_t> zlib;
+        while (pos + 12 <= png.size()) { // 12: 长度、类型和 crc
+            uint32_t length = ReadBigEndian32(&png[pos]);
+            std::string type(reinterpret_cast<const char*>(&png[pos + 4]), 4); // 4: 类型
+            const uint8_t* data = &png[pos + 8]; // 8: 数据起点
+            uint32_t crc = ReadBigEndian32(data + length);
+            if (crc != PngEncoder::Crc32(&png[pos + 4], length + 4)) { // 4: crc 包含类型
+                return false;
+            }
+            if (type == "IHDR") {
+                width = static_cast<int32_t>(ReadBigEndian32(data));
+                height = static_cast<int32_t>(ReadBigEndian32(data + 4)); // 4: 高度
+            } else if (type == "IDAT") {
+                zlib.insert(zlib.end(), data, data + length);
+            }
+            pos += 12 + length; // 12: 长度、类型和 crc
+        }
+        std::vector<uint8_t> raw;
+        size_t z = 2; // 2: zlib 头
+        bool isFinal = false;
+        while (!isFinal && z + 5 <= zlib.size()) { // 5: 存储块头
+            isFinal = (zlib[z] & 1) != 0;
+            size_t len = zlib[z + 1] | (zlib[z + 2] << 8); // 2: 长度高字节, 8: 移位
+            z += 5; // 5: 存储块头
+            raw.insert(raw.end(), zlib.begin() + z, zlib.begin() + z + len);
+            z += len;
+        }
+        if (!isFinal || ReadBigEndian32(&zlib[z]) != PngEncoder::Adler32(raw.data(), raw.size())) {
+            return false;
+        }
+        size_t rowLength = 1 + static_cast<size_t>(width) * 3; // 3: RGB
+        for (size_t row = 0; row + rowLength <= raw.size(); row += rowLength) {
+            pixels.insert(pixels.end(), raw.begin() + row + 1, raw.begin() + row + rowLength);
+        }
+        return true;
+    }
+
+    TEST(PngEncoderTest, ChecksumTest)
+    {
+        // 测试校验和与标准值一致
+        const char* text = "123456789";
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(text);
+        EXPECT_EQ(PngEncoder::Crc32(data, std::strlen(text)), 0xCBF43926u);
+        EXPECT_EQ(PngEncoder::Adler32(data, std::strlen(text)), 0x091E01DEu);
+        // 分段计算与一次计算结果相同
+        uint32_t crc = PngEncoder::Crc32(data, 4); // 4: 前半段
+        EXPECT_EQ(PngEncoder::Crc32(data + 4, std::strlen(text) - 4, crc), 0xCBF43926u); // 4: 后半段
+    }
+
+    TEST(PngEncoderTest, EncodeRgbxTest)
+    {
+        // 测试 RGBX 帧编码为 RGB png，跨多个存储块，且按 stride 取行
+        const int32_t width = 300;
+        const int32_t height = 100;
+        const size_t stride = width * 4 + 8; // 4: RGBX, 8: 行尾填充
+        std::vector<uint8_t> frame(stride * height);
+        std::vector<uint8_t> expected;
+        for (int32_t y = 0; y < height; y++) {
+            for (int32_t x = 0; x < width; x++) {
+                uint8_t* pixel = &frame[y * stride + x * 4]; // 4: RGBX
+                pixel[0] = static_cast<uint8_t>(x);
+                pixel[1] = static_cast<uint8_t>(y);
+                pixel[2] = static_cast<uint8_t>(x + y); // 2: 蓝色
+                pixel[3] = 0x55; // 3: 被丢弃的第四字节
+                expected.insert(expected.end(), pixel, pixel + 3); // 3: RGB
+            }
+        }
+        std::vector<uint8_t> png;
+        ASSERT_TRUE(PngEncoder::EncodeRgbx(frame.data(), stride, width, height, png));
+        const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        ASSERT_EQ(std::memcmp(png.data(), signature, sizeof(signature)), 0);
+        int32_t decodedWidth = 0;
+        int32_t decodedHeight = 0;
+        std::vector<uint8_t> pixels;
+        ASSERT_TRUE(DecodeStoredPng(png, decodedWidth, decodedHeight, pixels));
+        EXPECT_EQ(decodedWidth, width);
+        EXPECT_EQ(decodedHeight, height);
+        EXPECT_EQ(pixels, expected);
+
+        EXPECT_FALSE(PngEncoder::EncodeRgbx(nullptr, stride, width, height, png));
+        EXPECT_FALSE(PngEncoder::EncodeRgbx(frame.data(), stride, 0, height, png));
+        EXPECT_FALSE(PngEncoder::EncodeRgbx(frame.data(), width, width, height, png));
+    }
+}
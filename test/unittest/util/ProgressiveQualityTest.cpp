@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "ProgressiveQuality.h"
+
+namespace {
+    const int32_t BASE_QUALITY = 90;
+
+    TEST(ProgressiveQualityTest, DisabledTest)
+    {
+        // 测试未开启时质量不变，也不需要精细帧
+        ProgressiveQuality progressive;
+        EXPECT_EQ(progressive.GetQuality(BASE_QUALITY), BASE_QUALITY);
+        EXPECT_FALSE(progressive.IsRefinementDue());
+        EXPECT_EQ(progressive.GetIdleDelay().count(), 0);
+    }
+
+    TEST(ProgressiveQualityTest, RefinementTest)
+    {
+        // 测试运动时使用低质量，之后需要一次高质量精细帧
+        ProgressiveQuality progressive;
+        ProgressiveQualityConfig config;
+        config.enabled = true;
+        config.motionQuality = 50; // 50: 运动时质量
+        config.idleMs = 200; // 200: 空闲 200ms
+        progressive.Configure(config);
+        EXPECT_EQ(progressive.GetIdleDelay().count(), 200); // 200: 空闲时间
+        EXPECT_FALSE(progressive.IsRefinementDue());
+        EXPECT_EQ(progressive.GetQuality(BASE_QUALITY), 50); // 50: 运动时质量
+        EXPECT_EQ(progressive.GetQuality(40), 40); // 40: 不超过基础质量
+        EXPECT_TRUE(progressive.IsRefinementDue());
+        EXPECT_EQ(progressive.GetRefineQuality(), 100); // 100: 默认精细质量
+        progressive.OnRefined();
+        EXPECT_FALSE(progressive.IsRefinementDue());
+    }
+
+    TEST(ProgressiveQualityTest, ConfigureClampTest)
+    {
+        // 测试配置被限制在有效范围内，运动质量达到精细质量时不需要精细帧
+        ProgressiveQuality progressive;
+        ProgressiveQualityConfig config;
+        config.enabled = true;
+        config.motionQuality = 100; // 100: 高于精细质量
+        config.refineQuality = 95; // 95: 精细质量
+        config.idleMs = 1; // 1: 低于下限
+        progressive.Configure(config);
+        config = progressive.GetConfig();
+        EXPECT_EQ(config.motionQuality, 95); // 95: 不超过精细质量
+        EXPECT_EQ(config.idleMs, ProgressiveQuality::MIN_IDLE_MS);
+        EXPECT_EQ(progressive.GetQuality(100), 95); // 100, 95: 已是精细质量
+        EXPECT_FALSE(progressive.IsRefinementDue());
+    }
+}
@@ -52,4 +52,18 @@ namespace {
         // 验证结果字符串是否与预期相符
         ASSERT_TRUE(CompareInt8Arrays(expectedOutput, outputBuffer, resultLength));
     }
-}
\ No newline at end of file
+
+    TEST(PublicMethodsTest, Base64EncodeTest)
+    {
+        // 测试 base64 编码及末尾的填充
+        const uint8_t data[] = { 'f', 'o', 'o', 'b', 'a', 'r' };
+        EXPECT_EQ(PublicMethods::Base64Encode(data, 0), "");
+        EXPECT_EQ(PublicMethods::Base64Encode(data, 1), "Zg==");
+        EXPECT_EQ(PublicMethods::Base64Encode(data, 2), "Zm8="); // 2: 两个字节
+        EXPECT_EQ(PublicMethods::Base64Encode(data, 3), "Zm9v"); // 3: 三个字节
+        EXPECT_EQ(PublicMethods::Base64Encode(data, sizeof(data)), "Zm9vYmFy");
+        const uint8_t binary[] = { 0xFB, 0xFF };
+        EXPECT_EQ(PublicMethods::Base64Encode(binary, sizeof(binary)), "+/8=");
+        EXPECT_EQ(PublicMethods::Base64Encode(nullptr, 1), "");
+    }
+}
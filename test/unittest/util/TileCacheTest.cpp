@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "TileCache.h"
+
+namespace {
+    const int32_t WIDTH = 150; // 3 列图块，最后一列不满
+    const int32_t HEIGHT = 100; // 2 行图块，最后一行不满
+    const size_t FRAME_SIZE = WIDTH * HEIGHT * 4; // 4: 每像素字节数
+
+    std::vector<uint8_t> MakeFrame(uint32_t seed)
+    {
+        std::vector<uint8_t> frame(FRAME_SIZE);
+        for (uint8_t& value : frame) {
+            seed = seed * 1103515245 + 12345; // 1103515245, 12345: 线性同余
+            value = static_cast<uint8_t>(seed >> 24); // 24: 取高位
+        }
+        return frame;
+    }
+
+    TEST(TileCacheTest, EncodeApplyTest)
+    {
+        // 测试客户端已有的图块只发送引用，并且客户端可以还原出画面
+        TileCache server;
+        server.Configure(true, TileCache::DEFAULT_CAPACITY);
+        TileCache client;
+        std::vector<uint8_t> table(TileCache::GetTableSize(WIDTH, HEIGHT));
+        EXPECT_EQ(table.size(), TileCache::TABLE_HEAD_SIZE + 6 * sizeof(uint64_t)); // 6: 3 x 2 个图块
+        TileAtlas atlas;
+        bool isReset = false;
+        std::vector<uint8_t> frame = MakeFrame(1);
+        ASSERT_EQ(server.Encode(frame.data(), WIDTH, HEIGHT, 0, 1, table.data(), table.size(), atlas, isReset),
+                  table.size());
+        EXPECT_TRUE(isReset);
+        EXPECT_EQ(atlas.tileCount, 6); // 6: 首帧全部图块都是新的
+        EXPECT_EQ(atlas.width, 3 * TileCache::TILE_SIZE); // 3: 每行 3 个图块
+        EXPECT_EQ(atlas.height, 2 * TileCache::TILE_SIZE); // 2: 共 2 行
+        std::vector<uint8_t> picture(FRAME_SIZE);
+        EXPECT_TRUE(client.Apply(table.data(), table.size(), atlas, WIDTH, HEIGHT, picture.data()));
+        EXPECT_EQ(picture, frame);
+        // 只改变右下角的图块
+        std::vector<uint8_t> next = frame;
+        next[FRAME_SIZE - 1] ^= 0xFF;
+        ASSERT_EQ(server.Encode(next.data(), WIDTH, HEIGHT, 0, 1, table.data(), table.size(), atlas, isReset),
+                  table.size());
+        EXPECT_FALSE(isReset);
+        EXPECT_EQ(atlas.tileCount, 1);
+        EXPECT_EQ(atlas.width, TileCache::TILE_SIZE);
+        EXPECT_TRUE(client.Apply(table.data(), table.size(), atlas, WIDTH, HEIGHT, picture.data()));
+        EXPECT_EQ(picture, next);
+        // 尺寸不符的表被拒绝
+        EXPECT_FALSE(client.Apply(table.data(), table.size(), atlas, HEIGHT, WIDTH, picture.data()));
+        // 不在缓存中的引用被拒绝
+        TileCache other;
+        EXPECT_FALSE(other.Apply(table.data(), table.size(), atlas, WIDTH, HEIGHT, picture.data()));
+    }
+
+    TEST(TileCacheTest, ResetTest)
+    {
+        // 测试连接变化、请求重置、编码质量变化和容量淘汰
+        TileCache server;
+        std::vector<uint8_t> table(TileCache::GetTableSize(WIDTH, HEIGHT));
+        TileAtlas atlas;
+        bool isReset = false;
+        std::vector<uint8_t> frame(FRAME_SIZE, 0x80); // 0x80: 纯色画面
+        // 未开启时不编码
+        EXPECT_EQ(server.Encode(frame.data(), WIDTH, HEIGHT, 0, 1, table.data(), table.size(), atlas, isReset), 0);
+        server.Configure(true, 0);
+        EXPECT_EQ(server.GetCapacity(), TileCache::MIN_CAPACITY);
+        // 纯色画面中尺寸相同的图块只发送一次
+        server.Encode(frame.data(), WIDTH, HEIGHT, 0, 1, table.data(), table.size(), atlas, isReset);
+        EXPECT_EQ(atlas.tileCount, 4); // 4: 整块、右侧、底部和右下角四种尺寸
+        server.Encode(frame.data(), WIDTH, HEIGHT, 0, 1, table.data(), table.size(), atlas, isReset);
+        EXPECT_FALSE(isReset);
+        EXPECT_EQ(atlas.tileCount, 0);
+        EXPECT_EQ(atlas.width, 0);
+        // 编码质量变化后图块不再匹配
+        server.Encode(frame.data(), WIDTH, HEIGHT, 90, 1, table.data(), table.size(), atlas, isReset); // 90: 质量
+        EXPECT_EQ(atlas.tileCount, 4); // 4: 四种尺寸
+        // 客户端重连
+        server.Encode(frame.data(), WIDTH, HEIGHT, 0, 2, table.data(), table.size(), atlas, isReset); // 2: 新连接
+        EXPECT_TRUE(isReset);
+        EXPECT_EQ(atlas.tileCount, 4); // 4: 四种尺寸
+        server.RequestReset();
+        server.Encode(frame.data(), WIDTH, HEIGHT, 0, 2, table.data(), table.size(), atlas, isReset); // 2: 同一连接
+        EXPECT_TRUE(isReset);
+        // 超过容量的图块被淘汰，之后重新发送
+        const int32_t width = TileCache::TILE_SIZE * 10; // 10: 每行 10 个图块
+        const int32_t height = TileCache::TILE_SIZE * 7; // 7: 共 70 个图块，超过最小容量
+        std::vector<uint8_t> large(static_cast<size_t>(width) * height * 4); // 4: 每像素字节数
+        uint32_t seed = 1;
+        for (uint8_t& value : large) {
+            seed = seed * 1103515245 + 12345; // 1103515245, 12345: 线性同余
+            value = static_cast<uint8_t>(seed >> 24); // 24: 取高位
+        }
+        std::vector<uint8_t> largeTable(TileCache::GetTableSize(width, height));
+        EXPECT_EQ(server.Encode(large.data(), width, height, 0, 2, table.data(), table.size(), atlas, isReset), 0);
+        server.Encode(large.data(), width, height, 0, 2, largeTable.data(), largeTable.size(), atlas, isReset);
+        EXPECT_EQ(atlas.tileCount, 70); // 70: 全部是新图块
+        server.Encode(large.data(), width, height, 0, 2, largeTable.data(), largeTable.size(), atlas, isReset);
+        EXPECT_EQ(atlas.tileCount, 70); // 70: 按顺序访问时最早的图块总是已被淘汰
+    }
+}
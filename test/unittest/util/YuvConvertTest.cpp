@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "gtest/gtest.h"
+#include "YuvConvert.h"
+
+namespace {
+    const size_t PIXEL_SIZE = 4;
+
+    struct Planes {
+        std::vector<uint8_t> y;
+        std::vector<uint8_t> cb;
+        std::vector<uint8_t> cr;
+        size_t chromaStride = 0;
+    };
+
+    std::vector<uint8_t> MakeFrame(int32_t width, int32_t height)
+    {
+        std::vector<uint8_t> frame(static_cast<size_t>(width) * height * PIXEL_SIZE);
+        uint32_t seed = 11; // 11: 随机种子
+        for (uint8_t& value : frame) {
+            seed = seed * 1103515245 + 12345; // 1103515245, 12345: 线性同余
+            value = static_cast<uint8_t>(seed >> 24); // 24: 取高位
+        }
+        return frame;
+    }
+
+    Planes Convert(const std::vector<uint8_t>& frame, int32_t width, int32_t height, bool isBgr)
+    {
+        Planes planes;
+        planes.chromaStride = static_cast<size_t>(width + 1) / 2; // 2: 色度水平减半
+        planes.y.resize(static_cast<size_t>(width) * height);
+        planes.cb.resize(planes.chromaStride * ((height + 1) / 2)); // 2: 色度垂直减半
+        planes.cr.resize(planes.cb.size());
+        YuvConvert::RgbxToYuv420(frame.data(), width * PIXEL_SIZE, width, height, isBgr, planes.y.data(), width,
+            planes.cb.data(), planes.cr.data(), planes.chromaStride);
+        return planes;
+    }
+
+    TEST(YuvConvertTest, RgbxToYuv420Test)
+    {
+        // 测试奇数宽高下的亮度与 2x2 平均色度，与浮点公式相差不超过 1
+        const int32_t width = 37;
+        const int32_t height = 9;
+        std::vector<uint8_t> frame = MakeFrame(width, height);
+        Planes planes = Convert(frame, width, height, false);
+        auto pixel = [&frame, width, height](int32_t x, int32_t y) {
+            return frame.data() + (std::min(y, height - 1) * width + std::min(x, width - 1)) * PIXEL_SIZE;
+        };
+        for (int32_t y = 0; y < height; ++y) {
+            for (int32_t x = 0; x < width; ++x) {
+                const uint8_t* p = pixel(x, y);
+                double luma = 0.299 * p[0] + 0.587 * p[1] + 0.114 * p[2]; // 2: 蓝色
+                EXPECT_LE(std::fabs(planes.y[y * width + x] - luma), 1.0);
+            }
+        }
+        for (int32_t y = 0; y < height; y += 2) { // 2: 每两行一行色度
+            for (int32_t x = 0; x < width; x += 2) { // 2: 每两列一个色度
+                double rgb[3] = { 0 }; // 3: 颜色通道数
+                for (const uint8_t* p : { pixel(x, y), pixel(x + 1, y), pixel(x, y + 1), pixel(x + 1, y + 1) }) {
+                    for (int c = 0; c < 3; ++c) { // 3: 颜色通道数
+                        rgb[c] += p[c] / 4.0; // 4: 2x2 平均
+                    }
+                }
+                double cb = 128 - 0.168736 * rgb[0] - 0.331264 * rgb[1] + 0.5 * rgb[2]; // 2: 蓝色
+                double cr = 128 + 0.5 * rgb[0] - 0.418688 * rgb[1] - 0.081312 * rgb[2]; // 2: 蓝色
+                size_t index = (y / 2) * planes.chromaStride + x / 2; // 2: 色度减半
+                EXPECT_LE(std::fabs(planes.cb[index] - std::min(cb, 255.0)), 1.0); // 255: 最大值
+                EXPECT_LE(std::fabs(planes.cr[index] - std::min(cr, 255.0)), 1.0); // 255: 最大值
+            }
+        }
+    }
+
+    TEST(YuvConvertTest, BgrAndFlatTest)
+    {
+        // 测试 BGR 输入与交换红蓝后的 RGB 输入结果一致，纯白与纯灰转换精确
+        const int32_t width = 24;
+        const int32_t height = 4;
+        std::vector<uint8_t> frame = MakeFrame(width, height);
+        std::vector<uint8_t> swapped = frame;
+        for (size_t i = 0; i < swapped.size(); i += PIXEL_SIZE) {
+            std::swap(swapped[i], swapped[i + 2]); // 2: 蓝色
+        }
+        Planes rgb = Convert(frame, width, height, false);
+        Planes bgr = Convert(swapped, width, height, true);
+        EXPECT_EQ(rgb.y, bgr.y);
+        EXPECT_EQ(rgb.cb, bgr.cb);
+        EXPECT_EQ(rgb.cr, bgr.cr);
+        for (uint8_t level : { 255, 100 }) { // 255: 纯白, 100: 灰
+            std::vector<uint8_t> flat(frame.size(), level);
+            Planes planes = Convert(flat, width, height, false);
+            EXPECT_TRUE(std::all_of(planes.y.begin(), planes.y.end(), [level](uint8_t v) { return v == level; }));
+            EXPECT_TRUE(std::all_of(planes.cb.begin(), planes.cb.end(), [](uint8_t v) { return v == 128; }));
+            EXPECT_TRUE(std::all_of(planes.cr.begin(), planes.cr.end(), [](uint8_t v) { return v == 128; }));
+        }
+        // 非法参数不写入
+        YuvConvert::RgbxToYuv420(nullptr, 0, width, height, false, rgb.y.data(), width, rgb.cb.data(),
+            rgb.cr.data(), rgb.chromaStride);
+        YuvConvert::RgbxToYuv420(frame.data(), width * PIXEL_SIZE, 0, height, false, rgb.y.data(), width,
+            rgb.cb.data(), rgb.cr.data(), rgb.chromaStride);
+        EXPECT_EQ(rgb.y, bgr.y);
+    }
+}
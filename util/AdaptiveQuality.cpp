@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AdaptiveQuality.h"
+
+#include <algorithm>
+
+namespace {
+    const int32_t QUALITY_DECREASE_STEP = 5;
+    const int32_t QUALITY_INCREASE_STEP = 1;
+    const int64_t AVERAGE_WEIGHT = 4; // every sample moves the average by a quarter of the difference
+    const int64_t US_PER_SECOND = 1000000;
+    const int64_t US_PER_MS = 1000;
+
+    int64_t Smooth(int64_t average, int64_t sample)
+    {
+        return average + (sample - average) / AVERAGE_WEIGHT;
+    }
+}
+
+void AdaptiveQuality::Configure(const AdaptiveQualityConfig& newConfig)
+{
+    std::lock_guard<std::mutex> guard(qualityMutex);
+    config = newConfig;
+    config.latencyBudgetMs = std::max(config.latencyBudgetMs, 0);
+    config.bandwidthBytesPerSecond = std::max<int64_t>(config.bandwidthBytesPerSecond, 0);
+    config.maxQuality = std::clamp(config.maxQuality, MIN_QUALITY, MAX_QUALITY);
+    ResetLocked();
+}
+
+AdaptiveQualityConfig AdaptiveQuality::GetConfig() const
+{
+    std::lock_guard<std::mutex> guard(qualityMutex);
+    return config;
+}
+
+int32_t AdaptiveQuality::GetQuality(int32_t baseQuality, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> guard(qualityMutex);
+    if (!config.enabled) {
+        return baseQuality;
+    }
+    if (hasSample &&
+        std::chrono::duration_cast<std::chrono::microseconds>(now - lastFrameTime).count() > IDLE_RECOVERY_US) {
+        ResetLocked(); // what was measured during the last burst says nothing about the next one
+    }
+    return std::min(baseQuality, quality);
+}
+
+void AdaptiveQuality::OnFrameSent(const FrameCost& cost, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> guard(qualityMutex);
+    if (!config.enabled) {
+        return;
+    }
+    int64_t costUs = cost.encodeUs + cost.drainUs;
+    int64_t bytes = static_cast<int64_t>(cost.bytes);
+    if (!hasSample) {
+        averageCostUs = costUs;
+        averageBytes = bytes;
+        hasSample = true;
+    } else {
+        averageCostUs = Smooth(averageCostUs, costUs);
+        averageBytes = Smooth(averageBytes, bytes);
+    }
+    lastFrameTime = now;
+
+    bool isOverBudget = IsOverBudgetLocked();
+    if (isOverBudget) {
+        quality = std::max(quality - QUALITY_DECREASE_STEP, MIN_QUALITY);
+    } else if (HasHeadroomLocked()) {
+        quality = std::min(quality + QUALITY_INCREASE_STEP, config.maxQuality);
+    }
+    // The bandwidth budget caps the frame rate at any quality. Once quality is exhausted and frames still take
+    // longer than the latency budget, the link is left idle as long as a frame keeps it busy so it can drain.
+    int64_t interval = GetBandwidthIntervalLocked();
+    if (isOverBudget && quality == MIN_QUALITY && config.latencyBudgetMs > 0) {
+        interval = std::max(interval, averageCostUs * 2); // 2: busy half of the interval
+    }
+    frameIntervalUs = std::min(interval, MAX_FRAME_INTERVAL_US);
+}
+
+int64_t AdaptiveQuality::GetFrameIntervalUs() const
+{
+    std::lock_guard<std::mutex> guard(qualityMutex);
+    return config.enabled ? frameIntervalUs : 0;
+}
+
+int32_t AdaptiveQuality::GetCurrentQuality() const
+{
+    std::lock_guard<std::mutex> guard(qualityMutex);
+    return quality;
+}
+
+void AdaptiveQuality::ResetLocked()
+{
+    quality = config.maxQuality;
+    frameIntervalUs = 0;
+    hasSample = false;
+    averageCostUs = 0;
+    averageBytes = 0;
+}
+
+bool AdaptiveQuality::IsOverBudgetLocked() const
+{
+    if (config.latencyBudgetMs > 0 && averageCostUs > config.latencyBudgetMs * US_PER_MS) {
+        return true;
+    }
+    // Quality gives way before the frame rate falls below the target rate.
+    return config.bandwidthBytesPerSecond > 0 && GetBandwidthIntervalLocked() > TARGET_FRAME_INTERVAL_US;
+}
+
+bool AdaptiveQuality::HasHeadroomLocked() const
+{
+    // 3, 4: climb back only below three quarters of the budget so that quality does not oscillate at the limit
+    if (config.latencyBudgetMs > 0 && averageCostUs * 4 > config.latencyBudgetMs * US_PER_MS * 3) {
+        return false;
+    }
+    return config.bandwidthBytesPerSecond <= 0 ||
+        GetBandwidthIntervalLocked() * 4 < TARGET_FRAME_INTERVAL_US * 3; // 3, 4: same margin as the latency budget
+}
+
+int64_t AdaptiveQuality::GetBandwidthIntervalLocked() const
+{
+    if (config.bandwidthBytesPerSecond <= 0) {
+        return 0;
+    }
+    return averageBytes * US_PER_SECOND / config.bandwidthBytesPerSecond;
+}
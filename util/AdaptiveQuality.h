@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ADAPTIVEQUALITY_H
+#define ADAPTIVEQUALITY_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+struct AdaptiveQualityConfig {
+    bool enabled = false;
+    int32_t latencyBudgetMs = 0; // encode plus websocket drain time allowed per frame, 0: no limit
+    int64_t bandwidthBytesPerSecond = 0; // 0: no limit
+    int32_t maxQuality = 100;
+};
+
+// What one frame cost on the sender thread, region frames add up all their regions.
+struct FrameCost {
+    int64_t encodeUs = 0;
+    int64_t drainUs = 0;
+    size_t bytes = 0;
+};
+
+// Closed loop jpeg quality and frame rate control. The smoothed cost of the sent frames is held against the
+// latency and bandwidth budgets: quality drops quickly while a budget is exceeded and climbs back slowly once there
+// is headroom. The frame interval always respects the bandwidth, and grows with the frame cost when the lowest
+// quality still misses the latency budget. A link that stayed idle for a while starts again at the highest quality.
+class AdaptiveQuality {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr int32_t MIN_QUALITY = 30;
+    static constexpr int32_t MAX_QUALITY = 100;
+    static constexpr int64_t TARGET_FRAME_INTERVAL_US = 40000; // the 25 frames per second the screen is sent at
+    static constexpr int64_t MAX_FRAME_INTERVAL_US = 500000; // never slower than 2 frames per second
+    static constexpr int64_t IDLE_RECOVERY_US = 1000000; // quality is restored after 1 second without frames
+
+    void Configure(const AdaptiveQualityConfig& newConfig);
+    AdaptiveQualityConfig GetConfig() const;
+    // baseQuality is the quality chosen from the frame size, the result is never above it.
+    int32_t GetQuality(int32_t baseQuality, Clock::time_point now);
+    void OnFrameSent(const FrameCost& cost, Clock::time_point now);
+    // The sender waits this long between the starts of two frames, 0 when the frame rate is not limited.
+    int64_t GetFrameIntervalUs() const;
+    int32_t GetCurrentQuality() const;
+
+private:
+    void ResetLocked();
+    bool IsOverBudgetLocked() const;
+    bool HasHeadroomLocked() const;
+    int64_t GetBandwidthIntervalLocked() const;
+
+    mutable std::mutex qualityMutex;
+    AdaptiveQualityConfig config;
+    int32_t quality = MAX_QUALITY;
+    int64_t frameIntervalUs = 0;
+    bool hasSample = false;
+    int64_t averageCostUs = 0;
+    int64_t averageBytes = 0;
+    Clock::time_point lastFrameTime;
+};
+
+#endif // ADAPTIVEQUALITY_H
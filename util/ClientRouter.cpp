@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ClientRouter.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <new>
+#include "PreviewerEngineLog.h"
+
+ClientRouter::ClientRouter(BackupSource source) : backupSource(std::move(source))
+{
+}
+
+std::shared_ptr<ClientRouter::Client> ClientRouter::Add(void* handle, int32_t variant, const std::string& name)
+{
+    std::shared_ptr<Client> client(new(std::nothrow) Client());
+    if (!client) {
+        return nullptr;
+    }
+    client->handle = handle;
+    client->variant = variant;
+    client->name = name;
+    if (variant == 0) {
+        std::lock_guard<std::mutex> guard(routerMutex);
+        auto it = namedViewports.find(name);
+        client->viewport = (it != namedViewports.end()) ? it->second : defaultViewport;
+    }
+    // The backups are of the full stream, a client of a viewport waits for the crop of the next frame.
+    if (!client->viewport.IsSet() && backupSource) {
+        std::vector<std::shared_ptr<SendPacket>> lastImage = backupSource(variant);
+        if (!lastImage.empty()) {
+            ILOG("Send last image of variant %d after websocket connected", variant);
+            client->queue.Replace(lastImage);
+        }
+    }
+    std::lock_guard<std::mutex> guard(routerMutex);
+    clients[handle] = client;
+    return client;
+}
+
+void ClientRouter::Remove(void* handle)
+{
+    std::lock_guard<std::mutex> guard(routerMutex);
+    clients.erase(handle);
+}
+
+std::shared_ptr<ClientRouter::Client> ClientRouter::Find(void* handle)
+{
+    std::lock_guard<std::mutex> guard(routerMutex);
+    auto it = clients.find(handle);
+    return it != clients.end() ? it->second : nullptr;
+}
+
+size_t ClientRouter::GetCount()
+{
+    std::lock_guard<std::mutex> guard(routerMutex);
+    return clients.size();
+}
+
+bool ClientRouter::HasClient(int32_t variant)
+{
+    std::lock_guard<std::mutex> guard(routerMutex);
+    return std::any_of(clients.begin(), clients.end(), [variant](const auto& item) {
+        return item.second->variant == variant && !item.second->viewport.IsSet();
+    });
+}
+
+std::vector<std::shared_ptr<ClientRouter::Client>> ClientRouter::GetTargets(int32_t variant,
+                                                                             const FrameViewport& viewport)
+{
+    std::vector<std::shared_ptr<Client>> targets;
+    std::lock_guard<std::mutex> guard(routerMutex);
+    for (const auto& item : clients) {
+        if (item.second->variant == variant && item.second->viewport == viewport) {
+            targets.push_back(item.second);
+        }
+    }
+    return targets;
+}
+
+size_t ClientRouter::Route(const std::shared_ptr<SendPacket>& packet, int32_t variant, const FrameViewport& viewport)
+{
+    if (packet == nullptr) {
+        return 0;
+    }
+    std::vector<std::shared_ptr<Client>> targets = GetTargets(variant, viewport);
+    if (targets.empty()) {
+        return 0;
+    }
+    packet->queuedTime = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<Client>> lagging;
+    for (const std::shared_ptr<Client>& client : targets) {
+        if (!client->queue.Push(packet)) {
+            lagging.push_back(client);
+        }
+    }
+    if (lagging.empty()) {
+        return targets.size();
+    }
+    // The packets it has not started are dropped, the backups and this packet show it the current picture.
+    std::vector<std::shared_ptr<SendPacket>> packets;
+    if (IsReplayed(variant, viewport) && backupSource) {
+        packets = backupSource(variant);
+    }
+    packets.push_back(packet);
+    for (const std::shared_ptr<Client>& client : lagging) {
+        client->queue.Replace(packets);
+        WLOG("Websocket client is too slow, %" PRIu64 " packets dropped so far.", client->queue.GetDroppedCount());
+    }
+    return targets.size();
+}
+
+bool ClientRouter::SetViewport(const std::string& name, const FrameViewport& viewport)
+{
+    std::vector<std::shared_ptr<Client>> resumed;
+    {
+        std::lock_guard<std::mutex> guard(routerMutex);
+        if (name.empty()) {
+            defaultViewport = viewport;
+            namedViewports.clear();
+        } else {
+            namedViewports[name] = viewport;
+        }
+        for (const auto& item : clients) {
+            Client& client = *item.second;
+            if (client.variant != 0 || (!name.empty() && client.name != name)) {
+                continue;
+            }
+            if (client.viewport.IsSet() && !viewport.IsSet()) {
+                resumed.push_back(item.second);
+            }
+            client.viewport = viewport;
+        }
+    }
+    if (resumed.empty()) {
+        return false;
+    }
+    // The crops not started yet are dropped, the full stream picks up from the backups as after a reconnection.
+    std::vector<std::shared_ptr<SendPacket>> lastImage;
+    if (backupSource) {
+        lastImage = backupSource(0);
+    }
+    for (const std::shared_ptr<Client>& client : resumed) {
+        client->queue.Replace(lastImage);
+    }
+    return true;
+}
+
+std::vector<FrameViewport> ClientRouter::GetViewports()
+{
+    std::vector<FrameViewport> viewports;
+    std::lock_guard<std::mutex> guard(routerMutex);
+    for (const auto& item : clients) {
+        const FrameViewport& viewport = item.second->viewport;
+        if (viewport.IsSet() && std::find(viewports.begin(), viewports.end(), viewport) == viewports.end()) {
+            viewports.push_back(viewport);
+        }
+    }
+    return viewports;
+}
+
+std::vector<void*> ClientRouter::GetPendingHandles()
+{
+    std::vector<void*> handles;
+    std::lock_guard<std::mutex> guard(routerMutex);
+    for (const auto& item : clients) {
+        if (!item.second->queue.IsEmpty()) {
+            handles.push_back(item.first);
+        }
+    }
+    return handles;
+}
+
+bool ClientRouter::IsReplayed(int32_t variant, const FrameViewport& viewport)
+{
+    return variant == 0 && !viewport.IsSet();
+}
+
+std::vector<std::shared_ptr<SendPacket>> ClientRouter::SelectBackups(int32_t variant,
+    const std::shared_ptr<SendPacket>& first, const std::vector<std::shared_ptr<SendPacket>>& regions,
+    const std::vector<std::shared_ptr<SendPacket>>& variants)
+{
+    std::vector<std::shared_ptr<SendPacket>> packets;
+    if (variant > 0) {
+        // A variant is a full frame every time, there are no regions to replay after it.
+        if (static_cast<size_t>(variant) <= variants.size() && variants[variant - 1] != nullptr) {
+            packets.push_back(variants[variant - 1]);
+        }
+    } else if (first != nullptr) {
+        packets.push_back(first);
+        packets.insert(packets.end(), regions.begin(), regions.end());
+    }
+    if (std::find(packets.begin(), packets.end(), nullptr) != packets.end()) {
+        packets.clear(); // a chain with a gap would show a broken picture
+    }
+    return packets;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CLIENTROUTER_H
+#define CLIENTROUTER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ClientSendQueue.h"
+
+// The part of the rendered frame a zoomed client shows, the whole frame is sent while width or height is 0.
+struct FrameViewport {
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    double scale = 1.0; // the part is sent scaled down by it
+    static constexpr double MIN_SCALE = 0.1;
+
+    bool IsSet() const
+    {
+        return width > 0 && height > 0;
+    }
+    bool operator==(const FrameViewport& other) const
+    {
+        return x == other.x && y == other.y && width == other.width && height == other.height &&
+            scale == other.scale;
+    }
+    bool operator!=(const FrameViewport& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+// Decides which websocket client takes which packet and when a client is brought up to date from the backups.
+// It knows nothing of lws, a client is the handle of its connection, so the server and its test double share it.
+class ClientRouter {
+public:
+    struct Client {
+        void* handle = nullptr;
+        int32_t variant = 0; // 0 is the full stream
+        std::string name;
+        FrameViewport viewport;
+        ClientSendQueue queue;
+        std::chrono::steady_clock::time_point lastWrittenTime; // when the last packet of the client went out
+    };
+    // The backups that bring a new or lagging client of the variant to the current picture, called without the
+    // lock of the router held.
+    using BackupSource = std::function<std::vector<std::shared_ptr<SendPacket>>(int32_t variant)>;
+
+    explicit ClientRouter(BackupSource source);
+    ClientRouter(const ClientRouter&) = delete;
+    ClientRouter& operator=(const ClientRouter&) = delete;
+
+    // The client starts from the backups of its variant, a client of a viewport waits for its first crop. nullptr
+    // when out of memory.
+    std::shared_ptr<Client> Add(void* handle, int32_t variant, const std::string& name);
+    void Remove(void* handle);
+    std::shared_ptr<Client> Find(void* handle);
+    size_t GetCount();
+    // A variant nobody takes need not be encoded. The clients with a viewport do not take the full stream.
+    bool HasClient(int32_t variant);
+    // Queues the packet for every client of the variant and the viewport, a crop goes to the clients of the
+    // viewport only. A client whose queue is full drops the packets it has not started and catches up, see
+    // IsReplayed. Returns the number of clients that take the packet.
+    size_t Route(const std::shared_ptr<SendPacket>& packet, int32_t variant, const FrameViewport& viewport);
+    // An empty name sets the viewport of every client of the full stream and of the ones that connect later
+    // without a viewport of their own. True when a client went back to the full stream, it starts over from the
+    // backups like a new connection.
+    bool SetViewport(const std::string& name, const FrameViewport& viewport);
+    // The viewports clients show, each once.
+    std::vector<FrameViewport> GetViewports();
+    // The clients with a packet to write.
+    std::vector<void*> GetPendingHandles();
+    // Whether a client that fell behind replays the backups before the packet. A variant is a full frame every
+    // time and a crop is a whole picture by itself, the packet alone is enough.
+    static bool IsReplayed(int32_t variant, const FrameViewport& viewport);
+    // The backups a client of the variant replays: the last frame of the variant, or the last complete frame of
+    // the full stream and the regions sent after it. Empty when a packet of the chain is missing.
+    static std::vector<std::shared_ptr<SendPacket>> SelectBackups(int32_t variant,
+        const std::shared_ptr<SendPacket>& first, const std::vector<std::shared_ptr<SendPacket>>& regions,
+        const std::vector<std::shared_ptr<SendPacket>>& variants);
+
+private:
+    std::vector<std::shared_ptr<Client>> GetTargets(int32_t variant, const FrameViewport& viewport);
+
+    BackupSource backupSource;
+    std::mutex routerMutex;
+    std::map<void*, std::shared_ptr<Client>> clients;
+    FrameViewport defaultViewport; // for the clients of the full stream without a viewport of their own
+    std::map<std::string, FrameViewport> namedViewports;
+};
+
+#endif // CLIENTROUTER_H
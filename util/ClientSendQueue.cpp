@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ClientSendQueue.h"
+
+#include <algorithm>
+#include <new>
+
+std::shared_ptr<SendPacket> SendPacket::Create(std::shared_ptr<uint8_t> buffer, size_t headroom, size_t size)
+{
+    if (!buffer) {
+        return nullptr;
+    }
+    std::shared_ptr<SendPacket> packet(new(std::nothrow) SendPacket());
+    if (!packet) {
+        return nullptr;
+    }
+    packet->buffer = std::move(buffer);
+    packet->headroom = headroom;
+    packet->size = size;
+    return packet;
+}
+
+std::shared_ptr<SendPacket> SendPacket::Copy(const uint8_t* data, size_t size, size_t headroom)
+{
+    std::shared_ptr<uint8_t> buffer(new(std::nothrow) uint8_t[headroom + size], std::default_delete<uint8_t[]>());
+    if (!buffer) {
+        return nullptr;
+    }
+    std::copy(data, data + size, buffer.get() + headroom);
+    return Create(std::move(buffer), headroom, size);
+}
+
+ClientSendQueue::ClientSendQueue(size_t packetLimit, size_t byteLimit) : maxPackets(packetLimit), maxBytes(byteLimit)
+{
+}
+
+bool ClientSendQueue::Push(const std::shared_ptr<SendPacket>& packet)
+{
+    if (!packet) {
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(queueMutex);
+    if (!packets.empty() && (packets.size() >= maxPackets || bytes + packet->GetSize() > maxBytes)) {
+        return false; // an empty queue takes any packet, a large frame must not starve the client
+    }
+    packets.push_back(packet);
+    bytes += packet->GetSize();
+    return true;
+}
+
+void ClientSendQueue::Replace(const std::vector<std::shared_ptr<SendPacket>>& replacement)
+{
+    std::lock_guard<std::mutex> guard(queueMutex);
+    size_t kept = (frontOffset > 0) ? 1 : 0;
+    while (packets.size() > kept) {
+        bytes -= packets.back()->GetSize();
+        packets.pop_back();
+        droppedCount++;
+    }
+    for (const std::shared_ptr<SendPacket>& packet : replacement) {
+        if (packet) {
+            packets.push_back(packet);
+            bytes += packet->GetSize();
+        }
+    }
+}
+
+std::shared_ptr<SendPacket> ClientSendQueue::GetFront(size_t& offset)
+{
+    std::lock_guard<std::mutex> guard(queueMutex);
+    if (packets.empty()) {
+        return nullptr;
+    }
+    offset = frontOffset;
+    return packets.front();
+}
+
+bool ClientSendQueue::Advance(size_t sent)
+{
+    std::lock_guard<std::mutex> guard(queueMutex);
+    if (packets.empty()) {
+        return false;
+    }
+    frontOffset += sent;
+    if (frontOffset < packets.front()->GetSize()) {
+        return false;
+    }
+    packets.front()->isWritten = true;
+    bytes -= packets.front()->GetSize();
+    packets.pop_front();
+    frontOffset = 0;
+    return true;
+}
+
+bool ClientSendQueue::IsEmpty()
+{
+    std::lock_guard<std::mutex> guard(queueMutex);
+    return packets.empty();
+}
+
+size_t ClientSendQueue::GetBytes()
+{
+    std::lock_guard<std::mutex> guard(queueMutex);
+    return bytes;
+}
+
+uint64_t ClientSendQueue::GetDroppedCount() const
+{
+    return droppedCount;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CLIENTSENDQUEUE_H
+#define CLIENTSENDQUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// An encoded packet, written once and shared by every client queue and backup that takes it, the data is never
+// copied again and never changed. The writer may use the headroom before the data, lws_write puts the frame header
+// there.
+struct SendPacket {
+    std::shared_ptr<uint8_t> buffer; // headroom, then the packet
+    size_t headroom = 0;
+    size_t size = 0;
+    std::atomic<bool> isWritten { false }; // set once a client got all of it
+    std::chrono::steady_clock::time_point queuedTime;
+
+    // Takes buffer over, the encoder wrote the packet into it. nullptr when out of memory.
+    static std::shared_ptr<SendPacket> Create(std::shared_ptr<uint8_t> buffer, size_t headroom, size_t size);
+    // For a sender that reuses its buffer.
+    static std::shared_ptr<SendPacket> Copy(const uint8_t* data, size_t size, size_t headroom);
+    uint8_t* GetData() const
+    {
+        return buffer.get() + headroom;
+    }
+    size_t GetSize() const
+    {
+        return size;
+    }
+};
+
+// The packets waiting for one websocket client, bounded in count and bytes so that a slow client costs its own
+// frames only. A packet is written from GetFront and Advance, the one in progress is never dropped because the
+// client would receive a broken message. Push and Replace come from the sender, the rest from the service thread.
+class ClientSendQueue {
+public:
+    static constexpr size_t DEFAULT_MAX_PACKETS = 16; // far more than the regions of a frame
+    static constexpr size_t DEFAULT_MAX_BYTES = 32 * 1024 * 1024; // about a second of 4K frames
+
+    explicit ClientSendQueue(size_t packetLimit = DEFAULT_MAX_PACKETS, size_t byteLimit = DEFAULT_MAX_BYTES);
+    ClientSendQueue(const ClientSendQueue&) = delete;
+    ClientSendQueue& operator=(const ClientSendQueue&) = delete;
+
+    // False, and nothing queued, when the packet would exceed a bound.
+    bool Push(const std::shared_ptr<SendPacket>& packet);
+    // Drops the packets not started yet and queues replacement instead, whatever the bounds, to bring a client
+    // that fell behind up to date.
+    void Replace(const std::vector<std::shared_ptr<SendPacket>>& replacement);
+    // The packet being written and how much of it went out already, nullptr when there is nothing to write.
+    std::shared_ptr<SendPacket> GetFront(size_t& offset);
+    // sent bytes more of the front packet went out, it leaves the queue once complete. True when it did.
+    bool Advance(size_t sent);
+    bool IsEmpty();
+    size_t GetBytes();
+    uint64_t GetDroppedCount() const;
+
+private:
+    std::mutex queueMutex;
+    std::deque<std::shared_ptr<SendPacket>> packets;
+    size_t maxPackets;
+    size_t maxBytes;
+    size_t bytes = 0;
+    size_t frontOffset = 0;
+    std::atomic<uint64_t> droppedCount { 0 };
+};
+
+#endif // CLIENTSENDQUEUE_H
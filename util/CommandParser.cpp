@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <cstdlib>
 #include <regex>
+#include <sstream>
 #include "FileSystem.h"
 #include "PreviewerEngineLog.h"
 #include "TraceTool.h"
@@ -53,7 +54,12 @@ CommandParser::CommandParser()
 #endif // COMPONENT_TEST_ENABLED
       staticCard(false),
       sid(""),
-      srmPath("")
+      srmPath(""),
+      sendResolutionWidth(0),
+      sendResolutionHeight(0),
+      targetFps(-1),
+      recordPath(""),
+      lastFrameDir("")
 {
     Register("-j", 1, "Launch the js app in <directory>.");
     Register("-n", 1, "Set the js app name show on <window title>.");
@@ -103,6 +109,12 @@ CommandParser::CommandParser()
     Register("-sid", 1, "Set sid for websocket");
     Register("-ilt", 1, "Set enable file opertaion for mock");
     Register("-srmPath", 1, "Set system route path");
+    Register("-sr", 2, "Downscale frames to fit the display <width> <height> before sending"); // 2 arguments
+    Register("-fps", 1, "Send at most <fps> frames per second, 0 sends every frame at once.");
+    Register("-sv", 1, "Also send frames scaled to fit <width>x<height>[,...], a client picks one with ?variant=<n>.");
+    Register("-rec", 1, "Record every frame sent to <file>, FrameReplay serves it again.");
+    Register("-lfd", 1, "Keep the last frame of the project in <directory>, a new session sends it before its first"
+        " render.");
 }
 
 CommandParser& CommandParser::GetInstance()
@@ -145,7 +157,9 @@ bool CommandParser::IsCommandValid()
     partRet = partRet && IsAbilityNameValid() && IsLanguageValid() && IsTracePipeNameValid();
     partRet = partRet && IsLocalSocketNameValid() && IsConfigChangesValid() && IsScreenDensityValid();
     partRet = partRet && IsSidValid() && EnableFileOperationValid() && IsSrmPathValid();
-    partRet = partRet && IsBundleNameValid() && IsProjIdValid();
+    partRet = partRet && IsBundleNameValid() && IsProjIdValid() && IsSendResolutionValid();
+    partRet = partRet && IsTargetFpsValid() && IsSimulcastSizesValid() && IsRecordPathValid();
+    partRet = partRet && IsLastFrameDirValid();
     if (partRet) {
         return true;
     }
@@ -1163,4 +1177,139 @@ bool CommandParser::IsSrmPathValid()
     }
     srmPath = path;
     return true;
-}
\ No newline at end of file
+}
+
+int32_t CommandParser::GetSendResolutionWidth() const
+{
+    return sendResolutionWidth;
+}
+
+int32_t CommandParser::GetSendResolutionHeight() const
+{
+    return sendResolutionHeight;
+}
+
+bool CommandParser::IsSendResolutionValid()
+{
+    if (!IsSet("sr")) {
+        return true;
+    }
+    if (!IsResolutionArgValid(std::string("-sr"))) {
+        ELOG("Launch -sr parameters abnormal!");
+        return false;
+    }
+    sendResolutionWidth = atoi(Values("-sr")[0].c_str());
+    sendResolutionHeight = atoi(Values("-sr")[1].c_str());
+    ILOG("CommandParser send resolution: %d %d", sendResolutionWidth, sendResolutionHeight);
+    return true;
+}
+
+int32_t CommandParser::GetTargetFps() const
+{
+    return targetFps;
+}
+
+bool CommandParser::IsTargetFpsValid()
+{
+    if (!IsSet("fps")) {
+        return true;
+    }
+    if (CheckParamInvalidity(Value("fps"), true)) {
+        errorInfo = "Launch -fps parameters is not match regex.";
+        return false;
+    }
+    int32_t fps = atoi(Value("fps").c_str());
+    if (fps > MAX_TARGET_FPS) {
+        errorInfo = std::string("Target fps out of range: 0-" + std::to_string(MAX_TARGET_FPS) + ".");
+        ELOG("Launch -fps parameters abnormal!");
+        return false;
+    }
+    targetFps = fps;
+    ILOG("CommandParser target fps: %d", targetFps);
+    return true;
+}
+
+const std::vector<std::pair<int32_t, int32_t>>& CommandParser::GetSimulcastSizes() const
+{
+    return simulcastSizes;
+}
+
+bool CommandParser::IsSimulcastSizesValid()
+{
+    if (!IsSet("sv")) {
+        return true;
+    }
+    std::string value = Value("sv");
+    std::regex sizesRegex(R"(^[0-9]+x[0-9]+(,[0-9]+x[0-9]+)*$)");
+    if (!std::regex_match(value, sizesRegex)) {
+        errorInfo = "Launch -sv parameters is not match regex.";
+        return false;
+    }
+    std::vector<std::pair<int32_t, int32_t>> sizes;
+    std::stringstream stream(value);
+    std::string size;
+    while (std::getline(stream, size, ',')) {
+        std::string::size_type separator = size.find('x');
+        if (!IsResolutionRangeValid(size.substr(0, separator)) ||
+            !IsResolutionRangeValid(size.substr(separator + 1))) {
+            ELOG("Launch -sv parameters abnormal!");
+            return false;
+        }
+        sizes.emplace_back(atoi(size.substr(0, separator).c_str()), atoi(size.substr(separator + 1).c_str()));
+    }
+    if (sizes.size() > MAX_SIMULCAST_VARIANTS) {
+        errorInfo = std::string("At most " + std::to_string(MAX_SIMULCAST_VARIANTS) + " simulcast variants.");
+        ELOG("Launch -sv parameters abnormal!");
+        return false;
+    }
+    simulcastSizes = sizes;
+    ILOG("CommandParser simulcast variants: %s", value.c_str());
+    return true;
+}
+
+std::string CommandParser::GetRecordPath() const
+{
+    return recordPath;
+}
+
+bool CommandParser::IsRecordPathValid()
+{
+    if (!IsSet("rec")) {
+        return true;
+    }
+    std::string path = Value("rec");
+    std::string::size_type separator = path.find_last_of("/\\");
+    if (path.empty() || separator == path.size() - 1) {
+        errorInfo = "Launch -rec parameters is not a file path.";
+        return false;
+    }
+    if (separator != std::string::npos && separator > 0 && !FileSystem::IsDirectoryExists(path.substr(0, separator))) {
+        errorInfo = std::string("The directory of the recording does not exist.");
+        ELOG("Launch -rec parameters abnormal!");
+        return false;
+    }
+    recordPath = path;
+    ILOG("CommandParser record frames to: %s", recordPath.c_str());
+    return true;
+}
+
+std::string CommandParser::GetLastFrameDir() const
+{
+    return lastFrameDir;
+}
+
+bool CommandParser::IsLastFrameDirValid()
+{
+    if (!IsSet("lfd")) {
+        return true;
+    }
+    std::string path = Value("lfd");
+    if (!FileSystem::IsDirectoryExists(path)) {
+        errorInfo = std::string("The last frame directory does not exist.");
+        ELOG("Launch -lfd parameters abnormal!");
+        return false;
+    }
+    lastFrameDir = path;
+    ILOG("CommandParser keep the last frame in: %s", lastFrameDir.c_str());
+    return true;
+}
@@ -18,6 +18,7 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 class CommandInfo {
@@ -105,6 +106,17 @@ public:
 #endif // COMPONENT_TEST_ENABLED
     std::string GetSid() const;
     std::string GetSrmPath() const;
+    // 0 when frames are sent at render resolution.
+    int32_t GetSendResolutionWidth() const;
+    int32_t GetSendResolutionHeight() const;
+    // -1 when -fps is not given.
+    int32_t GetTargetFps() const;
+    // The -sv sizes, variant n of the stream fits the size at n - 1.
+    const std::vector<std::pair<int32_t, int32_t>>& GetSimulcastSizes() const;
+    // Empty when -rec is not given.
+    std::string GetRecordPath() const;
+    // Empty when -lfd is not given.
+    std::string GetLastFrameDir() const;
 
 private:
     CommandParser();
@@ -133,6 +145,8 @@ private:
     const int32_t MAX_RESOLUTION = 3840;
     const int MAX_JSHEAPSIZE = 512 * 1024;
     const int MIN_JSHEAPSIZE = 48 * 1024;
+    const int32_t MAX_TARGET_FPS = 120; // FramePacer::MAX_FPS
+    const size_t MAX_SIMULCAST_VARIANTS = 3; // FramePyramid::MAX_LEVELS
     const size_t MAX_NAME_LENGTH = 256;
     bool isSendJSHeap;
     int32_t orignalResolutionWidth;
@@ -175,6 +189,12 @@ private:
     std::string loaderJsonPath;
     std::string sid;
     std::string srmPath;
+    int32_t sendResolutionWidth;
+    int32_t sendResolutionHeight;
+    int32_t targetFps;
+    std::vector<std::pair<int32_t, int32_t>> simulcastSizes;
+    std::string recordPath;
+    std::string lastFrameDir;
 
     bool IsDebugPortValid();
     bool IsAppPathValid();
@@ -218,6 +238,11 @@ private:
     bool IsLoaderJsonPathValid();
     bool IsSidValid();
     bool IsSrmPathValid();
+    bool IsSendResolutionValid();
+    bool IsTargetFpsValid();
+    bool IsSimulcastSizesValid();
+    bool IsRecordPathValid();
+    bool IsLastFrameDirValid();
     std::string HelpText();
     void ProcessingCommand(const std::vector<std::string>& strs);
 };
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConfigFrameCache.h"
+
+#include <algorithm>
+
+void ConfigFrameCache::Store(const FrameConfig& config, std::vector<uint8_t>&& pixels, int32_t width,
+                             int32_t height)
+{
+    if (pixels.empty() || pixels.size() > MAX_BYTES || width < 1 || height < 1) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    std::string key = MakeKey(config);
+    auto found = std::find_if(entries.begin(), entries.end(), [&key](const Entry& entry) {
+        return entry.key == key;
+    });
+    if (found != entries.end()) {
+        bytes -= found->frame.pixels->size();
+        entries.erase(found);
+    }
+    bytes += pixels.size();
+    entries.push_front({ key, { std::make_shared<const std::vector<uint8_t>>(std::move(pixels)), width, height } });
+    while (entries.size() > MAX_ENTRIES || bytes > MAX_BYTES) {
+        bytes -= entries.back().frame.pixels->size();
+        entries.pop_back();
+    }
+}
+
+bool ConfigFrameCache::Find(const FrameConfig& config, CachedFrame& frame)
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    std::string key = MakeKey(config);
+    auto found = std::find_if(entries.begin(), entries.end(), [&key](const Entry& entry) {
+        return entry.key == key;
+    });
+    if (found == entries.end()) {
+        return false;
+    }
+    entries.splice(entries.begin(), entries, found);
+    frame = found->frame;
+    return true;
+}
+
+void ConfigFrameCache::Invalidate()
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    revision++;
+    entries.clear();
+    bytes = 0;
+}
+
+uint32_t ConfigFrameCache::GetRevision() const
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    return revision;
+}
+
+size_t ConfigFrameCache::GetCount() const
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    return entries.size();
+}
+
+size_t ConfigFrameCache::GetBytes() const
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    return bytes;
+}
+
+std::string ConfigFrameCache::MakeKey(const FrameConfig& config) const
+{
+    // The fields are separated by a newline, none of them holds one.
+    return config.route + "\n" + std::to_string(config.width) + "x" + std::to_string(config.height) + "\n" +
+        config.orientation + "\n" + config.colorMode + "\n" + config.language + "\n" + config.foldStatus + "\n" +
+        std::to_string(revision);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CONFIGFRAMECACHE_H
+#define CONFIGFRAMECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// What a rendered frame depends on besides the sources, see ConfigFrameCache.
+struct FrameConfig {
+    std::string route;
+    int32_t width = 0;
+    int32_t height = 0;
+    std::string orientation;
+    std::string colorMode;
+    std::string language;
+    std::string foldStatus;
+};
+
+struct CachedFrame {
+    std::shared_ptr<const std::vector<uint8_t>> pixels;
+    int32_t width = 0;
+    int32_t height = 0;
+};
+
+// The last frame seen in each configuration the client switched between, shown at once when it switches back
+// while the runtime renders the real one. The sources count as part of the configuration: Invalidate starts a
+// new revision and drops every frame. At most MAX_ENTRIES frames and MAX_BYTES are kept, the least recently used
+// frame goes first.
+class ConfigFrameCache {
+public:
+    static constexpr size_t MAX_ENTRIES = 16;
+    static constexpr size_t MAX_BYTES = 256 * 1024 * 1024; // 256 MB, about six 1080 x 2340 frames
+
+    void Store(const FrameConfig& config, std::vector<uint8_t>&& pixels, int32_t width, int32_t height);
+    bool Find(const FrameConfig& config, CachedFrame& frame);
+    void Invalidate();
+    uint32_t GetRevision() const;
+    size_t GetCount() const;
+    size_t GetBytes() const;
+
+private:
+    struct Entry {
+        std::string key;
+        CachedFrame frame;
+    };
+    std::string MakeKey(const FrameConfig& config) const;
+
+    mutable std::mutex cacheMutex;
+    uint32_t revision = 0;
+    size_t bytes = 0;
+    std::list<Entry> entries; // most recently used first
+};
+
+#endif // CONFIGFRAMECACHE_H
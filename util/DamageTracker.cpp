@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DamageTracker.h"
+
+#include <algorithm>
+#include <cstring>
+#include "PreviewerEngineLog.h"
+
+namespace {
+    const int32_t BYTES_PER_PIXEL = 4;
+}
+
+std::vector<DamageRect> DamageTracker::Update(const uint8_t* data, size_t stride, int32_t width, int32_t height)
+{
+    if (data == nullptr || width < 1 || height < 1 || stride < static_cast<size_t>(width) * BYTES_PER_PIXEL) {
+        ELOG("DamageTracker::Update invalid frame.");
+        return {};
+    }
+    if (!hasFrame || width != frameWidth || height != frameHeight) {
+        return TakeFullFrame(data, stride, width, height);
+    }
+    std::vector<TileRect> rects;
+    std::vector<size_t> openRects;
+    for (int32_t band = 0; band < tileRows; ++band) {
+        MarkBand(data, stride, band);
+        MergeBand(band, rects, openRects);
+    }
+    return ToPixelRects(rects);
+}
+
+void DamageTracker::Reset()
+{
+    hasFrame = false;
+}
+
+bool DamageTracker::IsFullFrame(const std::vector<DamageRect>& rects) const
+{
+    return rects.size() == 1 && rects[0].x == 0 && rects[0].y == 0 && rects[0].width == frameWidth &&
+        rects[0].height == frameHeight;
+}
+
+int32_t DamageTracker::GetTileSize() const
+{
+    return tileSize;
+}
+
+std::vector<DamageRect> DamageTracker::TakeFullFrame(const uint8_t* data, size_t stride, int32_t width,
+                                                     int32_t height)
+{
+    size_t rowBytes = static_cast<size_t>(width) * BYTES_PER_PIXEL;
+    previousFrame.resize(rowBytes * height);
+    for (int32_t y = 0; y < height; ++y) {
+        std::copy(data + y * stride, data + y * stride + rowBytes, previousFrame.data() + y * rowBytes);
+    }
+    frameWidth = width;
+    frameHeight = height;
+    tileColumns = (width + tileSize - 1) / tileSize;
+    tileRows = (height + tileSize - 1) / tileSize;
+    dirtyTiles.assign(tileColumns, 0);
+    hasFrame = true;
+    DamageRect full;
+    full.width = width;
+    full.height = height;
+    return { full };
+}
+
+void DamageTracker::MarkBand(const uint8_t* data, size_t stride, int32_t band)
+{
+    std::fill(dirtyTiles.begin(), dirtyTiles.end(), 0);
+    int32_t top = band * tileSize;
+    int32_t bottom = std::min(top + tileSize, frameHeight);
+    size_t rowBytes = static_cast<size_t>(frameWidth) * BYTES_PER_PIXEL;
+    size_t tileBytes = static_cast<size_t>(tileSize) * BYTES_PER_PIXEL;
+    bool isBandDirty = false;
+    for (int32_t y = top; y < bottom; ++y) {
+        const uint8_t* row = data + y * stride;
+        const uint8_t* previousRow = previousFrame.data() + y * rowBytes;
+        if (std::memcmp(row, previousRow, rowBytes) == 0) {
+            continue; // most rows of a mostly static screen
+        }
+        for (int32_t column = 0; column < tileColumns; ++column) {
+            size_t offset = column * tileBytes;
+            if (dirtyTiles[column] == 0 &&
+                std::memcmp(row + offset, previousRow + offset, std::min(tileBytes, rowBytes - offset)) != 0) {
+                dirtyTiles[column] = 1;
+                isBandDirty = true;
+            }
+        }
+    }
+    if (!isBandDirty) {
+        return;
+    }
+    // Only the changed tiles are copied, the previous frame stays identical to the one just seen.
+    for (int32_t y = top; y < bottom; ++y) {
+        const uint8_t* row = data + y * stride;
+        uint8_t* previousRow = previousFrame.data() + y * rowBytes;
+        for (int32_t column = 0; column < tileColumns; ++column) {
+            if (dirtyTiles[column] != 0) {
+                size_t offset = column * tileBytes;
+                std::copy(row + offset, row + offset + std::min(tileBytes, rowBytes - offset), previousRow + offset);
+            }
+        }
+    }
+}
+
+void DamageTracker::MergeBand(int32_t band, std::vector<TileRect>& rects, std::vector<size_t>& openRects) const
+{
+    std::vector<size_t> nextOpenRects;
+    int32_t column = 0;
+    while (column < tileColumns) {
+        if (dirtyTiles[column] == 0) {
+            column++;
+            continue;
+        }
+        int32_t start = column;
+        while (column < tileColumns && dirtyTiles[column] != 0) {
+            column++;
+        }
+        // A run spanning the same columns as a rectangle of the band above extends that rectangle downwards.
+        auto iter = std::find_if(openRects.begin(), openRects.end(), [&rects, start, column](size_t index) {
+            return rects[index].left == start && rects[index].right == column;
+        });
+        if (iter != openRects.end()) {
+            rects[*iter].bottom = band + 1;
+            nextOpenRects.push_back(*iter);
+        } else {
+            rects.push_back({ start, band, column, band + 1 });
+            nextOpenRects.push_back(rects.size() - 1);
+        }
+    }
+    openRects.swap(nextOpenRects);
+}
+
+std::vector<DamageRect> DamageTracker::ToPixelRects(std::vector<TileRect>& rects) const
+{
+    if (rects.size() > maxRects) {
+        // Too many pieces, one bounding rectangle is cheaper than a message per piece.
+        TileRect bounds = rects[0];
+        for (const TileRect& rect : rects) {
+            bounds.left = std::min(bounds.left, rect.left);
+            bounds.top = std::min(bounds.top, rect.top);
+            bounds.right = std::max(bounds.right, rect.right);
+            bounds.bottom = std::max(bounds.bottom, rect.bottom);
+        }
+        rects.assign(1, bounds);
+    }
+    std::vector<DamageRect> damage;
+    for (const TileRect& rect : rects) {
+        DamageRect pixels;
+        pixels.x = rect.left * tileSize;
+        pixels.y = rect.top * tileSize;
+        pixels.width = std::min(rect.right * tileSize, frameWidth) - pixels.x;
+        pixels.height = std::min(rect.bottom * tileSize, frameHeight) - pixels.y;
+        damage.push_back(pixels);
+    }
+    return damage;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DAMAGETRACKER_H
+#define DAMAGETRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct DamageRect {
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+
+    bool operator==(const DamageRect& other) const
+    {
+        return x == other.x && y == other.y && width == other.width && height == other.height;
+    }
+};
+
+// Finds what changed between two consecutive 4 bytes per pixel frames. Frames are compared tile by tile with the
+// copy of the previous frame kept here, the changed tiles are merged into a few rectangles.
+class DamageTracker {
+public:
+    static constexpr int32_t DEFAULT_TILE_SIZE = 32;
+    static constexpr size_t DEFAULT_MAX_RECTS = 4;
+
+    explicit DamageTracker(int32_t tile = DEFAULT_TILE_SIZE, size_t maxRectCount = DEFAULT_MAX_RECTS)
+        : tileSize(tile > 0 ? tile : DEFAULT_TILE_SIZE), maxRects(maxRectCount > 0 ? maxRectCount : 1) {}
+
+    // Returns the changed rectangles in pixels, empty when the frame equals the previous one. The first frame and
+    // every frame after Reset or a size change come back as one rectangle covering the whole frame.
+    std::vector<DamageRect> Update(const uint8_t* data, size_t stride, int32_t width, int32_t height);
+    // Forget the previous frame, the next Update reports the whole frame.
+    void Reset();
+    bool IsFullFrame(const std::vector<DamageRect>& rects) const;
+    int32_t GetTileSize() const;
+
+private:
+    struct TileRect {
+        int32_t left;
+        int32_t top;
+        int32_t right; // exclusive, in tiles
+        int32_t bottom; // exclusive, in tiles
+    };
+    std::vector<DamageRect> TakeFullFrame(const uint8_t* data, size_t stride, int32_t width, int32_t height);
+    void MarkBand(const uint8_t* data, size_t stride, int32_t band);
+    void MergeBand(int32_t band, std::vector<TileRect>& rects, std::vector<size_t>& openRects) const;
+    std::vector<DamageRect> ToPixelRects(std::vector<TileRect>& rects) const;
+
+    int32_t tileSize;
+    size_t maxRects;
+    int32_t frameWidth = 0;
+    int32_t frameHeight = 0;
+    int32_t tileColumns = 0;
+    int32_t tileRows = 0;
+    bool hasFrame = false;
+    std::vector<uint8_t> previousFrame;
+    std::vector<uint8_t> dirtyTiles; // dirty flags of the tile row being compared
+};
+
+#endif // DAMAGETRACKER_H
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameBufferPool.h"
+
+#include <new>
+#include "PreviewerEngineLog.h"
+
+FrameBufferPool& FrameBufferPool::GetInstance()
+{
+    static FrameBufferPool* pool = new FrameBufferPool(); // never destroyed, see the class comment
+    return *pool;
+}
+
+size_t FrameBufferPool::GetSizeClass(size_t size)
+{
+    return (size + SIZE_CLASS_GRANULARITY - 1) / SIZE_CLASS_GRANULARITY * SIZE_CLASS_GRANULARITY;
+}
+
+uint8_t* FrameBufferPool::Acquire(size_t size)
+{
+    if (size == 0) {
+        return nullptr;
+    }
+    size_t sizeClass = GetSizeClass(size);
+    std::lock_guard<std::mutex> guard(poolMutex);
+    auto iter = freeBuffers.find(sizeClass);
+    if (iter != freeBuffers.end() && !iter->second.empty()) {
+        uint8_t* buffer = iter->second.back();
+        iter->second.pop_back();
+        freeOrder.erase(buffers[buffer].freePos);
+        freeBytes -= sizeClass;
+        return buffer;
+    }
+    uint8_t* buffer = new(std::nothrow) uint8_t[sizeClass];
+    if (!buffer) {
+        ELOG("Memory allocation failed : frame buffer pool, size: %zu.", sizeClass);
+        return nullptr;
+    }
+    buffers[buffer] = { sizeClass, generation };
+    allocationCount++;
+    poolBytes += sizeClass;
+    if (poolBytes > peakPoolBytes) {
+        peakPoolBytes = poolBytes;
+    }
+    return buffer;
+}
+
+void FrameBufferPool::Release(uint8_t* buffer)
+{
+    if (buffer == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(poolMutex);
+    auto iter = buffers.find(buffer);
+    if (iter == buffers.end()) {
+        ELOG("FrameBufferPool::Release buffer is not owned by the pool.");
+        return;
+    }
+    std::vector<uint8_t*>& freeList = freeBuffers[iter->second.capacity];
+    if (iter->second.generation != generation || freeList.size() >= MAX_FREE_BUFFERS_PER_CLASS) {
+        FreeBuffer(buffer);
+        return;
+    }
+    freeList.push_back(buffer);
+    iter->second.freePos = freeOrder.insert(freeOrder.end(), buffer);
+    freeBytes += iter->second.capacity;
+    EvictFreeBuffers();
+}
+
+void FrameBufferPool::EvictFreeBuffers()
+{
+    while (freeBytes > maxFreeBytes && !freeOrder.empty()) {
+        uint8_t* oldest = freeOrder.front();
+        freeOrder.pop_front();
+        size_t capacity = buffers[oldest].capacity;
+        // A size class hands out its most recent buffer, its least recent one is the first of the list.
+        std::vector<uint8_t*>& freeList = freeBuffers[capacity];
+        freeList.erase(freeList.begin());
+        freeBytes -= capacity;
+        evictionCount++;
+        FreeBuffer(oldest);
+    }
+}
+
+std::shared_ptr<uint8_t> FrameBufferPool::Share(uint8_t* buffer)
+{
+    if (buffer == nullptr) {
+        return nullptr;
+    }
+    return std::shared_ptr<uint8_t>(buffer, [](uint8_t* shared) { FrameBufferPool::GetInstance().Release(shared); });
+}
+
+size_t FrameBufferPool::GetCapacity(const uint8_t* buffer) const
+{
+    std::lock_guard<std::mutex> guard(poolMutex);
+    auto iter = buffers.find(buffer);
+    if (iter == buffers.end()) {
+        return 0;
+    }
+    return iter->second.capacity;
+}
+
+void FrameBufferPool::Reset()
+{
+    std::lock_guard<std::mutex> guard(poolMutex);
+    for (auto& freeList : freeBuffers) {
+        for (uint8_t* buffer : freeList.second) {
+            FreeBuffer(buffer);
+        }
+    }
+    freeBuffers.clear();
+    freeOrder.clear();
+    freeBytes = 0;
+    // Buffers still in flight belong to the old generation and are freed when they come back.
+    generation++;
+    ILOG("FrameBufferPool reset, pool bytes: %zu.", poolBytes);
+}
+
+void FrameBufferPool::FreeBuffer(uint8_t* buffer)
+{
+    auto iter = buffers.find(buffer);
+    if (iter == buffers.end()) {
+        return;
+    }
+    poolBytes -= iter->second.capacity;
+    buffers.erase(iter);
+    delete [] buffer;
+}
+
+uint64_t FrameBufferPool::GetAllocationCount() const
+{
+    std::lock_guard<std::mutex> guard(poolMutex);
+    return allocationCount;
+}
+
+size_t FrameBufferPool::GetPoolBytes() const
+{
+    std::lock_guard<std::mutex> guard(poolMutex);
+    return poolBytes;
+}
+
+size_t FrameBufferPool::GetPeakPoolBytes() const
+{
+    std::lock_guard<std::mutex> guard(poolMutex);
+    return peakPoolBytes;
+}
+
+size_t FrameBufferPool::GetFreeBytes() const
+{
+    std::lock_guard<std::mutex> guard(poolMutex);
+    return freeBytes;
+}
+
+size_t FrameBufferPool::GetMaxFreeBytes() const
+{
+    std::lock_guard<std::mutex> guard(poolMutex);
+    return maxFreeBytes;
+}
+
+void FrameBufferPool::SetMaxFreeBytes(size_t bytes)
+{
+    std::lock_guard<std::mutex> guard(poolMutex);
+    maxFreeBytes = bytes;
+    EvictFreeBuffers();
+}
+
+uint64_t FrameBufferPool::GetEvictionCount() const
+{
+    std::lock_guard<std::mutex> guard(poolMutex);
+    return evictionCount;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEBUFFERPOOL_H
+#define FRAMEBUFFERPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Size-class pool for the frame buffers that travel through the screen send path.
+// Buffers are allocated with new[] so a buffer handed out by the pool can also be released with delete[].
+// The pool is never destroyed, a shared buffer may come back while the process exits.
+// The cached buffers are bounded per size class and in total, past the total the least recently released go first.
+class FrameBufferPool {
+public:
+    FrameBufferPool(const FrameBufferPool&) = delete;
+    FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+    static FrameBufferPool& GetInstance();
+
+    uint8_t* Acquire(size_t size);
+    void Release(uint8_t* buffer);
+    // Hands an acquired buffer over to shared owners, it is released when the last one drops it.
+    std::shared_ptr<uint8_t> Share(uint8_t* buffer);
+    size_t GetCapacity(const uint8_t* buffer) const;
+    // Drop the cached buffers, called when the resolution or the fold status changes.
+    void Reset();
+    uint64_t GetAllocationCount() const;
+    size_t GetPoolBytes() const;
+    size_t GetPeakPoolBytes() const;
+    // The bytes of the cached buffers, at most GetMaxFreeBytes.
+    size_t GetFreeBytes() const;
+    size_t GetMaxFreeBytes() const;
+    void SetMaxFreeBytes(size_t bytes);
+    // Cached buffers freed to keep within GetMaxFreeBytes.
+    uint64_t GetEvictionCount() const;
+
+private:
+    FrameBufferPool() = default;
+    ~FrameBufferPool() = default;
+    static size_t GetSizeClass(size_t size);
+    void FreeBuffer(uint8_t* buffer);
+    // Frees the least recently released buffers until the cached ones fit maxFreeBytes, with the lock held.
+    void EvictFreeBuffers();
+
+    struct BufferInfo {
+        size_t capacity;
+        uint32_t generation;
+        std::list<uint8_t*>::iterator freePos; // in freeOrder while the buffer is cached
+    };
+    std::map<const uint8_t*, BufferInfo> buffers;
+    std::map<size_t, std::vector<uint8_t*>> freeBuffers;
+    std::list<uint8_t*> freeOrder; // the cached buffers, the least recently released first
+    mutable std::mutex poolMutex;
+    uint32_t generation = 0;
+    uint64_t allocationCount = 0;
+    uint64_t evictionCount = 0;
+    size_t poolBytes = 0;
+    size_t peakPoolBytes = 0;
+    size_t freeBytes = 0;
+    size_t maxFreeBytes = DEFAULT_MAX_FREE_BYTES;
+    static constexpr size_t SIZE_CLASS_GRANULARITY = 64 * 1024; // 64 KiB per size class step
+    static constexpr size_t MAX_FREE_BUFFERS_PER_CLASS = 4;
+    static constexpr size_t DEFAULT_MAX_FREE_BYTES = 64 * 1024 * 1024; // about two 4K RGBA frames
+};
+
+#endif // FRAMEBUFFERPOOL_H
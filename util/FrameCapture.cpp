@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameCapture.h"
+
+#include "FrameHash.h"
+
+void FrameCapture::Offer(const uint8_t* data, size_t length, int32_t width, int32_t height)
+{
+    if (!isWaiting || data == nullptr || length == 0) {
+        return;
+    }
+    uint64_t hash = FrameHash::Hash64(data, length);
+    {
+        std::lock_guard<std::mutex> guard(captureMutex);
+        if (!isWaiting) {
+            return;
+        }
+        latestTime = Clock::now();
+        if (sameCount > 0 && hash == latestHash && width == latest.width && height == latest.height &&
+            length == latest.pixels.size()) {
+            sameCount++;
+        } else {
+            latest.pixels.assign(data, data + length);
+            latest.width = width;
+            latest.height = height;
+            latestHash = hash;
+            sameCount = 1;
+        }
+    }
+    frameCondition.notify_all();
+}
+
+bool FrameCapture::Capture(uint32_t stableFrames, std::chrono::milliseconds quietPeriod,
+                           std::chrono::milliseconds timeout, CapturedFrame& frame,
+                           const std::function<void()>& onWaiting)
+{
+    std::unique_lock<std::mutex> lock(captureMutex);
+    if (isWaiting) {
+        return false; // one screenshot at a time, the commands come from one thread anyway
+    }
+    latest = CapturedFrame();
+    sameCount = 0;
+    isWaiting = true;
+    if (onWaiting) {
+        lock.unlock();
+        onWaiting();
+        lock.lock();
+    }
+    Clock::time_point deadline = Clock::now() + timeout;
+    bool isSettled = false;
+    while (true) {
+        Clock::time_point now = Clock::now();
+        isSettled = IsSettled(stableFrames, quietPeriod, now);
+        if (isSettled || now >= deadline) {
+            break;
+        }
+        Clock::time_point wakeUp = deadline;
+        if (sameCount > 0 && latestTime + quietPeriod < wakeUp) {
+            wakeUp = latestTime + quietPeriod;
+        }
+        frameCondition.wait_until(lock, wakeUp);
+    }
+    isWaiting = false;
+    if (isSettled) {
+        frame = std::move(latest);
+    }
+    latest = CapturedFrame();
+    return isSettled;
+}
+
+bool FrameCapture::IsSettled(uint32_t stableFrames, std::chrono::milliseconds quietPeriod,
+                             Clock::time_point now) const
+{
+    if (sameCount == 0) {
+        return false;
+    }
+    return sameCount >= stableFrames || now - latestTime >= quietPeriod;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+struct CapturedFrame {
+    std::vector<uint8_t> pixels;
+    int32_t width = 0;
+    int32_t height = 0;
+};
+
+// Hands the frames the sender takes to a screenshot that waits for them. Nothing is copied while no screenshot
+// waits, the sender only reads an atomic flag then.
+class FrameCapture {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Called by the sender with every frame it takes.
+    void Offer(const uint8_t* data, size_t length, int32_t width, int32_t height);
+    // Blocks until stableFrames frames in a row are identical, or until a frame stayed for quietPeriod without a
+    // newer one, which is how a still scene looks to the sender. Frames offered before the call do not count.
+    // onWaiting runs once offers are taken, to have the current frame offered again. False when no frame settled
+    // before the timeout.
+    bool Capture(uint32_t stableFrames, std::chrono::milliseconds quietPeriod, std::chrono::milliseconds timeout,
+                 CapturedFrame& frame, const std::function<void()>& onWaiting = nullptr);
+
+private:
+    bool IsSettled(uint32_t stableFrames, std::chrono::milliseconds quietPeriod, Clock::time_point now) const;
+
+    std::mutex captureMutex;
+    std::condition_variable frameCondition;
+    std::atomic<bool> isWaiting { false };
+    CapturedFrame latest;
+    uint64_t latestHash = 0;
+    uint32_t sameCount = 0; // offers in a row with the pixels of latest, 0 before the first one
+    Clock::time_point latestTime;
+};
+
+#endif // FRAMECAPTURE_H
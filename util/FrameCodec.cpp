@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameCodec.h"
+
+#include <cstring>
+#include "Lz4Codec.h"
+#include "PreviewerEngineLog.h"
+#include "QoiCodec.h"
+
+namespace {
+    const size_t PIXEL_SIZE = 4;
+    const double AVERAGE_WEIGHT = 0.25; // every sample moves the average by a quarter of the difference
+    const char* const CODEC_NAMES[] = { "raw", "qoi", "lz4" }; // same order as the codecs of the selector
+
+    double Smooth(bool hasSample, double average, double sample)
+    {
+        return hasSample ? average + (sample - average) * AVERAGE_WEIGHT : sample;
+    }
+}
+
+FrameCodecId RawFrameCodec::GetId() const
+{
+    return FrameCodecId::RAW;
+}
+
+size_t RawFrameCodec::Encode(const uint8_t* data, int32_t width, int32_t height, uint8_t* dst, size_t capacity)
+{
+    if (data == nullptr || dst == nullptr || width < 1 || height < 1) {
+        return 0;
+    }
+    size_t length = static_cast<size_t>(width) * height * PIXEL_SIZE;
+    if (length > capacity) {
+        return 0;
+    }
+    std::memcpy(dst, data, length);
+    return length;
+}
+
+bool RawFrameCodec::Decode(const uint8_t* data, size_t length, int32_t width, int32_t height, uint8_t* dst)
+{
+    if (data == nullptr || dst == nullptr || width < 1 || height < 1 ||
+        length != static_cast<size_t>(width) * height * PIXEL_SIZE) {
+        return false;
+    }
+    std::memcpy(dst, data, length);
+    return true;
+}
+
+FrameCodecSelector::FrameCodecSelector()
+{
+    codecs[GetIndex(FrameCodecId::RAW)] = std::make_unique<RawFrameCodec>();
+    codecs[GetIndex(FrameCodecId::QOI)] = std::make_unique<QoiCodec>();
+    codecs[GetIndex(FrameCodecId::LZ4)] = std::make_unique<Lz4Codec>();
+}
+
+FrameCodecSelector::~FrameCodecSelector() {}
+
+bool FrameCodecSelector::SetCodec(const std::string& name)
+{
+    int index = -1;
+    for (size_t i = 0; i < CODEC_COUNT; ++i) {
+        if (name == CODEC_NAMES[i]) {
+            index = static_cast<int>(i);
+        }
+    }
+    if (index < 0 && name != "default" && name != "auto") {
+        ELOG("FrameCodecSelector::SetCodec unknown codec: %s", name.c_str());
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(selectorMutex);
+    codecName = name;
+    fixedIndex = index;
+    for (CodecStats& codecStats : stats) {
+        codecStats = CodecStats();
+    }
+    hasDrainSample = false;
+    frameCount = 0;
+    return true;
+}
+
+std::string FrameCodecSelector::GetCodecName() const
+{
+    std::lock_guard<std::mutex> guard(selectorMutex);
+    return codecName;
+}
+
+bool FrameCodecSelector::IsDefault() const
+{
+    std::lock_guard<std::mutex> guard(selectorMutex);
+    return codecName == "default";
+}
+
+FrameCodec* FrameCodecSelector::Pick()
+{
+    std::lock_guard<std::mutex> guard(selectorMutex);
+    if (fixedIndex >= 0) {
+        return codecs[fixedIndex].get();
+    }
+    if (codecName != "auto") {
+        return nullptr;
+    }
+    return codecs[PickAutoLocked()].get();
+}
+
+FrameCodec* FrameCodecSelector::GetRawCodec()
+{
+    return codecs[GetIndex(FrameCodecId::RAW)].get();
+}
+
+void FrameCodecSelector::OnFrameSent(FrameCodecId id, size_t rawBytes, size_t encodedBytes, int64_t encodeUs,
+                                     int64_t drainUs)
+{
+    int index = GetIndex(id);
+    if (index < 0 || rawBytes == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(selectorMutex);
+    CodecStats& codecStats = stats[index];
+    codecStats.encodeUsPerByte = Smooth(codecStats.hasSample, codecStats.encodeUsPerByte,
+        static_cast<double>(encodeUs) / rawBytes);
+    codecStats.ratio = Smooth(codecStats.hasSample, codecStats.ratio, static_cast<double>(encodedBytes) / rawBytes);
+    codecStats.hasSample = true;
+    if (encodedBytes > 0) {
+        drainUsPerByte = Smooth(hasDrainSample, drainUsPerByte, static_cast<double>(drainUs) / encodedBytes);
+        hasDrainSample = true;
+    }
+}
+
+size_t FrameCodecSelector::PickAutoLocked()
+{
+    // Each codec is measured once, then the cheapest one is used and the others are measured again now and then
+    // since the content and the link change.
+    for (size_t i = 0; i < CODEC_COUNT; ++i) {
+        if (!stats[i].hasSample) {
+            return i;
+        }
+    }
+    ++frameCount;
+    if (frameCount % PROBE_PERIOD == 0) {
+        probeIndex = (probeIndex + 1) % CODEC_COUNT;
+        return probeIndex;
+    }
+    // Encoding a byte costs encodeUsPerByte and saves (1 - ratio) bytes of drain time.
+    size_t best = 0;
+    double bestCost = 0;
+    for (size_t i = 0; i < CODEC_COUNT; ++i) {
+        double cost = stats[i].encodeUsPerByte + stats[i].ratio * drainUsPerByte;
+        if (i == 0 || cost < bestCost) {
+            best = i;
+            bestCost = cost;
+        }
+    }
+    return best;
+}
+
+int FrameCodecSelector::GetIndex(FrameCodecId id)
+{
+    switch (id) {
+        case FrameCodecId::RAW:
+            return 0;
+        case FrameCodecId::QOI:
+            return 1;
+        case FrameCodecId::LZ4:
+            return 2; // 2: third codec
+        default:
+            return -1;
+    }
+}
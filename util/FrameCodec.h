@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMECODEC_H
+#define FRAMECODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Written to the frame header so the client knows how to read the payload. DEFAULT keeps the old meaning: jpeg,
+// or raw RGBA in component mode. DELTA frames are read with FrameDelta against the previous picture.
+enum class FrameCodecId : uint8_t { DEFAULT = 0, JPEG = 1, RAW = 2, QOI = 3, LZ4 = 4, DELTA = 5 };
+
+// A codec for 4 bytes per pixel frames with rows packed back to back.
+class FrameCodec {
+public:
+    virtual ~FrameCodec() {}
+    virtual FrameCodecId GetId() const = 0;
+    // Returns the encoded size, 0 when the result does not fit in capacity.
+    virtual size_t Encode(const uint8_t* data, int32_t width, int32_t height, uint8_t* dst, size_t capacity) = 0;
+    // Returns false for a malformed payload, dst must hold width * height * 4 bytes.
+    virtual bool Decode(const uint8_t* data, size_t length, int32_t width, int32_t height, uint8_t* dst) = 0;
+};
+
+class RawFrameCodec : public FrameCodec {
+public:
+    FrameCodecId GetId() const override;
+    size_t Encode(const uint8_t* data, int32_t width, int32_t height, uint8_t* dst, size_t capacity) override;
+    bool Decode(const uint8_t* data, size_t length, int32_t width, int32_t height, uint8_t* dst) override;
+};
+
+// Picks the lossless codec of the component mode frames. A session either fixes one codec or lets the selector
+// choose by measured cost: encoding time is only worth spending while it saves more websocket time than it takes.
+class FrameCodecSelector {
+public:
+    FrameCodecSelector();
+    ~FrameCodecSelector();
+    FrameCodecSelector(const FrameCodecSelector&) = delete;
+    FrameCodecSelector& operator=(const FrameCodecSelector&) = delete;
+
+    // "default", "raw", "qoi", "lz4" or "auto", returns false for other names.
+    bool SetCodec(const std::string& name);
+    std::string GetCodecName() const;
+    bool IsDefault() const;
+    // nullptr keeps the default raw RGBA path.
+    FrameCodec* Pick();
+    FrameCodec* GetRawCodec();
+    void OnFrameSent(FrameCodecId id, size_t rawBytes, size_t encodedBytes, int64_t encodeUs, int64_t drainUs);
+
+private:
+    struct CodecStats {
+        bool hasSample = false;
+        double encodeUsPerByte = 0; // per raw byte
+        double ratio = 1; // encoded bytes per raw byte
+    };
+    static constexpr size_t CODEC_COUNT = 3; // raw, qoi and lz4 are candidates in auto mode
+    static constexpr uint32_t PROBE_PERIOD = 60; // frames between two measurements of the other codecs
+
+    size_t PickAutoLocked();
+    static int GetIndex(FrameCodecId id);
+
+    mutable std::mutex selectorMutex;
+    std::string codecName = "default";
+    int fixedIndex = -1;
+    std::unique_ptr<FrameCodec> codecs[CODEC_COUNT];
+    CodecStats stats[CODEC_COUNT];
+    bool hasDrainSample = false;
+    double drainUsPerByte = 0;
+    uint32_t frameCount = 0;
+    size_t probeIndex = 0;
+};
+
+#endif // FRAMECODEC_H
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "FrameDelta.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // out = left ^ right, eight bytes at a time so the compiler can vectorize it.
+    void XorFrames(const uint8_t* left, const uint8_t* right, uint8_t* out, size_t length)
+    {
+        size_t offset = 0;
+        for (; offset + sizeof(uint64_t) <= length; offset += sizeof(uint64_t)) {
+            uint64_t leftWord;
+            uint64_t rightWord;
+            std::memcpy(&leftWord, left + offset, sizeof(leftWord));
+            std::memcpy(&rightWord, right + offset, sizeof(rightWord));
+            leftWord ^= rightWord;
+            std::memcpy(out + offset, &leftWord, sizeof(leftWord));
+        }
+        for (; offset < length; ++offset) {
+            out[offset] = left[offset] ^ right[offset];
+        }
+    }
+}
+
+void FrameDelta::Configure(bool enable, uint32_t interval)
+{
+    std::lock_guard<std::mutex> guard(deltaMutex);
+    enabled = enable;
+    keyframeInterval = std::clamp<uint32_t>(interval, 1, MAX_KEYFRAME_INTERVAL);
+    hasReference = false;
+    if (!enabled) {
+        std::vector<uint8_t>().swap(reference);
+        std::vector<uint8_t>().swap(scratch);
+    }
+}
+
+bool FrameDelta::IsEnabled() const
+{
+    std::lock_guard<std::mutex> guard(deltaMutex);
+    return enabled;
+}
+
+uint32_t FrameDelta::GetKeyframeInterval() const
+{
+    std::lock_guard<std::mutex> guard(deltaMutex);
+    return keyframeInterval;
+}
+
+void FrameDelta::RequestKeyframe()
+{
+    std::lock_guard<std::mutex> guard(deltaMutex);
+    hasReference = false;
+}
+
+size_t FrameDelta::Encode(const uint8_t* data, int32_t width, int32_t height, uint32_t connection, uint8_t* dst,
+                          size_t capacity)
+{
+    std::lock_guard<std::mutex> guard(deltaMutex);
+    if (!enabled || !hasReference || data == nullptr || dst == nullptr || width != referenceWidth ||
+        height != referenceHeight || connection != referenceConnection || framesSinceKeyframe >= keyframeInterval) {
+        return 0;
+    }
+    size_t length = reference.size();
+    scratch.resize(length);
+    XorFrames(data, reference.data(), scratch.data(), length);
+    size_t size = lz4.Compress(scratch.data(), length, dst, std::min(capacity, length / MAX_DELTA_RATIO));
+    if (size == 0) {
+        return 0;
+    }
+    std::copy(data, data + length, reference.begin());
+    framesSinceKeyframe++;
+    return size;
+}
+
+void FrameDelta::SetReference(const uint8_t* data, int32_t width, int32_t height, uint32_t connection)
+{
+    std::lock_guard<std::mutex> guard(deltaMutex);
+    if (!enabled || data == nullptr || width < 1 || height < 1) {
+        return;
+    }
+    size_t length = static_cast<size_t>(width) * height * PIXEL_SIZE;
+    reference.assign(data, data + length);
+    referenceWidth = width;
+    referenceHeight = height;
+    referenceConnection = connection;
+    framesSinceKeyframe = 0;
+    hasReference = true;
+}
+
+bool FrameDelta::Apply(const uint8_t* delta, size_t length, int32_t width, int32_t height, uint8_t* frame)
+{
+    if (delta == nullptr || frame == nullptr || width < 1 || height < 1) {
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(deltaMutex);
+    size_t frameLength = static_cast<size_t>(width) * height * PIXEL_SIZE;
+    scratch.resize(frameLength);
+    if (!lz4.Decompress(delta, length, scratch.data(), frameLength)) {
+        return false;
+    }
+    XorFrames(frame, scratch.data(), frame, frameLength);
+    return true;
+}
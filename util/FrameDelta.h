@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FRAMEDELTA_H
+#define FRAMEDELTA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "Lz4Codec.h"
+
+// Inter-frame delta of component mode frames: the frame is XORed with the last one sent to the client and the
+// mostly zero result is LZ4 compressed. A keyframe is due when there is no reference for the current connection,
+// the size changed, the keyframe interval is over or the delta would not save enough.
+class FrameDelta {
+public:
+    static constexpr uint32_t DEFAULT_KEYFRAME_INTERVAL = 120; // frames between two keyframes
+    static constexpr uint32_t MAX_KEYFRAME_INTERVAL = 3600;
+
+    void Configure(bool enable, uint32_t interval);
+    bool IsEnabled() const;
+    uint32_t GetKeyframeInterval() const;
+    void RequestKeyframe();
+    // Returns the size of the delta written to dst and makes data the new reference, 0 when a keyframe is due.
+    size_t Encode(const uint8_t* data, int32_t width, int32_t height, uint32_t connection, uint8_t* dst,
+                  size_t capacity);
+    // Called after a keyframe of data went out on the connection.
+    void SetReference(const uint8_t* data, int32_t width, int32_t height, uint32_t connection);
+    // Client side of Encode: frame holds the previous picture and is updated in place.
+    bool Apply(const uint8_t* delta, size_t length, int32_t width, int32_t height, uint8_t* frame);
+
+private:
+    static constexpr size_t PIXEL_SIZE = 4;
+    static constexpr size_t MAX_DELTA_RATIO = 4; // a delta above a quarter of the frame costs as much as a keyframe
+
+    mutable std::mutex deltaMutex;
+    bool enabled = false;
+    bool hasReference = false;
+    uint32_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL;
+    uint32_t framesSinceKeyframe = 0;
+    uint32_t referenceConnection = 0;
+    int32_t referenceWidth = 0;
+    int32_t referenceHeight = 0;
+    std::vector<uint8_t> reference;
+    std::vector<uint8_t> scratch;
+    Lz4Codec lz4;
+};
+
+#endif // FRAMEDELTA_H
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameHash.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define FRAME_HASH_SSE2
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define FRAME_HASH_NEON
+#endif
+
+namespace {
+    constexpr size_t LANES = 8;
+    constexpr size_t STRIPE_SIZE = LANES * sizeof(uint64_t); // 64 bytes per stripe
+    constexpr size_t STRIPES_PER_BLOCK = 16;
+    constexpr size_t SECRET_WORDS = STRIPES_PER_BLOCK + LANES; // every stripe uses the secret shifted by one word
+    constexpr uint64_t PRIME32_1 = 0x9E3779B1ULL;
+    constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+    struct Secret {
+        uint64_t words[SECRET_WORDS];
+        uint64_t scramble[LANES];
+    };
+
+    uint64_t SplitMix64(uint64_t& state)
+    {
+        uint64_t value = (state += PRIME64_1);
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL; // 30: splitmix shift
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL; // 27: splitmix shift
+        return value ^ (value >> 31); // 31: splitmix shift
+    }
+
+    const Secret& GetSecret()
+    {
+        static const Secret secret = []() {
+            Secret value;
+            uint64_t state = PRIME64_5;
+            for (uint64_t& word : value.words) {
+                word = SplitMix64(state);
+            }
+            for (uint64_t& word : value.scramble) {
+                word = SplitMix64(state);
+            }
+            return value;
+        }();
+        return secret;
+    }
+
+    uint64_t Read64(const uint8_t* data)
+    {
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    uint64_t Multiply128Fold64(uint64_t left, uint64_t right)
+    {
+#ifdef __SIZEOF_INT128__
+        unsigned __int128 product = static_cast<unsigned __int128>(left) * right;
+        return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64); // 64: high half
+#else
+        const uint64_t mask = 0xFFFFFFFFULL;
+        uint64_t lowLow = (left & mask) * (right & mask);
+        uint64_t highLow = (left >> 32) * (right & mask); // 32: high word
+        uint64_t lowHigh = (left & mask) * (right >> 32); // 32: high word
+        uint64_t highHigh = (left >> 32) * (right >> 32); // 32: high word
+        uint64_t cross = (lowLow >> 32) + (highLow & mask) + lowHigh; // 32: high word
+        uint64_t high = (highLow >> 32) + (cross >> 32) + highHigh; // 32: high word
+        uint64_t low = (cross << 32) | (lowLow & mask); // 32: high word
+        return low ^ high;
+#endif
+    }
+
+    uint64_t Avalanche(uint64_t hash)
+    {
+        hash ^= hash >> 37; // 37: xxh3 avalanche shift
+        hash *= 0x165667919E3779F9ULL;
+        return hash ^ (hash >> 32); // 32: xxh3 avalanche shift
+    }
+
+    // acc[i] += low32(key) * high32(key) and the neighbouring lane gets the raw input, two lanes per register.
+#if defined(FRAME_HASH_SSE2)
+    inline void AccumulateStripe(uint64_t* acc, const uint8_t* stripe, const uint64_t* secret)
+    {
+        for (size_t i = 0; i < LANES; i += 2) { // 2: lanes per register
+            __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe + i * sizeof(uint64_t)));
+            __m128i key = _mm_xor_si128(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret + i)));
+            __m128i product = _mm_mul_epu32(key, _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m128i swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+            __m128i* lanes = reinterpret_cast<__m128i*>(acc + i);
+            _mm_storeu_si128(lanes, _mm_add_epi64(_mm_loadu_si128(lanes), _mm_add_epi64(product, swapped)));
+        }
+    }
+#elif defined(FRAME_HASH_NEON)
+    inline void AccumulateStripe(uint64_t* acc, const uint8_t* stripe, const uint64_t* secret)
+    {
+        for (size_t i = 0; i < LANES; i += 2) { // 2: lanes per register
+            uint64x2_t value = vreinterpretq_u64_u8(vld1q_u8(stripe + i * sizeof(uint64_t)));
+            uint64x2_t key = veorq_u64(value, vld1q_u64(secret + i));
+            uint64x2_t product = vmull_u32(vmovn_u64(key), vshrn_n_u64(key, 32)); // 32: high word
+            uint64x2_t swapped = vextq_u64(value, value, 1);
+            vst1q_u64(acc + i, vaddq_u64(vld1q_u64(acc + i), vaddq_u64(product, swapped)));
+        }
+    }
+#else
+    inline void AccumulateStripe(uint64_t* acc, const uint8_t* stripe, const uint64_t* secret)
+    {
+        for (size_t i = 0; i < LANES; ++i) {
+            uint64_t value = Read64(stripe + i * sizeof(uint64_t));
+            uint64_t key = value ^ secret[i];
+            acc[i ^ 1] += value;
+            acc[i] += (key & 0xFFFFFFFFULL) * (key >> 32); // 32: high word
+        }
+    }
+#endif
+
+    inline void ScrambleLanes(uint64_t* acc, const uint64_t* secret)
+    {
+        for (size_t i = 0; i < LANES; ++i) {
+            acc[i] = (acc[i] ^ (acc[i] >> 47) ^ secret[i]) * PRIME32_1; // 47: xxh3 scramble shift
+        }
+    }
+
+    uint64_t HashShort(const uint8_t* data, size_t length, uint64_t seed, const Secret& secret)
+    {
+        uint64_t hash = seed ^ secret.words[0] ^ (length * PRIME64_1);
+        size_t offset = 0;
+        for (; offset + sizeof(uint64_t) <= length; offset += sizeof(uint64_t)) {
+            hash = Multiply128Fold64(hash ^ Read64(data + offset), PRIME64_2 ^ secret.words[1]);
+        }
+        uint64_t tail = 0;
+        if (offset < length) {
+            std::memcpy(&tail, data + offset, length - offset);
+            hash = Multiply128Fold64(hash ^ tail ^ PRIME64_3, PRIME64_4 ^ secret.words[2]); // 2: third key
+        }
+        return Avalanche(hash);
+    }
+}
+
+namespace FrameHash {
+    uint64_t Hash64(const uint8_t* data, size_t length, uint64_t seed)
+    {
+        const Secret& secret = GetSecret();
+        if (data == nullptr) {
+            length = 0;
+        }
+        if (length < STRIPE_SIZE) {
+            return HashShort(data, length, seed, secret);
+        }
+        uint64_t acc[LANES] = {
+            PRIME32_1 ^ seed, PRIME64_1, PRIME64_2, PRIME64_3 ^ seed,
+            PRIME64_4, PRIME32_1, PRIME64_5 ^ seed, PRIME64_1 ^ PRIME64_2,
+        };
+        const size_t blockSize = STRIPE_SIZE * STRIPES_PER_BLOCK;
+        size_t blocks = (length - 1) / blockSize;
+        for (size_t block = 0; block < blocks; ++block) {
+            const uint8_t* blockData = data + block * blockSize;
+            for (size_t stripe = 0; stripe < STRIPES_PER_BLOCK; ++stripe) {
+                AccumulateStripe(acc, blockData + stripe * STRIPE_SIZE, secret.words + stripe);
+            }
+            ScrambleLanes(acc, secret.scramble);
+        }
+        // Whole stripes of the last block, then the final 64 bytes, which may overlap the previous stripe.
+        const uint8_t* lastBlock = data + blocks * blockSize;
+        size_t stripes = (length - 1 - blocks * blockSize) / STRIPE_SIZE;
+        for (size_t stripe = 0; stripe < stripes; ++stripe) {
+            AccumulateStripe(acc, lastBlock + stripe * STRIPE_SIZE, secret.words + stripe);
+        }
+        AccumulateStripe(acc, data + length - STRIPE_SIZE, secret.words + STRIPES_PER_BLOCK - 1);
+
+        uint64_t hash = (length * PRIME64_1) ^ seed;
+        for (size_t i = 0; i < LANES; i += 2) { // 2: lanes are folded in pairs
+            hash += Multiply128Fold64(acc[i] ^ secret.words[i], acc[i + 1] ^ secret.words[i + 1]);
+        }
+        return Avalanche(hash);
+    }
+}; // namespace FrameHash
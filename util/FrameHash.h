@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEHASH_H
+#define FRAMEHASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Fast non-cryptographic 64-bit hash for whole frame buffers, built like XXH3: eight independent 64-bit lanes
+// consume 64 byte stripes, two lanes per SSE2 or NEON register. The values are only meant to be compared within
+// one process.
+namespace FrameHash {
+    uint64_t Hash64(const uint8_t* data, size_t length, uint64_t seed = 0);
+}; // namespace FrameHash
+
+#endif // FRAMEHASH_H
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameMailbox.h"
+
+#include <algorithm>
+#include <chrono>
+
+FrameMailbox::FrameMailbox(Handler frameHandler) : handler(std::move(frameHandler)), replacedCount(0) {}
+
+FrameMailbox::~FrameMailbox()
+{
+    Stop();
+}
+
+FrameMailbox::PostResult FrameMailbox::Post(const uint8_t* data, size_t length, int32_t width, int32_t height,
+    uint64_t tag)
+{
+    if (data == nullptr || length == 0) {
+        return PostResult::FAILED;
+    }
+    return Enqueue([this, data, length]() { pendingData.assign(data, data + length); }, width, height, tag);
+}
+
+FrameMailbox::PostResult FrameMailbox::Post(std::vector<uint8_t>& data, int32_t width, int32_t height,
+    uint64_t tag)
+{
+    if (data.empty()) {
+        return PostResult::FAILED;
+    }
+    // The sender only swaps pendingData under the lock, the buffer data gets back is not in use.
+    return Enqueue([this, &data]() { std::swap(pendingData, data); }, width, height, tag);
+}
+
+FrameMailbox::PostResult FrameMailbox::Enqueue(const std::function<void()>& fill, int32_t width, int32_t height,
+    uint64_t tag)
+{
+    if (!handler) {
+        return PostResult::FAILED;
+    }
+    bool isReplaced = false;
+    {
+        std::lock_guard<std::mutex> guard(mailboxMutex);
+        if (isStopping) {
+            return PostResult::FAILED;
+        }
+        if (!worker.joinable()) {
+            worker = std::thread(&FrameMailbox::WorkerLoop, this);
+        }
+        isReplaced = hasPendingFrame;
+        fill();
+        pendingFrame.data = pendingData.data();
+        pendingFrame.length = pendingData.size();
+        pendingFrame.width = width;
+        pendingFrame.height = height;
+        pendingFrame.tag = tag;
+        hasPendingFrame = true;
+    }
+    frameCondition.notify_one();
+    if (isReplaced) {
+        replacedCount++;
+        return PostResult::REPLACED;
+    }
+    return PostResult::QUEUED;
+}
+
+void FrameMailbox::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(mailboxMutex);
+    idleCondition.wait(lock, [this]() {
+        return isStopping || (!hasPendingFrame && !isResendRequested && !isHandling);
+    });
+}
+
+void FrameMailbox::Stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(mailboxMutex);
+        if (isStopping) {
+            return;
+        }
+        isStopping = true;
+    }
+    frameCondition.notify_all();
+    idleCondition.notify_all();
+    // The handler refers to the owner of the mailbox, so the sender must never outlive it.
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+uint64_t FrameMailbox::GetReplacedCount() const
+{
+    return replacedCount;
+}
+
+void FrameMailbox::SetIdleHandler(Handler idleHandler, IdleDelay idleDelay)
+{
+    std::lock_guard<std::mutex> guard(mailboxMutex);
+    this->idleHandler = std::move(idleHandler);
+    this->idleDelay = std::move(idleDelay);
+}
+
+void FrameMailbox::Resend()
+{
+    {
+        std::lock_guard<std::mutex> guard(mailboxMutex);
+        if (!worker.joinable()) {
+            return; // nothing was handled yet
+        }
+        isResendRequested = true;
+    }
+    frameCondition.notify_one();
+}
+
+bool FrameMailbox::CopyLastPosted(std::vector<uint8_t>& data, int32_t& width, int32_t& height, uint64_t& tag)
+{
+    // The sender only reads workingData while it handles the frame, both buffers are swapped under the lock.
+    std::lock_guard<std::mutex> guard(mailboxMutex);
+    if (!hasPendingFrame && handledCount == 0) {
+        return false;
+    }
+    const MailboxFrame& frame = hasPendingFrame ? pendingFrame : lastFrame;
+    data.assign(frame.data, frame.data + frame.length);
+    width = frame.width;
+    height = frame.height;
+    tag = frame.tag;
+    return true;
+}
+
+void FrameMailbox::WorkerLoop()
+{
+    bool isIdlePending = false; // lastFrame has not been handed to the idle handler yet
+    while (true) {
+        MailboxFrame frame;
+        bool isIdle = false;
+        {
+            std::unique_lock<std::mutex> lock(mailboxMutex);
+            std::chrono::milliseconds delay(0);
+            if (isIdlePending && idleHandler && idleDelay) {
+                delay = idleDelay();
+            }
+            auto isWoken = [this]() { return isStopping || hasPendingFrame || isResendRequested; };
+            if (delay.count() > 0) {
+                isIdle = !frameCondition.wait_for(lock, delay, isWoken);
+            } else {
+                frameCondition.wait(lock, isWoken);
+            }
+            if (isStopping) {
+                return;
+            }
+            bool isResend = isResendRequested && !hasPendingFrame && !isIdle;
+            isResendRequested = false;
+            if (isIdle || isResend) {
+                frame = lastFrame; // workingData is only swapped by this thread, it still holds the frame
+            } else {
+                // The sender keeps the frame while Post fills the other buffer.
+                std::swap(pendingData, workingData);
+                frame = pendingFrame;
+                frame.data = workingData.data();
+                hasPendingFrame = false;
+                lastFrame = frame;
+                handledCount++;
+            }
+            isIdlePending = !isIdle;
+            isHandling = true;
+        }
+        if (isIdle) {
+            idleHandler(frame);
+        } else {
+            handler(frame);
+        }
+        {
+            std::lock_guard<std::mutex> guard(mailboxMutex);
+            isHandling = false;
+        }
+        idleCondition.notify_all();
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEMAILBOX_H
+#define FRAMEMAILBOX_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct MailboxFrame {
+    uint8_t* data = nullptr;
+    size_t length = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    uint64_t tag = 0; // given by the poster
+};
+
+// Single slot hand-off from the render threads to one sender thread. Post copies the frame and returns at once, a
+// frame the sender has not picked up yet is replaced by the newer one. A slow client then costs dropped intermediate
+// frames instead of blocking rendering. The two frame buffers are swapped, not reallocated, between frames.
+class FrameMailbox {
+public:
+    enum class PostResult { QUEUED, REPLACED, FAILED };
+    using Handler = std::function<void(const MailboxFrame& frame)>;
+    using IdleDelay = std::function<std::chrono::milliseconds()>;
+
+    explicit FrameMailbox(Handler frameHandler = nullptr);
+    ~FrameMailbox();
+    FrameMailbox(const FrameMailbox&) = delete;
+    FrameMailbox& operator=(const FrameMailbox&) = delete;
+
+    // The sender thread is started by the first Post.
+    PostResult Post(const uint8_t* data, size_t length, int32_t width, int32_t height, uint64_t tag = 0);
+    // Takes the frame by swapping buffers instead of copying it, data gets back a buffer to fill next time.
+    PostResult Post(std::vector<uint8_t>& data, int32_t width, int32_t height, uint64_t tag = 0);
+    // Blocks until every posted frame has been handled.
+    void WaitIdle();
+    // Wakes the sender and joins it, a frame being handled is finished first. Pending frames are dropped.
+    void Stop();
+    uint64_t GetReplacedCount() const;
+    // The last frame handled is handed once more to idleHandler when no frame followed it for idleDelay(), which
+    // is read after every frame, 0 never calls it. Set before the first Post.
+    void SetIdleHandler(Handler idleHandler, IdleDelay idleDelay);
+    // The last frame handled goes to the handler once more unless a newer one is pending, for settings that change
+    // how frames are sent while the scene stays still.
+    void Resend();
+    // A copy of the last frame posted, handled or not, and its tag, false before the first one.
+    bool CopyLastPosted(std::vector<uint8_t>& data, int32_t& width, int32_t& height, uint64_t& tag);
+
+private:
+    // fill puts the frame in pendingData, under the lock.
+    PostResult Enqueue(const std::function<void()>& fill, int32_t width, int32_t height, uint64_t tag);
+    void WorkerLoop();
+
+    Handler handler;
+    Handler idleHandler;
+    IdleDelay idleDelay;
+    std::thread worker;
+    std::mutex mailboxMutex;
+    std::condition_variable frameCondition;
+    std::condition_variable idleCondition;
+    std::vector<uint8_t> pendingData;
+    std::vector<uint8_t> workingData;
+    MailboxFrame pendingFrame;
+    MailboxFrame lastFrame; // points into workingData
+    uint64_t handledCount = 0;
+    bool hasPendingFrame = false;
+    bool isResendRequested = false;
+    bool isHandling = false;
+    bool isStopping = false;
+    std::atomic<uint64_t> replacedCount;
+};
+
+#endif // FRAMEMAILBOX_H
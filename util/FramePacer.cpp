@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FramePacer.h"
+
+#include <algorithm>
+
+namespace {
+    const int64_t US_PER_SECOND = 1000000;
+}
+
+void FramePacer::SetTargetFps(int32_t fps)
+{
+    std::lock_guard<std::mutex> guard(pacerMutex);
+    targetFps = std::clamp(fps, 0, MAX_FPS);
+    hasDeadline = false;
+}
+
+int32_t FramePacer::GetTargetFps() const
+{
+    std::lock_guard<std::mutex> guard(pacerMutex);
+    return targetFps;
+}
+
+FramePacer::Clock::time_point FramePacer::NextDeadline(Clock::time_point frameStart)
+{
+    std::lock_guard<std::mutex> guard(pacerMutex);
+    if (targetFps <= 0) {
+        return frameStart;
+    }
+    std::chrono::microseconds interval(US_PER_SECOND / targetFps);
+    if (!hasDeadline || frameStart >= deadline + interval) {
+        deadline = frameStart + interval;
+        hasDeadline = true;
+    } else {
+        deadline += interval;
+    }
+    return deadline;
+}
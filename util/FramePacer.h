@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// Paces the sender thread to a target frame rate on monotonic deadlines. The deadlines follow a fixed grid of one
+// frame interval, so the rate holds on average even when single frames take longer. A frame that starts more than an
+// interval after the last deadline, after an idle spell, restarts the grid instead of catching up with a burst.
+// Between deadlines the mailbox keeps replacing its frame, the frame sent at a deadline is always the newest one.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr int32_t MAX_FPS = 120;
+
+    // 0 lets every frame start as soon as the previous one is sent.
+    void SetTargetFps(int32_t fps);
+    int32_t GetTargetFps() const;
+    // Called with the start of every frame sent, returns the earliest start of the next one.
+    Clock::time_point NextDeadline(Clock::time_point frameStart);
+
+private:
+    mutable std::mutex pacerMutex;
+    int32_t targetFps = 0;
+    bool hasDeadline = false;
+    Clock::time_point deadline;
+};
+
+#endif // FRAMEPACER_H
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FramePyramid.h"
+
+#include <algorithm>
+#include <numeric>
+#include "FrameScaler.h"
+
+namespace {
+    constexpr size_t PIXEL_SIZE = 4;
+}
+
+void FramePyramid::SetSizes(const std::vector<std::pair<int32_t, int32_t>>& maxSizes)
+{
+    sizes.assign(maxSizes.begin(), maxSizes.begin() + std::min(maxSizes.size(), MAX_LEVELS));
+    levels.assign(sizes.size(), Level());
+    buffers.resize(sizes.size());
+}
+
+size_t FramePyramid::GetLevelCount() const
+{
+    return sizes.size();
+}
+
+bool FramePyramid::Build(const uint8_t* frame, size_t stride, int32_t width, int32_t height)
+{
+    if (frame == nullptr || width < 1 || height < 1) {
+        return false;
+    }
+    for (size_t i = 0; i < sizes.size(); i++) {
+        FrameScaler::FitSize(width, height, sizes[i].first, sizes[i].second, levels[i].width, levels[i].height);
+    }
+    // Largest first, then every level finds the smallest source among the ones built before it.
+    std::vector<size_t> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return static_cast<int64_t>(levels[a].width) * levels[a].height >
+            static_cast<int64_t>(levels[b].width) * levels[b].height;
+    });
+    for (size_t built = 0; built < order.size(); built++) {
+        Level source = { width, height, stride, frame };
+        for (size_t j = built; j > 0; j--) {
+            const Level& candidate = levels[order[j - 1]];
+            if (candidate.width >= levels[order[built]].width && candidate.height >= levels[order[built]].height) {
+                source = candidate;
+                break;
+            }
+        }
+        Level& level = levels[order[built]];
+        if (level.width == source.width && level.height == source.height) {
+            level.stride = source.stride;
+            level.data = source.data;
+            continue;
+        }
+        std::vector<uint8_t>& buffer = buffers[order[built]];
+        level.stride = static_cast<size_t>(level.width) * PIXEL_SIZE;
+        buffer.resize(level.stride * level.height);
+        if (!FrameScaler::DownscaleRgba(source.data, source.stride, source.width, source.height, buffer.data(),
+                                        level.stride, level.width, level.height)) {
+            return false;
+        }
+        level.data = buffer.data();
+    }
+    return true;
+}
+
+const std::vector<FramePyramid::Level>& FramePyramid::GetLevels() const
+{
+    return levels;
+}
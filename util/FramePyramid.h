@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEPYRAMID_H
+#define FRAMEPYRAMID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Scaled down copies of a frame for the simulcast variants. Every level is scaled from the smallest level built
+// before it that still covers its size, so the rendered frame is read once however many variants are configured.
+class FramePyramid {
+public:
+    struct Level {
+        int32_t width = 0;
+        int32_t height = 0;
+        size_t stride = 0;
+        const uint8_t* data = nullptr; // the frame itself when the level is as large as the frame
+    };
+    static constexpr size_t MAX_LEVELS = 3;
+
+    // Level i fits in sizes[i] like -sr fits the frame, see FrameScaler::FitSize, sizes past MAX_LEVELS are dropped.
+    void SetSizes(const std::vector<std::pair<int32_t, int32_t>>& maxSizes);
+    size_t GetLevelCount() const;
+    // The levels stay valid until the next Build, and only as long as frame does.
+    bool Build(const uint8_t* frame, size_t stride, int32_t width, int32_t height);
+    // In the order of the sizes.
+    const std::vector<Level>& GetLevels() const;
+
+private:
+    std::vector<std::pair<int32_t, int32_t>> sizes;
+    std::vector<Level> levels;
+    std::vector<std::vector<uint8_t>> buffers;
+};
+
+#endif // FRAMEPYRAMID_H
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameRecorder.h"
+
+#include <cinttypes>
+#include <cstring>
+#include "PreviewerEngineLog.h"
+
+namespace {
+    const char FILE_MAGIC[] = "PVFREC01";
+    const char RECORD_MAGIC[] = "FRME";
+    const char INDEX_MAGIC[] = "FIDX";
+    const char END_MAGIC[] = "FEND";
+    constexpr size_t FILE_MAGIC_SIZE = 8;
+    constexpr size_t MAGIC_SIZE = 4;
+    // magic, packet length, timestamp, encode time, write time and variant
+    constexpr size_t RECORD_HEADER_SIZE = MAGIC_SIZE + sizeof(uint32_t) + sizeof(uint64_t) + 3 * sizeof(uint32_t);
+    constexpr size_t TRAILER_SIZE = sizeof(uint64_t) + MAGIC_SIZE;
+    constexpr uint32_t MAX_PACKET_SIZE = 256 * 1024 * 1024; // far above any frame, guards against a broken file
+
+    template<class T>
+    void WriteValue(std::ofstream& out, T value)
+    {
+        uint8_t bytes[sizeof(T)];
+        uint64_t bits = static_cast<uint64_t>(value);
+        for (size_t i = sizeof(T); i > 0; i--) {
+            bytes[i - 1] = static_cast<uint8_t>(bits);
+            bits >>= 8; // 8 bits per byte
+        }
+        out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+    }
+
+    template<class T>
+    bool ReadValue(std::ifstream& in, T& value)
+    {
+        uint8_t bytes[sizeof(T)];
+        if (!in.read(reinterpret_cast<char*>(bytes), sizeof(bytes))) {
+            return false;
+        }
+        uint64_t bits = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            bits = (bits << 8) | bytes[i]; // 8 bits per byte
+        }
+        value = static_cast<T>(bits);
+        return true;
+    }
+
+    bool ReadMagic(std::ifstream& in, const char* magic, size_t size)
+    {
+        char buffer[FILE_MAGIC_SIZE] = { 0 };
+        return in.read(buffer, size) && std::memcmp(buffer, magic, size) == 0;
+    }
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    Close();
+}
+
+bool FrameRecorder::Open(const std::string& path)
+{
+    std::lock_guard<std::mutex> guard(recorderMutex);
+    if (isOpen) {
+        return false;
+    }
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        ELOG("FrameRecorder::Open can not create %s", path.c_str());
+        return false;
+    }
+    file.write(FILE_MAGIC, FILE_MAGIC_SIZE);
+    fileOffset = FILE_MAGIC_SIZE;
+    index.clear();
+    droppedCount = 0;
+    isStopping = false;
+    isOpen = true;
+    startTime = Clock::now();
+    writer = std::thread(&FrameRecorder::WriterLoop, this);
+    return true;
+}
+
+bool FrameRecorder::IsOpen() const
+{
+    return isOpen;
+}
+
+bool FrameRecorder::Append(const uint8_t* data, size_t length, uint32_t encodeUs, uint32_t writeUs,
+                           int32_t variant)
+{
+    if (!isOpen || data == nullptr || length == 0 || length > MAX_PACKET_SIZE) {
+        return false;
+    }
+    FrameRecord record;
+    record.timestampUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startTime).count());
+    record.encodeUs = encodeUs;
+    record.writeUs = writeUs;
+    record.variant = variant;
+    {
+        std::lock_guard<std::mutex> guard(recorderMutex);
+        if (!isOpen || isStopping) {
+            return false;
+        }
+        if (pendingBytes + length > MAX_PENDING_BYTES) {
+            droppedCount++; // the disk can not keep up, the sender must not wait for it
+            return false;
+        }
+        pendingBytes += length;
+    }
+    record.packet.assign(data, data + length); // outside the lock, the writer keeps draining meanwhile
+    {
+        std::lock_guard<std::mutex> guard(recorderMutex);
+        if (isStopping) {
+            pendingBytes -= length;
+            return false;
+        }
+        pendingRecords.push_back(std::move(record));
+    }
+    recordCondition.notify_one();
+    return true;
+}
+
+void FrameRecorder::Close()
+{
+    {
+        std::lock_guard<std::mutex> guard(recorderMutex);
+        if (!isOpen || isStopping) {
+            return;
+        }
+        isStopping = true;
+    }
+    recordCondition.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    WriteIndex();
+    file.close();
+    std::lock_guard<std::mutex> guard(recorderMutex);
+    isOpen = false;
+    if (droppedCount > 0) {
+        WLOG("FrameRecorder::Close %" PRIu64 " packets were dropped.", droppedCount);
+    }
+}
+
+uint64_t FrameRecorder::GetDroppedCount() const
+{
+    std::lock_guard<std::mutex> guard(recorderMutex);
+    return droppedCount;
+}
+
+void FrameRecorder::WriterLoop()
+{
+    while (true) {
+        std::deque<FrameRecord> records;
+        {
+            std::unique_lock<std::mutex> lock(recorderMutex);
+            recordCondition.wait(lock, [this]() { return isStopping || !pendingRecords.empty(); });
+            if (pendingRecords.empty()) {
+                return; // stopping with everything written
+            }
+            records.swap(pendingRecords);
+        }
+        size_t bytes = 0;
+        for (const FrameRecord& record : records) {
+            WriteRecord(record);
+            bytes += record.packet.size();
+        }
+        // Whole records reach the disk, a preview that is killed leaves a recording the reader can walk.
+        file.flush();
+        std::lock_guard<std::mutex> guard(recorderMutex);
+        pendingBytes -= bytes;
+    }
+}
+
+void FrameRecorder::WriteRecord(const FrameRecord& record)
+{
+    index.emplace_back(fileOffset, record.timestampUs);
+    file.write(RECORD_MAGIC, MAGIC_SIZE);
+    WriteValue<uint32_t>(file, static_cast<uint32_t>(record.packet.size()));
+    WriteValue<uint64_t>(file, record.timestampUs);
+    WriteValue<uint32_t>(file, record.encodeUs);
+    WriteValue<uint32_t>(file, record.writeUs);
+    WriteValue<int32_t>(file, record.variant);
+    file.write(reinterpret_cast<const char*>(record.packet.data()), record.packet.size());
+    fileOffset += RECORD_HEADER_SIZE + record.packet.size();
+}
+
+void FrameRecorder::WriteIndex()
+{
+    uint64_t indexOffset = fileOffset;
+    file.write(INDEX_MAGIC, MAGIC_SIZE);
+    WriteValue<uint32_t>(file, static_cast<uint32_t>(index.size()));
+    for (const std::pair<uint64_t, uint64_t>& entry : index) {
+        WriteValue<uint64_t>(file, entry.first);
+        WriteValue<uint64_t>(file, entry.second);
+    }
+    WriteValue<uint64_t>(file, indexOffset);
+    file.write(END_MAGIC, MAGIC_SIZE);
+    if (!file) {
+        ELOG("FrameRecorder::WriteIndex write failed.");
+    }
+}
+
+bool FrameRecordReader::Open(const std::string& path)
+{
+    offsets.clear();
+    file.open(path, std::ios::binary);
+    if (!file.is_open() || !ReadMagic(file, FILE_MAGIC, FILE_MAGIC_SIZE)) {
+        ELOG("FrameRecordReader::Open %s is not a frame recording.", path.c_str());
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    if (LoadIndex(fileSize)) {
+        return true;
+    }
+    WLOG("FrameRecordReader::Open %s has no index, walk the records.", path.c_str());
+    return ScanRecords(fileSize);
+}
+
+size_t FrameRecordReader::GetCount() const
+{
+    return offsets.size();
+}
+
+bool FrameRecordReader::Read(size_t position, FrameRecord& record)
+{
+    if (position >= offsets.size()) {
+        return false;
+    }
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offsets[position]));
+    uint32_t length = 0;
+    if (!ReadMagic(file, RECORD_MAGIC, MAGIC_SIZE) || !ReadValue(file, length) || length > MAX_PACKET_SIZE ||
+        !ReadValue(file, record.timestampUs) || !ReadValue(file, record.encodeUs) ||
+        !ReadValue(file, record.writeUs) || !ReadValue(file, record.variant)) {
+        return false;
+    }
+    record.packet.resize(length);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(record.packet.data()), length));
+}
+
+bool FrameRecordReader::LoadIndex(uint64_t fileSize)
+{
+    if (fileSize < FILE_MAGIC_SIZE + TRAILER_SIZE) {
+        return false;
+    }
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(fileSize - TRAILER_SIZE));
+    uint64_t indexOffset = 0;
+    uint32_t count = 0;
+    if (!ReadValue(file, indexOffset) || !ReadMagic(file, END_MAGIC, MAGIC_SIZE) || indexOffset < FILE_MAGIC_SIZE ||
+        indexOffset > fileSize - TRAILER_SIZE) {
+        return false;
+    }
+    file.seekg(static_cast<std::streamoff>(indexOffset));
+    const size_t entrySize = 2 * sizeof(uint64_t); // 2: offset and timestamp
+    if (!ReadMagic(file, INDEX_MAGIC, MAGIC_SIZE) || !ReadValue(file, count) ||
+        static_cast<uint64_t>(count) * entrySize > fileSize - indexOffset) {
+        return false;
+    }
+    std::vector<uint64_t> entries(count);
+    for (uint64_t& offset : entries) {
+        uint64_t timestampUs = 0;
+        if (!ReadValue(file, offset) || !ReadValue(file, timestampUs) || offset >= indexOffset) {
+            return false;
+        }
+    }
+    offsets.swap(entries);
+    return true;
+}
+
+bool FrameRecordReader::ScanRecords(uint64_t fileSize)
+{
+    uint64_t offset = FILE_MAGIC_SIZE;
+    file.clear();
+    while (offset + RECORD_HEADER_SIZE <= fileSize) {
+        file.seekg(static_cast<std::streamoff>(offset));
+        uint32_t length = 0;
+        if (!ReadMagic(file, RECORD_MAGIC, MAGIC_SIZE) || !ReadValue(file, length)) {
+            break;
+        }
+        if (offset + RECORD_HEADER_SIZE + length > fileSize) {
+            break; // the last record was cut off
+        }
+        offsets.push_back(offset);
+        offset += RECORD_HEADER_SIZE + length;
+    }
+    file.clear();
+    return true;
+}
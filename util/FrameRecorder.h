@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMERECORDER_H
+#define FRAMERECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// A frame packet as it went to the websocket, its 40 byte header included, and how long it took to produce.
+struct FrameRecord {
+    uint64_t timestampUs = 0; // since the recording started
+    uint32_t encodeUs = 0;
+    uint32_t writeUs = 0;
+    int32_t variant = 0;
+    std::vector<uint8_t> packet;
+};
+
+// Appends the sent packets to a file, the way an mjpeg container appends its jpegs, and writes an index of them
+// when it is closed. All integers are in network byte order like the frame header:
+//   file header  "PVFREC01"
+//   record       "FRME", u32 packet length, u64 timestamp us, u32 encode us, u32 write us, i32 variant, packet
+//   index        "FIDX", u32 count, count x (u64 record offset, u64 timestamp us)
+//   trailer      u64 index offset, "FEND"
+// A recording that was cut short has no index, FrameRecordReader then walks the records.
+class FrameRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t MAX_PENDING_BYTES = 64 * 1024 * 1024; // packets beyond this are dropped, not waited for
+
+    FrameRecorder() = default;
+    ~FrameRecorder();
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    // Truncates path and starts the writer thread.
+    bool Open(const std::string& path);
+    bool IsOpen() const;
+    // Copies the packet and returns at once, the file is written by the writer thread. Only reads an atomic flag
+    // while no recording is open.
+    bool Append(const uint8_t* data, size_t length, uint32_t encodeUs, uint32_t writeUs, int32_t variant);
+    // Writes the queued packets and the index.
+    void Close();
+    uint64_t GetDroppedCount() const;
+
+private:
+    void WriterLoop();
+    void WriteRecord(const FrameRecord& record);
+    void WriteIndex();
+
+    std::ofstream file;
+    std::thread writer;
+    mutable std::mutex recorderMutex;
+    std::condition_variable recordCondition;
+    std::deque<FrameRecord> pendingRecords;
+    size_t pendingBytes = 0;
+    std::atomic<bool> isOpen { false };
+    bool isStopping = false;
+    uint64_t droppedCount = 0;
+    Clock::time_point startTime;
+    uint64_t fileOffset = 0; // only touched by the writer thread, then by Close after it joined
+    std::vector<std::pair<uint64_t, uint64_t>> index;
+};
+
+class FrameRecordReader {
+public:
+    // Loads the index, or walks the records of a recording without one.
+    bool Open(const std::string& path);
+    size_t GetCount() const;
+    bool Read(size_t position, FrameRecord& record);
+
+private:
+    bool LoadIndex(uint64_t fileSize);
+    bool ScanRecords(uint64_t fileSize);
+
+    std::ifstream file;
+    std::vector<uint64_t> offsets;
+};
+
+#endif // FRAMERECORDER_H
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameReplayer.h"
+
+#include <algorithm>
+#include <thread>
+#include "PreviewerEngineLog.h"
+
+namespace {
+    // A record sent less than this after its slot is on time, sleep_until itself overshoots by about as much.
+    const std::chrono::microseconds LATE_TOLERANCE(2000);
+}
+
+bool FrameReplayer::Replay(FrameRecordReader& reader, double speed, const Sink& sink, Stats& stats)
+{
+    if (!sink || speed < 0) {
+        return false;
+    }
+    stats = Stats();
+    FrameRecord record;
+    Clock::time_point start = Clock::now();
+    uint64_t firstTimestampUs = 0;
+    for (size_t position = 0; position < reader.GetCount(); position++) {
+        if (!reader.Read(position, record)) {
+            ELOG("FrameReplayer::Replay record %zu is broken.", position);
+            return false;
+        }
+        if (position == 0) {
+            firstTimestampUs = record.timestampUs;
+        }
+        if (speed > 0) {
+            double offsetUs = static_cast<double>(record.timestampUs - firstTimestampUs) / speed;
+            Clock::time_point due = start + std::chrono::microseconds(static_cast<int64_t>(offsetUs));
+            Clock::time_point now = Clock::now();
+            if (now < due) {
+                std::this_thread::sleep_until(due);
+            } else if (now - due > LATE_TOLERANCE) {
+                int64_t lateUs = std::chrono::duration_cast<std::chrono::microseconds>(now - due).count();
+                stats.maxLateUs = std::max(stats.maxLateUs, lateUs);
+                stats.lateFrames++;
+            }
+        }
+        stats.bytes += sink(record);
+        stats.frames++;
+    }
+    stats.durationUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    return true;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEREPLAYER_H
+#define FRAMEREPLAYER_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include "FrameRecorder.h"
+
+// Feeds a recording to a sink in order, on a schedule taken from the recorded timestamps. A record due while the
+// sink was still busy is sent at once and counted as late, the schedule does not shift, so a replay of the same
+// recording offers every record at the same point of it.
+class FrameReplayer {
+public:
+    using Clock = std::chrono::steady_clock;
+    // Returns the bytes the client took, like WebSocketServer::WriteData.
+    using Sink = std::function<size_t(const FrameRecord& record)>;
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t bytes = 0;
+        int64_t durationUs = 0;
+        int64_t maxLateUs = 0;
+        uint64_t lateFrames = 0;
+    };
+
+    // speed scales the recorded pace, 2 replays twice as fast, 0 sends every record as soon as the sink returns.
+    static bool Replay(FrameRecordReader& reader, double speed, const Sink& sink, Stats& stats);
+};
+
+#endif // FRAMEREPLAYER_H
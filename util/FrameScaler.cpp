@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameScaler.h"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define FRAME_SCALER_SSE2
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define FRAME_SCALER_NEON
+#endif
+
+namespace {
+    constexpr size_t PIXEL_SIZE = 4;
+    constexpr int WEIGHT_BITS = 14; // the weights of one output pixel along one axis sum up to 1 << 14
+    constexpr uint32_t WEIGHT_ONE = 1U << WEIGHT_BITS;
+    constexpr int ROW_FRACTION_BITS = 8; // fraction bits kept between the horizontal and the vertical pass
+    constexpr int OUT_SHIFT = WEIGHT_BITS + ROW_FRACTION_BITS;
+
+    struct Tap {
+        int32_t index;
+        uint32_t weight;
+    };
+
+    struct Span {
+        size_t first; // first tap of the output pixel
+        size_t count;
+    };
+
+    // Source pixels covered by every output pixel along one axis and how much of each is covered.
+    void BuildTaps(int32_t srcSize, int32_t dstSize, std::vector<Tap>& taps, std::vector<Span>& spans)
+    {
+        taps.clear();
+        spans.resize(dstSize);
+        for (int32_t d = 0; d < dstSize; ++d) {
+            // Coverage in units of 1 / dstSize source pixels, so every bound is an integer.
+            int64_t begin = static_cast<int64_t>(d) * srcSize;
+            int64_t end = begin + srcSize;
+            spans[d].first = taps.size();
+            uint32_t total = 0;
+            for (int64_t s = begin / dstSize; s * dstSize < end; ++s) {
+                int64_t covered = std::min(end, (s + 1) * dstSize) - std::max(begin, s * dstSize);
+                uint32_t weight = static_cast<uint32_t>(covered * WEIGHT_ONE / srcSize);
+                taps.push_back({ static_cast<int32_t>(s), weight });
+                total += weight;
+            }
+            taps[spans[d].first].weight += WEIGHT_ONE - total; // rounding leftovers, the sum stays exact
+            spans[d].count = taps.size() - spans[d].first;
+        }
+    }
+
+    void ScalarHalfRow(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, int32_t dstWidth)
+    {
+        for (int32_t x = 0; x < dstWidth; ++x) {
+            for (size_t c = 0; c < PIXEL_SIZE; ++c) {
+                uint32_t sum = row0[c] + row0[c + PIXEL_SIZE] + row1[c] + row1[c + PIXEL_SIZE];
+                dst[c] = static_cast<uint8_t>((sum + 2) >> 2); // 2: rounding, 2: mean of 4 pixels
+            }
+            row0 += PIXEL_SIZE * 2; // 2: two source pixels per output pixel
+            row1 += PIXEL_SIZE * 2; // 2: two source pixels per output pixel
+            dst += PIXEL_SIZE;
+        }
+    }
+
+#if defined(FRAME_SCALER_SSE2)
+    // 4 source pixels of two rows give 2 output pixels, the sums are taken in 16 bits.
+    void HalfRow(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, int32_t dstWidth)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i round = _mm_set1_epi16(2); // 2: rounding of the mean of 4 pixels
+        const int32_t step = 2; // output pixels per iteration
+        int32_t x = 0;
+        for (; x + step <= dstWidth; x += step) {
+            __m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0));
+            __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1));
+            __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+            __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+            low = _mm_add_epi16(low, _mm_srli_si128(low, 8)); // 8: the second pixel of the pair
+            high = _mm_add_epi16(high, _mm_srli_si128(high, 8)); // 8: the second pixel of the pair
+            __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(low, high), round), 2); // 2: divide by 4
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(sum, zero));
+            row0 += PIXEL_SIZE * 4; // 4: source pixels per iteration
+            row1 += PIXEL_SIZE * 4; // 4: source pixels per iteration
+            dst += PIXEL_SIZE * step;
+        }
+        ScalarHalfRow(row0, row1, dst, dstWidth - x);
+    }
+#elif defined(FRAME_SCALER_NEON)
+    void HalfRow(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, int32_t dstWidth)
+    {
+        const int32_t step = 2; // output pixels per iteration
+        int32_t x = 0;
+        for (; x + step <= dstWidth; x += step) {
+            uint8x16_t top = vld1q_u8(row0);
+            uint8x16_t bottom = vld1q_u8(row1);
+            uint16x8_t low = vaddl_u8(vget_low_u8(top), vget_low_u8(bottom));
+            uint16x8_t high = vaddl_u8(vget_high_u8(top), vget_high_u8(bottom));
+            uint16x8_t sum = vcombine_u16(vadd_u16(vget_low_u16(low), vget_high_u16(low)),
+                vadd_u16(vget_low_u16(high), vget_high_u16(high)));
+            vst1_u8(dst, vrshrn_n_u16(sum, 2)); // 2: rounded divide by 4
+            row0 += PIXEL_SIZE * 4; // 4: source pixels per iteration
+            row1 += PIXEL_SIZE * 4; // 4: source pixels per iteration
+            dst += PIXEL_SIZE * step;
+        }
+        ScalarHalfRow(row0, row1, dst, dstWidth - x);
+    }
+#else
+    void HalfRow(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, int32_t dstWidth)
+    {
+        ScalarHalfRow(row0, row1, dst, dstWidth);
+    }
+#endif
+
+    void Halve(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride, int32_t dstWidth,
+               int32_t firstRow, int32_t rowCount)
+    {
+        for (int32_t y = 0; y < rowCount; ++y) {
+            // 2: two source rows per output row
+            const uint8_t* row0 = src + static_cast<size_t>(firstRow + y) * 2 * srcStride;
+            HalfRow(row0, row0 + srcStride, dst + static_cast<size_t>(y) * dstStride, dstWidth);
+        }
+    }
+
+    void AreaScale(const uint8_t* src, size_t srcStride, int32_t srcWidth, int32_t srcHeight,
+                   uint8_t* dst, size_t dstStride, int32_t dstWidth, int32_t dstHeight, int32_t firstRow,
+                   int32_t rowCount)
+    {
+        std::vector<Tap> columnTaps;
+        std::vector<Span> columns;
+        std::vector<Tap> rowTaps;
+        std::vector<Span> rows;
+        BuildTaps(srcWidth, dstWidth, columnTaps, columns);
+        BuildTaps(srcHeight, dstHeight, rowTaps, rows);
+        size_t rowValues = static_cast<size_t>(dstWidth) * PIXEL_SIZE;
+        std::vector<uint32_t> filtered(rowValues);
+        std::vector<uint32_t> accumulated(rowValues);
+        for (int32_t y = firstRow; y < firstRow + rowCount; ++y) {
+            std::fill(accumulated.begin(), accumulated.end(), 0);
+            for (size_t r = rows[y].first; r < rows[y].first + rows[y].count; ++r) {
+                const uint8_t* srcRow = src + static_cast<size_t>(rowTaps[r].index) * srcStride;
+                for (int32_t x = 0; x < dstWidth; ++x) {
+                    uint32_t sum[PIXEL_SIZE] = { 0 };
+                    for (size_t t = columns[x].first; t < columns[x].first + columns[x].count; ++t) {
+                        const uint8_t* pixel = srcRow + static_cast<size_t>(columnTaps[t].index) * PIXEL_SIZE;
+                        for (size_t c = 0; c < PIXEL_SIZE; ++c) {
+                            sum[c] += pixel[c] * columnTaps[t].weight;
+                        }
+                    }
+                    for (size_t c = 0; c < PIXEL_SIZE; ++c) {
+                        filtered[x * PIXEL_SIZE + c] = sum[c] >> (WEIGHT_BITS - ROW_FRACTION_BITS);
+                    }
+                }
+                uint32_t weight = rowTaps[r].weight;
+                for (size_t i = 0; i < rowValues; ++i) {
+                    accumulated[i] += filtered[i] * weight;
+                }
+            }
+            uint8_t* dstRow = dst + static_cast<size_t>(y - firstRow) * dstStride;
+            for (size_t i = 0; i < rowValues; ++i) {
+                uint32_t value = (accumulated[i] + (1U << (OUT_SHIFT - 1))) >> OUT_SHIFT;
+                dstRow[i] = static_cast<uint8_t>(std::min<uint32_t>(value, UINT8_MAX));
+            }
+        }
+    }
+}
+
+namespace FrameScaler {
+    void FitSize(int32_t width, int32_t height, int32_t maxWidth, int32_t maxHeight,
+                 int32_t& fitWidth, int32_t& fitHeight)
+    {
+        fitWidth = width;
+        fitHeight = height;
+        if (width < 1 || height < 1 || maxWidth < 1 || maxHeight < 1) {
+            return;
+        }
+        if ((width > height) != (maxWidth > maxHeight)) {
+            std::swap(maxWidth, maxHeight);
+        }
+        if (width <= maxWidth && height <= maxHeight) {
+            return;
+        }
+        // Compare maxWidth / width with maxHeight / height without rounding.
+        if (static_cast<int64_t>(maxWidth) * height <= static_cast<int64_t>(maxHeight) * width) {
+            fitWidth = maxWidth;
+            fitHeight = static_cast<int32_t>(std::max<int64_t>(1,
+                (static_cast<int64_t>(height) * maxWidth + width / 2) / width)); // 2: round to nearest
+        } else {
+            fitHeight = maxHeight;
+            fitWidth = static_cast<int32_t>(std::max<int64_t>(1,
+                (static_cast<int64_t>(width) * maxHeight + height / 2) / height)); // 2: round to nearest
+        }
+    }
+
+    bool DownscaleRgba(const uint8_t* src, size_t srcStride, int32_t srcWidth, int32_t srcHeight,
+                       uint8_t* dst, size_t dstStride, int32_t dstWidth, int32_t dstHeight)
+    {
+        return DownscaleRgbaRows(src, srcStride, srcWidth, srcHeight, dst, dstStride, dstWidth, dstHeight, 0,
+            dstHeight);
+    }
+
+    bool DownscaleRgbaRows(const uint8_t* src, size_t srcStride, int32_t srcWidth, int32_t srcHeight,
+                           uint8_t* dst, size_t dstStride, int32_t dstWidth, int32_t dstHeight,
+                           int32_t firstRow, int32_t rowCount)
+    {
+        if (src == nullptr || dst == nullptr || dstWidth < 1 || dstHeight < 1 || dstWidth > srcWidth ||
+            dstHeight > srcHeight || firstRow < 0 || rowCount < 1 || rowCount > dstHeight - firstRow) {
+            return false;
+        }
+        if (srcWidth == dstWidth * 2 && srcHeight == dstHeight * 2) { // 2: halving has its own kernel
+            Halve(src, srcStride, dst, dstStride, dstWidth, firstRow, rowCount);
+        } else {
+            AreaScale(src, srcStride, srcWidth, srcHeight, dst, dstStride, dstWidth, dstHeight, firstRow, rowCount);
+        }
+        return true;
+    }
+}; // namespace FrameScaler
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMESCALER_H
+#define FRAMESCALER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Downscaling of 4 bytes per pixel frames before they are encoded. Every output pixel is the area weighted mean of
+// the source pixels it covers, halving has its own SSE2 or NEON kernel.
+namespace FrameScaler {
+    // The largest size with the aspect ratio of width x height that fits in maxWidth x maxHeight, or in the
+    // rotated box when the frame is rotated against it. Frames are never enlarged.
+    void FitSize(int32_t width, int32_t height, int32_t maxWidth, int32_t maxHeight,
+                 int32_t& fitWidth, int32_t& fitHeight);
+    bool DownscaleRgba(const uint8_t* src, size_t srcStride, int32_t srcWidth, int32_t srcHeight,
+                       uint8_t* dst, size_t dstStride, int32_t dstWidth, int32_t dstHeight);
+    // Only the output rows [firstRow, firstRow + rowCount), written from dst on, for scaling a frame band by band.
+    bool DownscaleRgbaRows(const uint8_t* src, size_t srcStride, int32_t srcWidth, int32_t srcHeight,
+                           uint8_t* dst, size_t dstStride, int32_t dstWidth, int32_t dstHeight,
+                           int32_t firstRow, int32_t rowCount);
+}; // namespace FrameScaler
+
+#endif // FRAMESCALER_H
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameSnapshot.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include "FileSystem.h"
+#include "FrameHash.h"
+#include "PreviewerEngineLog.h"
+
+namespace {
+    const char FILE_MAGIC[] = "PVSNAP01";
+    constexpr size_t FILE_MAGIC_SIZE = 8;
+    constexpr size_t KEY_HASH_POS = FILE_MAGIC_SIZE;
+    constexpr size_t CHECKSUM_POS = KEY_HASH_POS + sizeof(uint64_t);
+    constexpr size_t HEADER_SIZE = CHECKSUM_POS + sizeof(uint64_t);
+    constexpr uint32_t BITS_PER_BYTE = 8;
+
+    template<class T>
+    void PutValue(uint8_t* dst, T value)
+    {
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            dst[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> ((sizeof(T) - 1 - i) * BITS_PER_BYTE));
+        }
+    }
+
+    template<class T>
+    T GetValue(const uint8_t* src)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            value = (value << BITS_PER_BYTE) | src[i];
+        }
+        return static_cast<T>(value);
+    }
+
+    uint64_t HashKey(const std::string& key)
+    {
+        return FrameHash::Hash64(reinterpret_cast<const uint8_t*>(key.data()), key.size());
+    }
+
+    void AppendValue(std::vector<uint8_t>& body, uint32_t value)
+    {
+        size_t pos = body.size();
+        body.resize(pos + sizeof(value));
+        PutValue<uint32_t>(body.data() + pos, value);
+    }
+}
+
+std::string FrameSnapshot::GetPath(const std::string& dir, const std::string& key)
+{
+    char name[32]; // 32: 16 hex digits and the extension
+    if (snprintf(name, sizeof(name), "%016" PRIx64 ".pvsnap", HashKey(key)) < 0) {
+        return std::string();
+    }
+    return dir + FileSystem::GetSeparator() + name;
+}
+
+bool FrameSnapshot::Save(const std::string& dir, const std::string& key,
+                         const std::vector<std::vector<uint8_t>>& packets)
+{
+    size_t bodySize = sizeof(uint32_t);
+    for (const std::vector<uint8_t>& packet : packets) {
+        if (packet.empty()) {
+            return false;
+        }
+        bodySize += sizeof(uint32_t) + packet.size();
+    }
+    if (packets.empty() || bodySize > MAX_SNAPSHOT_SIZE) {
+        return false;
+    }
+    std::vector<uint8_t> body;
+    body.reserve(bodySize);
+    AppendValue(body, static_cast<uint32_t>(packets.size()));
+    for (const std::vector<uint8_t>& packet : packets) {
+        AppendValue(body, static_cast<uint32_t>(packet.size()));
+        body.insert(body.end(), packet.begin(), packet.end());
+    }
+    uint8_t header[HEADER_SIZE];
+    std::copy(FILE_MAGIC, FILE_MAGIC + FILE_MAGIC_SIZE, header);
+    PutValue<uint64_t>(header + KEY_HASH_POS, HashKey(key));
+    PutValue<uint64_t>(header + CHECKSUM_POS, FrameHash::Hash64(body.data(), body.size()));
+    std::string path = GetPath(dir, key);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+        out.write(reinterpret_cast<const char*>(body.data()), body.size());
+        if (!out.good()) {
+            ELOG("FrameSnapshot::Save write %s failed.", tempPath.c_str());
+            out.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    // rename does not replace an existing file on every platform.
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0 &&
+        (std::remove(path.c_str()) != 0 || std::rename(tempPath.c_str(), path.c_str()) != 0)) {
+        ELOG("FrameSnapshot::Save rename to %s failed.", path.c_str());
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool FrameSnapshot::Load(const std::string& dir, const std::string& key, std::vector<std::vector<uint8_t>>& packets)
+{
+    packets.clear();
+    std::ifstream in(GetPath(dir, key), std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::streamoff fileSize = in.tellg();
+    uint8_t header[HEADER_SIZE];
+    if (fileSize < static_cast<std::streamoff>(HEADER_SIZE + sizeof(uint32_t)) ||
+        fileSize > static_cast<std::streamoff>(HEADER_SIZE + MAX_SNAPSHOT_SIZE) || !in.seekg(0) ||
+        !in.read(reinterpret_cast<char*>(header), HEADER_SIZE) ||
+        !std::equal(FILE_MAGIC, FILE_MAGIC + FILE_MAGIC_SIZE, header) ||
+        GetValue<uint64_t>(header + KEY_HASH_POS) != HashKey(key)) {
+        ELOG("FrameSnapshot::Load the snapshot is not one of this key.");
+        return false;
+    }
+    std::vector<uint8_t> body(static_cast<size_t>(fileSize) - HEADER_SIZE);
+    if (!in.read(reinterpret_cast<char*>(body.data()), body.size()) ||
+        FrameHash::Hash64(body.data(), body.size()) != GetValue<uint64_t>(header + CHECKSUM_POS)) {
+        ELOG("FrameSnapshot::Load the snapshot is damaged.");
+        return false;
+    }
+    uint32_t count = GetValue<uint32_t>(body.data());
+    size_t pos = sizeof(uint32_t);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (body.size() - pos < sizeof(uint32_t)) {
+            break;
+        }
+        uint32_t length = GetValue<uint32_t>(body.data() + pos);
+        pos += sizeof(uint32_t);
+        if (length == 0 || body.size() - pos < length) {
+            break;
+        }
+        packets.emplace_back(body.begin() + pos, body.begin() + pos + length);
+        pos += length;
+    }
+    if (packets.size() != count || count == 0) {
+        ELOG("FrameSnapshot::Load the snapshot has %zu of %u packets.", packets.size(), count);
+        packets.clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMESNAPSHOT_H
+#define FRAMESNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The last packets sent, the full frame and the regions after it, kept on disk per key so that a new session has
+// a picture to send before its first render. One file per key in the directory: "PVSNAP01", the hash of the key,
+// the checksum of the rest, the packet count, then every packet after its length. The checksum is FrameHash, a
+// snapshot written by a build of another platform may read as damaged.
+namespace FrameSnapshot {
+    constexpr size_t MAX_SNAPSHOT_SIZE = 64 * 1024 * 1024; // far above a 4K frame, guards against a broken file
+
+    std::string GetPath(const std::string& dir, const std::string& key);
+    // Written to a temporary file and renamed, a session killed meanwhile leaves the previous snapshot.
+    bool Save(const std::string& dir, const std::string& key, const std::vector<std::vector<uint8_t>>& packets);
+    // False when there is no snapshot of the key or it is damaged.
+    bool Load(const std::string& dir, const std::string& key, std::vector<std::vector<uint8_t>>& packets);
+}; // namespace FrameSnapshot
+
+#endif // FRAMESNAPSHOT_H
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Lz4Codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    const size_t MIN_MATCH = 4;
+    const size_t LAST_LITERALS = 5; // the block ends with at least 5 literals
+    const size_t MATCH_FIND_LIMIT = 12; // no match starts within the last 12 bytes
+    const size_t MAX_OFFSET = 65535;
+    const uint32_t HASH_LOG = 16;
+    const uint32_t SKIP_TRIGGER = 6; // the search step grows by one every 64 bytes without a match
+    const uint8_t RUN_MASK = 15;
+    const uint8_t LENGTH_EXTENSION = 255;
+    const uint32_t PIXEL_SIZE = 4;
+
+    uint32_t Read32(const uint8_t* data)
+    {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    uint32_t Hash(uint32_t sequence)
+    {
+        return (sequence * 2654435761U) >> (32 - HASH_LOG); // 2654435761: knuth multiplicative hash, 32: bits
+    }
+
+    size_t CountMatch(const uint8_t* in, const uint8_t* match, const uint8_t* limit)
+    {
+        const uint8_t* start = in;
+        while (in + sizeof(uint64_t) <= limit) {
+            uint64_t left;
+            uint64_t right;
+            std::memcpy(&left, in, sizeof(left));
+            std::memcpy(&right, match, sizeof(right));
+            if (left != right) {
+                break;
+            }
+            in += sizeof(uint64_t);
+            match += sizeof(uint64_t);
+        }
+        while (in < limit && *in == *match) {
+            ++in;
+            ++match;
+        }
+        return static_cast<size_t>(in - start);
+    }
+
+    size_t LengthSize(size_t length)
+    {
+        return length < RUN_MASK ? 0 : (length - RUN_MASK) / LENGTH_EXTENSION + 1;
+    }
+
+    void WriteLength(uint8_t*& out, size_t length)
+    {
+        length -= RUN_MASK;
+        for (; length >= LENGTH_EXTENSION; length -= LENGTH_EXTENSION) {
+            *out++ = LENGTH_EXTENSION;
+        }
+        *out++ = static_cast<uint8_t>(length);
+    }
+
+    // One sequence: the literals since the last match, then a match unless matchLength is 0 (the last sequence).
+    bool WriteSequence(uint8_t*& out, const uint8_t* outEnd, const uint8_t* literals, size_t literalLength,
+                       size_t offset, size_t matchLength)
+    {
+        size_t needed = 1 + LengthSize(literalLength) + literalLength +
+            (matchLength > 0 ? sizeof(uint16_t) + LengthSize(matchLength - MIN_MATCH) : 0);
+        if (needed > static_cast<size_t>(outEnd - out)) {
+            return false;
+        }
+        uint8_t* token = out++;
+        *token = static_cast<uint8_t>(std::min<size_t>(literalLength, RUN_MASK) << 4); // 4: literal nibble
+        if (literalLength >= RUN_MASK) {
+            WriteLength(out, literalLength);
+        }
+        std::memcpy(out, literals, literalLength);
+        out += literalLength;
+        if (matchLength == 0) {
+            return true;
+        }
+        *out++ = static_cast<uint8_t>(offset);
+        *out++ = static_cast<uint8_t>(offset >> 8); // 8: little endian high byte
+        size_t matchCode = matchLength - MIN_MATCH;
+        *token |= static_cast<uint8_t>(std::min<size_t>(matchCode, RUN_MASK));
+        if (matchCode >= RUN_MASK) {
+            WriteLength(out, matchCode);
+        }
+        return true;
+    }
+
+    bool ReadLength(const uint8_t*& in, const uint8_t* end, size_t& length)
+    {
+        uint8_t value = LENGTH_EXTENSION;
+        while (value == LENGTH_EXTENSION) {
+            if (in >= end) {
+                return false;
+            }
+            value = *in++;
+            length += value;
+        }
+        return true;
+    }
+}
+
+FrameCodecId Lz4Codec::GetId() const
+{
+    return FrameCodecId::LZ4;
+}
+
+size_t Lz4Codec::Encode(const uint8_t* data, int32_t width, int32_t height, uint8_t* dst, size_t capacity)
+{
+    if (width < 1 || height < 1) {
+        return 0;
+    }
+    return Compress(data, static_cast<size_t>(width) * height * PIXEL_SIZE, dst, capacity);
+}
+
+bool Lz4Codec::Decode(const uint8_t* data, size_t length, int32_t width, int32_t height, uint8_t* dst)
+{
+    if (width < 1 || height < 1) {
+        return false;
+    }
+    return Decompress(data, length, dst, static_cast<size_t>(width) * height * PIXEL_SIZE);
+}
+
+size_t Lz4Codec::Compress(const uint8_t* src, size_t length, uint8_t* dst, size_t capacity)
+{
+    if (src == nullptr || dst == nullptr || length == 0 || length > UINT32_MAX) {
+        return 0;
+    }
+    uint8_t* out = dst;
+    const uint8_t* outEnd = dst + capacity;
+    const uint8_t* anchor = src;
+    if (length > MATCH_FIND_LIMIT) {
+        hashTable.assign(static_cast<size_t>(1) << HASH_LOG, 0);
+        const uint8_t* in = src + 1;
+        const uint8_t* matchEnd = src + length - LAST_LITERALS;
+        const uint8_t* searchEnd = src + length - MATCH_FIND_LIMIT;
+        while (in < searchEnd) {
+            uint32_t sequence = Read32(in);
+            uint32_t& slot = hashTable[Hash(sequence)];
+            const uint8_t* match = src + slot;
+            slot = static_cast<uint32_t>(in - src);
+            if (match >= in || static_cast<size_t>(in - match) > MAX_OFFSET || Read32(match) != sequence) {
+                in += 1 + (static_cast<size_t>(in - anchor) >> SKIP_TRIGGER);
+                continue;
+            }
+            // Matches of a frame usually start a whole pixel back, extending backwards picks up the rest.
+            while (in > anchor && match > src && in[-1] == match[-1]) {
+                --in;
+                --match;
+            }
+            size_t matchLength = MIN_MATCH + CountMatch(in + MIN_MATCH, match + MIN_MATCH, matchEnd);
+            if (!WriteSequence(out, outEnd, anchor, static_cast<size_t>(in - anchor),
+                               static_cast<size_t>(in - match), matchLength)) {
+                return 0;
+            }
+            in += matchLength;
+            anchor = in;
+            if (in < searchEnd) {
+                hashTable[Hash(Read32(in - PIXEL_SIZE))] = static_cast<uint32_t>(in - PIXEL_SIZE - src);
+            }
+        }
+    }
+    if (!WriteSequence(out, outEnd, anchor, static_cast<size_t>(src + length - anchor), 0, 0)) {
+        return 0;
+    }
+    return static_cast<size_t>(out - dst);
+}
+
+bool Lz4Codec::Decompress(const uint8_t* src, size_t length, uint8_t* dst, size_t dstLength) const
+{
+    if (src == nullptr || dst == nullptr) {
+        return false;
+    }
+    const uint8_t* in = src;
+    const uint8_t* end = src + length;
+    uint8_t* out = dst;
+    uint8_t* outEnd = dst + dstLength;
+    while (in < end) {
+        uint8_t token = *in++;
+        size_t literalLength = token >> 4; // 4: literal nibble
+        if (literalLength == RUN_MASK && !ReadLength(in, end, literalLength)) {
+            return false;
+        }
+        if (literalLength > static_cast<size_t>(end - in) || literalLength > static_cast<size_t>(outEnd - out)) {
+            return false;
+        }
+        std::memcpy(out, in, literalLength);
+        in += literalLength;
+        out += literalLength;
+        if (in == end) {
+            break; // the last sequence has no match
+        }
+        if (static_cast<size_t>(end - in) < sizeof(uint16_t)) {
+            return false;
+        }
+        size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8); // 8: little endian high byte
+        in += sizeof(uint16_t);
+        size_t matchLength = token & RUN_MASK;
+        if (matchLength == RUN_MASK && !ReadLength(in, end, matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > static_cast<size_t>(out - dst) ||
+            matchLength > static_cast<size_t>(outEnd - out)) {
+            return false;
+        }
+        // Byte by byte, the match may overlap the bytes it produces.
+        const uint8_t* match = out - offset;
+        for (size_t i = 0; i < matchLength; ++i) {
+            out[i] = match[i];
+        }
+        out += matchLength;
+    }
+    return out == outEnd;
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LZ4CODEC_H
+#define LZ4CODEC_H
+
+#include <vector>
+#include "FrameCodec.h"
+
+// The raw frame compressed as one LZ4 block: greedy matching over a 64 KB window, so any LZ4 block decoder reads
+// it back, given the frame size from the header. Flat areas of the frame turn into long matches.
+class Lz4Codec : public FrameCodec {
+public:
+    FrameCodecId GetId() const override;
+    size_t Encode(const uint8_t* data, int32_t width, int32_t height, uint8_t* dst, size_t capacity) override;
+    bool Decode(const uint8_t* data, size_t length, int32_t width, int32_t height, uint8_t* dst) override;
+
+    size_t Compress(const uint8_t* src, size_t length, uint8_t* dst, size_t capacity);
+    bool Decompress(const uint8_t* src, size_t length, uint8_t* dst, size_t dstLength) const;
+
+private:
+    std::vector<uint32_t> hashTable; // last position of every hashed 4 byte sequence, the storage is reused
+};
+
+#endif // LZ4CODEC_H
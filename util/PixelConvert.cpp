@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PixelConvert.h"
+
+#include <algorithm>
+#include <atomic>
+#include "PreviewerEngineLog.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PIXEL_CONVERT_X86
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define PIXEL_CONVERT_NEON
+#endif
+
+namespace {
+    constexpr size_t SRC_PIXEL_SIZE = 4;
+    constexpr size_t DST_PIXEL_SIZE = 3;
+    constexpr int KERNEL_UNRESOLVED = -1;
+    std::atomic<int> g_kernel(KERNEL_UNRESOLVED);
+
+    using RowFunc = void (*)(const uint8_t* src, uint8_t* dst, size_t pixels, bool swapRedBlue);
+
+    void ScalarRow(const uint8_t* src, uint8_t* dst, size_t pixels, bool swapRedBlue)
+    {
+        const size_t red = swapRedBlue ? 2 : 0; // 2: blue channel of BGRA
+        const size_t blue = swapRedBlue ? 0 : 2; // 2: blue channel of RGBA
+        for (size_t i = 0; i < pixels; ++i) {
+            dst[0] = src[red];
+            dst[1] = src[1];
+            dst[2] = src[blue]; // 2: blue channel of RGB
+            src += SRC_PIXEL_SIZE;
+            dst += DST_PIXEL_SIZE;
+        }
+    }
+
+#ifdef PIXEL_CONVERT_X86
+    // pshufb packs 4 pixels into the low 12 bytes of a register, the high 4 bytes are zeroed.
+    __attribute__((target("ssse3"))) void Ssse3Row(const uint8_t* src, uint8_t* dst, size_t pixels,
+        bool swapRedBlue)
+    {
+        const __m128i mask = swapRedBlue ?
+            _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1) :
+            _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        const size_t step = 16; // 16 pixels in, 48 bytes out
+        size_t i = 0;
+        for (; i + step <= pixels; i += step) {
+            __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), mask);
+            __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16)), mask);
+            __m128i c = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32)), mask);
+            __m128i d = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48)), mask);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_or_si128(a, _mm_slli_si128(b, 12)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16),
+                _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32),
+                _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+            src += step * SRC_PIXEL_SIZE;
+            dst += step * DST_PIXEL_SIZE;
+        }
+        ScalarRow(src, dst, pixels - i, swapRedBlue);
+    }
+
+    // Each 128-bit lane packs 4 pixels into 12 bytes, vpermd then joins the two lanes into 24 contiguous bytes.
+    // The 32-byte store overruns by 8 bytes that the next iteration overwrites, so the loop stops while at least
+    // 11 pixels remain and the tail goes through the scalar path.
+    __attribute__((target("avx2"))) void Avx2Row(const uint8_t* src, uint8_t* dst, size_t pixels,
+        bool swapRedBlue)
+    {
+        const __m256i mask = swapRedBlue ?
+            _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                             2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1) :
+            _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                             0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        const __m256i pack = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+        const size_t step = 8; // 8 pixels in, 24 bytes out
+        const size_t overrun = 11; // 32 bytes written per step need 11 pixels of room
+        size_t i = 0;
+        for (; i + overrun <= pixels; i += step) {
+            __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+            px = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(px, mask), pack);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), px);
+            src += step * SRC_PIXEL_SIZE;
+            dst += step * DST_PIXEL_SIZE;
+        }
+        ScalarRow(src, dst, pixels - i, swapRedBlue);
+    }
+#endif
+
+#ifdef PIXEL_CONVERT_NEON
+    void NeonRow(const uint8_t* src, uint8_t* dst, size_t pixels, bool swapRedBlue)
+    {
+        const size_t step = 16;
+        size_t i = 0;
+        for (; i + step <= pixels; i += step) {
+            uint8x16x4_t px = vld4q_u8(src);
+            uint8x16x3_t out;
+            out.val[0] = swapRedBlue ? px.val[2] : px.val[0]; // 2: blue plane
+            out.val[1] = px.val[1];
+            out.val[2] = swapRedBlue ? px.val[0] : px.val[2]; // 2: blue plane
+            vst3q_u8(dst, out);
+            src += step * SRC_PIXEL_SIZE;
+            dst += step * DST_PIXEL_SIZE;
+        }
+        ScalarRow(src, dst, pixels - i, swapRedBlue);
+    }
+#endif
+
+    RowFunc GetRowFunc(PixelConvert::Kernel kernel)
+    {
+        switch (kernel) {
+#ifdef PIXEL_CONVERT_X86
+            case PixelConvert::Kernel::SSSE3:
+                return Ssse3Row;
+            case PixelConvert::Kernel::AVX2:
+                return Avx2Row;
+#endif
+#ifdef PIXEL_CONVERT_NEON
+            case PixelConvert::Kernel::NEON:
+                return NeonRow;
+#endif
+            default:
+                return ScalarRow;
+        }
+    }
+
+    void ConvertRows(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                     int32_t width, int32_t height, bool swapRedBlue)
+    {
+        if (src == nullptr || dst == nullptr || width < 1 || height < 1) {
+            return;
+        }
+        RowFunc row = GetRowFunc(PixelConvert::GetKernel());
+        size_t pixels = static_cast<size_t>(width);
+        if (srcStride == pixels * SRC_PIXEL_SIZE && dstStride == pixels * DST_PIXEL_SIZE) {
+            row(src, dst, pixels * static_cast<size_t>(height), swapRedBlue);
+            return;
+        }
+        for (int32_t i = 0; i < height; ++i) {
+            row(src + i * srcStride, dst + i * dstStride, pixels, swapRedBlue);
+        }
+    }
+}
+
+PixelConvert::Kernel PixelConvert::GetKernel()
+{
+    int kernel = g_kernel.load(std::memory_order_relaxed);
+    if (kernel != KERNEL_UNRESOLVED) {
+        return static_cast<Kernel>(kernel);
+    }
+    Kernel best = Kernel::SCALAR;
+    for (Kernel candidate : { Kernel::NEON, Kernel::AVX2, Kernel::SSSE3 }) {
+        if (IsKernelSupported(candidate)) {
+            best = candidate;
+            break;
+        }
+    }
+    g_kernel.store(static_cast<int>(best), std::memory_order_relaxed);
+    ILOG("PixelConvert kernel: %s", GetKernelName(best));
+    return best;
+}
+
+bool PixelConvert::SetKernel(Kernel kernel)
+{
+    if (!IsKernelSupported(kernel)) {
+        ELOG("PixelConvert kernel %s is not supported on this cpu.", GetKernelName(kernel));
+        return false;
+    }
+    g_kernel.store(static_cast<int>(kernel), std::memory_order_relaxed);
+    return true;
+}
+
+bool PixelConvert::IsKernelSupported(Kernel kernel)
+{
+    switch (kernel) {
+        case Kernel::SCALAR:
+            return true;
+#ifdef PIXEL_CONVERT_X86
+        case Kernel::SSSE3:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("ssse3");
+        case Kernel::AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+#ifdef PIXEL_CONVERT_NEON
+        case Kernel::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* PixelConvert::GetKernelName(Kernel kernel)
+{
+    switch (kernel) {
+        case Kernel::SSSE3:
+            return "SSSE3";
+        case Kernel::AVX2:
+            return "AVX2";
+        case Kernel::NEON:
+            return "NEON";
+        default:
+            return "SCALAR";
+    }
+}
+
+void PixelConvert::RgbaToRgb(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                             int32_t width, int32_t height)
+{
+    ConvertRows(src, srcStride, dst, dstStride, width, height, false);
+}
+
+void PixelConvert::BgraToRgb(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                             int32_t width, int32_t height)
+{
+    ConvertRows(src, srcStride, dst, dstStride, width, height, true);
+}
+
+void PixelConvert::CopyRgba(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                            int32_t width, int32_t height)
+{
+    if (src == nullptr || dst == nullptr || width < 1 || height < 1) {
+        return;
+    }
+    size_t rowSize = static_cast<size_t>(width) * SRC_PIXEL_SIZE;
+    if (srcStride == rowSize && dstStride == rowSize) {
+        std::copy(src, src + rowSize * static_cast<size_t>(height), dst);
+        return;
+    }
+    for (int32_t i = 0; i < height; ++i) {
+        const uint8_t* row = src + i * srcStride;
+        std::copy(row, row + rowSize, dst + i * dstStride);
+    }
+}
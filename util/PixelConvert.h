@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PIXELCONVERT_H
+#define PIXELCONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Pixel format conversion for the screen send path. Strides are in bytes, the best kernel supported by the
+// running CPU is selected on first use and can be overridden for tests and benchmarks.
+namespace PixelConvert {
+    enum class Kernel {
+        SCALAR = 0,
+        SSSE3,
+        AVX2,
+        NEON,
+    };
+
+    Kernel GetKernel();
+    bool SetKernel(Kernel kernel);
+    bool IsKernelSupported(Kernel kernel);
+    const char* GetKernelName(Kernel kernel);
+
+    // 4 bytes per pixel to packed 3 bytes per pixel, dropping alpha.
+    void RgbaToRgb(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                   int32_t width, int32_t height);
+    // 4 bytes per pixel to packed 3 bytes per pixel, swapping red and blue and dropping alpha.
+    void BgraToRgb(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                   int32_t width, int32_t height);
+    // 4 bytes per pixel copied as is, RGBA or BGRA.
+    void CopyRgba(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                  int32_t width, int32_t height);
+}; // namespace PixelConvert
+
+#endif // PIXELCONVERT_H
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PngEncoder.h"
+
+#include <array>
+#include <cstring>
+
+namespace {
+    constexpr uint8_t PNG_SIGNATURE[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    constexpr size_t RGB_COMPONENTS = 3;
+    constexpr size_t RGBX_COMPONENTS = 4;
+    constexpr uint8_t BIT_DEPTH = 8;
+    constexpr uint8_t COLOR_TYPE_RGB = 2;
+    constexpr uint8_t FILTER_NONE = 0;
+    constexpr size_t IHDR_LENGTH = 13; // width, height, depth, color type, compression, filter and interlace
+    constexpr size_t CHUNK_OVERHEAD = 12; // length, type and crc
+    constexpr size_t MAX_STORED_BLOCK = 65535; // the length field of a stored block has 16 bits
+    constexpr size_t STORED_BLOCK_HEADER = 5; // final flag byte, length and its complement
+    constexpr uint8_t ZLIB_CMF = 0x78; // deflate with a 32K window
+    constexpr uint8_t ZLIB_FLG = 0x01; // no dictionary, fastest level, (CMF * 256 + FLG) % 31 == 0
+    constexpr uint32_t CRC32_POLYNOMIAL = 0xEDB88320;
+    constexpr uint32_t ADLER32_MODULO = 65521;
+    constexpr size_t ADLER32_NMAX = 5552; // the most bytes before the 32 bit sums can overflow
+    constexpr int32_t MAX_DIMENSION = 1 << 15; // far above any resolution, keeps the sizes in 32 bits
+
+    const std::array<uint32_t, 256>& CrcTable()
+    {
+        static const std::array<uint32_t, 256> table = []() {
+            std::array<uint32_t, 256> values {};
+            for (uint32_t n = 0; n < values.size(); n++) {
+                uint32_t c = n;
+                for (int bit = 0; bit < 8; bit++) { // 8: bits per byte
+                    c = (c & 1) ? (CRC32_POLYNOMIAL ^ (c >> 1)) : (c >> 1);
+                }
+                values[n] = c;
+            }
+            return values;
+        }();
+        return table;
+    }
+
+    void PutBigEndian32(uint8_t* dst, uint32_t value)
+    {
+        dst[0] = static_cast<uint8_t>(value >> 24); // 24: most significant byte
+        dst[1] = static_cast<uint8_t>(value >> 16); // 16: second byte
+        dst[2] = static_cast<uint8_t>(value >> 8);  // 2: third byte, 8: its shift
+        dst[3] = static_cast<uint8_t>(value);       // 3: least significant byte
+    }
+
+    // Chunks are written in place: the length and type first, the crc over type and data once the data is in.
+    size_t BeginChunk(uint8_t* dst, const char* type, size_t length)
+    {
+        PutBigEndian32(dst, static_cast<uint32_t>(length));
+        std::memcpy(dst + 4, type, 4); // 4: the type follows the length, it has 4 letters
+        return 8; // 8: the data starts after length and type
+    }
+
+    size_t EndChunk(uint8_t* chunk, size_t length)
+    {
+        const size_t typeOffset = 4; // 4: the crc starts at the type
+        uint32_t crc = PngEncoder::Crc32(chunk + typeOffset, length + 4); // 4: the type is covered too
+        PutBigEndian32(chunk + typeOffset + 4 + length, crc); // 4: past the type
+        return CHUNK_OVERHEAD + length;
+    }
+}
+
+namespace PngEncoder {
+    uint32_t Crc32(const uint8_t* data, size_t length, uint32_t crc)
+    {
+        const std::array<uint32_t, 256>& table = CrcTable();
+        crc = ~crc;
+        for (size_t i = 0; i < length; i++) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8); // 8: one byte per step
+        }
+        return ~crc;
+    }
+
+    uint32_t Adler32(const uint8_t* data, size_t length, uint32_t adler)
+    {
+        uint32_t a = adler & 0xFFFF;
+        uint32_t b = adler >> 16; // 16: the high half holds the second sum
+        while (length > 0) {
+            size_t count = (length < ADLER32_NMAX) ? length : ADLER32_NMAX;
+            length -= count;
+            for (size_t i = 0; i < count; i++) {
+                a += data[i];
+                b += a;
+            }
+            data += count;
+            a %= ADLER32_MODULO;
+            b %= ADLER32_MODULO;
+        }
+        return (b << 16) | a; // 16: the high half holds the second sum
+    }
+
+    bool EncodeRgbx(const uint8_t* data, size_t stride, int32_t width, int32_t height, std::vector<uint8_t>& png)
+    {
+        if (data == nullptr || width <= 0 || height <= 0 || width > MAX_DIMENSION || height > MAX_DIMENSION ||
+            stride < static_cast<size_t>(width) * RGBX_COMPONENTS) {
+            return false;
+        }
+        size_t rowLength = 1 + static_cast<size_t>(width) * RGB_COMPONENTS; // the filter byte leads every row
+        size_t rawLength = rowLength * static_cast<size_t>(height);
+        size_t blockCount = (rawLength + MAX_STORED_BLOCK - 1) / MAX_STORED_BLOCK;
+        size_t zlibLength = 2 + blockCount * STORED_BLOCK_HEADER + rawLength + 4; // 2: CMF and FLG, 4: adler32
+        png.resize(sizeof(PNG_SIGNATURE) + CHUNK_OVERHEAD + IHDR_LENGTH + CHUNK_OVERHEAD + zlibLength +
+                   CHUNK_OVERHEAD);
+        uint8_t* out = png.data();
+        std::memcpy(out, PNG_SIGNATURE, sizeof(PNG_SIGNATURE));
+        out += sizeof(PNG_SIGNATURE);
+
+        uint8_t* ihdr = out + BeginChunk(out, "IHDR", IHDR_LENGTH);
+        PutBigEndian32(ihdr, static_cast<uint32_t>(width));
+        PutBigEndian32(ihdr + 4, static_cast<uint32_t>(height)); // 4: after the width
+        ihdr[8] = BIT_DEPTH; // 8: after width and height
+        ihdr[9] = COLOR_TYPE_RGB; // 9: after the bit depth
+        ihdr[10] = 0; // 10: deflate compression
+        ihdr[11] = 0; // 11: adaptive filtering
+        ihdr[12] = 0; // 12: no interlace
+        out += EndChunk(out, IHDR_LENGTH);
+
+        uint8_t* idat = out + BeginChunk(out, "IDAT", zlibLength);
+        uint8_t* z = idat;
+        *z++ = ZLIB_CMF;
+        *z++ = ZLIB_FLG;
+        // The rows are streamed into the stored blocks, a block may end in the middle of a row.
+        uint32_t adler = 1;
+        size_t blockLeft = 0;
+        size_t rawLeft = rawLength;
+        auto put = [&](const uint8_t* src, size_t length) {
+            while (length > 0) {
+                if (blockLeft == 0) {
+                    blockLeft = (rawLeft < MAX_STORED_BLOCK) ? rawLeft : MAX_STORED_BLOCK;
+                    rawLeft -= blockLeft;
+                    *z++ = (rawLeft == 0) ? 1 : 0; // 1: the last block
+                    uint16_t len = static_cast<uint16_t>(blockLeft);
+                    uint16_t nlen = static_cast<uint16_t>(~len);
+                    *z++ = static_cast<uint8_t>(len);
+                    *z++ = static_cast<uint8_t>(len >> 8); // 8: little endian high byte
+                    *z++ = static_cast<uint8_t>(nlen);
+                    *z++ = static_cast<uint8_t>(nlen >> 8); // 8: little endian high byte
+                }
+                size_t count = (length < blockLeft) ? length : blockLeft;
+                std::memcpy(z, src, count);
+                adler = Adler32(src, count, adler);
+                z += count;
+                src += count;
+                length -= count;
+                blockLeft -= count;
+            }
+        };
+        std::vector<uint8_t> row(rowLength);
+        row[0] = FILTER_NONE;
+        for (int32_t y = 0; y < height; y++) {
+            const uint8_t* src = data + static_cast<size_t>(y) * stride;
+            uint8_t* dst = row.data() + 1;
+            for (int32_t x = 0; x < width; x++) {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2]; // 2: blue, the fourth byte is dropped
+                dst += RGB_COMPONENTS;
+                src += RGBX_COMPONENTS;
+            }
+            put(row.data(), rowLength);
+        }
+        PutBigEndian32(z, adler);
+        out += EndChunk(out, zlibLength);
+
+        BeginChunk(out, "IEND", 0);
+        EndChunk(out, 0);
+        return true;
+    }
+}; // namespace PngEncoder
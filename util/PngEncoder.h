@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PNGENCODER_H
+#define PNGENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Writes 4 bytes per pixel RGBX frames as 8 bit truecolor png, the fourth byte is dropped like the jpeg encoders
+// do. The image data goes into stored deflate blocks: the file is about as large as the raw pixels, in exchange it
+// takes one copy to write and needs no zlib.
+namespace PngEncoder {
+    // Replaces the content of png, false on an empty or too large frame.
+    bool EncodeRgbx(const uint8_t* data, size_t stride, int32_t width, int32_t height, std::vector<uint8_t>& png);
+    // The checksums of the chunks and of the zlib stream, exposed for the tests.
+    uint32_t Crc32(const uint8_t* data, size_t length, uint32_t crc = 0);
+    uint32_t Adler32(const uint8_t* data, size_t length, uint32_t adler = 1);
+}; // namespace PngEncoder
+
+#endif // PNGENCODER_H
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ProgressiveQuality.h"
+
+#include <algorithm>
+#include "AdaptiveQuality.h"
+
+void ProgressiveQuality::Configure(const ProgressiveQualityConfig& newConfig)
+{
+    std::lock_guard<std::mutex> guard(qualityMutex);
+    config = newConfig;
+    config.refineQuality = std::clamp(config.refineQuality, AdaptiveQuality::MIN_QUALITY,
+        AdaptiveQuality::MAX_QUALITY);
+    config.motionQuality = std::clamp(config.motionQuality, AdaptiveQuality::MIN_QUALITY, config.refineQuality);
+    config.idleMs = std::clamp(config.idleMs, MIN_IDLE_MS, MAX_IDLE_MS);
+    isRefinementDue = false;
+}
+
+ProgressiveQualityConfig ProgressiveQuality::GetConfig() const
+{
+    std::lock_guard<std::mutex> guard(qualityMutex);
+    return config;
+}
+
+int32_t ProgressiveQuality::GetQuality(int32_t baseQuality)
+{
+    std::lock_guard<std::mutex> guard(qualityMutex);
+    if (!config.enabled) {
+        return baseQuality;
+    }
+    int32_t quality = std::min(baseQuality, config.motionQuality);
+    isRefinementDue = quality < config.refineQuality;
+    return quality;
+}
+
+bool ProgressiveQuality::IsRefinementDue() const
+{
+    std::lock_guard<std::mutex> guard(qualityMutex);
+    return config.enabled && isRefinementDue;
+}
+
+int32_t ProgressiveQuality::GetRefineQuality() const
+{
+    std::lock_guard<std::mutex> guard(qualityMutex);
+    return config.refineQuality;
+}
+
+void ProgressiveQuality::OnRefined()
+{
+    std::lock_guard<std::mutex> guard(qualityMutex);
+    isRefinementDue = false;
+}
+
+std::chrono::milliseconds ProgressiveQuality::GetIdleDelay() const
+{
+    std::lock_guard<std::mutex> guard(qualityMutex);
+    return std::chrono::milliseconds(config.enabled ? config.idleMs : 0);
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PROGRESSIVEQUALITY_H
+#define PROGRESSIVEQUALITY_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+struct ProgressiveQualityConfig {
+    bool enabled = false;
+    int32_t motionQuality = 60; // ceiling of the frames sent while the scene changes
+    int32_t refineQuality = 100;
+    int32_t idleMs = 300; // the last frame is refined once no other frame followed it for this long
+};
+
+// Progressive refinement of a scene that stops changing. While frames keep coming, during drags, scrolls and
+// animations, they are encoded at most at the motion quality. Once the sender has been idle for the idle delay, the
+// last frame is sent once more at the refine quality with full resolution chroma, so the picture the user looks at
+// is sharp again. A frame that already went out at the refine quality is not sent twice.
+class ProgressiveQuality {
+public:
+    static constexpr int32_t MIN_IDLE_MS = 50;
+    static constexpr int32_t MAX_IDLE_MS = 10000;
+
+    void Configure(const ProgressiveQualityConfig& newConfig);
+    ProgressiveQualityConfig GetConfig() const;
+    // Called for every frame encoded, baseQuality is the quality chosen without refinement. The result is never
+    // above it, a result below the refine quality makes a refinement due.
+    int32_t GetQuality(int32_t baseQuality);
+    bool IsRefinementDue() const;
+    int32_t GetRefineQuality() const;
+    void OnRefined();
+    // How long the sender waits for a new frame before it refines the last one, 0 when disabled.
+    std::chrono::milliseconds GetIdleDelay() const;
+
+private:
+    mutable std::mutex qualityMutex;
+    ProgressiveQualityConfig config;
+    bool isRefinementDue = false;
+};
+
+#endif // PROGRESSIVEQUALITY_H
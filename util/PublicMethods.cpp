@@ -42,3 +42,35 @@ uint32_t PublicMethods::Ulltoa(uintptr_t value, int8_t (&rstStr)[MAX_ITOA_BIT])
     *tmpRstStr = 0;
     return rstLength;
 }
+
+std::string PublicMethods::Base64Encode(const uint8_t* data, size_t length)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const size_t groupSize = 3; // 3 bytes become 4 characters
+    std::string encoded;
+    if (data == nullptr) {
+        return encoded;
+    }
+    encoded.reserve((length + groupSize - 1) / groupSize * 4); // 4 characters per group
+    size_t i = 0;
+    for (; i + groupSize <= length; i += groupSize) {
+        uint32_t group = (static_cast<uint32_t>(data[i]) << 16) | (static_cast<uint32_t>(data[i + 1]) << 8) | // 16, 8
+            data[i + 2]; // 2: the third byte
+        encoded.push_back(alphabet[(group >> 18) & 0x3F]); // 18: the first 6 bits
+        encoded.push_back(alphabet[(group >> 12) & 0x3F]); // 12: the second 6 bits
+        encoded.push_back(alphabet[(group >> 6) & 0x3F]);  // 6: the third 6 bits
+        encoded.push_back(alphabet[group & 0x3F]);
+    }
+    size_t rest = length - i;
+    if (rest > 0) {
+        uint32_t group = static_cast<uint32_t>(data[i]) << 16; // 16: the first byte
+        if (rest > 1) {
+            group |= static_cast<uint32_t>(data[i + 1]) << 8; // 8: the second byte
+        }
+        encoded.push_back(alphabet[(group >> 18) & 0x3F]); // 18: the first 6 bits
+        encoded.push_back(alphabet[(group >> 12) & 0x3F]); // 12: the second 6 bits
+        encoded.push_back((rest > 1) ? alphabet[(group >> 6) & 0x3F] : '='); // 6: the third 6 bits
+        encoded.push_back('=');
+    }
+    return encoded;
+}
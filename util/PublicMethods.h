@@ -16,6 +16,8 @@
 #ifndef PUBLICMETHODS_H
 #define PUBLICMETHODS_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 #ifdef _WIN32
@@ -30,6 +32,8 @@ public:
     PublicMethods& operator=(const PublicMethods&) = delete;
     PublicMethods(const PublicMethods&) = delete;
     static uint32_t Ulltoa(uintptr_t value, int8_t (&rstStr)[MAX_ITOA_BIT]);
+    // Standard base64 with padding, for binary data in json results.
+    static std::string Base64Encode(const uint8_t* data, size_t length);
 };
 
 #endif // LOCALSOCKET_H
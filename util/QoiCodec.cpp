@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QoiCodec.h"
+
+#include <cstring>
+
+namespace {
+    const uint8_t QOI_OP_INDEX = 0x00;
+    const uint8_t QOI_OP_DIFF = 0x40;
+    const uint8_t QOI_OP_LUMA = 0x80;
+    const uint8_t QOI_OP_RUN = 0xC0;
+    const uint8_t QOI_OP_RGB = 0xFE;
+    const uint8_t QOI_OP_RGBA = 0xFF;
+    const uint8_t QOI_MASK = 0xC0;
+    const uint8_t QOI_CHANNELS = 4;
+    const size_t QOI_HEADER_SIZE = 14;
+    const size_t QOI_INDEX_SIZE = 64;
+    const size_t QOI_MAX_PIXEL_SIZE = 5; // QOI_OP_RGBA
+    const size_t QOI_MAX_STEP_SIZE = 6; // a pending run and QOI_OP_RGBA
+    const int32_t QOI_MAX_RUN = 62;
+    const uint8_t QOI_PADDING[] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    const uint8_t QOI_MAGIC[] = { 'q', 'o', 'i', 'f' };
+
+    struct Pixel {
+        uint8_t r;
+        uint8_t g;
+        uint8_t b;
+        uint8_t a;
+
+        bool operator==(const Pixel& other) const
+        {
+            return r == other.r && g == other.g && b == other.b && a == other.a;
+        }
+    };
+
+    size_t Hash(const Pixel& px)
+    {
+        return (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % QOI_INDEX_SIZE; // 3, 5, 7, 11: qoi hash primes
+    }
+
+    void Write32(uint8_t* dst, uint32_t value)
+    {
+        dst[0] = static_cast<uint8_t>(value >> 24); // 24: big endian, highest byte
+        dst[1] = static_cast<uint8_t>(value >> 16); // 16: second byte
+        dst[2] = static_cast<uint8_t>(value >> 8); // 2: third byte, 8: shift
+        dst[3] = static_cast<uint8_t>(value); // 3: lowest byte
+    }
+
+    uint32_t Read32(const uint8_t* src)
+    {
+        // 2, 3: third and lowest byte; 24, 16, 8: byte shifts
+        return (static_cast<uint32_t>(src[0]) << 24) | (static_cast<uint32_t>(src[1]) << 16) |
+            (static_cast<uint32_t>(src[2]) << 8) | src[3];
+    }
+
+    void EncodeColor(const Pixel& px, const Pixel& prev, uint8_t*& out)
+    {
+        if (px.a != prev.a) {
+            *out++ = QOI_OP_RGBA;
+            *out++ = px.r;
+            *out++ = px.g;
+            *out++ = px.b;
+            *out++ = px.a;
+            return;
+        }
+        int8_t vr = static_cast<int8_t>(px.r - prev.r);
+        int8_t vg = static_cast<int8_t>(px.g - prev.g);
+        int8_t vb = static_cast<int8_t>(px.b - prev.b);
+        int8_t vgr = static_cast<int8_t>(vr - vg);
+        int8_t vgb = static_cast<int8_t>(vb - vg);
+        // -2..1 per channel fits 2 bits, -32..31 green with -8..7 red and blue fits the luma op
+        if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) { // -3, 2: bounds of the diff op
+            *out++ = QOI_OP_DIFF | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2); // 2: bias, 4, 2: bit positions
+        } else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) { // -9, 8, -33, 32: luma
+            *out++ = QOI_OP_LUMA | (vg + 32); // 32: bias
+            *out++ = ((vgr + 8) << 4) | (vgb + 8); // 8: bias, 4: bit position
+        } else {
+            *out++ = QOI_OP_RGB;
+            *out++ = px.r;
+            *out++ = px.g;
+            *out++ = px.b;
+        }
+    }
+}
+
+FrameCodecId QoiCodec::GetId() const
+{
+    return FrameCodecId::QOI;
+}
+
+size_t QoiCodec::Encode(const uint8_t* data, int32_t width, int32_t height, uint8_t* dst, size_t capacity)
+{
+    if (data == nullptr || dst == nullptr || width < 1 || height < 1 ||
+        capacity < QOI_HEADER_SIZE + sizeof(QOI_PADDING)) {
+        return 0;
+    }
+    uint8_t* out = dst;
+    std::memcpy(out, QOI_MAGIC, sizeof(QOI_MAGIC));
+    Write32(out + 4, static_cast<uint32_t>(width)); // 4: after the magic
+    Write32(out + 8, static_cast<uint32_t>(height)); // 8: after the width
+    out[12] = QOI_CHANNELS; // 12: channel count
+    out[13] = 0; // 13: sRGB with linear alpha
+    out += QOI_HEADER_SIZE;
+    // Every pixel is checked against the end only when the worst case does not fit.
+    const uint8_t* limit = dst + capacity - sizeof(QOI_PADDING) - QOI_MAX_STEP_SIZE;
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    bool isBounded = QOI_HEADER_SIZE + pixelCount * QOI_MAX_PIXEL_SIZE + sizeof(QOI_PADDING) > capacity;
+
+    Pixel index[QOI_INDEX_SIZE] = {};
+    Pixel prev = { 0, 0, 0, 255 }; // 255: opaque black
+    int32_t run = 0;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        Pixel px;
+        std::memcpy(&px, data + i * QOI_CHANNELS, sizeof(px));
+        if (isBounded && out > limit) {
+            return 0;
+        }
+        if (px == prev) {
+            ++run;
+            if (run == QOI_MAX_RUN || i + 1 == pixelCount) {
+                *out++ = QOI_OP_RUN | (run - 1);
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            *out++ = QOI_OP_RUN | (run - 1);
+            run = 0;
+        }
+        size_t hash = Hash(px);
+        if (index[hash] == px) {
+            *out++ = QOI_OP_INDEX | static_cast<uint8_t>(hash);
+        } else {
+            index[hash] = px;
+            EncodeColor(px, prev, out);
+        }
+        prev = px;
+    }
+    std::memcpy(out, QOI_PADDING, sizeof(QOI_PADDING));
+    out += sizeof(QOI_PADDING);
+    return static_cast<size_t>(out - dst);
+}
+
+bool QoiCodec::Decode(const uint8_t* data, size_t length, int32_t width, int32_t height, uint8_t* dst)
+{
+    if (data == nullptr || dst == nullptr || length < QOI_HEADER_SIZE + sizeof(QOI_PADDING) ||
+        std::memcmp(data, QOI_MAGIC, sizeof(QOI_MAGIC)) != 0 ||
+        Read32(data + 4) != static_cast<uint32_t>(width) || Read32(data + 8) != static_cast<uint32_t>(height)) {
+        return false; // 4, 8: width and height in the header
+    }
+    const uint8_t* in = data + QOI_HEADER_SIZE;
+    const uint8_t* end = data + length - sizeof(QOI_PADDING);
+    Pixel index[QOI_INDEX_SIZE] = {};
+    Pixel px = { 0, 0, 0, 255 }; // 255: opaque black
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    int32_t run = 0;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        if (run > 0) {
+            --run;
+        } else {
+            if (in >= end) {
+                return false;
+            }
+            uint8_t op = *in++;
+            if (op == QOI_OP_RGB || op == QOI_OP_RGBA) {
+                size_t size = (op == QOI_OP_RGB) ? 3 : 4; // 3, 4: rgb or rgba bytes follow
+                if (static_cast<size_t>(end - in) < size) {
+                    return false;
+                }
+                px.r = in[0];
+                px.g = in[1];
+                px.b = in[2]; // 2: blue
+                px.a = (op == QOI_OP_RGBA) ? in[3] : px.a; // 3: alpha
+                in += size;
+            } else if ((op & QOI_MASK) == QOI_OP_INDEX) {
+                px = index[op];
+            } else if ((op & QOI_MASK) == QOI_OP_DIFF) {
+                px.r += ((op >> 4) & 0x03) - 2; // 4: red bits, 2: bias
+                px.g += ((op >> 2) & 0x03) - 2; // 2: green bits and bias
+                px.b += (op & 0x03) - 2; // 2: bias
+            } else if ((op & QOI_MASK) == QOI_OP_LUMA) {
+                if (in >= end) {
+                    return false;
+                }
+                uint8_t next = *in++;
+                int vg = (op & 0x3F) - 32; // 32: bias
+                px.r += vg - 8 + ((next >> 4) & 0x0F); // 8: bias, 4: red bits
+                px.g += vg;
+                px.b += vg - 8 + (next & 0x0F); // 8: bias
+            } else {
+                run = op & 0x3F;
+            }
+            index[Hash(px)] = px;
+        }
+        std::memcpy(dst + i * QOI_CHANNELS, &px, sizeof(px));
+    }
+    return true;
+}
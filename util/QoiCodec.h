@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef QOICODEC_H
+#define QOICODEC_H
+
+#include "FrameCodec.h"
+
+// The "Quite OK Image" format with 4 channels: runs, a 64 entry color cache and small deltas against the previous
+// pixel. Lossless, a single pass and several times faster than png.
+class QoiCodec : public FrameCodec {
+public:
+    FrameCodecId GetId() const override;
+    size_t Encode(const uint8_t* data, int32_t width, int32_t height, uint8_t* dst, size_t capacity) override;
+    bool Decode(const uint8_t* data, size_t length, int32_t width, int32_t height, uint8_t* dst) override;
+};
+
+#endif // QOICODEC_H
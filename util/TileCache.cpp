@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TileCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include "FrameHash.h"
+
+namespace {
+    const size_t COLUMNS_POS = 2;
+    const size_t ROWS_POS = 4;
+    const size_t ATLAS_COLUMNS_POS = 6;
+    const size_t CAPACITY_POS = 8;
+    const size_t FLAGS_POS = 12;
+    const uint32_t BITS_PER_BYTE = 8;
+
+    template<class T>
+    void WriteBigEndian(uint8_t* dst, T value)
+    {
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            dst[i] = static_cast<uint8_t>(value >> ((sizeof(T) - 1 - i) * BITS_PER_BYTE));
+        }
+    }
+
+    template<class T>
+    T ReadBigEndian(const uint8_t* src)
+    {
+        T value = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            value = static_cast<T>((value << BITS_PER_BYTE) | src[i]);
+        }
+        return value;
+    }
+
+    int32_t TileCount(int32_t length)
+    {
+        return (length + TileCache::TILE_SIZE - 1) / TileCache::TILE_SIZE;
+    }
+
+    // Copies a tile of tileWidth x tileHeight into a full atlas cell, the last column and row are repeated into
+    // the rest of the cell so that the jpeg blocks at the edge stay flat.
+    void CopyToCell(const uint8_t* tile, size_t stride, int32_t tileWidth, int32_t tileHeight, uint8_t* cell,
+                    size_t cellStride, size_t pixelSize)
+    {
+        for (int32_t y = 0; y < TileCache::TILE_SIZE; ++y) {
+            const uint8_t* src = tile + static_cast<size_t>(std::min(y, tileHeight - 1)) * stride;
+            uint8_t* dst = cell + static_cast<size_t>(y) * cellStride;
+            std::copy(src, src + tileWidth * pixelSize, dst);
+            for (int32_t x = tileWidth; x < TileCache::TILE_SIZE; ++x) {
+                std::copy(src + (tileWidth - 1) * pixelSize, src + tileWidth * pixelSize, dst + x * pixelSize);
+            }
+        }
+    }
+}
+
+void TileCache::Configure(bool enable, uint32_t tileCapacity)
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    enabled = enable;
+    capacity = std::clamp(tileCapacity, MIN_CAPACITY, MAX_CAPACITY);
+    resetRequested = true;
+    Clear();
+}
+
+bool TileCache::IsEnabled() const
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    return enabled;
+}
+
+uint32_t TileCache::GetCapacity() const
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    return capacity;
+}
+
+void TileCache::RequestReset()
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    resetRequested = true;
+}
+
+size_t TileCache::GetTableSize(int32_t width, int32_t height)
+{
+    if (width < 1 || height < 1) {
+        return 0;
+    }
+    return TABLE_HEAD_SIZE + static_cast<size_t>(TileCount(width)) * TileCount(height) * sizeof(uint64_t);
+}
+
+size_t TileCache::GetAtlasSize(int32_t width, int32_t height)
+{
+    if (width < 1 || height < 1) {
+        return 0;
+    }
+    return static_cast<size_t>(TileCount(width)) * TileCount(height) * TILE_SIZE * TILE_SIZE * PIXEL_SIZE;
+}
+
+size_t TileCache::Encode(const uint8_t* data, int32_t width, int32_t height, uint32_t salt, uint32_t connection,
+                         uint8_t* dst, size_t capacityOfDst, TileAtlas& atlas, bool& isReset)
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    size_t tableSize = GetTableSize(width, height);
+    if (!enabled || data == nullptr || dst == nullptr || tableSize == 0 || tableSize > capacityOfDst ||
+        width > UINT16_MAX || height > UINT16_MAX) {
+        return 0;
+    }
+    isReset = resetRequested || connection != cacheConnection;
+    if (isReset) {
+        Clear();
+        cacheConnection = connection;
+        resetRequested = false;
+    }
+    int32_t columns = TileCount(width);
+    int32_t rows = TileCount(height);
+    size_t stride = static_cast<size_t>(width) * PIXEL_SIZE;
+    uint8_t* entry = dst + TABLE_HEAD_SIZE;
+    missing.clear();
+    for (int32_t row = 0; row < rows; ++row) {
+        for (int32_t column = 0; column < columns; ++column) {
+            int32_t tileWidth = std::min(TILE_SIZE, width - column * TILE_SIZE);
+            int32_t tileHeight = std::min(TILE_SIZE, height - row * TILE_SIZE);
+            // 32, 16: the salt and the tile size seed the hash, an edge tile never matches a full one.
+            uint64_t hash = (static_cast<uint64_t>(salt) << 32) | (static_cast<uint64_t>(tileWidth) << 16) |
+                static_cast<uint64_t>(tileHeight);
+            const uint8_t* tile = data + static_cast<size_t>(row) * TILE_SIZE * stride +
+                static_cast<size_t>(column) * TILE_SIZE * PIXEL_SIZE;
+            for (int32_t y = 0; y < tileHeight; ++y) {
+                hash = FrameHash::Hash64(tile + y * stride, tileWidth * PIXEL_SIZE, hash);
+            }
+            hash &= ~NEW_TILE_BIT;
+            if (!Touch(hash)) {
+                missing.push_back(static_cast<uint32_t>(row * columns + column));
+                hash |= NEW_TILE_BIT;
+            }
+            WriteBigEndian<uint64_t>(entry, hash);
+            entry += sizeof(uint64_t);
+        }
+    }
+    atlas.tileCount = static_cast<uint32_t>(missing.size());
+    atlas.atlasColumns = std::min(static_cast<int32_t>(missing.size()), columns);
+    atlas.width = atlas.atlasColumns * TILE_SIZE;
+    atlas.height = (atlas.atlasColumns == 0) ? 0 :
+        static_cast<int32_t>((missing.size() + atlas.atlasColumns - 1) / atlas.atlasColumns) * TILE_SIZE;
+    size_t atlasStride = static_cast<size_t>(atlas.width) * PIXEL_SIZE;
+    atlas.pixels.resize(atlasStride * atlas.height);
+    for (size_t i = 0; i < missing.size(); ++i) {
+        int32_t row = static_cast<int32_t>(missing[i]) / columns;
+        int32_t column = static_cast<int32_t>(missing[i]) % columns;
+        const uint8_t* tile = data + static_cast<size_t>(row) * TILE_SIZE * stride +
+            static_cast<size_t>(column) * TILE_SIZE * PIXEL_SIZE;
+        uint8_t* cell = atlas.pixels.data() + (i / atlas.atlasColumns) * TILE_SIZE * atlasStride +
+            (i % atlas.atlasColumns) * TILE_SIZE * PIXEL_SIZE;
+        CopyToCell(tile, stride, std::min(TILE_SIZE, width - column * TILE_SIZE),
+                   std::min(TILE_SIZE, height - row * TILE_SIZE), cell, atlasStride, PIXEL_SIZE);
+    }
+    WriteBigEndian<uint16_t>(dst, static_cast<uint16_t>(TILE_SIZE));
+    WriteBigEndian<uint16_t>(dst + COLUMNS_POS, static_cast<uint16_t>(columns));
+    WriteBigEndian<uint16_t>(dst + ROWS_POS, static_cast<uint16_t>(rows));
+    WriteBigEndian<uint16_t>(dst + ATLAS_COLUMNS_POS, static_cast<uint16_t>(atlas.atlasColumns));
+    WriteBigEndian<uint32_t>(dst + CAPACITY_POS, capacity);
+    std::fill(dst + FLAGS_POS, dst + TABLE_HEAD_SIZE, 0);
+    dst[FLAGS_POS] = isReset ? FLAG_RESET : 0;
+    return tableSize;
+}
+
+bool TileCache::Apply(const uint8_t* table, size_t length, const TileAtlas& atlas, int32_t width, int32_t height,
+                      uint8_t* frame)
+{
+    if (table == nullptr || frame == nullptr || length < TABLE_HEAD_SIZE || length != GetTableSize(width, height)) {
+        return false;
+    }
+    int32_t columns = ReadBigEndian<uint16_t>(table + COLUMNS_POS);
+    int32_t rows = ReadBigEndian<uint16_t>(table + ROWS_POS);
+    int32_t atlasColumns = ReadBigEndian<uint16_t>(table + ATLAS_COLUMNS_POS);
+    if (ReadBigEndian<uint16_t>(table) != TILE_SIZE || columns != TileCount(width) || rows != TileCount(height)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    if ((table[FLAGS_POS] & FLAG_RESET) != 0) {
+        Clear();
+    }
+    capacity = std::clamp(ReadBigEndian<uint32_t>(table + CAPACITY_POS), MIN_CAPACITY, MAX_CAPACITY);
+    size_t stride = static_cast<size_t>(width) * PIXEL_SIZE;
+    size_t atlasStride = static_cast<size_t>(atlas.width) * PIXEL_SIZE;
+    uint32_t atlasIndex = 0;
+    const uint8_t* entry = table + TABLE_HEAD_SIZE;
+    for (int32_t row = 0; row < rows; ++row) {
+        for (int32_t column = 0; column < columns; ++column) {
+            uint64_t hash = ReadBigEndian<uint64_t>(entry);
+            entry += sizeof(uint64_t);
+            size_t tileStride = static_cast<size_t>(std::min(TILE_SIZE, width - column * TILE_SIZE)) * PIXEL_SIZE;
+            int32_t tileHeight = std::min(TILE_SIZE, height - row * TILE_SIZE);
+            std::vector<uint8_t> pixels;
+            if ((hash & NEW_TILE_BIT) != 0) {
+                hash &= ~NEW_TILE_BIT;
+                if (atlasColumns == 0 || atlasColumns * TILE_SIZE > atlas.width ||
+                    static_cast<int32_t>(atlasIndex / atlasColumns + 1) * TILE_SIZE > atlas.height ||
+                    atlas.pixels.size() < atlasStride * atlas.height) {
+                    return false;
+                }
+                const uint8_t* cell = atlas.pixels.data() + (atlasIndex / atlasColumns) * TILE_SIZE * atlasStride +
+                    (atlasIndex % atlasColumns) * TILE_SIZE * PIXEL_SIZE;
+                for (int32_t y = 0; y < tileHeight; ++y) {
+                    pixels.insert(pixels.end(), cell + y * atlasStride, cell + y * atlasStride + tileStride);
+                }
+                atlasIndex++;
+                Touch(hash);
+                tiles[hash] = std::move(pixels);
+            } else if (!Touch(hash)) {
+                return false; // the client lost track of the server cache, it waits for the next reset
+            }
+            const std::vector<uint8_t>& tile = tiles[hash];
+            if (tile.size() != tileStride * tileHeight) {
+                return false;
+            }
+            uint8_t* dst = frame + static_cast<size_t>(row) * TILE_SIZE * stride + column * TILE_SIZE * PIXEL_SIZE;
+            for (int32_t y = 0; y < tileHeight; ++y) {
+                std::copy(tile.data() + y * tileStride, tile.data() + (y + 1) * tileStride, dst + y * stride);
+            }
+        }
+    }
+    return true;
+}
+
+bool TileCache::Touch(uint64_t hash)
+{
+    auto found = entries.find(hash);
+    if (found != entries.end()) {
+        lru.splice(lru.begin(), lru, found->second);
+        return true;
+    }
+    lru.push_front(hash);
+    entries[hash] = lru.begin();
+    if (lru.size() > capacity) {
+        entries.erase(lru.back());
+        tiles.erase(lru.back());
+        lru.pop_back();
+    }
+    return false;
+}
+
+void TileCache::Clear()
+{
+    lru.clear();
+    entries.clear();
+    tiles.clear();
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TILECACHE_H
+#define TILECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// The tiles of a frame the client does not hold, TileCache::TILE_SIZE apart in rows of atlasColumns.
+struct TileAtlas {
+    std::vector<uint8_t> pixels;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t atlasColumns = 0;
+    uint32_t tileCount = 0;
+};
+
+// Tile cache of the full frames: the frame is cut into TILE_SIZE squares and a tile the client still holds goes
+// out as its hash only. Server and client run the same LRU of tile hashes and update it tile by tile in frame
+// order, so a hash either names a cached tile or, with NEW_TILE_BIT, the next tile of the atlas.
+// The table, in network byte order: u16 tile size, u16 columns, u16 rows, u16 atlas columns, u32 capacity,
+// u8 flags and 3 reserved bytes, then a u64 hash per tile, row by row.
+class TileCache {
+public:
+    static constexpr int32_t TILE_SIZE = 64;
+    static constexpr uint32_t DEFAULT_CAPACITY = 2048; // tiles, 32 MB of RGBA on the client
+    static constexpr uint32_t MIN_CAPACITY = 64;
+    static constexpr uint32_t MAX_CAPACITY = 16384;
+    static constexpr size_t TABLE_HEAD_SIZE = 16;
+    static constexpr uint8_t FLAG_RESET = 0x01; // the client empties its cache before reading the table
+    static constexpr uint64_t NEW_TILE_BIT = 1ULL << 63;
+
+    void Configure(bool enable, uint32_t tileCapacity);
+    bool IsEnabled() const;
+    uint32_t GetCapacity() const;
+    // The next frame starts over from an empty cache, after the client may have missed a frame.
+    void RequestReset();
+    static size_t GetTableSize(int32_t width, int32_t height);
+    // The atlas of a frame whose tiles are all new, in bytes.
+    static size_t GetAtlasSize(int32_t width, int32_t height);
+    // Writes the table of the frame to dst and the tiles the client lacks to atlas. The salt goes into every tile
+    // hash, tiles encoded at another quality do not match. Returns the table size, 0 on failure. isReset tells
+    // that the cache started over with this frame, a reconnecting client can replay from it.
+    size_t Encode(const uint8_t* data, int32_t width, int32_t height, uint32_t salt, uint32_t connection,
+                  uint8_t* dst, size_t capacity, TileAtlas& atlas, bool& isReset);
+    // Client side of Encode: frame is assembled from the cached tiles and the decoded atlas.
+    bool Apply(const uint8_t* table, size_t length, const TileAtlas& atlas, int32_t width, int32_t height,
+               uint8_t* frame);
+
+private:
+    static constexpr size_t PIXEL_SIZE = 4;
+    // Moves hash to the front, false when it was not cached. A new hash is inserted and the oldest one dropped.
+    bool Touch(uint64_t hash);
+    void Clear();
+
+    mutable std::mutex cacheMutex;
+    bool enabled = false;
+    bool resetRequested = true;
+    uint32_t capacity = DEFAULT_CAPACITY;
+    uint32_t cacheConnection = 0;
+    std::list<uint64_t> lru; // most recently used first
+    std::unordered_map<uint64_t, std::list<uint64_t>::iterator> entries;
+    std::unordered_map<uint64_t, std::vector<uint8_t>> tiles; // client side, the pixels of every entry
+    std::vector<uint32_t> missing; // tile indexes of the frame being encoded that go to the atlas
+};
+
+#endif // TILECACHE_H
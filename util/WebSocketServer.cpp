@@ -13,22 +13,26 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <atomic>
+#include <cctype>
+#include <cstring>
 #include <thread>
-#include "securec.h"
 #include "CommandLineInterface.h"
 #include "PreviewerEngineLog.h"
 #include "WebSocketServer.h"
 
-lws* WebSocketServer::webSocket = nullptr;
 std::atomic<bool> WebSocketServer::interrupted = false;
-WebSocketServer::WebSocketState WebSocketServer::webSocketWritable = WebSocketState::INIT;
-uint8_t* WebSocketServer::firstImageBuffer = nullptr;
-uint64_t WebSocketServer::firstImagebufferSize = 0;
+std::shared_ptr<SendPacket> WebSocketServer::firstImage;
+std::vector<std::shared_ptr<SendPacket>> WebSocketServer::regionImages;
+std::vector<std::shared_ptr<SendPacket>> WebSocketServer::variantImages;
+std::atomic<uint32_t> WebSocketServer::connectionCount = 0;
 
-WebSocketServer::WebSocketServer() : serverThread(nullptr), serverPort(0)
+WebSocketServer::WebSocketServer()
+    : serverThread(nullptr), serverPort(0),
+      router([this](int32_t variant) { return GetLastImagePackets(variant); })
 {
-    protocols[0] = {"ws", WebSocketServer::ProtocolCallback, 0, MAX_PAYLOAD_SIZE};
+    protocols[0] = {"ws", WebSocketServer::ProtocolCallback, sizeof(SessionData), MAX_PAYLOAD_SIZE};
     protocols[1] = {NULL, NULL, 0, 0};
 }
 
@@ -50,6 +54,11 @@ void WebSocketServer::SetSid(const std::string curSid)
     sid = curSid;
 }
 
+void WebSocketServer::SetVariantCount(int32_t count)
+{
+    variantCount = count;
+}
+
 bool WebSocketServer::CheckSid(struct lws* wsi)
 {
     if (WebSocketServer::GetInstance().sid.empty()) {
@@ -78,6 +87,145 @@ bool WebSocketServer::CheckSid(struct lws* wsi)
     }
 }
 
+int32_t WebSocketServer::ParseVariant(struct lws* wsi)
+{
+    char value[WebSocketServer::variantMaxLength] = {0};
+    if (lws_get_urlarg_by_name(wsi, "variant=", value, sizeof(value)) == nullptr) {
+        return 0;
+    }
+    std::string variant(value); // a few digits at most, atoi cannot overflow
+    bool isNumber = !variant.empty() && std::all_of(variant.begin(), variant.end(),
+        [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+    if (!isNumber || atoi(variant.c_str()) > WebSocketServer::GetInstance().variantCount) {
+        ELOG("Websocket variant %s is not configured.", variant.c_str());
+        return -1;
+    }
+    return atoi(variant.c_str());
+}
+
+bool WebSocketServer::ParseClientName(struct lws* wsi, SessionData& session)
+{
+    char value[WebSocketServer::clientNameMaxLength + 2] = {0}; // 2: one character too many and the terminator
+    if (lws_get_urlarg_by_name(wsi, "client=", value, sizeof(value)) == nullptr) {
+        return true;
+    }
+    std::string name(value);
+    bool isValid = !name.empty() && name.size() <= static_cast<size_t>(WebSocketServer::clientNameMaxLength) &&
+        std::all_of(name.begin(), name.end(),
+            [](char c) { return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '-' || c == '_'; });
+    if (!isValid) {
+        ELOG("Websocket client name %s is invalid.", name.c_str());
+        return false;
+    }
+    std::copy(name.begin(), name.end(), session.name);
+    session.name[name.size()] = '\0';
+    return true;
+}
+
+std::shared_ptr<SendPacket> WebSocketServer::MakePacket(const uint8_t* data, size_t length)
+{
+    std::shared_ptr<SendPacket> packet = SendPacket::Copy(data, length, LWS_PRE);
+    if (!packet) {
+        ELOG("Memory allocation failed : websocket packet.");
+    }
+    return packet;
+}
+
+std::vector<std::shared_ptr<SendPacket>> WebSocketServer::GetLastImagePackets(int32_t variant)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    return ClientRouter::SelectBackups(variant, firstImage, regionImages, variantImages);
+}
+
+bool WebSocketServer::AddClient(struct lws* wsi, int32_t variant, const std::string& name)
+{
+    if (!router.Add(wsi, variant, name)) {
+        ELOG("Memory allocation failed : websocket client.");
+        return false;
+    }
+    {
+        // A client of a viewport gets the crop the connect handler asks for.
+        std::lock_guard<std::mutex> guard(clientsMutex);
+        ILOG("Websocket clients: %zu", router.GetCount());
+        connectionCount++;
+        if (connectHandler) {
+            connectHandler(); // under the lock, SetConnectHandler(nullptr) waits for it
+        }
+    }
+    clientsCondition.notify_all();
+    lws_callback_on_writable(wsi);
+    return true;
+}
+
+void WebSocketServer::RemoveClient(struct lws* wsi)
+{
+    router.Remove(wsi);
+}
+
+bool WebSocketServer::WriteClient(struct lws* wsi)
+{
+    std::shared_ptr<ClientRouter::Client> client = router.Find(wsi);
+    if (!client) {
+        return true;
+    }
+    size_t offset = 0;
+    std::shared_ptr<SendPacket> packet = client->queue.GetFront(offset);
+    if (!packet) {
+        return true;
+    }
+    if (lws_send_pipe_choked(wsi)) {
+        lws_callback_on_writable(wsi);
+        return true;
+    }
+    int ret = WriteFragment(wsi, *packet, offset);
+    if (ret < 0) {
+        ELOG("lws_write failed at offset %zu, error = %s", offset, strerror(errno));
+        return false;
+    }
+    bool isFirstClient = !packet->isWritten; // Advance runs on this thread only
+    if (client->queue.Advance(static_cast<size_t>(ret))) {
+        auto now = std::chrono::steady_clock::now();
+        if (isFirstClient) {
+            drainUs += std::chrono::duration_cast<std::chrono::microseconds>(
+                now - std::max(packet->queuedTime, client->lastWrittenTime)).count();
+        }
+        client->lastWrittenTime = now;
+    }
+    if (!client->queue.IsEmpty()) {
+        lws_callback_on_writable(wsi);
+    }
+    return true;
+}
+
+int WebSocketServer::WriteFragment(struct lws* wsi, SendPacket& packet, size_t offset)
+{
+    size_t remaining = packet.GetSize() - offset;
+    size_t toWrite = std::min(remaining, static_cast<size_t>(MAX_PAYLOAD_SIZE));
+    bool isLastFragment = toWrite == remaining;
+    int flags = offset == 0 ? LWS_WRITE_BINARY : LWS_WRITE_CONTINUATION;
+    if (!isLastFragment) {
+        flags |= LWS_WRITE_NO_FIN;
+    }
+    // lws puts the frame header in the LWS_PRE bytes before the fragment. Past the first fragment they belong to
+    // the packet, which the other clients and the backups share, so the fragment is written from a copy.
+    uint8_t* fragment = packet.GetData() + offset;
+    if (offset != 0) {
+        fragmentBuffer.resize(LWS_PRE + toWrite);
+        std::copy(fragment, fragment + toWrite, fragmentBuffer.data() + LWS_PRE);
+        fragment = fragmentBuffer.data() + LWS_PRE;
+    }
+    int ret = lws_write(wsi, fragment, toWrite, static_cast<enum lws_write_protocol>(flags));
+    // A partial send is kept by lws and flushed before the next writable callback, the fragment went out.
+    return ret < 0 ? ret : static_cast<int>(toWrite);
+}
+
+void WebSocketServer::RequestWritable()
+{
+    for (void* handle : router.GetPendingHandles()) {
+        lws_callback_on_writable(static_cast<lws*>(handle));
+    }
+}
+
 int WebSocketServer::ProtocolCallback(struct lws* wsi, enum lws_callback_reasons reason,
     void* user, void* in, size_t len)
 {
@@ -86,33 +234,35 @@ int WebSocketServer::ProtocolCallback(struct lws* wsi, enum lws_callback_reasons
             if (!CheckSid(wsi)) {
                 return 1; // 1 is connection denied
             }
+            static_cast<SessionData*>(user)->variant = ParseVariant(wsi);
+            if (static_cast<SessionData*>(user)->variant < 0 ||
+                !ParseClientName(wsi, *static_cast<SessionData*>(user))) {
+                return 1; // 1 is connection denied
+            }
             break;
         case LWS_CALLBACK_PROTOCOL_INIT:
             ILOG("Engine Websocket protocol init");
             break;
         case LWS_CALLBACK_ESTABLISHED:
             ILOG("Websocket client connect");
-            webSocket = wsi;
-            lws_callback_on_writable(wsi);
+            if (!GetInstance().AddClient(wsi, static_cast<SessionData*>(user)->variant,
+                                         static_cast<SessionData*>(user)->name)) {
+                return -1; // -1 closes the connection
+            }
             break;
         case LWS_CALLBACK_RECEIVE:
             break;
         case LWS_CALLBACK_SERVER_WRITEABLE:
-            ILOG("Engine websocket server writeable");
-            if (firstImagebufferSize > 0 && webSocketWritable == WebSocketState::UNWRITEABLE &&
-                firstImageBuffer != nullptr) {
-                ILOG("Send last image after websocket reconnected");
-                std::lock_guard<std::mutex> guard(WebSocketServer::GetInstance().mutex);
-                lws_write(wsi,
-                          firstImageBuffer + LWS_PRE,
-                          firstImagebufferSize,
-                          LWS_WRITE_BINARY);
+            if (!GetInstance().WriteClient(wsi)) {
+                return -1; // -1 closes the connection
             }
-            webSocketWritable = WebSocketState::WRITEABLE;
+            break;
+        case LWS_CALLBACK_EVENT_WAIT_CANCELLED:
+            GetInstance().RequestWritable();
             break;
         case LWS_CALLBACK_CLOSED:
             ILOG("Websocket client connection closed");
-            webSocketWritable = WebSocketState::UNWRITEABLE;
+            GetInstance().RemoveClient(wsi);
             break;
         default:
             break;
@@ -144,11 +294,13 @@ void WebSocketServer::StartWebsocketListening()
         ELOG("WebSocketServer::StartWebsocketListening context memory allocation failed");
         return;
     }
+    serviceContext = context;
     while (!interrupted) {
         if (lws_service(context, WEBSOCKET_SERVER_TIMEOUT)) {
             interrupted = true;
         }
     }
+    serviceContext = nullptr;
     lws_context_destroy(context);
 }
 
@@ -164,93 +316,66 @@ void WebSocketServer::Run()
     serverThread->detach();
 }
 
-int WebSocketServer::WriteChunk(unsigned char* data, size_t offset, size_t toWrite, bool isLastFrame)
+size_t WebSocketServer::WriteData(unsigned char* data, size_t length, int32_t variant,
+                                  const FrameViewport& viewport)
 {
-    if (webSocket == nullptr) {
-        ELOG("WriteChunk called with null webSocket.");
-        return -1;
-    }
-    size_t totalBufSize = LWS_PRE + toWrite;
-    unsigned char* sendBuf = (unsigned char*)malloc(totalBufSize);
-    if (!sendBuf) {
-        ELOG("Failed to allocate send buffer for chunk at offset %zu.", offset);
-        return -1;
-    }
-    if (EOK != memset_s(sendBuf, totalBufSize, 0, totalBufSize)) {
-        free(sendBuf);
-        ELOG("sendBuf memset_s failed.");
-        return -1;
-    }
-    if (EOK != memcpy_s(sendBuf + LWS_PRE, totalBufSize - LWS_PRE, data + offset, toWrite)) {
-        free(sendBuf);
-        ELOG("sendBuf memcpy_s failed.");
-        return -1;
-    }
-
-    enum lws_write_protocol flags;
-    if (offset == 0) {
-        flags = isLastFrame ? LWS_WRITE_BINARY : (enum lws_write_protocol)(LWS_WRITE_BINARY | LWS_WRITE_NO_FIN);
-    } else {
-        flags = isLastFrame ? LWS_WRITE_CONTINUATION :
-            (enum lws_write_protocol)(LWS_WRITE_CONTINUATION | LWS_WRITE_NO_FIN);
+    if (data == nullptr || length == 0) {
+        return 0;
     }
-    int ret = lws_write(webSocket, sendBuf + LWS_PRE, toWrite, flags);
-    free(sendBuf);
+    return WriteData(MakePacket(data, length), variant, viewport);
+}
 
-    if (ret < 0) {
-        ELOG("lws_write failed at offset %zu, error = %s", offset, strerror(errno));
-        return -1;
+size_t WebSocketServer::WriteData(const std::shared_ptr<SendPacket>& packet, int32_t variant,
+                                  const FrameViewport& viewport)
+{
+    if (packet == nullptr || packet->GetSize() == 0) {
+        return 0;
     }
-    if (ret == 0) {
-        WLOG("lws_write busy at offset %zu, will retry", offset);
+    if (router.Route(packet, variant, viewport) == 0) {
         return 0;
     }
-    if (static_cast<size_t>(ret) != toWrite) {
-        WLOG("lws_write partial send at offset %zu, sent = %d,expected = %zu", offset, ret, toWrite);
+    lws_context* context = serviceContext;
+    if (context != nullptr) {
+        lws_cancel_service(context); // the service thread asks for the writable callbacks
     }
-    return ret;
+    return packet->GetSize();
 }
 
-size_t WebSocketServer::WriteData(unsigned char* data, size_t length)
+bool WebSocketServer::HasClients()
 {
-    while (webSocketWritable != WebSocketState::WRITEABLE) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
-    if (webSocket == nullptr || webSocketWritable != WebSocketState::WRITEABLE) {
-        return 0;
-    }
-    size_t written = 0;
-    const size_t chunkSize = MAX_PAYLOAD_SIZE;
-    while (written < length) {
-        size_t remaining = length - written;
-        size_t toWrite = (remaining < chunkSize) ? remaining : chunkSize;
-        bool isLastFrame = (written + toWrite >= length);
+    return router.GetCount() > 0;
+}
 
-        int sendRet = WriteChunk(data, written, toWrite, isLastFrame);
-        if (sendRet < 0) {
-            ELOG("WriteChunk fatal error at written = %zu", written);
-            break;
-        } else if (sendRet == 0) {
-            webSocketWritable = WebSocketState::UNWRITEABLE;
-            if (webSocket != nullptr) {
-                lws_callback_on_writable(webSocket);
-            }
-            while (webSocket != nullptr && webSocketWritable != WebSocketState::WRITEABLE) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            }
-            if (webSocket == nullptr) {
-                ELOG("webSocket disconnected while waiting for writable");
-                break;
-            }
-            continue;
-        } else {
-            written += sendRet;
-            if (written < length) {
-                const int timeOut = 30;
-                std::this_thread::sleep_for(std::chrono::milliseconds(timeOut));
-            }
-        }
+bool WebSocketServer::HasClient(int32_t variant)
+{
+    return router.HasClient(variant);
+}
+
+void WebSocketServer::SetViewport(const std::string& name, const FrameViewport& viewport)
+{
+    if (router.SetViewport(name, viewport)) {
+        connectionCount++; // the full stream starts over for them as it does for a new connection
     }
-    ILOG("lws_write fragmented:total = %zu, written = %zu", length, written);
-    return written;
+}
+
+std::vector<FrameViewport> WebSocketServer::GetViewports()
+{
+    return router.GetViewports();
+}
+
+void WebSocketServer::SetConnectHandler(std::function<void()> handler)
+{
+    std::lock_guard<std::mutex> guard(clientsMutex);
+    connectHandler = std::move(handler);
+}
+
+bool WebSocketServer::WaitForClient(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(clientsMutex);
+    return clientsCondition.wait_for(lock, timeout, [this]() { return router.GetCount() > 0; });
+}
+
+int64_t WebSocketServer::TakeDrainUs()
+{
+    return drainUs.exchange(0);
 }
@@ -16,11 +16,19 @@
 #ifndef WEBSOCKETSERVER_H
 #define WEBSOCKETSERVER_H
 
+#include <atomic>
+#include <chrono>
 #include <thread>
+#include <condition_variable>
 #include <csignal>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 #include "libwebsockets.h"
+#include "ClientRouter.h"
 
 class WebSocketServer {
 public:
@@ -29,33 +37,96 @@ public:
     static WebSocketServer& GetInstance();
     void SetServerPort(int port);
     void SetSid(const std::string curSid);
+    // Simulcast variants beside the full stream, a client asks for one with ?variant=<1..count> in its URL.
+    void SetVariantCount(int32_t count);
+    // A client of the full stream that names itself with ?client=<name> in its URL gets the crop of its own
+    // viewport instead of the full stream. An empty name sets the viewport of every client of the full stream and
+    // of the ones that connect later without a viewport of their own.
+    void SetViewport(const std::string& name, const FrameViewport& viewport);
+    // The viewports clients show, each once.
+    std::vector<FrameViewport> GetViewports();
     static int ProtocolCallback(struct lws* wsi, enum lws_callback_reasons reason, void* user, void* in, size_t len);
     void StartWebsocketListening();
     void Run();
-    size_t WriteData(unsigned char* data, size_t length);
-    enum class WebSocketState { INIT = -1, UNWRITEABLE = 0, WRITEABLE = 1 };
-    static WebSocketState webSocketWritable;
-    static uint8_t* firstImageBuffer;
-    static uint64_t firstImagebufferSize;
+    // Queues the packet for every client of the variant and returns, each client has its own queue drained by
+    // the service thread. A client that falls behind only loses packets of its own queue, it is brought up to
+    // date from the backups below. Returns 0 without queueing when no client takes the variant. A crop goes to
+    // the clients of the viewport only, the full stream to the clients without one. The packet is shared, not
+    // copied, it may be a backup as well.
+    size_t WriteData(const std::shared_ptr<SendPacket>& packet, int32_t variant = 0,
+                     const FrameViewport& viewport = FrameViewport());
+    // Copies the data first, for a sender that reuses its buffer.
+    size_t WriteData(unsigned char* data, size_t length, int32_t variant = 0,
+                     const FrameViewport& viewport = FrameViewport());
+    static std::shared_ptr<SendPacket> MakePacket(const uint8_t* data, size_t length);
+    // Frames need not be encoded while it is false, the connect handler asks for the current one.
+    bool HasClients();
+    // A variant nobody takes need not be encoded. The clients with a viewport do not take the full stream.
+    bool HasClient(int32_t variant);
+    // Called on the service thread after a client connected, it must not block.
+    void SetConnectHandler(std::function<void()> handler);
+    // False when no client connected within timeout.
+    bool WaitForClient(std::chrono::milliseconds timeout);
+    // How long the packets written since the last call took to go out to the fastest client, the time they waited
+    // behind earlier packets of the client excluded.
+    int64_t TakeDrainUs();
+    // The last complete frame of the full stream. The backups below share their packets with the client queues.
+    static std::shared_ptr<SendPacket> firstImage;
+    // Region frames sent after firstImage. They are replayed after it, in order, so that a client that
+    // reconnects ends up with the picture the previous one had.
+    static std::vector<std::shared_ptr<SendPacket>> regionImages;
+    // Last frame of every simulcast variant, the one at n - 1 is sent to a client of variant n when it connects.
+    static std::vector<std::shared_ptr<SendPacket>> variantImages;
+    // Counts the established connections, state kept for the client of one connection is stale after the next.
+    static std::atomic<uint32_t> connectionCount;
     std::mutex mutex;
 
 private:
+    static constexpr int clientNameMaxLength = 64;
+    struct SessionData {
+        int32_t variant;
+        char name[clientNameMaxLength + 1];
+    };
+
     WebSocketServer();
     virtual ~WebSocketServer();
     static bool CheckSid(struct lws* wsi);
+    // -1 when the URL asks for a variant that is not configured.
+    static int32_t ParseVariant(struct lws* wsi);
+    // False when the URL names the client with other than letters, digits, '-' and '_'.
+    static bool ParseClientName(struct lws* wsi, SessionData& session);
+    // The backups that bring a new or lagging client of the variant to the current picture.
+    std::vector<std::shared_ptr<SendPacket>> GetLastImagePackets(int32_t variant);
     static void SignalHandler(int sig);
-    int WriteChunk(unsigned char* data, size_t offset, size_t toWrite, bool isLastFrame);
+    // The callbacks below run on the service thread.
+    bool AddClient(struct lws* wsi, int32_t variant, const std::string& name = "");
+    void RemoveClient(struct lws* wsi);
+    // Writes the next fragment queued for the client, false when the connection failed.
+    bool WriteClient(struct lws* wsi);
+    // Up to MAX_PAYLOAD_SIZE bytes of the packet from offset, the bytes written or -1.
+    int WriteFragment(struct lws* wsi, SendPacket& packet, size_t offset);
+    // WriteData queued packets, asks for a writable callback of every client with a packet to write.
+    void RequestWritable();
     std::unique_ptr<std::thread> serverThread;
     int serverPort;
     const char* serverHostname = "127.0.0.1";
     int websocketMaxConn = 1024;
-    static lws* webSocket;
     static std::atomic<bool> interrupted;
     static const int MAX_PAYLOAD_SIZE = 6400000;
+    // WriteData wakes the service with lws_cancel_service, the timeout only bounds how late an interrupt is seen.
     static const int WEBSOCKET_SERVER_TIMEOUT = 1000;
     struct lws_protocols protocols[2];
     std::string sid;
+    std::atomic<int32_t> variantCount { 0 };
+    std::atomic<lws_context*> serviceContext { nullptr };
+    ClientRouter router;
+    std::mutex clientsMutex; // for the connect handler and the condition
+    std::condition_variable clientsCondition; // a client connected
+    std::function<void()> connectHandler;
+    std::atomic<int64_t> drainUs { 0 };
+    std::vector<uint8_t> fragmentBuffer; // the fragments past the first with their headroom, service thread only
     static constexpr int sidMaxLength = 256;
+    static constexpr int variantMaxLength = 4;
 };
 
 #endif // WEBSOCKETSERVER_H
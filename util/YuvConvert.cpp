@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "YuvConvert.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define YUV_CONVERT_SSE2
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define YUV_CONVERT_NEON
+#endif
+
+namespace {
+    constexpr size_t PIXEL_SIZE = 4;
+    constexpr size_t CHANNELS = 3; // alpha is not used
+    constexpr int COEF_BITS = 14; // the coefficients are scaled by 1 << 14, they fit in int16_t
+    constexpr int32_t LUMA_ROUND = 1 << (COEF_BITS - 1);
+    // Chroma is computed from the sum of 4 pixels, which adds 2 bits to the shift.
+    constexpr int CHROMA_SHIFT = COEF_BITS + 2;
+    constexpr int32_t CHROMA_OFFSET = (128 << CHROMA_SHIFT) + (1 << (CHROMA_SHIFT - 1)); // 128: chroma zero
+    constexpr int32_t MAX_SAMPLE = 255;
+
+    struct Coefficients {
+        int16_t y[CHANNELS];
+        int16_t cb[CHANNELS];
+        int16_t cr[CHANNELS];
+    };
+
+    // Y = 0.299 R + 0.587 G + 0.114 B, Cb = 0.564 (B - Y), Cr = 0.713 (R - Y). Each row sums to 1 << 14 or to 0,
+    // so flat white and flat grey come out exact.
+    const Coefficients RGB_COEFFICIENTS = {
+        { 4899, 9617, 1868 },
+        { -2765, -5427, 8192 },
+        { 8192, -6860, -1332 },
+    };
+    const Coefficients BGR_COEFFICIENTS = {
+        { 1868, 9617, 4899 },
+        { 8192, -5427, -2765 },
+        { -1332, -6860, 8192 },
+    };
+
+    inline uint8_t Luma(const uint8_t* pixel, const Coefficients& k)
+    {
+        int32_t value = k.y[0] * pixel[0] + k.y[1] * pixel[1] + k.y[2] * pixel[2]; // 2: third channel
+        return static_cast<uint8_t>((value + LUMA_ROUND) >> COEF_BITS);
+    }
+
+    inline uint8_t Chroma(const int16_t* k, const int32_t* sum)
+    {
+        int32_t value = (k[0] * sum[0] + k[1] * sum[1] + k[2] * sum[2] + CHROMA_OFFSET) >> CHROMA_SHIFT; // 2: third
+        return static_cast<uint8_t>(std::min(value, MAX_SAMPLE));
+    }
+
+    // Pixels [x, width) of a row pair, x is even.
+    void ScalarRowPair(const uint8_t* row0, const uint8_t* row1, int32_t x, int32_t width, const Coefficients& k,
+                       uint8_t* y0, uint8_t* y1, uint8_t* cb, uint8_t* cr)
+    {
+        for (; x < width; x += 2) { // 2: one chroma sample per two pixels
+            const uint8_t* top = row0 + static_cast<size_t>(x) * PIXEL_SIZE;
+            const uint8_t* bottom = row1 + static_cast<size_t>(x) * PIXEL_SIZE;
+            size_t next = (x + 1 < width) ? PIXEL_SIZE : 0;
+            y0[x] = Luma(top, k);
+            y1[x] = Luma(bottom, k);
+            if (next != 0) {
+                y0[x + 1] = Luma(top + next, k);
+                y1[x + 1] = Luma(bottom + next, k);
+            }
+            int32_t sum[CHANNELS];
+            for (size_t c = 0; c < CHANNELS; ++c) {
+                sum[c] = top[c] + top[c + next] + bottom[c] + bottom[c + next];
+            }
+            cb[x / 2] = Chroma(k.cb, sum); // 2: chroma is subsampled horizontally
+            cr[x / 2] = Chroma(k.cr, sum); // 2: chroma is subsampled horizontally
+        }
+    }
+
+#if defined(YUV_CONVERT_SSE2)
+    constexpr int32_t SIMD_PIXELS = 8;
+
+    inline __m128i LoadCoefficients(const int16_t* k)
+    {
+        return _mm_setr_epi16(k[0], k[1], k[2], 0, k[0], k[1], k[2], 0); // 2: third channel, alpha is weighted 0
+    }
+
+    // Weighted sums of 4 pixels held as 16-bit channels, two pixels per register. madd leaves k0 c0 + k1 c1 and
+    // k2 c2 per pixel, the two halves are gathered and added.
+    inline __m128i Dot4(__m128i low, __m128i high, __m128i coefficients)
+    {
+        __m128 first = _mm_castsi128_ps(_mm_madd_epi16(low, coefficients));
+        __m128 second = _mm_castsi128_ps(_mm_madd_epi16(high, coefficients));
+        __m128i even = _mm_castps_si128(_mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i odd = _mm_castps_si128(_mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+        return _mm_add_epi32(even, odd);
+    }
+
+    inline __m128i Luma4(__m128i pixels, __m128i coefficients)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i sum = Dot4(_mm_unpacklo_epi8(pixels, zero), _mm_unpackhi_epi8(pixels, zero), coefficients);
+        return _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(LUMA_ROUND)), COEF_BITS);
+    }
+
+    inline void StoreLuma8(uint8_t* dst, __m128i first, __m128i second, __m128i coefficients)
+    {
+        __m128i luma = _mm_packs_epi32(Luma4(first, coefficients), Luma4(second, coefficients));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(luma, luma));
+    }
+
+    // The 2x2 sums of 4 pixels of two rows, 2 chroma pixels as 16-bit channels.
+    inline __m128i BlockSums(__m128i top, __m128i bottom)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+        __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+        low = _mm_add_epi16(low, _mm_srli_si128(low, 8)); // 8: the second pixel of the pair
+        high = _mm_add_epi16(high, _mm_srli_si128(high, 8)); // 8: the second pixel of the pair
+        return _mm_unpacklo_epi64(low, high);
+    }
+
+    inline void StoreChroma4(uint8_t* dst, __m128i first, __m128i second, __m128i coefficients)
+    {
+        __m128i sum = _mm_add_epi32(Dot4(first, second, coefficients), _mm_set1_epi32(CHROMA_OFFSET));
+        __m128i chroma = _mm_packs_epi32(_mm_srai_epi32(sum, CHROMA_SHIFT), _mm_setzero_si128());
+        int32_t packed = _mm_cvtsi128_si32(_mm_packus_epi16(chroma, chroma));
+        std::memcpy(dst, &packed, sizeof(packed));
+    }
+
+    int32_t SimdRowPair(const uint8_t* row0, const uint8_t* row1, int32_t width, const Coefficients& k,
+                        uint8_t* y0, uint8_t* y1, uint8_t* cb, uint8_t* cr)
+    {
+        const __m128i lumaK = LoadCoefficients(k.y);
+        const __m128i cbK = LoadCoefficients(k.cb);
+        const __m128i crK = LoadCoefficients(k.cr);
+        const size_t half = PIXEL_SIZE * SIMD_PIXELS / 2; // 2: two registers per 8 pixels
+        int32_t x = 0;
+        for (; x + SIMD_PIXELS <= width; x += SIMD_PIXELS) {
+            const uint8_t* top = row0 + static_cast<size_t>(x) * PIXEL_SIZE;
+            const uint8_t* bottom = row1 + static_cast<size_t>(x) * PIXEL_SIZE;
+            __m128i top0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top));
+            __m128i top1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + half));
+            __m128i bottom0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom));
+            __m128i bottom1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + half));
+            StoreLuma8(y0 + x, top0, top1, lumaK);
+            StoreLuma8(y1 + x, bottom0, bottom1, lumaK);
+            __m128i sums0 = BlockSums(top0, bottom0);
+            __m128i sums1 = BlockSums(top1, bottom1);
+            StoreChroma4(cb + x / 2, sums0, sums1, cbK); // 2: chroma is subsampled horizontally
+            StoreChroma4(cr + x / 2, sums0, sums1, crK); // 2: chroma is subsampled horizontally
+        }
+        return x;
+    }
+#elif defined(YUV_CONVERT_NEON)
+    constexpr int32_t SIMD_PIXELS = 8;
+
+    inline void StoreLuma8(uint8_t* dst, const uint8x8x4_t& pixels, const Coefficients& k)
+    {
+        uint16x8_t c0 = vmovl_u8(pixels.val[0]);
+        uint16x8_t c1 = vmovl_u8(pixels.val[1]);
+        uint16x8_t c2 = vmovl_u8(pixels.val[2]); // 2: third channel
+        uint32x4_t low = vmull_n_u16(vget_low_u16(c0), static_cast<uint16_t>(k.y[0]));
+        low = vmlal_n_u16(low, vget_low_u16(c1), static_cast<uint16_t>(k.y[1]));
+        low = vmlal_n_u16(low, vget_low_u16(c2), static_cast<uint16_t>(k.y[2])); // 2: third channel
+        uint32x4_t high = vmull_n_u16(vget_high_u16(c0), static_cast<uint16_t>(k.y[0]));
+        high = vmlal_n_u16(high, vget_high_u16(c1), static_cast<uint16_t>(k.y[1]));
+        high = vmlal_n_u16(high, vget_high_u16(c2), static_cast<uint16_t>(k.y[2])); // 2: third channel
+        uint16x8_t luma = vcombine_u16(vrshrn_n_u32(low, COEF_BITS), vrshrn_n_u32(high, COEF_BITS));
+        vst1_u8(dst, vqmovn_u16(luma));
+    }
+
+    inline int32x4_t BlockSums(uint8x8_t top, uint8x8_t bottom)
+    {
+        uint16x8_t sum = vaddl_u8(top, bottom);
+        return vreinterpretq_s32_u32(vmovl_u16(vpadd_u16(vget_low_u16(sum), vget_high_u16(sum))));
+    }
+
+    inline void StoreChroma4(uint8_t* dst, const int32x4_t* sums, const int16_t* k)
+    {
+        int32x4_t value = vmlaq_n_s32(vdupq_n_s32(CHROMA_OFFSET), sums[0], k[0]);
+        value = vmlaq_n_s32(value, sums[1], k[1]);
+        value = vmlaq_n_s32(value, sums[2], k[2]); // 2: third channel
+        uint16x4_t chroma = vqmovun_s32(vshrq_n_s32(value, CHROMA_SHIFT));
+        uint8_t packed[SIMD_PIXELS];
+        vst1_u8(packed, vqmovn_u16(vcombine_u16(chroma, chroma)));
+        std::memcpy(dst, packed, SIMD_PIXELS / 2); // 2: chroma is subsampled horizontally
+    }
+
+    int32_t SimdRowPair(const uint8_t* row0, const uint8_t* row1, int32_t width, const Coefficients& k,
+                        uint8_t* y0, uint8_t* y1, uint8_t* cb, uint8_t* cr)
+    {
+        int32_t x = 0;
+        for (; x + SIMD_PIXELS <= width; x += SIMD_PIXELS) {
+            uint8x8x4_t top = vld4_u8(row0 + static_cast<size_t>(x) * PIXEL_SIZE);
+            uint8x8x4_t bottom = vld4_u8(row1 + static_cast<size_t>(x) * PIXEL_SIZE);
+            StoreLuma8(y0 + x, top, k);
+            StoreLuma8(y1 + x, bottom, k);
+            int32x4_t sums[CHANNELS];
+            for (size_t c = 0; c < CHANNELS; ++c) {
+                sums[c] = BlockSums(top.val[c], bottom.val[c]);
+            }
+            StoreChroma4(cb + x / 2, sums, k.cb); // 2: chroma is subsampled horizontally
+            StoreChroma4(cr + x / 2, sums, k.cr); // 2: chroma is subsampled horizontally
+        }
+        return x;
+    }
+#else
+    int32_t SimdRowPair(const uint8_t* row0, const uint8_t* row1, int32_t width, const Coefficients& k,
+                        uint8_t* y0, uint8_t* y1, uint8_t* cb, uint8_t* cr)
+    {
+        return 0;
+    }
+#endif
+}
+
+namespace YuvConvert {
+    void RgbxToYuv420(const uint8_t* src, size_t srcStride, int32_t width, int32_t height, bool isBgr,
+                      uint8_t* yPlane, size_t yStride, uint8_t* cbPlane, uint8_t* crPlane, size_t chromaStride)
+    {
+        if (src == nullptr || yPlane == nullptr || cbPlane == nullptr || crPlane == nullptr || width < 1 ||
+            height < 1) {
+            return;
+        }
+        const Coefficients& k = isBgr ? BGR_COEFFICIENTS : RGB_COEFFICIENTS;
+        for (int32_t y = 0; y < height; y += 2) { // 2: one chroma row per two rows
+            const uint8_t* row0 = src + static_cast<size_t>(y) * srcStride;
+            uint8_t* y0 = yPlane + static_cast<size_t>(y) * yStride;
+            // The last row of an odd height is its own pair and its luma is written twice.
+            bool hasPair = y + 1 < height;
+            const uint8_t* row1 = hasPair ? row0 + srcStride : row0;
+            uint8_t* y1 = hasPair ? y0 + yStride : y0;
+            uint8_t* cb = cbPlane + static_cast<size_t>(y / 2) * chromaStride; // 2: chroma row of the pair
+            uint8_t* cr = crPlane + static_cast<size_t>(y / 2) * chromaStride; // 2: chroma row of the pair
+            int32_t x = SimdRowPair(row0, row1, width, k, y0, y1, cb, cr);
+            ScalarRowPair(row0, row1, x, width, k, y0, y1, cb, cr);
+        }
+    }
+}; // namespace YuvConvert
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef YUVCONVERT_H
+#define YUVCONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Conversion of 4 bytes per pixel frames into the planes of a 4:2:0 jpeg, with an SSE2 or NEON kernel.
+namespace YuvConvert {
+    // Full range BT.601 YCbCr as JFIF defines it, alpha is dropped and every chroma sample is the mean of a 2x2
+    // block. An odd last column or row is paired with itself. The chroma planes hold (width + 1) / 2 samples of
+    // (height + 1) / 2 rows.
+    void RgbxToYuv420(const uint8_t* src, size_t srcStride, int32_t width, int32_t height, bool isBgr,
+                      uint8_t* yPlane, size_t yStride, uint8_t* cbPlane, uint8_t* crPlane, size_t chromaStride);
+}; // namespace YuvConvert
+
+#endif // YUVCONVERT_H